@@ -58,10 +58,20 @@
 #if ( TM_ENHANCE_NOISEBAND_FOR_RA6E1 == 1 )
 #include "dvr_extflash.h" /* Needed to allow noiseband command to disable writes to the serial flash chip */
 #endif
+#ifdef TM_LOGSTORE_UNIT_TEST
+#include "dvr_logStore.h"
+#endif
+#ifdef TM_RS_UNIT_TEST
+#include "rs.h"
+#endif
+#ifdef TM_DFWP_UNIT_TEST
+#include "dfw_pckt.h"
+#endif
 #include "radio.h"
 #include "radio_hal.h"
 #include "PHY.h"
 #include "PHY_Protocol.h"
+#include "SoftDemodulator.h"
 #include "MAC_Protocol.h"
 #include "SM_Protocol.h"     // Stack Manager
 #include "SM.h"              // Stack Manager
@@ -74,6 +84,7 @@
 #include "mtls.h"
 #endif
 #include "time_util.h"
+#include "timer_util.h"
 #include "partitions.h"
 #if ( DCU == 1 )
 #include "MAINBD_Handler.h"
@@ -93,6 +104,9 @@
 #include "ecc108_freertos.h"
 #include "crc.h"
 #include "crc32.h"
+#if ( MCU_SELECTED == RA6E1 )
+#include "crc_custom.h"
+#endif
 #endif
 #include "ecc108_lib_return_codes.h"
 //#include "compiler_types.h"
@@ -758,6 +772,9 @@ static const struct_CmdLineEntry DBG_CmdTable[] =
    { "rxdetection",  DBG_CommandLine_RxDetection,     "Set/print the detection configuration" },
    { "rxframing",    DBG_CommandLine_RxFraming,       "Set/print the framing configuration" },
    { "rxmode",       DBG_CommandLine_RxMode,          "Set/print the PHY mode configuration" },
+#if ( TM_SD_STAGE_TIMING == 1 )
+   { "sdstats",      DBG_CommandLine_SdStats,         "Soft demodulator cycles per stage since last reset. Param: reset (optional)" },
+#endif
 #if ( DCU == 1 )
    { "sdtest",       DBG_CommandLine_sdtest,          "[count (default=1)] Exercise SDRAM" },
 #endif
@@ -888,6 +905,7 @@ static const struct_CmdLineEntry DBG_CmdTable[] =
 #endif
 #if ( TM_CRC_UNIT_TEST == 1)
    { "crcunittest",          DBG_CommandLine_CrcCalculate,     "Displays CRC results" },
+   { "crcbench",             DBG_CommandLine_CrcBenchmark,     "Compares table driven and bitwise CRC results and timing" },
 #endif
 #if ( TM_TIME_COMPOUND_TEST == 1)
    { "ticktestelapsed",      DBG_CommandLine_TimeElapsed,    "Displays Time compound's difference in ElapsedMilliseconds" },
@@ -939,6 +957,27 @@ static const struct_CmdLineEntry DBG_CmdTable[] =
 #if ( TM_RTC_UNIT_TEST == 1 )
    { "rtcUnitTest",   DBG_CommandLine_RTC_UnitTest,      "Run the RTC_UnitTest" },
 #endif
+#ifdef TM_TIMER_UNIT_TEST
+   { "tmrUnitTest",   DBG_CommandLine_TMR_UnitTest,      "Run the TMR_unitTest" },
+#endif
+#ifdef TM_SOFTDEMOD_UNIT_TEST
+   { "sdUnitTest",    DBG_CommandLine_SD_UnitTest,       "Run the SD_unitTest (radio must not be using the soft demodulator)" },
+#endif
+#ifdef TM_LOGSTORE_UNIT_TEST
+   { "lgsUnitTest",   DBG_CommandLine_LGS_UnitTest,      "Run the log store driver power loss unit test (RAM only)" },
+#endif
+#ifdef TM_PACK_UNIT_TEST
+   { "packUnitTest",  DBG_CommandLine_PACK_UnitTest,     "Run the PACK_unitTest" },
+#endif
+#ifdef TM_BM_UNIT_TEST
+   { "bmUnitTest",    DBG_CommandLine_BM_UnitTest,       "Run the BM_unitTest" },
+#endif
+#ifdef TM_DFWP_UNIT_TEST
+   { "dfwpUnitTest",  DBG_CommandLine_DFWP_UnitTest,     "Run the DFWP_unitTest on the last download's bit field" },
+#endif
+#ifdef TM_RS_UNIT_TEST
+   { "rsUnitTest",    DBG_CommandLine_RS_UnitTest,       "Run the RS_unitTest" },
+#endif
 #if ( TM_UART_EVENT_COUNTERS == 1 )
    { "UARTcounters",         DBG_CommandLine_UARTcounters,              "Dumps RA6E1 UART driver counters" },
    { "UARTclearCounters",    DBG_CommandLine_UARTclearCounters,         "Clears RA6E1 UART driver counters" },
@@ -1751,6 +1790,105 @@ uint32_t DBG_CommandLine_CrcCalculate( uint32_t argc, char *argv[] )
 
    return ( 0 );
 }/* end DBG_CommandLine_CrcCalculate() */
+
+/*******************************************************************************
+
+   Function name: DBG_CommandLine_CrcBenchmark
+
+   Purpose: Cross-checks the table driven CRC routines against the bitwise reference and reports the time taken by each
+
+   Arguments:  argc - Number of Arguments passed to this function
+               argv - pointer to the list of arguments passed to this function (optional: number of passes)
+
+   Returns: FuncStatus - Successful status of this function - currently always 0 (success)
+
+*******************************************************************************/
+uint32_t DBG_CommandLine_CrcBenchmark( uint32_t argc, char *argv[] )
+{
+   static uint8_t dataBuf[1024];
+   crc32Cfg_t     crcCfg;
+   uint32_t       passes = 64;
+   uint32_t       pass;
+   uint32_t       startMs;
+   uint32_t       tableMs;
+   uint32_t       bitMs;
+   uint32_t       tableCrc = 0;
+   uint32_t       bitCrc = 0;
+   uint16_t       i;
+
+   if ( argc > 1 )
+   {
+      passes = ( uint32_t )atoi( argv[1] );
+      if ( 0 == passes )
+      {
+         DBG_logPrintf( 'R', "ERROR - number of passes must be at least 1" );
+         return ( 0 );
+      }
+   }
+   for ( i = 0; i < sizeof( dataBuf ); i++ )
+   {
+      dataBuf[i] = (uint8_t)( ( i * 131U ) + ( i >> 3 ) );
+   }
+
+   /* Odd start offset/length so that the unaligned head and tail handling is exercised as well */
+   CRC32_init( CRC32_DFW_START_VALUE, CRC32_DFW_POLY, eCRC32_RESULT_INVERT, &crcCfg );
+   startMs = OS_TICK_Get_ElapsedMilliseconds();
+   for ( pass = 0; pass < passes; pass++ )
+   {
+      tableCrc = CRC32_calc( &dataBuf[1], sizeof( dataBuf ) - 2, &crcCfg );
+   }
+   tableMs = OS_TICK_Get_ElapsedMilliseconds() - startMs;
+
+   CRC32_init( CRC32_DFW_START_VALUE, CRC32_DFW_POLY, eCRC32_RESULT_INVERT, &crcCfg );
+   startMs = OS_TICK_Get_ElapsedMilliseconds();
+   for ( pass = 0; pass < passes; pass++ )
+   {
+      bitCrc = CRC32_calcBitwise( &dataBuf[1], sizeof( dataBuf ) - 2, &crcCfg );
+   }
+   bitMs = OS_TICK_Get_ElapsedMilliseconds() - startMs;
+
+   DBG_logPrintf( 'R', "CRC32_calc: %lu bytes, table %lums, bitwise %lums, %s",
+                  ( unsigned long )( passes * ( sizeof( dataBuf ) - 2 ) ),
+                  tableMs, bitMs, ( tableCrc == bitCrc ) ? "match" : "MISMATCH" );
+#if ( MCU_SELECTED == RA6E1 )
+   {
+      uint16_t tableCrc16 = 0;
+      uint16_t bitCrc16 = 0;
+
+      startMs = OS_TICK_Get_ElapsedMilliseconds();
+      for ( pass = 0; pass < passes; pass++ )
+      {
+         tableCrc16 = CRC_CUSTOM_16cal( CRC_CUSTOM_PHY_HDR_POLY, 0x98FD, dataBuf, sizeof( dataBuf ) );
+      }
+      tableMs = OS_TICK_Get_ElapsedMilliseconds() - startMs;
+      startMs = OS_TICK_Get_ElapsedMilliseconds();
+      for ( pass = 0; pass < passes; pass++ )
+      {
+         bitCrc16 = CRC_CUSTOM_16calBitwise( CRC_CUSTOM_PHY_HDR_POLY, 0x98FD, dataBuf, sizeof( dataBuf ) );
+      }
+      bitMs = OS_TICK_Get_ElapsedMilliseconds() - startMs;
+      DBG_logPrintf( 'R', "CRC_CUSTOM_16cal: table %lums, bitwise %lums, %s", tableMs, bitMs,
+                     ( tableCrc16 == bitCrc16 ) ? "match" : "MISMATCH" );
+
+      startMs = OS_TICK_Get_ElapsedMilliseconds();
+      for ( pass = 0; pass < passes; pass++ )
+      {
+         tableCrc = CRC_CUSTOM_32cal( CRC_CUSTOM_PHY_PAYLOAD_POLY, 0xFDBB3209, dataBuf, sizeof( dataBuf ) );
+      }
+      tableMs = OS_TICK_Get_ElapsedMilliseconds() - startMs;
+      startMs = OS_TICK_Get_ElapsedMilliseconds();
+      for ( pass = 0; pass < passes; pass++ )
+      {
+         bitCrc = CRC_CUSTOM_32calBitwise( CRC_CUSTOM_PHY_PAYLOAD_POLY, 0xFDBB3209, dataBuf, sizeof( dataBuf ) );
+      }
+      bitMs = OS_TICK_Get_ElapsedMilliseconds() - startMs;
+      DBG_logPrintf( 'R', "CRC_CUSTOM_32cal: table %lums, bitwise %lums, %s", tableMs, bitMs,
+                     ( tableCrc == bitCrc ) ? "match" : "MISMATCH" );
+   }
+#endif
+
+   return ( 0 );
+}/* end DBG_CommandLine_CrcBenchmark() */
 #endif
 
 #if ( TM_TIME_COMPOUND_TEST == 1 )
@@ -7408,6 +7546,7 @@ uint32_t DBG_CommandLine_HmcEng ( uint32_t argc, char *argv[] )
     DBG_logPrintf( 'R', "   retry:   0x%02x", fileData.exeCnts.retry);
     DBG_logPrintf( 'R', "   tog:     0x%02x", fileData.exeCnts.tog);
   }
+  HMC_APP_PrintAppletStats();
   return 0;
 }
 #endif /* ( ACLARA_LC == 0 ) && ( ACLARA_DA == 0 ) meter specific code */
@@ -12868,6 +13007,59 @@ uint32_t DBG_CommandLine_Buffers( uint32_t argc, char *argv[] )
 
    return ( 0 );
 }
+
+#if ( TM_SD_STAGE_TIMING == 1 )
+/******************************************************************************
+
+   Function Name: DBG_CommandLine_SdStats
+
+   Purpose: This function displays the cycles spent in each stage of the soft demodulator, to measure its real time
+            margin and the effect of changes to its DSP kernels
+
+   Arguments:  argc - Number of Arguments passed to this function
+               argv - pointer to the list of arguments passed to this function
+
+   Returns: FuncStatus - Successful status of this function - currently always 0 (success)
+
+   Notes: sdstats reset - restart the statistics after displaying them
+          The cycles are measured around each call, so they include any preemption by higher priority tasks
+
+******************************************************************************/
+uint32_t DBG_CommandLine_SdStats( uint32_t argc, char *argv[] )
+{
+   static const char * const stageName[eSD_STAGE_LAST] =
+   {
+      "phase2freq", "findSync", "resample", "fir", "preamble", "syncPayload"
+   };
+   SD_StageStats_t stats[eSD_STAGE_LAST];
+   uint32_t        elapsedMs;
+   uint32_t        cpuFreq;
+   uint32_t        i;
+
+   SD_GetStageStats( stats, &elapsedMs, (bool)( ( argc > 1 ) && ( 0 == strcasecmp( argv[1], "reset" ) ) ) );
+   (void)TIME_SYS_GetRealCpuFreq( &cpuFreq, NULL, NULL );
+
+   DBG_printf( "Soft demodulator stages over %lu ms", elapsedMs );
+   for ( i = 0; i < (uint32_t)eSD_STAGE_LAST; i++ )
+   {
+      if ( ( stats[i].calls != 0 ) && ( elapsedMs != 0 ) )
+      {
+         /* CPU load in 0.01% units: cycles * 10000 / cycles elapsed */
+         DBG_printf( "%-11s calls: %6lu cycles/call: %6lu max: %6lu samples/s: %6lu load: %lu.%02lu%%",
+                     stageName[i],
+                     stats[i].calls,
+                     (uint32_t)( stats[i].cycles / stats[i].calls ),
+                     stats[i].maxCycles,
+                     (uint32_t)( ( stats[i].samples * 1000U ) / elapsedMs ),
+                     (uint32_t)( ( ( stats[i].cycles * 10000U ) / ( (uint64_t)elapsedMs * ( cpuFreq / 1000U ) ) ) / 100U ),
+                     (uint32_t)( ( ( stats[i].cycles * 10000U ) / ( (uint64_t)elapsedMs * ( cpuFreq / 1000U ) ) ) % 100U ) );
+      }
+   }
+
+   return ( 0 );
+}
+#endif // ( TM_SD_STAGE_TIMING == 1 )
+
 #if ( RTOS_SELECTION == FREE_RTOS )
 /******************************************************************************
 
@@ -16710,3 +16902,136 @@ uint32_t DBG_CommandLine_RTC_UnitTest( uint32_t argc, char *argv[] )
    return ( uint32_t )retVal;
 }
 #endif
+#ifdef TM_TIMER_UNIT_TEST
+/******************************************************************************
+
+   Function Name: DBG_CommandLine_TMR_UnitTest ( uint32_t argc, char *argv[] )
+
+   Purpose: This function runs the unit test of the timer utility. Results are logged by the test.
+
+   Arguments:  argc - Number of Arguments passed to this function
+               argv - pointer to the list of arguments passed to this function
+
+   Returns: FuncStatus - Successful status of this function - currently always 0 (success)
+
+******************************************************************************/
+uint32_t DBG_CommandLine_TMR_UnitTest( uint32_t argc, char *argv[] )
+{
+   TMR_unitTest();
+   return ( 0 );
+}
+#endif
+#ifdef TM_SOFTDEMOD_UNIT_TEST
+/******************************************************************************
+
+   Function Name: DBG_CommandLine_SD_UnitTest ( uint32_t argc, char *argv[] )
+
+   Purpose: This function runs the soft demodulator replay unit test. Results are logged by the test.
+
+   Arguments:  argc - Number of Arguments passed to this function
+               argv - pointer to the list of arguments passed to this function
+
+   Returns: FuncStatus - Successful status of this function - currently always 0 (success)
+
+******************************************************************************/
+uint32_t DBG_CommandLine_SD_UnitTest( uint32_t argc, char *argv[] )
+{
+   SD_unitTest();
+   return ( 0 );
+}
+#endif
+#ifdef TM_LOGSTORE_UNIT_TEST
+/******************************************************************************
+
+   Function Name: DBG_CommandLine_LGS_UnitTest ( uint32_t argc, char *argv[] )
+
+   Purpose: This function runs the power loss unit test of the log store driver. Results are logged by the test.
+
+   Arguments:  argc - Number of Arguments passed to this function
+               argv - pointer to the list of arguments passed to this function
+
+   Returns: FuncStatus - Successful status of this function - currently always 0 (success)
+
+******************************************************************************/
+uint32_t DBG_CommandLine_LGS_UnitTest( uint32_t argc, char *argv[] )
+{
+   DVR_LOGSTORE_unitTest();
+   return ( 0 );
+}
+#endif
+#ifdef TM_PACK_UNIT_TEST
+/******************************************************************************
+
+   Function Name: DBG_CommandLine_PACK_UnitTest ( uint32_t argc, char *argv[] )
+
+   Purpose: This function runs the unit test of the pack/unpack routines. Results are logged by the test.
+
+   Arguments:  argc - Number of Arguments passed to this function
+               argv - pointer to the list of arguments passed to this function
+
+   Returns: FuncStatus - Successful status of this function - currently always 0 (success)
+
+******************************************************************************/
+uint32_t DBG_CommandLine_PACK_UnitTest( uint32_t argc, char *argv[] )
+{
+   PACK_unitTest();
+   return ( 0 );
+}
+#endif
+#ifdef TM_BM_UNIT_TEST
+/******************************************************************************
+
+   Function Name: DBG_CommandLine_BM_UnitTest ( uint32_t argc, char *argv[] )
+
+   Purpose: This function runs the unit test of the buffer manager. Results are logged by the test.
+
+   Arguments:  argc - Number of Arguments passed to this function
+               argv - pointer to the list of arguments passed to this function
+
+   Returns: FuncStatus - Successful status of this function - currently always 0 (success)
+
+******************************************************************************/
+uint32_t DBG_CommandLine_BM_UnitTest( uint32_t argc, char *argv[] )
+{
+   BM_unitTest();
+   return ( 0 );
+}
+#endif
+#ifdef TM_DFWP_UNIT_TEST
+/******************************************************************************
+
+   Function Name: DBG_CommandLine_DFWP_UnitTest ( uint32_t argc, char *argv[] )
+
+   Purpose: This function runs the unit test of the DFW packet bit field. Results are logged by the test.
+
+   Arguments:  argc - Number of Arguments passed to this function
+               argv - pointer to the list of arguments passed to this function
+
+   Returns: FuncStatus - Successful status of this function - currently always 0 (success)
+
+******************************************************************************/
+uint32_t DBG_CommandLine_DFWP_UnitTest( uint32_t argc, char *argv[] )
+{
+   DFWP_unitTest();
+   return ( 0 );
+}
+#endif
+#ifdef TM_RS_UNIT_TEST
+/******************************************************************************
+
+   Function Name: DBG_CommandLine_RS_UnitTest ( uint32_t argc, char *argv[] )
+
+   Purpose: This function runs the unit test of the Reed-Solomon encoder and decoder. Results are logged by the test.
+
+   Arguments:  argc - Number of Arguments passed to this function
+               argv - pointer to the list of arguments passed to this function
+
+   Returns: FuncStatus - Successful status of this function - currently always 0 (success)
+
+******************************************************************************/
+uint32_t DBG_CommandLine_RS_UnitTest( uint32_t argc, char *argv[] )
+{
+   RS_unitTest();
+   return ( 0 );
+}
+#endif
@@ -40,6 +40,7 @@ void DBG_CommandLineTask ( taskParameter );
 uint32_t DBG_CommandLine_Help ( uint32_t argc, char *argv[] );
 #if ( TM_CRC_UNIT_TEST == 1 )
 uint32_t DBG_CommandLine_CrcCalculate( uint32_t argc, char *argv[] );
+uint32_t DBG_CommandLine_CrcBenchmark( uint32_t argc, char *argv[] );
 #endif
 
 #if ( TM_TIME_COMPOUND_TEST == 1 )
@@ -94,6 +95,27 @@ uint32_t DBG_CommandLine_OS_LinkedList_Dump( uint32_t argc, char *argv[] );
 #if ( TM_RTC_UNIT_TEST == 1 )
 uint32_t DBG_CommandLine_RTC_UnitTest( uint32_t argc, char *argv[] );
 #endif
+#ifdef TM_TIMER_UNIT_TEST
+uint32_t DBG_CommandLine_TMR_UnitTest( uint32_t argc, char *argv[] );
+#endif
+#ifdef TM_SOFTDEMOD_UNIT_TEST
+uint32_t DBG_CommandLine_SD_UnitTest( uint32_t argc, char *argv[] );
+#endif
+#ifdef TM_LOGSTORE_UNIT_TEST
+uint32_t DBG_CommandLine_LGS_UnitTest( uint32_t argc, char *argv[] );
+#endif
+#ifdef TM_PACK_UNIT_TEST
+uint32_t DBG_CommandLine_PACK_UnitTest( uint32_t argc, char *argv[] );
+#endif
+#ifdef TM_BM_UNIT_TEST
+uint32_t DBG_CommandLine_BM_UnitTest( uint32_t argc, char *argv[] );
+#endif
+#ifdef TM_DFWP_UNIT_TEST
+uint32_t DBG_CommandLine_DFWP_UnitTest( uint32_t argc, char *argv[] );
+#endif
+#ifdef TM_RS_UNIT_TEST
+uint32_t DBG_CommandLine_RS_UnitTest( uint32_t argc, char *argv[] );
+#endif
 #if ( DAC_CODE_CONFIG == 1 )
 uint32_t DBG_CommandLine_DAC_SetDacStep ( uint32_t argc, char *argv[] );
 uint32_t DBG_CommandLine_setPwrSel ( uint32_t argc, char *argv[] );
@@ -238,6 +260,9 @@ uint32_t DBG_CommandLine_RxChannels( uint32_t argc, char *argv[] );
 uint32_t DBG_CommandLine_RxDetection ( uint32_t argc, char *argv[] );
 uint32_t DBG_CommandLine_RxFraming ( uint32_t argc, char *argv[] );
 uint32_t DBG_CommandLine_RxMode ( uint32_t argc, char *argv[] );
+#if ( TM_SD_STAGE_TIMING == 1 )
+uint32_t DBG_CommandLine_SdStats ( uint32_t argc, char *argv[] );
+#endif
 uint32_t DBG_CommandLine_StackUsage ( uint32_t argc, char *argv[] );
 uint32_t DBG_CommandLine_TaskSummary ( uint32_t argc, char *argv[] );
 uint32_t DBG_CommandLine_TXMode ( uint32_t argc, char *argv[] );
@@ -272,9 +272,13 @@ returnStatus_t MINIBS_patch( PartitionData_t const *pOldImagePTbl, eFwTarget_t p
          readAndWriteBuffer( &oldpos, i, bufSizeToRead, reservedSectionSize,
                              oldImgBuf, eBSPATCH_READ_FROM_MEMORY, NULL );
 
+         /* Get the diff bytes from the patch partition */
+         if( bufSizeToRead != ( off_t )DFW_XZMINI_uncompressedData_read( patchOffset, newImgBuf, ( uint32_t )bufSizeToRead ) )
+         {
+            return eFAILURE; // Corrupt patch -3
+         }
          for( j = 0; j < bufSizeToRead; j++ )
          {
-            newImgBuf[j] = DFW_XZMINI_uncompressedData_getchar( patchOffset ); /* Get a byte from the patch partition */
             newImgBuf[j] += oldImgBuf[j]; /* Add with the app code */
          }
 
@@ -311,9 +315,10 @@ returnStatus_t MINIBS_patch( PartitionData_t const *pOldImagePTbl, eFwTarget_t p
             bufSizeToRead = ctrl - i;
          }
 
-         for( j = 0; j < bufSizeToRead; j++ )
+         /* Get the extra bytes from the patch partition */
+         if( bufSizeToRead != ( off_t )DFW_XZMINI_uncompressedData_read( patchOffset, newImgBuf, ( uint32_t )bufSizeToRead ) )
          {
-            newImgBuf[j] = DFW_XZMINI_uncompressedData_getchar( patchOffset ); /* Get a byte from the patch partition */
+            return eFAILURE; // Corrupt patch -3
          }
 
          /* Write the created buffer in the partition */
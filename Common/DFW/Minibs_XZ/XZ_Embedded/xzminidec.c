@@ -251,6 +251,62 @@ static xz_returnStatus_t XZMINIDEC_run( compressedData_position_t *patchOffset )
    return returnValue;
 }
 
+/***********************************************************************************************************************
+
+   Function Name: XZMINIDEC_read
+
+   Purpose: It copies count bytes of uncompressed patch output to pDest. The output buffer is copied a contiguous span
+            at a time, and re-filled with XZMINIDEC_run API when it has been consumed.
+
+   Arguments: compressedData_position_t *patchOffset, uint8_t *pDest, uint32_t count
+
+   Returns: uint32_t - number of bytes copied, less than count if the patch ended or is corrupt
+
+   Side Effects: Nothing
+
+   Reentrant Code: No
+
+   Notes:
+
+**********************************************************************************************************************/
+uint32_t XZMINIDEC_read( compressedData_position_t *patchOffset, uint8_t *pDest, uint32_t count )
+{
+   uint32_t          copied = 0;    // Bytes copied to pDest
+   uint32_t          span;          // Bytes available in the output buffer
+   xz_returnStatus_t status;
+
+   while ( copied < count )
+   {
+      if( getchar_pos >= xzDataBuffer.output_pos )
+      {  /* Output buffer consumed, uncompress more */
+         status = XZMINIDEC_run( patchOffset );
+         if( getchar_pos == xzDataBuffer.output_size )
+         {
+            getchar_pos = 0;
+         }
+         if( getchar_pos >= xzDataBuffer.output_pos )
+         {  /* Nothing uncompressed, only input consumed. Try again unless the stream ended or failed. */
+            if( XZ_OK != status )
+            {
+               break;
+            }
+            continue;
+         }
+      }
+
+      span = xzDataBuffer.output_pos - getchar_pos;
+      if( span > ( count - copied ) )
+      {
+         span = count - copied;
+      }
+      ( void )memcpy( &pDest[copied], &xzDataBuffer.output[getchar_pos], span );
+      getchar_pos += span;
+      copied      += span;
+   }
+
+   return copied;
+}
+
 /***********************************************************************************************************************
 
    Function Name: XZMINIDEC_getchar
@@ -260,26 +316,20 @@ static xz_returnStatus_t XZMINIDEC_run( compressedData_position_t *patchOffset )
 
    Arguments: compressedData_position_t *patchOffset
 
-   Returns: u_char - return a byte data of uncompressed patch output
+   Returns: u_char - return a byte data of uncompressed patch output (0 if the patch ended or is corrupt)
 
    Side Effects: Nothing
 
    Reentrant Code: No
 
-   Notes:
+   Notes:  Use XZMINIDEC_read for more than one byte.
 
 **********************************************************************************************************************/
 u_char XZMINIDEC_getchar( compressedData_position_t *patchOffset )
 {
-   if( getchar_pos >= xzDataBuffer.output_pos )
-   {
-      ( void ) XZMINIDEC_run( patchOffset );
-   }
+   u_char data = 0;
 
-   if( getchar_pos == xzDataBuffer.output_size )
-   {
-      getchar_pos = 0;
-   }
+   ( void )XZMINIDEC_read( patchOffset, &data, 1 );
 
-   return xzDataBuffer.output[getchar_pos++];
+   return data;
 }
@@ -49,5 +49,6 @@
 xz_returnStatus_t  XZMINIDEC_init( compressedData_position_t *patchOffset );
 void               XZMINIDEC_end( void );
 u_char             XZMINIDEC_getchar( compressedData_position_t *patchOffset );
+uint32_t           XZMINIDEC_read( compressedData_position_t *patchOffset, uint8_t *pDest, uint32_t count );
 
 #endif
@@ -136,7 +136,6 @@ static int32_t convertCharBufArrayToInt32 ( const u_char *buffer )
    Function Name: DFW_XZMINI_uncompressedData_read_ssize
 
    Purpose: Gets the uncompressed data buffer xzDataBuffer.out structure of 4 bytes
-            It obtains the data byte by byte so to prevent the need of uncompression from xzDataBuffer.in structure
 
    Arguments: compressedData_position_t *patchOffset
 
@@ -151,15 +150,34 @@ static int32_t convertCharBufArrayToInt32 ( const u_char *buffer )
 **********************************************************************************************************************/
 int32_t DFW_XZMINI_uncompressedData_read_ssize( compressedData_position_t *patchOffset )
 {
-   u_char buffer[4];
-   u_char *buffer_p = &buffer[0];
+   u_char buffer[4] = { 0 };  // Stays 0 if the patch ended or is corrupt
 
-   buffer[0] = DFW_XZMINI_uncompressedData_getchar( patchOffset );
-   buffer[1] = DFW_XZMINI_uncompressedData_getchar( patchOffset );
-   buffer[2] = DFW_XZMINI_uncompressedData_getchar( patchOffset );
-   buffer[3] = DFW_XZMINI_uncompressedData_getchar( patchOffset );
+   ( void )XZMINIDEC_read( patchOffset, buffer, ( uint32_t )sizeof( buffer ) );
 
-   return convertCharBufArrayToInt32( buffer_p );
+   return convertCharBufArrayToInt32( buffer );
+}
+
+/***********************************************************************************************************************
+
+   Function Name: DFW_XZMINI_uncompressedData_read
+
+   Purpose: Gets count bytes of uncompressed data into pDest. The data is copied from the uncompressed data buffer a
+            contiguous span at a time, uncompressing another block when the buffer has been used up to the end.
+
+   Arguments: compressedData_position_t *patchOffset, u_char *pDest, uint32_t count
+
+   Returns: uint32_t - number of bytes read, less than count if the patch ended or is corrupt
+
+   Side Effects: Nothing
+
+   Reentrant Code: No
+
+   Notes:
+
+**********************************************************************************************************************/
+uint32_t DFW_XZMINI_uncompressedData_read( compressedData_position_t *patchOffset, u_char *pDest, uint32_t count )
+{
+   return( XZMINIDEC_read( patchOffset, pDest, count ) );
 }
 
 /***********************************************************************************************************************
@@ -77,6 +77,7 @@ returnStatus_t            DFW_XZMINI_uncompressPatch_init( const PartitionData_t
 returnStatus_t            DFW_XZMINI_bspatch_valid_header( int32_t* newsize, int32_t* ctrllen, int32_t* datalen );
 int32_t                   DFW_XZMINI_uncompressedData_read_ssize( compressedData_position_t *patchOffset );
 u_char                    DFW_XZMINI_uncompressedData_getchar( compressedData_position_t *patchOffset );
+uint32_t                  DFW_XZMINI_uncompressedData_read( compressedData_position_t *patchOffset, u_char *pDest, uint32_t count );
 void                      DFW_XZMINI_bspatch_close( void );
 returnStatus_t            DFW_XZMINI_bspatch( PartitionData_t const *pOldImagePTbl, eFwTarget_t patchTarget, PartitionData_t const *pNewImagePTbl, off_t newImageSize );
 #endif
@@ -13,6 +13,11 @@
  * When clearing the bit filed, use 'DFWP_clearBitField()' to set a flag so that the bit field is cleared
  * at the lowest priority from the main loop.  Main loop should call 'DFWP_ClearBitMap()'.
  *
+ * The bit field is mirrored in RAM (loaded once from NV, written through to NV by DFWP_modifyBit) so status and
+ * missing packet requests do not read NV.  The missing packet scans work on 32 bit words, skipping words with no
+ * missing packet, and the number of packets received below the last requested packet count is kept up to date so
+ * counting the missing packets does not scan the bit field.
+ *
  ***********************************************************************************************************************
  * A product of
  * Aclara Technologies LLC
@@ -42,6 +47,7 @@
  *                         Function modifyBit() now takes an enum.  It used to have macro definitions.
  *                         Added a global flag to determine if the NV memory needs to be read to get the status.  This
  *                            will save NV memory access (reduce SPI traffic for external memory).
+ * v2.1 - RAM mirror of the bit field, word wide scans and running received packet count.
  *
  * @version    2.0
  * #since      2014-02-10
@@ -81,6 +87,13 @@
 #define CHAR_BIT  ((uint8_t)8)
 #endif
 
+#define DFWP_WORD_BITS            ((uint16_t)32)                                      // Bits in a bit field word
+#define DFWP_PCKT_CNT_SIZE_WORDS  ((uint16_t)(DFWP_PCKT_CNT_SIZE_BITS / DFWP_WORD_BITS)) // Maximum packets in words
+/* Mask of the bits below bit n of a word (n = 0-31) */
+#define DFWP_BITS_BELOW( n )      ( ( (uint32_t)1 << (n) ) - 1 )
+/* Index of the lowest bit set in a non zero word */
+#define DFWP_LOWEST_BIT( w )      ( (uint16_t)__CLZ( __RBIT( w ) ) )
+
 // </editor-fold>
 
 // <editor-fold defaultstate="collapsed" desc="Type Definitions">
@@ -95,6 +108,13 @@
 
 static PartitionData_t const *pDFWBitfieldPTbl_; // Pointer to the DFW bit field partition
 
+/* RAM copy of the bit field.  The targets are little endian, so bit n of word w is bit (n % 8) of NV byte (w * 4 + n / 8)
+ * which is packet (w * 32 + n), as in NV. */
+static uint32_t bitField_[DFWP_PCKT_CNT_SIZE_WORDS];
+static bool     bitFieldValid_ = false; // bitField_ matches the NV bit field
+static uint16_t countLimit_    = 0;     // Packet count of the last missing packet count request
+static uint16_t countSet_      = 0;     // Number of bits set in bitField_ below countLimit_
+
 /* Used to reduce the NV traffic in the timeSlice function.  If set the timeSlice function will read the status from NV
  * memory to see if action is required.  */
 
@@ -104,6 +124,11 @@ static PartitionData_t const *pDFWBitfieldPTbl_; // Pointer to the DFW bit field
 /* ****************************************************************************************************************** */
 /* FUNCTION PROTOTYPES */
 
+static returnStatus_t loadBitField( void );
+static uint16_t       countSetBits( uint16_t limit );
+static uint16_t       findBit( uint16_t from, uint16_t limit, bool bSet );
+static uint16_t       missingCount( uint16_t totPckts );
+
 // </editor-fold>
 
 /* ****************************************************************************************************************** */
@@ -124,12 +149,19 @@ static PartitionData_t const *pDFWBitfieldPTbl_; // Pointer to the DFW bit field
  *
  * Reentrant Code: Yes
  *
- * Notes:  Uses a named partition, ePART_NV_DFW_BITFIELD, so the timing will be '0'.
+ * Notes:  Uses a named partition, ePART_NV_DFW_BITFIELD, so the timing will be '0'.  Reads the bit field into RAM.
  *
  **********************************************************************************************************************/
 returnStatus_t DFWP_init( void )
 {
-   return (PAR_partitionFptr.parOpen(&pDFWBitfieldPTbl_, ePART_NV_DFW_BITFIELD, (uint32_t)0));// Open DFW bit field file
+   returnStatus_t retVal;
+
+   retVal = PAR_partitionFptr.parOpen(&pDFWBitfieldPTbl_, ePART_NV_DFW_BITFIELD, (uint32_t)0);// Open DFW bit field file
+   if ( eSUCCESS == retVal )
+   {
+      retVal = loadBitField();                     // Get the RAM copy of the bit field
+   }
+   return (retVal);
 }
 /* ****************************************************************************************************************** */
 // </editor-fold>
@@ -225,6 +257,8 @@ bool DFWP_ClearBitMap( void )
    {  // Success!
       bTimeSpent = true;               // Time was spent
    }
+   bitFieldValid_ = false;             // RAM copy follows whatever the erase left in NV
+   (void)loadBitField();
 #endif
    return(bTimeSpent);
 }
@@ -254,14 +288,13 @@ bool DFWP_ClearBitMap( void )
 returnStatus_t DFWP_getBitStatus( uint16_t pcktNum, uint8_t *pBit )
 {
    returnStatus_t retVal = eFAILURE;   // Assume error
-   uint8_t          rdByte;              // rdByte containing the bit to look at
 
    if ( pcktNum < DFWP_PCKT_CNT_SIZE_BITS ) // Check for valid size
-   {  // Read byte from bit field containing requested packet's bit
-      retVal = PAR_partitionFptr.parRead(&rdByte, (dSize)(pcktNum/CHAR_BIT), (lCnt)(sizeof(rdByte)), pDFWBitfieldPTbl_);
+   {
+      retVal = loadBitField();         // Only reads NV if the RAM copy is not valid
       /* If the read above were to fail, the *pBit will be updated with an incorrect value.  It doesn't matter because
        * the returned value will be eFAILURE.  So, to save code, don't bother checking if the data was read properly. */
-      *pBit = (uint8_t)((rdByte >> (pcktNum % (uint8_t)CHAR_BIT)) & 1); /* Update the pBit value w/corresponding bit */
+      *pBit = (uint8_t)((bitField_[pcktNum / DFWP_WORD_BITS] >> (pcktNum % DFWP_WORD_BITS)) & 1); /* Corresponding bit */
    }
    return(retVal);
 }
@@ -287,7 +320,8 @@ returnStatus_t DFWP_getBitStatus( uint16_t pcktNum, uint8_t *pBit )
  *
  * Reentrant Code: Yes
  *
- * Notes:  On a PIC24 @ 16MHz, it takes 53mS to report on 2048 bytes!
+ * Notes:  On a PIC24 @ 16MHz, it took 53mS to report on 2048 bytes read from NV one byte at a time.  The RAM copy is
+ *         now scanned a word at a time, and the count alone (maxPcktsReported = 0) does not scan.
  *
  **********************************************************************************************************************/
 returnStatus_t DFWP_getMissingPackets(dl_packetcnt_t  totPckts,         dl_packetcnt_t maxPcktsReported,
@@ -297,36 +331,25 @@ returnStatus_t DFWP_getMissingPackets(dl_packetcnt_t  totPckts,         dl_packe
    uint16_t       missingPckts = 0;                // Local copy of the number of missing packets.
 
    if ( (0 != totPckts) && (totPckts <= DFWP_PCKT_CNT_SIZE_BITS) )      // Check for valid size
-   {  // Scan each bit in bit field to find those that are 0.  Stop scanning when maxPcktsReported are found
-      uint32_t      offset;                        // Offset of current byte in bitfield
-      dl_packetid_t bitInBitmap;                   // Loop counter that iterates through all bits in bit field
-      uint8_t       mapData = 0;                   // Copy of NV memory bit array
-
-      offset       = 0;
-      for ( bitInBitmap = 0; bitInBitmap < totPckts; bitInBitmap++ )
-      {  //Get a byte of the bit map field when needed
-         if ( bitInBitmap % CHAR_BIT == 0)
-         {
-            /*lint -e(776) Only read the curent byte needed. */
-            retVal = PAR_partitionFptr.parRead(&mapData, (dSize)offset, (lCnt)1, pDFWBitfieldPTbl_);
-            if (eSUCCESS != retVal)
+   {
+      retVal = loadBitField();                     // Only reads NV if the RAM copy is not valid
+      if ( eSUCCESS == retVal )
+      {
+         missingPckts = missingCount(totPckts);
+         if ( NULL != pMissingPcktIds )
+         {  // Find the 0 bits in the bit field.  Stop scanning when maxPcktsReported are found
+            dl_packetcnt_t reported;               // Number of missing packet IDs stored
+            uint16_t       bitInBitmap = 0;        // Current bit in the bit field
+
+            for ( reported = 0; reported < maxPcktsReported; reported++ )
             {
-               break;   //Exit loop and function if unable to read data
-            }
-            offset++;
-         }
-         // Check if we have a missing packet at offset bitInBitmap
-         if ( 0 == (mapData & (1 << (bitInBitmap % CHAR_BIT))) )
-         {  // A missing packet has been found!
-            if (missingPckts < maxPcktsReported)   // Have the maximum number of missing packets been reported?
-            {  // Number of missing packets reported hasn't exceeded the requested maximum.
-               if (NULL != pMissingPcktIds)
+               bitInBitmap = findBit(bitInBitmap, totPckts, (bool)false);
+               if ( bitInBitmap >= totPckts )
                {
-                  //lint -e(413)  NULL is checked for above.
-                  pMissingPcktIds[missingPckts] = bitInBitmap; // Store missing pckt ID.  Using missingPckts as index
+                  break;                           // No more missing packets
                }
+               pMissingPcktIds[reported] = (dl_packetid_t)bitInBitmap++; // Store missing pckt ID
             }
-            missingPckts++;  // Increment the number of missing packets.  Done here so it can be used as an index.
          }
       }
    }
@@ -362,7 +385,8 @@ returnStatus_t DFWP_getMissingPackets(dl_packetcnt_t  totPckts,         dl_packe
  *
  * Reentrant Code: Yes
  *
- * Notes:  On a K60 @ ??MHz, it takes ??mS to report on 2048 bytes!
+ * Notes:  Each range is found with two word wide scans of the RAM copy of the bit field (first 0 bit, then first 1 bit).
+ *         A range whose first packet ID fills the last entry of pMissingPcktIds is reported as that single ID.
  *
  **********************************************************************************************************************/
 returnStatus_t DFWP_getMissingPacketsRange(dl_packetcnt_t  totPckts,         dl_packetcnt_t maxReportPckts,
@@ -374,81 +398,31 @@ returnStatus_t DFWP_getMissingPacketsRange(dl_packetcnt_t  totPckts,         dl_
         (totPckts <= DFWP_PCKT_CNT_SIZE_BITS) &&      // Check for valid size
         (    NULL != pMissingPcktIds)         &&      // Check for valid pointer
         (    NULL != pNumMissingPckts)        )       // Check for valid pointer
-   {  // Scan each bit in bit field to find those that are 0.  Stop scanning when maxPcktsReported are found
-      dl_packetid_t bitInBitmap;          // Loop counter that iterates through all bits in bit field
-      uint8_t       mapData = 0;          // Copy of NV memory bit array
-      uint32_t      offset;               // Offset of current byte in bitfield
-      uint16_t      pktIndex;             // Index in pMissingPcktIds.
-      dl_packetid_t nextID;               // Next PacketID when checking for consecutive ID's
-      uint8_t       consecutive;          // Used to track consecutive packet ID's
-
-      offset      = 0;
-      pktIndex    = 0;
-      consecutive = false;
-      nextID      = 0;        // Just to make sure it is initialized
-      for ( bitInBitmap = 0; bitInBitmap < totPckts; bitInBitmap++ )
-      {  //Get a byte of the bit map field when needed
-         if ( bitInBitmap % CHAR_BIT == 0)
+   {  // Find each range of 0 bits in the bit field.  Stop scanning when maxReportPckts IDs are stored
+      retVal = loadBitField();            // Only reads NV if the RAM copy is not valid
+      if ( eSUCCESS == retVal )
+      {
+         uint16_t pktIndex   = 0;         // Index in pMissingPcktIds.
+         uint16_t rangeStart = 0;         // First missing packet of a range
+         uint16_t rangeEnd   = 0;         // First received packet after the range
+
+         while ( pktIndex < maxReportPckts )
          {
-            /*lint -e(776) Only read the curent byte needed. */
-            retVal = PAR_partitionFptr.parRead(&mapData, (dSize)offset, (lCnt)1, pDFWBitfieldPTbl_);
-            if (eSUCCESS != retVal)
+            rangeStart = findBit(rangeEnd, totPckts, (bool)false);
+            if ( rangeStart >= totPckts )
             {
-               break;   //Exit loop and function if unable to read data
-            }
-            offset++;
-         }
-         // Check if we have a missing packet at offset bitInBitmap
-         if ( 0 == (mapData & (1 << (bitInBitmap % CHAR_BIT))) )
-         {  // A missing packet has been found!
-            if (pktIndex < maxReportPckts)   // Have the maximum number of missing packets been reported?
-            {  // Number of missing packets reported hasn't exceeded the requested maximum.
-               if (0 == pktIndex)  /* Have to save the first one to get started */
-               {
-                  pMissingPcktIds[pktIndex++] = bitInBitmap;
-                  nextID                      = bitInBitmap + 1;
-               }
-               else
-               {
-                  /*lint -e(644) Variable is initialized when pktIndex is 0 */
-                  if (nextID == bitInBitmap)
-                  {
-                     nextID      = bitInBitmap + 1;
-                     consecutive = true; // indicate that we have found a range of missing packets
-
-                     // Special case if it is the last packet...
-                     if ( (totPckts - 1) <= bitInBitmap )
-                     {  // Make it negative to indicate it is the last consecutive packet of a range
-                        /*lint -e{734} Loss of precision acceptable as long as Max Packet Count < INT16_MAX */
-                        pMissingPcktIds[pktIndex++] = -1 * bitInBitmap;
-                     }
-                  }
-                  else // It is not a consecutive ID
-                  {
-                     // Put the next non-consecutive missing packet id in the buffer
-                     pMissingPcktIds[pktIndex++] = bitInBitmap;
-                     nextID                      = bitInBitmap + 1;
-                     consecutive                 = false;
-                  }
-               }
-            }  //end of else to if (0 == pktIndex)
-            else
-            {  // No more room to add packet ID's, break out of loop to exit function
-               break;
+               break;                     // No more missing packets
             }
-         }  //end of if (pktIndex < maxReportPckts)
-         else
-         {  // packet is not missing
-
-            // check to see if a consectutive range has ended, if so add range end to packet ID list
-            if( true == consecutive )
-            {
-               pMissingPcktIds[pktIndex++] = (dl_packetid_t)(-1 * (nextID - 1));
-               consecutive = false;
+            rangeEnd = findBit(rangeStart + 1, totPckts, (bool)true);
+            pMissingPcktIds[pktIndex++] = (dl_packetid_t)rangeStart;
+            if ( ( (rangeEnd - rangeStart) > 1 ) && (pktIndex < maxReportPckts) )
+            {  // Make the last ID negative to indicate it is the last consecutive packet of a range
+               /*lint -e{734} Loss of precision acceptable as long as Max Packet Count < INT16_MAX */
+               pMissingPcktIds[pktIndex++] = (dl_packetid_t)(-1 * (int32_t)(rangeEnd - 1));
             }
          }
-      }  //end of for ( bitInBitmap = 0; ...
-      *pNumMissingPckts = pktIndex;
+         *pNumMissingPckts = pktIndex;
+      }
    }  //end of if ( (totPckts <= DFWP_PCKT_CNT_SIZE_BITS) && ...
    return(retVal);
 }
@@ -463,7 +437,8 @@ returnStatus_t DFWP_getMissingPacketsRange(dl_packetcnt_t  totPckts,         dl_
  *
  * Function name: DFWP_modifyBit
  *
- * Purpose: Sets or clears a bit in the NV memory bit array that corresponds to the packetNumber passed in.
+ * Purpose: Sets or clears a bit in the NV memory bit array (and its RAM copy) that corresponds to the packetNumber
+ *          passed in.
  *
  * Arguments:  uint16_t                  packetNumber - Packet number in the sequence 0-16383
  *             eDFWP_BitFieldModify_t  action       - Set or clear bit
@@ -483,29 +458,312 @@ returnStatus_t DFWP_modifyBit( uint16_t packetNumber, eDFWP_BitFieldModify_t act
 
    if ( packetNumber < DFWP_PCKT_CNT_SIZE_BITS )   // Check for valid size, Is the packet number in the bit field?
    {  // Yes - Compute offset and mask
-      uint8_t          Byte;                         // Byte that will be modified
-      uint8_t          BitMask;                      // Bit mask to set or clear a bit
+      uint32_t         Word;                         // Word that will be modified
+      uint32_t         BitMask;                      // Bit mask to set or clear a bit
+      uint16_t         WordOffset;                   // Word offset in the bitfield
       uint16_t         ByteOffset;                   // Byte offset in the bitfield
+      uint8_t          Byte;                         // NV byte containing the bit
 
-      ByteOffset = packetNumber / CHAR_BIT;        // There are 8 bits/byte
-      BitMask    = 1 << (packetNumber % CHAR_BIT); // Get the mask for the requested packet number within the byte.
-      // Read byte from bit field containing requested packet's bit
-      RetVal = PAR_partitionFptr.parRead(&Byte, (dSize)ByteOffset, (lCnt)sizeof(Byte), pDFWBitfieldPTbl_);
+      RetVal = loadBitField();                     // Only reads NV if the RAM copy is not valid
       if ( eSUCCESS == RetVal )
-      {  // Set bit or clear bit
+      {
+         WordOffset = packetNumber / DFWP_WORD_BITS;
+         BitMask    = (uint32_t)1 << (packetNumber % DFWP_WORD_BITS); // Mask for the packet number within the word
+         Word       = bitField_[WordOffset];
          if ( eDL_BIT_SET == action )              // Set the bit?
          {
-            Byte |= BitMask;                       // Set bit
+            Word |= BitMask;                       // Set bit
          }
          else
          {
-            Byte &= ~BitMask;                      // Clear bit
+            Word &= ~BitMask;                      // Clear bit
+         }
+         if ( Word != bitField_[WordOffset] )      // No NV write if the bit already has the requested value
+         {  // Update the bit field in NV first, then the RAM copy
+            ByteOffset = packetNumber / CHAR_BIT;  // There are 8 bits/byte
+            Byte       = (uint8_t)(Word >> ((ByteOffset % sizeof(Word)) * CHAR_BIT));
+            RetVal = PAR_partitionFptr.parWrite((dSize)ByteOffset, &Byte, (lCnt)sizeof(Byte), pDFWBitfieldPTbl_);
+            if ( eSUCCESS == RetVal )
+            {
+               bitField_[WordOffset] = Word;
+               if ( packetNumber < countLimit_ )   // Keep the received packet count up to date
+               {
+                  if ( eDL_BIT_SET == action )
+                  {
+                     countSet_++;
+                  }
+                  else
+                  {
+                     countSet_--;
+                  }
+               }
+            }
+            else
+            {  // NV may or may not have been updated, get it again the next time
+               bitFieldValid_ = false;
+            }
          }
-         // Update bit field
-         RetVal = PAR_partitionFptr.parWrite((dSize)ByteOffset, &Byte, (lCnt)sizeof(Byte), pDFWBitfieldPTbl_);
       }
    }
    return(RetVal);
 }
 /* ****************************************************************************************************************** */
 // </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="static returnStatus_t loadBitField(void)">
+/***********************************************************************************************************************
+ *
+ * Function name: loadBitField
+ *
+ * Purpose: Reads the NV bit field into RAM, unless the RAM copy is already valid.
+ *
+ * Arguments: None
+ *
+ * Returns: returnStatus_t - defined by error_codes.h
+ *
+ * Side effect: The received packet count restarts with the next missing packet count request.
+ *
+ * Reentrant Code: No
+ *
+ * Notes:
+ *
+ **********************************************************************************************************************/
+static returnStatus_t loadBitField( void )
+{
+   returnStatus_t retVal = eSUCCESS;
+
+   if ( !bitFieldValid_ )
+   {
+      retVal = PAR_partitionFptr.parRead((uint8_t *)&bitField_[0], (dSize)0, (lCnt)sizeof(bitField_), pDFWBitfieldPTbl_);
+      if ( eSUCCESS == retVal )
+      {
+         bitFieldValid_ = true;
+         countLimit_    = 0;     // No packets below 0, so the count is 0.
+         countSet_      = 0;
+      }
+   }
+   return(retVal);
+}
+/* ****************************************************************************************************************** */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="static uint16_t countSetBits(uint16_t limit)">
+/***********************************************************************************************************************
+ *
+ * Function name: countSetBits
+ *
+ * Purpose: Counts the bits set in the RAM copy of the bit field below a packet number.
+ *
+ * Arguments: uint16_t limit - Count the bits for packets 0 to limit - 1 (limit <= DFWP_PCKT_CNT_SIZE_BITS)
+ *
+ * Returns: uint16_t - Number of bits set
+ *
+ * Side effect: None
+ *
+ * Reentrant Code: Yes
+ *
+ * Notes:  The Cortex-M has no population count instruction, the bits of each word are added in parallel.
+ *
+ **********************************************************************************************************************/
+static uint16_t countSetBits( uint16_t limit )
+{
+   uint16_t count = 0;
+   uint16_t word;
+   uint32_t bits;
+
+   for ( word = 0; word < ((limit + DFWP_WORD_BITS - 1) / DFWP_WORD_BITS); word++ )
+   {
+      bits = bitField_[word];
+      if ( ((word + 1) * DFWP_WORD_BITS) > limit )
+      {  // Last word is partial
+         bits &= DFWP_BITS_BELOW(limit % DFWP_WORD_BITS);
+      }
+      bits = bits - ((bits >> 1) & 0x55555555UL);                       // 2 bit sums
+      bits = (bits & 0x33333333UL) + ((bits >> 2) & 0x33333333UL);      // 4 bit sums
+      bits = (bits + (bits >> 4)) & 0x0F0F0F0FUL;                       // 8 bit sums
+      count += (uint16_t)((uint32_t)(bits * 0x01010101UL) >> 24);       // Sum of the bytes
+   }
+   return(count);
+}
+/* ****************************************************************************************************************** */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="static uint16_t findBit(uint16_t from, uint16_t limit, bool bSet)">
+/***********************************************************************************************************************
+ *
+ * Function name: findBit
+ *
+ * Purpose: Finds the first bit with the requested value in the RAM copy of the bit field.
+ *
+ * Arguments: uint16_t from  - First packet number to look at
+ *            uint16_t limit - Look at packets below limit (limit <= DFWP_PCKT_CNT_SIZE_BITS)
+ *            bool     bSet  - true to find a bit set (received packet), false to find a bit cleared (missing packet)
+ *
+ * Returns: uint16_t - Packet number of the bit found, limit if none
+ *
+ * Side effect: None
+ *
+ * Reentrant Code: Yes
+ *
+ * Notes:  Words without the requested value are skipped with a single compare.
+ *
+ **********************************************************************************************************************/
+static uint16_t findBit( uint16_t from, uint16_t limit, bool bSet )
+{
+   uint16_t found = limit;
+   uint16_t word;
+   uint32_t bits;
+   uint32_t invert = bSet ? 0 : 0xFFFFFFFFUL;   // Turns the bits looked for into 1s
+
+   if ( from < limit )
+   {
+      word = from / DFWP_WORD_BITS;
+      bits = (bitField_[word] ^ invert) & ~DFWP_BITS_BELOW(from % DFWP_WORD_BITS);  // Ignore the bits below from
+      while ( (0 == bits) && (++word < ((limit + DFWP_WORD_BITS - 1) / DFWP_WORD_BITS)) )
+      {
+         bits = bitField_[word] ^ invert;
+      }
+      if ( 0 != bits )
+      {
+         found = (uint16_t)(word * DFWP_WORD_BITS) + DFWP_LOWEST_BIT(bits);
+         if ( found > limit )
+         {  // Found in the partial last word, past the limit
+            found = limit;
+         }
+      }
+   }
+   return(found);
+}
+/* ****************************************************************************************************************** */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="static uint16_t missingCount(uint16_t totPckts)">
+/***********************************************************************************************************************
+ *
+ * Function name: missingCount
+ *
+ * Purpose: Returns the number of missing packets out of totPckts.
+ *
+ * Arguments: uint16_t totPckts - Total Packets in bit field (totPckts <= DFWP_PCKT_CNT_SIZE_BITS)
+ *
+ * Returns: uint16_t - Number of bits cleared below totPckts
+ *
+ * Side effect: The received packet count is kept for totPckts from now on.
+ *
+ * Reentrant Code: No
+ *
+ * Notes:  The bits are only counted when totPckts changes (once per download), DFWP_modifyBit keeps the count.
+ *
+ **********************************************************************************************************************/
+static uint16_t missingCount( uint16_t totPckts )
+{
+   if ( totPckts != countLimit_ )
+   {
+      countSet_   = countSetBits(totPckts);
+      countLimit_ = totPckts;
+   }
+   return(totPckts - countSet_);
+}
+/* ****************************************************************************************************************** */
+// </editor-fold>
+
+#ifdef TM_DFWP_UNIT_TEST
+// <editor-fold defaultstate="collapsed" desc="void DFWP_unitTest(void)">
+/***********************************************************************************************************************
+ *
+ * Function name: DFWP_unitTest
+ *
+ * Purpose: Checks the RAM copy and the word wide scans against a bit by bit scan of the NV bit field, and times both.
+ *
+ * Arguments: None
+ *
+ * Returns: None
+ *
+ * Side effect: None, the bit field is only read.
+ *
+ * Reentrant Code: No
+ *
+ * Notes:  Uses the bit field of the current (or last) download.  Results are printed.
+ *
+ **********************************************************************************************************************/
+void DFWP_unitTest( void )
+{
+   static dl_packetid_t refIds[256];               // Missing packets found by the bit by bit NV scan
+   static dl_packetid_t missingIds[256];           // Missing packets reported by the module
+   uint32_t       errors = 0;
+   uint32_t       startMs;
+   uint32_t       nvMs;
+   uint16_t       totPckts;
+   uint16_t       bit;
+   uint16_t       idx;
+   uint16_t       nvMissing;
+   dl_packetcnt_t missing;
+   dl_packetid_t  id;
+   uint8_t        nvByte = 0;
+
+   bitFieldValid_ = false;                         // Start from NV
+   for ( totPckts = DFWP_PCKT_CNT_SIZE_BITS; totPckts > 0; totPckts /= 3 )
+   {  // Reference: one NV read per byte, bit by bit
+      nvMissing = 0;
+      startMs = OS_TICK_Get_ElapsedMilliseconds();
+      for ( bit = 0; bit < totPckts; bit++ )
+      {
+         if ( 0 == (bit % CHAR_BIT) )
+         {
+            (void)PAR_partitionFptr.parRead(&nvByte, (dSize)(bit / CHAR_BIT), (lCnt)1, pDFWBitfieldPTbl_);
+         }
+         if ( 0 == (nvByte & (1 << (bit % CHAR_BIT))) )
+         {
+            if ( nvMissing < ARRAY_IDX_CNT(refIds) )
+            {
+               refIds[nvMissing] = (dl_packetid_t)bit;
+            }
+            nvMissing++;
+         }
+      }
+      nvMs = OS_TICK_Get_ElapsedMilliseconds() - startMs;
+
+      startMs = OS_TICK_Get_ElapsedMilliseconds();
+      (void)DFWP_getMissingPackets(totPckts, (dl_packetcnt_t)ARRAY_IDX_CNT(missingIds), &missing, missingIds);
+      if ( missing != nvMissing )
+      {
+         errors++;
+      }
+      for ( idx = 0; (idx < nvMissing) && (idx < ARRAY_IDX_CNT(refIds)); idx++ )
+      {
+         if ( missingIds[idx] != refIds[idx] )
+         {
+            errors++;
+         }
+      }
+      (void)DFWP_getMissingPacketsRange(totPckts, (dl_packetcnt_t)ARRAY_IDX_CNT(missingIds), &missing, missingIds);
+      DBG_logPrintf( 'U', "DFWP %u packets, %u missing: NV bit scan %lu ms, RAM word scans %lu ms",
+                     totPckts, nvMissing, nvMs, OS_TICK_Get_ElapsedMilliseconds() - startMs );
+
+      /* Expand the ranges, they must list the same packets as the bit by bit scan */
+      bit = 0;
+      for ( idx = 0; idx < missing; idx++ )
+      {
+         if ( missingIds[idx] >= 0 )
+         {
+            id = missingIds[idx];
+         }
+         else
+         {  // End of a range started by the previous ID
+            id = missingIds[idx - 1] + 1;
+         }
+         do
+         {
+            if ( (bit < ARRAY_IDX_CNT(refIds)) && (refIds[bit] != id) )
+            {
+               errors++;
+            }
+            bit++;
+         } while ( (missingIds[idx] < 0) && (id++ < -missingIds[idx]) );
+      }
+   }
+   DBG_logPrintf( 'U', "DFWP errors: %lu", errors );
+}
+/* ****************************************************************************************************************** */
+// </editor-fold>
+#endif
@@ -79,6 +79,7 @@ returnStatus_t  DFWP_getMissingPackets(dl_packetcnt_t totPckts, dl_packetcnt_t m
                                        dl_packetcnt_t *pNumMissingPckts, dl_packetid_t *pMissingPcktIds);
 returnStatus_t  DFWP_getMissingPacketsRange(dl_packetcnt_t totPckts, dl_packetcnt_t maxReportPckts,
                                             dl_packetcnt_t *pNumMissingPckts, dl_packetid_t *pMissingPcktIds);
+void            DFWP_unitTest(void);
 
 #undef DFWP_EXTERN
 
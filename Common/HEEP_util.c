@@ -232,7 +232,6 @@ static const OR_PM_HandlersDef OR_PM_Handlers[] =
   { PHY_OR_PM_Handler,         phyFramesReceivedCount },
   { PHY_OR_PM_Handler,         phyFramesTransmittedCount },
   { PHY_OR_PM_Handler,         phyFailedHeaderDecodeCount },
-  { PHY_OR_PM_Handler,         phySyncDetectCount },
   { PHY_OR_PM_Handler,         phyDemodulator },
   { PHY_OR_PM_Handler,         phyMaxTxPayload },
 #if ( (DCU == 1) && (VSWR_MEASUREMENT == 1) )
@@ -530,6 +529,10 @@ static const OR_PM_HandlersDef OR_PM_Handlers[] =
   { NULL , invalidReadingType }
 };
 
+#define OR_PM_HANDLER_CNT  ( ARRAY_IDX_CNT( OR_PM_Handlers ) - 1 )   /* Entries in OR_PM_Handlers, less the terminator */
+
+static uint16_t OR_PM_Index_[ OR_PM_HANDLER_CNT ]; /* Indices into OR_PM_Handlers sorted by reading type, see HEEP_util_init */
+
 //lint -e750    Lint is complaining about macro not referenced
 #define HEEP_COMMON_CALLS APP_MSG_SecurityHandler \
                      ,DFWA_OR_PM_Handler \
@@ -779,6 +782,8 @@ static const TRMTupple_u TRM[]=
 static void ReadingQty_Inc(struct readings_s *p);
 static void ReadingHeader_Set(struct   readings_s *p,ReadingsValueTypecast Type,uint16_t  Size,meterReadingType ReadingType );
 static uint8_t getMinSize(uint8_t const *pData, uint8_t size);
+static void OR_PM_BuildIndex( void );
+static OR_PM_HandlersDef const *OR_PM_FindHandler( meterReadingType rType );
 
 
 
@@ -831,6 +836,7 @@ returnStatus_t HEEP_MSG_Tx ( HEEP_APPHDR_t const *heepMsgInfo, buffer_t const *p
          NWK_Override_t override = { eNWK_LINK_OVERRIDE_NULL, eNWK_LINK_SETTINGS_OVERRIDE_NULL };
          buffer_t      *pBuf;
          uint16_t       opportunisticAlarmSize = 0;
+         bool           inPlace = (bool)true;   //Message is built directly in the NWK data request buffer
          if ( (   ( heepMsgInfo->Resource    == (uint8_t)bu_lp )
                || ( heepMsgInfo->Resource    == (uint8_t)bu_ds )
                || ( heepMsgInfo->Resource    == (uint8_t)bu_en )
@@ -843,8 +849,22 @@ returnStatus_t HEEP_MSG_Tx ( HEEP_APPHDR_t const *heepMsgInfo, buffer_t const *p
          {  //Max number of bytes needed for opportunistic alarms
             opportunisticAlarmSize = ( uint16_t )min((APP_MSG_MAX_DATA - payloadBuf->x.dataLen), MAX_ALARM_MEMORY);
          }
-         // Allocate a temporary buffer to build the payload
-         pBuf = BM_allocStack( payloadBuf->x.dataLen + HEEP_APP_HEADER_SIZE + opportunisticAlarmSize);
+#if (USE_DTLS == 1)
+#if ( DTLS_FIELD_TRIAL == 0 )
+         inPlace = ( heepMsgInfo->appSecurityAuthMode == 0 );
+#else
+         /* Allow unsecured communications until DTLS session established */
+         inPlace = ( heepMsgInfo->appSecurityAuthMode == 0 ) || ( !DTLS_IsSessionEstablished() );
+#endif
+#endif
+         if ( inPlace )
+         {  // Unsecured: build the message where the NWK layer expects it so it isn't copied again
+            pBuf = NWK_DataRequestAlloc( payloadBuf->x.dataLen + HEEP_APP_HEADER_SIZE + opportunisticAlarmSize );
+         }
+         else
+         {  // Allocate a temporary buffer to build the payload, DTLS encrypts it into its own buffer
+            pBuf = BM_allocStack( payloadBuf->x.dataLen + HEEP_APP_HEADER_SIZE + opportunisticAlarmSize );
+         }
          if( pBuf != NULL )
          {
             uint8_t       *data = ( uint8_t* )pBuf->data;
@@ -936,24 +956,20 @@ returnStatus_t HEEP_MSG_Tx ( HEEP_APPHDR_t const *heepMsgInfo, buffer_t const *p
                }
             }
 
-#if (USE_DTLS == 1)
-#if ( DTLS_FIELD_TRIAL == 0 )
-            if ( heepMsgInfo->appSecurityAuthMode == 0 )
-#else
-            /* Allow unsecured communications until DTLS session established */
-            if (  ( heepMsgInfo->appSecurityAuthMode == 0 ) ||
-                  ( !DTLS_IsSessionEstablished() ) )
-#endif
-#endif
+            if ( inPlace )
             {
-               ( void )NWK_DataRequest(  0,
-                                         heepMsgInfo->qos,
-                                         payloadBuf->x.dataLen + alarmBytes + HEEP_APP_HEADER_SIZE,
-                                         data,
-                                         &dst_address,
-                                         &override,
-                                         heepMsgInfo->callback,
-                                         NULL );
+#if (TM_HEEP_UNIT_TEST != 0)
+               INFO_printHex( "Sent: ", data, payloadBuf->x.dataLen + alarmBytes + HEEP_APP_HEADER_SIZE );
+#endif
+               pBuf->x.dataLen = payloadBuf->x.dataLen + alarmBytes + HEEP_APP_HEADER_SIZE;
+               ( void )NWK_DataRequestSend(  pBuf,
+                                             0,
+                                             heepMsgInfo->qos,
+                                             &dst_address,
+                                             &override,
+                                             heepMsgInfo->callback,
+                                             NULL );
+               pBuf = NULL;   // Owned by the NWK layer now
 
                sent = (bool)true;
                RetVal = eSUCCESS;
@@ -995,10 +1011,13 @@ returnStatus_t HEEP_MSG_Tx ( HEEP_APPHDR_t const *heepMsgInfo, buffer_t const *p
             }
 
 #if (TM_HEEP_UNIT_TEST != 0)
-            INFO_printHex( sent ? "Sent: " : "Not sent: " ,
-                           data, payloadBuf->x.dataLen + alarmBytes + HEEP_APP_HEADER_SIZE );
+            if ( pBuf != NULL )
+            {
+               INFO_printHex( sent ? "Sent: " : "Not sent: " ,
+                              data, payloadBuf->x.dataLen + alarmBytes + HEEP_APP_HEADER_SIZE );
+            }
 #endif
-            // free the temp buffer
+            // free the temp buffer (BM_free ignores NULL)
             BM_free( pBuf );
          }
          BM_free( ( buffer_t * )payloadBuf ); //Free the app buffer
@@ -1416,6 +1435,117 @@ void HEEP_initHeader( HEEP_APPHDR_t *hdr )
    hdr->appSecurityAuthMode = securityMode;
 }
 
+/***********************************************************************************************************************
+
+   Function name: HEEP_util_init
+
+   Purpose: Builds the OR_PM handler index used to look up a reading type.  Called once at power up, before the
+            application messages are handled.
+
+   Arguments: None
+
+   Returns: returnStatus_t - eSUCCESS
+
+   Side Effects: None
+
+   Reentrant Code: No
+
+ **********************************************************************************************************************/
+returnStatus_t HEEP_util_init( void )
+{
+   OR_PM_BuildIndex();
+   return eSUCCESS;
+}
+
+/***********************************************************************************************************************
+
+   Function name: OR_PM_BuildIndex
+
+   Purpose: Sorts the indices of the OR_PM_Handlers entries by reading type so a handler can be found with a binary
+            search instead of a scan of the whole table.  The sort is stable, so when a reading type appears more than
+            once the first entry in the table still wins, as it did with the scan.  The table is also checked: a NULL
+            handler before the terminator or a duplicated reading type is reported on the debug port.
+
+   Arguments: None
+
+   Returns: None
+
+   Side Effects: OR_PM_Index_ is built
+
+   Reentrant Code: No
+
+ **********************************************************************************************************************/
+static void OR_PM_BuildIndex( void )
+{
+   uint16_t i;
+   uint16_t j;
+   uint16_t idx;
+
+   for ( i = 0; i < OR_PM_HANDLER_CNT; i++ )
+   {
+      if ( NULL == OR_PM_Handlers[i].pHandler )
+      {
+         DBG_logPrintf( 'E', "OR_PM handler table entry %u has no handler", i );
+      }
+      /* Insertion sort, the table is only sorted once */
+      idx = i;
+      for ( j = i; ( j > 0 ) && ( OR_PM_Handlers[ OR_PM_Index_[ j - 1 ] ].rType > OR_PM_Handlers[ idx ].rType ); j-- )
+      {
+         OR_PM_Index_[ j ] = OR_PM_Index_[ j - 1 ];
+      }
+      OR_PM_Index_[ j ] = idx;
+   }
+   for ( i = 1; i < OR_PM_HANDLER_CNT; i++ )
+   {
+      if ( OR_PM_Handlers[ OR_PM_Index_[ i ] ].rType == OR_PM_Handlers[ OR_PM_Index_[ i - 1 ] ].rType )
+      {
+         DBG_logPrintf( 'E', "OR_PM reading type %u has more than one handler", (uint16_t)OR_PM_Handlers[ OR_PM_Index_[ i ] ].rType );
+      }
+   }
+}
+
+/***********************************************************************************************************************
+
+   Function name: OR_PM_FindHandler
+
+   Purpose: Finds the OR_PM_Handlers entry for a reading type.
+
+   Arguments: meterReadingType rType - Reading type requested
+
+   Returns: OR_PM_HandlersDef const * - Handler entry, NULL if the reading type isn't supported
+
+   Side Effects: None
+
+   Reentrant Code: Yes
+
+ **********************************************************************************************************************/
+static OR_PM_HandlersDef const *OR_PM_FindHandler( meterReadingType rType )
+{
+   OR_PM_HandlersDef const *pHandler = NULL;
+   uint16_t                 lo = 0;
+   uint16_t                 hi = OR_PM_HANDLER_CNT;
+   uint16_t                 mid;
+
+   while ( lo < hi )  /* Find the first entry that is not less than rType */
+   {
+      mid = lo + ( ( hi - lo ) / 2 );
+      if ( OR_PM_Handlers[ OR_PM_Index_[ mid ] ].rType < rType )
+      {
+         lo = mid + 1;
+      }
+      else
+      {
+         hi = mid;
+      }
+   }
+   if ( ( lo < OR_PM_HANDLER_CNT ) && ( OR_PM_Handlers[ OR_PM_Index_[ lo ] ].rType == rType ) &&
+        ( NULL != OR_PM_Handlers[ OR_PM_Index_[ lo ] ].pHandler ) )
+   {
+      pHandler = &OR_PM_Handlers[ OR_PM_Index_[ lo ] ];
+   }
+   return pHandler;
+}
+
 /*******************************************************************************
 
    Function name: OR_PM_MsgHandler
@@ -1437,7 +1567,7 @@ void OR_PM_MsgHandler(HEEP_APPHDR_t *heepReqHdr, void *payloadBuf, uint16_t leng
 {
    (void)length;
    HEEP_APPHDR_t      heepRespHdr;  // Application header/QOS info
-   OR_PM_HandlersDef *pHandlers;    //Used to search for id
+   OR_PM_HandlersDef const *pHandlers; //Handler for the reading type
    OR_PM_Attr_t       OR_PM_Attr_s; //Info of the return string
    buffer_t          *lBuf;         // pointer to value
 
@@ -1559,11 +1689,10 @@ void OR_PM_MsgHandler(HEEP_APPHDR_t *heepReqHdr, void *payloadBuf, uint16_t leng
                   bytesLeft   -= READING_TYPE_SIZE;
                   (void)memset(lBuf->data, 0, MAX_OR_PM_PAYLOAD_SIZE); // initialize the destination buffer
 
-                  for( pHandlers = (OR_PM_HandlersDef *)OR_PM_Handlers; pHandlers->pHandler != NULL;  pHandlers++ )
-                  {
-                     if (pHandlers->rType == readingType)
-                     {  //found handler
-                        foundHandler = true;
+                  pHandlers = OR_PM_FindHandler( readingType );
+                  if ( NULL != pHandlers )
+                  {  //found handler
+                     foundHandler = true;
 _Pragma ( "calls = \
                         HEEP_COMMON_CALLS \
                         HEEP_DCU_CALLS \
@@ -1577,16 +1706,14 @@ _Pragma ( "calls = \
                         HEEP_DA_CALLS \
                         HEEP_BOOTLOADER_CALLS \
                         " )
-                        retVal = (* pHandlers->pHandler )( method_get, readingType, lBuf->data, &OR_PM_Attr_s );
-                        if (retVal == eSUCCESS )
+                     retVal = (* pHandlers->pHandler )( method_get, readingType, lBuf->data, &OR_PM_Attr_s );
+                     if (retVal == eSUCCESS )
+                     {
+                        if( (OR_PM_Attr_s.rValLen != 0) || (OR_PM_Attr_s.rValTypecast == (uint8_t)ASCIIStringValue)
+                           || (OR_PM_Attr_s.rValTypecast == (uint8_t)hexBinary))
                         {
-                           if( (OR_PM_Attr_s.rValLen != 0) || (OR_PM_Attr_s.rValTypecast == (uint8_t)ASCIIStringValue)
-                              || (OR_PM_Attr_s.rValTypecast == (uint8_t)hexBinary))
-                           {
-                              eventCount_flags = 0; //flags, all zero for now
-                           }
+                           eventCount_flags = 0; //flags, all zero for now
                         }
-                        break;
                      }
                   }
 
@@ -1868,11 +1995,10 @@ _Pragma ( "calls = \
                      }
                   }
 
-                  for( pHandlers = (OR_PM_HandlersDef *)OR_PM_Handlers; pHandlers->pHandler != NULL;  pHandlers++ )
-                  {
-                     if (pHandlers->rType == readingType)
-                     {  //found handler
-                        foundHandler = true;
+                  pHandlers = OR_PM_FindHandler( readingType );
+                  if ( NULL != pHandlers )
+                  {  //found handler
+                     foundHandler = true;
 _Pragma ( "calls = \
                         HEEP_COMMON_CALLS \
                         HEEP_DCU_CALLS \
@@ -1885,9 +2011,7 @@ _Pragma ( "calls = \
                         HEEP_DA_CALLS \
                         HEEP_BOOTLOADER_CALLS \
                         " )
-                        retVal = (* pHandlers->pHandler )( method_put, readingType, lBuf->data, &OR_PM_Attr_s );  //TODO: Oct 22 2018 SMG, Most of the handlers are not qualifying the typecast
-                        break;
-                     }
+                     retVal = (* pHandlers->pHandler )( method_put, readingType, lBuf->data, &OR_PM_Attr_s );  //TODO: Oct 22 2018 SMG, Most of the handlers are not qualifying the typecast
                   }
 
                   bits  += (OR_PM_Attr_s.rValLen * 8); //lint !e734 Max bits allowed in pack routine is less than uint16
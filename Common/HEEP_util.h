@@ -119,6 +119,7 @@ HEEP_UTIL_GLOBALS uint16_t HEEP_GetNextReadingInfo(void *payloadBuf, uint16_t *b
 HEEP_UTIL_GLOBALS uint8_t HEEP_getPowerOf10Code(uint8_t ch, int64_t *val);
 HEEP_UTIL_GLOBALS uint8_t HEEP_getMinByteNeeded( int64_t val, ReadingsValueTypecast typecast, uint16_t valueSizeInBytes );
 HEEP_UTIL_GLOBALS void    HEEP_initHeader(HEEP_APPHDR_t *hdr);
+HEEP_UTIL_GLOBALS returnStatus_t HEEP_util_init( void );
 HEEP_UTIL_GLOBALS void OR_PM_MsgHandler(HEEP_APPHDR_t *heepReqHdr, void *payloadBuf, uint16_t length);
 HEEP_UTIL_GLOBALS returnStatus_t HEEP_util_OR_PM_Handler( enum_MessageMethod action, meterReadingType id, void *value, OR_PM_Attr_t *attr );
 returnStatus_t NWK_OR_PM_Handler( enum_MessageMethod action, meterReadingType id, void *value, OR_PM_Attr_t *attr );
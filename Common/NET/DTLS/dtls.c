@@ -427,7 +427,7 @@ static void             DtlsDisconnectSerial( void );
 static void             DtlsDisconnectRf( bool quietShutdown );
 static bool             DtlsTransportRx( buffer_t *pBuf );
 static void             DtlsApplicationTx( const buffer_t *pBuf );
-static void             DtlsApplicationRx( buffer_t *pBuf, buffer_t *decryptedStackBuffer );
+static void             DtlsApplicationRx( buffer_t *pBuf, uint16_t plainLen );
 static int32_t          DtlsTransportTx( const char *pBuf, uint32_t size );
 static void             DtlsSessionStateChange( DtlsSessionState_e sessionState );
 static void             DtlsSessionStateChangedCallback( DtlsSessionState_e sessionState );
@@ -1543,10 +1543,11 @@ static WOLFSSL *DtlsCreateSession( WOLFSSL_CTX *context, int32_t timeoutInit, in
 
    Reentrant Code: No
 
-   Notes:
+   Notes: This is the only copy of the record on receive. WolfSSL decrypts from its own input buffer, so the plaintext
+          is written back over the received record (see DtlsTransportRx).
 
  ******************************************************************************************************************** */
-static int32_t GetTransportRxBuffer( char *buf )
+static int32_t GetTransportRxBuffer( char *buf, int32_t sz )
 {
    DTLS_INFO( "GetTransportRxBuffer" );
 
@@ -1555,14 +1556,25 @@ static int32_t GetTransportRxBuffer( char *buf )
    {
       if ( _dtlsTransport == DTLS_TRANSPORT_SERIAL_e )
       {
-         ( void )memcpy( buf, ( char * )_dtlsTransportRxBuffer->data, _dtlsTransportRxBuffer->x.dataLen );
          totalBytes = _dtlsTransportRxBuffer->x.dataLen;
+         if ( totalBytes <= sz )
+         {
+            ( void )memcpy( buf, ( char * )_dtlsTransportRxBuffer->data, ( uint32_t )totalBytes );
+         }
       }
       else if ( _dtlsTransport == DTLS_TRANSPORT_RF_e )
       {
-         NWK_DataInd_t* dataIndication = ( NWK_DataInd_t* )( void * )_dtlsTransportRxBuffer->data;
-         ( void )memcpy( buf, ( char * )dataIndication->payload, dataIndication->payloadLength );
+         NWK_DataInd_t const *dataIndication = ( NWK_DataInd_t const * )( void const * )_dtlsTransportRxBuffer->data;
          totalBytes = dataIndication->payloadLength;
+         if ( totalBytes <= sz )
+         {
+            ( void )memcpy( buf, ( char * )dataIndication->payload, ( uint32_t )totalBytes );
+         }
+      }
+      if ( totalBytes > sz )
+      {
+         DTLS_ERROR( "GetTransportRxBuffer record %d larger than %d, dropped", totalBytes, sz );
+         totalBytes = 0;
       }
    }
    _dtlsTransportRxBuffer = NULL;
@@ -1586,7 +1598,7 @@ static int32_t GetTransportRxBuffer( char *buf )
  **********************************************************************************************************************/
 static int32_t DtlsRcvCallback( WOLFSSL *ssl, char *buf, int32_t sz, void *ctx )
 {
-   int32_t  totalBytes = GetTransportRxBuffer( buf );                   /* Bytes in the message */
+   int32_t  totalBytes = GetTransportRxBuffer( buf, sz );               /* Bytes in the message */
 
    INFO_printf( "DtlsRcvCallback sz = %d totalBytes = %d", sz, totalBytes );
 
@@ -4099,79 +4111,84 @@ static bool DtlsTransportRx( buffer_t *pBuf )
    {
       if ( pBuf )
       {
-         buffer_t *decryptedStackBuffer = BM_allocStack( pBuf->x.dataLen );
+         uint8_t  *plain;     /* The plaintext is decrypted over the received record, which is always larger */
+         uint16_t plainMax;
 
-         if ( decryptedStackBuffer != NULL )
+         if ( _dtlsTransport == DTLS_TRANSPORT_RF_e )
          {
-            ( void )memset( decryptedStackBuffer->data, 0, decryptedStackBuffer->x.dataLen );
+            NWK_DataInd_t const *dataIndication = ( NWK_DataInd_t const * )( void * )pBuf->data;
 
-            ret = wolfSSL_read( _dtlsSsl, decryptedStackBuffer->data, ( int32_t )decryptedStackBuffer->x.dataLen );
+            plain    = dataIndication->payload;
+            plainMax = dataIndication->payloadLength;
+         }
+         else
+         {
+            plain    = pBuf->data;
+            plainMax = pBuf->x.dataLen;
+         }
+
+         ret = wolfSSL_read( _dtlsSsl, plain, ( int32_t )plainMax );
 
 #if ( DTLS_DEBUG == 1 )
-            DBG_logPrintHex( 'I', "from wolfSSL_read: ", decryptedStackBuffer->data, decryptedStackBuffer->x.dataLen );
+         if ( ret > 0 )
+         {
+            DBG_logPrintHex( 'I', "from wolfSSL_read: ", plain, ( uint16_t )ret );
+         }
 #endif
-            if ( ret > 0 )
+         if ( ret > 0 )
+         {
+            DtlsApplicationRx( pBuf, ( uint16_t )ret );
+            if ( _dtlsTransport == DTLS_TRANSPORT_RF_e )
             {
-               decryptedStackBuffer->x.dataLen = ( uint16_t )ret;
-               DtlsApplicationRx( pBuf, decryptedStackBuffer );
-               if ( _dtlsTransport == DTLS_TRANSPORT_RF_e )
-               {
-                  DtlsUpdateLastSessionSuccessSysTime();
-                  ( void )DtlsUpdateSessionCache( _dtlsSsl );
-                  DTLS_CounterInc( eDTLS_IfInUcastPkts );
-                  freeBuffer = false;
-               }
+               DtlsUpdateLastSessionSuccessSysTime();
+               ( void )DtlsUpdateSessionCache( _dtlsSsl );
+               DTLS_CounterInc( eDTLS_IfInUcastPkts );
+               freeBuffer = false;
+            }
+         }
+         else if ( ret == 0 ) /* Server disconnected (wolfSSL_shutdown) */
+         {
+            DtlsSessionStateChange( DTLS_SESSION_SHUTDOWN_e );
+            if ( _dtlsTransport == DTLS_TRANSPORT_RF_e )
+            {
+               DTLS_CounterInc( eDTLS_IfInNonApplicationPkts );
             }
-            else if ( ret == 0 ) /* Server disconnected (wolfSSL_shutdown) */
+         }
+         else
+         {
+            sslError = wolfSSL_get_error( _dtlsSsl, ret );
+            DTLS_ERROR( "DtlsTransportRx wolfSSL returned %d error %d", ret, sslError );
+
+            if ( _dtlsTransport == DTLS_TRANSPORT_RF_e )
             {
-               DtlsSessionStateChange( DTLS_SESSION_SHUTDOWN_e );
-               if ( _dtlsTransport == DTLS_TRANSPORT_RF_e )
+               if ( sslError == SSL_ERROR_WANT_READ || sslError == SSL_ERROR_WANT_WRITE )
                {
-                  DTLS_CounterInc( eDTLS_IfInNonApplicationPkts );
+                  DTLS_CounterInc( eDTLS_IfInDuplicates );
                }
-            }
-            else
-            {
-               sslError = wolfSSL_get_error( _dtlsSsl, ret );
-               DTLS_ERROR( "DtlsTransportRx wolfSSL returned %d error %d", ret, sslError );
-
-               if ( _dtlsTransport == DTLS_TRANSPORT_RF_e )
+               else
                {
-                  if ( sslError == SSL_ERROR_WANT_READ || sslError == SSL_ERROR_WANT_WRITE )
+                  if ( DECRYPT_ERROR == _dtlsSsl->error )
                   {
-                     DTLS_CounterInc( eDTLS_IfInDuplicates );
-                  }
-                  else
-                  {
-                     if ( DECRYPT_ERROR == _dtlsSsl->error )
-                     {
-                        //build and log comDeviceSecurityDecryptionFailed event
-                        EventData_s          eventData;
-                        EventKeyValuePair_s  keyVal[ 1 ];   /* Need only one "placeholder" */
-
-                        eventData.markSent                          = (bool)false;
-                        eventData.timestamp                         = 0;
-                        eventData.eventId                           = (uint16_t)comDeviceSecurityDecryptionFailed;
-                        eventData.alarmId                           = 0;
-                        eventData.eventKeyValuePairsCount           = 0;
-                        eventData.eventKeyValueSize                 = 0;
-                        *( uint16_t * )keyVal[ 0 ].Key              = 0;
-                        *( uint16_t * )keyVal[ 0 ].Value            = 0;
-                        (void)EVL_LogEvent( 111, &eventData, keyVal, TIMESTAMP_NOT_PROVIDED, NULL );
-                     }
-                     DtlsCheckIfSessionIsStale();
-                     DTLS_CounterInc( eDTLS_IfInSecurityErrors );
+                     //build and log comDeviceSecurityDecryptionFailed event
+                     EventData_s          eventData;
+                     EventKeyValuePair_s  keyVal[ 1 ];   /* Need only one "placeholder" */
+
+                     eventData.markSent                          = (bool)false;
+                     eventData.timestamp                         = 0;
+                     eventData.eventId                           = (uint16_t)comDeviceSecurityDecryptionFailed;
+                     eventData.alarmId                           = 0;
+                     eventData.eventKeyValuePairsCount           = 0;
+                     eventData.eventKeyValueSize                 = 0;
+                     *( uint16_t * )keyVal[ 0 ].Key              = 0;
+                     *( uint16_t * )keyVal[ 0 ].Value            = 0;
+                     (void)EVL_LogEvent( 111, &eventData, keyVal, TIMESTAMP_NOT_PROVIDED, NULL );
                   }
+                  DtlsCheckIfSessionIsStale();
+                  DTLS_CounterInc( eDTLS_IfInSecurityErrors );
                }
             }
-
-            BM_free( decryptedStackBuffer );
-         }
-         else
-         {
-            DTLS_ERROR( "DtlsTransportRx failed to allocate decrypted buffer" );
-            DtlsSessionStateChange( DTLS_SESSION_FAILED_e );
          }
+
          if ( _dtlsTransport == DTLS_TRANSPORT_RF_e )
          {
             DtlsCheckIfServerCertificateHasExpired(); /*lint !e522 !e523 no side effect.   */
@@ -4205,8 +4222,8 @@ static bool DtlsTransportRx( buffer_t *pBuf )
    Purpose: This function is called to receive application data.
 
    Arguments:
-         *pBuf                               - Original RX Buffer
-         *decryptedStackBuffer               - Decrypted buffer
+         *pBuf                               - Original RX Buffer, already holding the decrypted data
+         plainLen                            - Number of decrypted bytes
 
    Returns: None
 
@@ -4214,33 +4231,27 @@ static bool DtlsTransportRx( buffer_t *pBuf )
 
    Reentrant Code: No
 
-   Notes:
+   Notes: The plaintext was decrypted over the record in pBuf, so pBuf is handed on as is.
 
  ******************************************************************************************************************** */
-static void DtlsApplicationRx( buffer_t *pBuf, buffer_t *decryptedStackBuffer )
+static void DtlsApplicationRx( buffer_t *pBuf, uint16_t plainLen )
 {
    DTLS_INFO( "DtlsApplicationRx" );
    if ( _dtlsTransport == DTLS_TRANSPORT_SERIAL_e )
    {
-      MFGP_ProcessDecryptedCommand( decryptedStackBuffer );
-      DTLS_INFO( "decryptedStackBuffer: %p, len: hu", decryptedStackBuffer, decryptedStackBuffer->x.dataLen );
+      pBuf->x.dataLen = plainLen;
+      MFGP_ProcessDecryptedCommand( pBuf );
+      DTLS_INFO( "decrypted: %p, len: %hu", pBuf, pBuf->x.dataLen );
    }
    else if ( _dtlsTransport == DTLS_TRANSPORT_RF_e )
    {
       NWK_DataInd_t *nwk_indication = ( NWK_DataInd_t * )( void * )pBuf->data;
 
-      /* Make sure the buffer is clear of the encrypted data before copying over it */
-      ( void )memset( nwk_indication->payload, 0, nwk_indication->payloadLength );
+      /* Clear what is left of the encrypted record after the decrypted data */
+      ( void )memset( &nwk_indication->payload[plainLen], 0, ( uint32_t )nwk_indication->payloadLength - plainLen );
 
       /* Reset the payload length to the de-crypted length */
-      nwk_indication->payloadLength = decryptedStackBuffer->x.dataLen;
-
-      /* Copy the decrypted data into the payload of the original data */
-      ( void )memcpy( nwk_indication->payload, decryptedStackBuffer->data, nwk_indication->payloadLength );
-
-      /* Combine the decrypted data and network indication into the DTLS buffer and send to APP */
-      ( void )memcpy( decryptedStackBuffer->data, pBuf->data, sizeof( NWK_DataInd_t ) );
-      decryptedStackBuffer->eSysFmt = eSYSFMT_NWK_INDICATION;
+      nwk_indication->payloadLength = plainLen;
 
       /* get the UDP index so the decrypted data can be routed properly */
       uint8_t port = NWK_UdpPortNumToId( nwk_indication->dstUdpPort );
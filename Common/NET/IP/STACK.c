@@ -21,6 +21,8 @@
 #include <math.h>
 #include <limits.h> /* only for CHAR_BIT */
 #include <string.h>
+#include <stddef.h>       // offsetof()
+#include <assert.h>       // static_assert
 #include "pack.h"
 #include "time_util.h"
 #include "timer_util.h"
@@ -104,6 +106,13 @@
 #define MIN_IP_MSG_SIZE (IP_VERSION_SIZE + SRC_ADDR_COMPRESSION_SIZE + DST_ADDR_COMPRESSION_SIZE + QOS_SIZE + NXT_HDR_PRESENT_SIZE)
 #define MAX_IP_MSG_SIZE ((IP_VERSION_SIZE + SRC_ADDR_COMPRESSION_SIZE + DST_ADDR_COMPRESSION_SIZE + QOS_SIZE + NXT_HDR_PRESENT_SIZE + IPV6_SIZE + IPV6_SIZE + NEXT_HEADER_SIZE + UDP_PORT_SIZE + UDP_PORT_SIZE )/8)
 
+/* Largest header Process_DataRequest builds (multicast destination). It is written into NWK_DataReq_t.hdrRoom. */
+#define MAX_IP_TX_HDR_SIZE ((MIN_IP_MSG_SIZE + DST_MULTI_SIZE + UDP_PORT_SIZE + UDP_PORT_SIZE + 7)/8)
+static_assert( MAX_IP_TX_HDR_SIZE <= NWK_DATA_REQ_HDR_ROOM, "NWK_DATA_REQ_HDR_ROOM is too small for the IP/UDP header" );
+
+/* Offset of the payload in a data request buffer. NWK_DataRequestAlloc reserves this much headroom. */
+#define NWK_DATA_REQ_HEADROOM ((uint16_t)offsetof(NWK_Request_t, Service.DataReq.data))
+
 /* time of day to send stats:  22:59:45 */
 #if ( FAKE_TRAFFIC == 1 )
 #define FAKE_SRFN_MESSAGE_SIZE 15
@@ -304,7 +313,7 @@ static bool Process_ResetRequest(NWK_ResetReq_t const *pReq);
 static bool Process_StopRequest( NWK_StopReq_t  const *pReq);
 static bool Process_GetRequest(  NWK_GetReq_t   const *pReq);
 static bool Process_SetRequest(  NWK_SetReq_t   const *pReq);
-static bool Process_DataRequest( NWK_DataReq_t  const *pReq);
+static bool Process_DataRequest( NWK_DataReq_t *pReq);
 
 static bool Process_SetConfirm(  MAC_SetConf_t   const *pConfirm  );
 static bool Process_GetConfirm(  MAC_GetConf_t   const *pConfirm  );
@@ -822,12 +831,15 @@ Purpose: This function will process a DATA.request
 
 Arguments: req - pointer to a NWK layer DATA.request
 
+Notes: The IP/UDP header is written into req->hdrRoom, directly in front of the payload, so the packet handed to the MAC
+       is contiguous in the request buffer and the payload is not copied.
+
 Returns: true if this function updated pNwkConf to contain confirmation details, false if the caller should not generate
             a confirm using information written to pNwkConf.
 ***********************************************************************************************************************/
-static bool Process_DataRequest( NWK_DataReq_t  const *req)
+static bool Process_DataRequest( NWK_DataReq_t *req)
 {
-   NWK_DataReq_t const *stack_request = req;
+   NWK_DataReq_t *stack_request = req;
 
    pNwkConf->Type = eNWK_DATA_CONF;
 
@@ -869,112 +881,102 @@ static bool Process_DataRequest( NWK_DataReq_t  const *req)
                    ((stack_request->override.linkSettingsOverride == eNWK_LINK_SETTINGS_OVERRIDE_BROADCAST_OB) ||   // it can only be overriten to broadcast.
                     (stack_request->override.linkSettingsOverride == eNWK_LINK_SETTINGS_OVERRIDE_BROADCAST_IB)))) ) // This is because we don't have the MAC address needed to unicast so we can't do that.
             {
-               // Allocate a temporary buffer to build the payload
-               buffer_t *pBuf = BM_allocStack( stack_request->payloadLength + MAX_IP_MSG_SIZE);
-               if(pBuf != NULL)
-               {
-                  uint8_t *payload = (uint8_t*)pBuf->data;
-
-                  bool                 ackRequired;
-                  uint8_t              MsgPriority;
-                  bool                 droppable;
-                  MAC_Reliability_e    reliability;
-                  NWK_Address_t        dstAddress = stack_request->dstAddress;
+               uint8_t              header[NWK_DATA_REQ_HDR_ROOM] = { 0 };
+               uint8_t             *payload = header;
+               bool                 ackRequired;
+               uint8_t              MsgPriority;
+               bool                 droppable;
+               MAC_Reliability_e    reliability;
+               NWK_Address_t        dstAddress = stack_request->dstAddress;
 #if ( DCU == 1 )
-                  MAC_CHANNEL_SET_INDEX_e channelSetIndex = eMAC_CHANNEL_SET_INDEX_1;
+               MAC_CHANNEL_SET_INDEX_e channelSetIndex = eMAC_CHANNEL_SET_INDEX_1;
 #else
-                  MAC_CHANNEL_SET_INDEX_e channelSetIndex = eMAC_CHANNEL_SET_INDEX_2;
+               MAC_CHANNEL_SET_INDEX_e channelSetIndex = eMAC_CHANNEL_SET_INDEX_2;
 #endif
-                  (void) NWK_QosToParams(stack_request->qos,
-                                &ackRequired,
-                                &MsgPriority,
-                                &droppable,
-                                &reliability);
+               (void) NWK_QosToParams(stack_request->qos,
+                             &ackRequired,
+                             &MsgPriority,
+                             &droppable,
+                             &reliability);
 
-                  bitNo = PACK_uint8_2bits( (uint8_t []) { IP_VERSION }             , IP_VERSION_SIZE,           payload, bitNo);
-                  bitNo = PACK_uint8_2bits( (uint8_t []) { (uint8_t)eELIDED}        , SRC_ADDR_COMPRESSION_SIZE, payload, bitNo);
+               bitNo = PACK_uint8_2bits( (uint8_t []) { IP_VERSION }             , IP_VERSION_SIZE,           payload, bitNo);
+               bitNo = PACK_uint8_2bits( (uint8_t []) { (uint8_t)eELIDED}        , SRC_ADDR_COMPRESSION_SIZE, payload, bitNo);
 
-                  if ((stack_request->dstAddress.addr_type == eEXTENSION_ID) ||
-                      (stack_request->dstAddress.addr_type == eELIDED))
-                  {
-                     bitNo = PACK_uint8_2bits((uint8_t []) {(uint8_t) eELIDED }     , DST_ADDR_COMPRESSION_SIZE, payload, bitNo);
-                     bitNo = PACK_uint8_2bits(&stack_request->qos                   , QOS_SIZE                 , payload, bitNo);
-                     bitNo = PACK_uint8_2bits((uint8_t []) {0}                      , NXT_HDR_PRESENT_SIZE     , payload, bitNo);
-                  }
-                  else if (stack_request->dstAddress.addr_type == eMULTICAST)
-                  {
-                     bitNo = PACK_uint8_2bits((uint8_t []) {(uint8_t) eMULTICAST}   , DST_ADDR_COMPRESSION_SIZE, payload, bitNo);
-                     bitNo = PACK_uint8_2bits(&stack_request->qos                   , QOS_SIZE                 , payload, bitNo);
-                     bitNo = PACK_uint8_2bits((uint8_t []) {0}                      , NXT_HDR_PRESENT_SIZE     , payload, bitNo);
-                     bitNo = PACK_addr(stack_request->dstAddress.multicastAddr      , MAC_ADDRESS_SIZE         , payload, bitNo);
-                     // hack last byte of multicast address in
-                     bitNo = PACK_uint8_2bits((uint8_t []) {(uint8_t) stack_request->dstAddress.multicastAddr[5] } , 8, payload, bitNo);
-                  }
-                  else if (stack_request->dstAddress.addr_type == eCONTEXT)
-                  {
-                     bitNo = PACK_uint8_2bits((uint8_t []) {(uint8_t) eCONTEXT }    , DST_ADDR_COMPRESSION_SIZE, payload, bitNo);
-                     bitNo = PACK_uint8_2bits(&stack_request->qos                   , QOS_SIZE                 , payload, bitNo);
-                     bitNo = PACK_uint8_2bits((uint8_t []) {0}                      , NXT_HDR_PRESENT_SIZE     , payload, bitNo);
-                     bitNo = PACK_uint8_2bits(&stack_request->dstAddress.context    , CONTEXT_SIZE             , payload, bitNo);
-                  }
+               if ((stack_request->dstAddress.addr_type == eEXTENSION_ID) ||
+                   (stack_request->dstAddress.addr_type == eELIDED))
+               {
+                  bitNo = PACK_uint8_2bits((uint8_t []) {(uint8_t) eELIDED }     , DST_ADDR_COMPRESSION_SIZE, payload, bitNo);
+                  bitNo = PACK_uint8_2bits(&stack_request->qos                   , QOS_SIZE                 , payload, bitNo);
+                  bitNo = PACK_uint8_2bits((uint8_t []) {0}                      , NXT_HDR_PRESENT_SIZE     , payload, bitNo);
+               }
+               else if (stack_request->dstAddress.addr_type == eMULTICAST)
+               {
+                  bitNo = PACK_uint8_2bits((uint8_t []) {(uint8_t) eMULTICAST}   , DST_ADDR_COMPRESSION_SIZE, payload, bitNo);
+                  bitNo = PACK_uint8_2bits(&stack_request->qos                   , QOS_SIZE                 , payload, bitNo);
+                  bitNo = PACK_uint8_2bits((uint8_t []) {0}                      , NXT_HDR_PRESENT_SIZE     , payload, bitNo);
+                  bitNo = PACK_addr(stack_request->dstAddress.multicastAddr      , MAC_ADDRESS_SIZE         , payload, bitNo);
+                  // hack last byte of multicast address in
+                  bitNo = PACK_uint8_2bits((uint8_t []) {(uint8_t) stack_request->dstAddress.multicastAddr[5] } , 8, payload, bitNo);
+               }
+               else if (stack_request->dstAddress.addr_type == eCONTEXT)
+               {
+                  bitNo = PACK_uint8_2bits((uint8_t []) {(uint8_t) eCONTEXT }    , DST_ADDR_COMPRESSION_SIZE, payload, bitNo);
+                  bitNo = PACK_uint8_2bits(&stack_request->qos                   , QOS_SIZE                 , payload, bitNo);
+                  bitNo = PACK_uint8_2bits((uint8_t []) {0}                      , NXT_HDR_PRESENT_SIZE     , payload, bitNo);
+                  bitNo = PACK_uint8_2bits(&stack_request->dstAddress.context    , CONTEXT_SIZE             , payload, bitNo);
+               }
 
-                  /* udp source port */
-                  bitNo = PACK_uint8_2bits( &stack_request->port                    , UDP_PORT_SIZE            , payload, bitNo);
+               /* udp source port */
+               bitNo = PACK_uint8_2bits( &stack_request->port                    , UDP_PORT_SIZE            , payload, bitNo);
 
-                  /* udp destination port */
-                  bitNo = PACK_uint8_2bits( &stack_request->port                    , UDP_PORT_SIZE            , payload, bitNo);
+               /* udp destination port */
+               bitNo = PACK_uint8_2bits( &stack_request->port                    , UDP_PORT_SIZE            , payload, bitNo);
 
-                  /* xxx jmb:  warning, shortcut for speed, assumes payload portion starts byte aligned */
-                  // Copy the stack payload to the payload buffer
-                  (void)memcpy(&payload[(bitNo/8)], stack_request->data,    stack_request->payloadLength);
+               /* xxx jmb:  warning, shortcut for speed, assumes payload portion starts byte aligned */
+               // Put the header immediately in front of the payload
+               payload = &stack_request->hdrRoom[NWK_DATA_REQ_HDR_ROOM - (bitNo/8)];
+               (void)memcpy(payload, header, bitNo/8);
 
-                  // Override some settings if needed
-                  if ( (stack_request->override.linkOverride         == eNWK_LINK_OVERRIDE_TENGWAR_MAC) &&
-                       (stack_request->override.linkSettingsOverride != eNWK_LINK_SETTINGS_OVERRIDE_NULL) ) {
-                     switch (stack_request->override.linkSettingsOverride ) {
-                        case eNWK_LINK_SETTINGS_OVERRIDE_UNICAST_OB:   dstAddress.addr_type = eEXTENSION_ID;            // Force MAC to unicast
-                                                                       channelSetIndex      = eMAC_CHANNEL_SET_INDEX_1;
-                                                                       break;
+               // Override some settings if needed
+               if ( (stack_request->override.linkOverride         == eNWK_LINK_OVERRIDE_TENGWAR_MAC) &&
+                    (stack_request->override.linkSettingsOverride != eNWK_LINK_SETTINGS_OVERRIDE_NULL) ) {
+                  switch (stack_request->override.linkSettingsOverride ) {
+                     case eNWK_LINK_SETTINGS_OVERRIDE_UNICAST_OB:   dstAddress.addr_type = eEXTENSION_ID;            // Force MAC to unicast
+                                                                    channelSetIndex      = eMAC_CHANNEL_SET_INDEX_1;
+                                                                    break;
 
-                        case eNWK_LINK_SETTINGS_OVERRIDE_UNICAST_IB:   dstAddress.addr_type = eEXTENSION_ID;            // Force MAC to unicast
-                                                                       channelSetIndex      = eMAC_CHANNEL_SET_INDEX_2;
-                                                                       break;
+                     case eNWK_LINK_SETTINGS_OVERRIDE_UNICAST_IB:   dstAddress.addr_type = eEXTENSION_ID;            // Force MAC to unicast
+                                                                    channelSetIndex      = eMAC_CHANNEL_SET_INDEX_2;
+                                                                    break;
 
-                        case eNWK_LINK_SETTINGS_OVERRIDE_BROADCAST_OB: dstAddress.addr_type = eMULTICAST;               // Force MAC to broadcast
-                                                                       channelSetIndex      = eMAC_CHANNEL_SET_INDEX_1;
-                                                                       break;
+                     case eNWK_LINK_SETTINGS_OVERRIDE_BROADCAST_OB: dstAddress.addr_type = eMULTICAST;               // Force MAC to broadcast
+                                                                    channelSetIndex      = eMAC_CHANNEL_SET_INDEX_1;
+                                                                    break;
 
-                        case eNWK_LINK_SETTINGS_OVERRIDE_BROADCAST_IB: dstAddress.addr_type = eMULTICAST;               // Force MAC to broadcast
-                                                                       channelSetIndex      = eMAC_CHANNEL_SET_INDEX_2;
-                                                                       break;
+                     case eNWK_LINK_SETTINGS_OVERRIDE_BROADCAST_IB: dstAddress.addr_type = eMULTICAST;               // Force MAC to broadcast
+                                                                    channelSetIndex      = eMAC_CHANNEL_SET_INDEX_2;
+                                                                    break;
 
-                        case eNWK_LINK_SETTINGS_OVERRIDE_NULL: // Fall through
-                        default: break;
-                     }
+                     case eNWK_LINK_SETTINGS_OVERRIDE_NULL: // Fall through
+                     default: break;
                   }
-
-                  // This function returns a handle that can be used to associate the confirmation to this request
-                  (void)MAC_DataRequest_Srfn(
-                           &dstAddress,
-                           payload,
-                           stack_request->payloadLength+(bitNo/8),
-                           ackRequired,
-                           MsgPriority,
-                           droppable,
-                           reliability,
-                           channelSetIndex,
-                           stack_request->callback,
-                           NWK_Confirm);
-
-                  BM_free( pBuf );
-
-                  // Send to MAC, so confirm will be later!
-                  return (bool)true;
-               }else
-               {  // Buffer allocation failed
-                  pNwkConf->DataConf.status = eNWK_DATA_TRANSACTION_FAILED;
-                  return (bool)true;
                }
+
+               // This function returns a handle that can be used to associate the confirmation to this request
+               (void)MAC_DataRequest_Srfn(
+                        &dstAddress,
+                        payload,
+                        stack_request->payloadLength+(bitNo/8),
+                        ackRequired,
+                        MsgPriority,
+                        droppable,
+                        reliability,
+                        channelSetIndex,
+                        stack_request->callback,
+                        NWK_Confirm);
+
+               // Send to MAC, so confirm will be later!
+               return (bool)true;
             }else
             {
                NWK_CounterInc(eNWK_ipIfOutDiscards, 1, IGNORE_PARAMETER);  // Does not track by LINK
@@ -3050,25 +3052,68 @@ uint32_t NWK_DataRequest(
    NWK_ConfirmHandler confirm_cb)
 {
    // Allocate the buffer
+   buffer_t *pBuf = NWK_DataRequestAlloc(size);
+   if (pBuf != NULL)
+   {
+      (void) memcpy(pBuf->data, data, size);
+      ASSERT(pBuf->x.dataLen == size); // Exactly the caller's payload goes over the air
+      return NWK_DataRequestSend(pBuf, port, qos, dst_addr, override, callback, confirm_cb);
+   }
+   return NWK_INVALID_HANDLE_ID;
+}
+
+/*!
+ *  Allocate a Data Request buffer for a caller that builds its payload in place.
+ *
+ *  The request header is held as headroom, so pBuf->data points at the payload area (size bytes) and x.dataLen is size.
+ *  The caller writes its payload at pBuf->data, sets x.dataLen to the payload length, then either passes the buffer to
+ *  NWK_DataRequestSend (which takes ownership) or frees it.
+ */
+buffer_t *NWK_DataRequestAlloc( uint16_t size )
+{
    buffer_t *pBuf = ReqBuffer_Alloc(eNWK_DATA_REQ, size);
    if (pBuf != NULL)
    {
-      NWK_Request_t *pReq = (NWK_Request_t *)pBuf->data; /*lint !e740 !e826 */
-      pReq->handleId = NextRequestHandle();
-      pReq->pConfirmHandler = confirm_cb;
+      (void)BM_Reserve(pBuf, NWK_DATA_REQ_HEADROOM); // Can't fail, ReqBuffer_Alloc sized the buffer for the header
+      /* ReqBuffer_Alloc counts sizeof(NWK_DataReq_t), which includes padding past data[], so the reserve leaves more
+         than was asked for */
+      pBuf->x.dataLen = size;
+   }
+   return pBuf;
+}
 
-      pReq->Service.DataReq.qos           = qos;
-      pReq->Service.DataReq.payloadLength = size;
-      pReq->Service.DataReq.callback      = callback;
-      pReq->Service.DataReq.port          = port;
-      pReq->Service.DataReq.dstAddress    = *dst_addr;
-      pReq->Service.DataReq.override      = *override;
-      (void) memcpy(pReq->Service.DataReq.data, data, size);
+/*!
+ *  Send a Data Request built in a buffer from NWK_DataRequestAlloc. The payload is not copied.
+ */
+uint32_t NWK_DataRequestSend(
+   buffer_t *pBuf,
+   uint8_t port,  /* UDP port number   */
+   uint8_t qos,
+   NWK_Address_t const *dst_addr,
+   NWK_Override_t const *override,
+   MAC_dataConfCallback callback,
+   NWK_ConfirmHandler confirm_cb)
+{
+   uint16_t       size = pBuf->x.dataLen;
+   NWK_Request_t *pReq = (NWK_Request_t *)(void *)BM_Push(pBuf, NWK_DATA_REQ_HEADROOM); /*lint !e740 !e826 */
 
-      OS_MSGQ_Post(&NWK_msgQueue, (void *)pBuf); // Function will not return if it fails
-      return pReq->handleId;
+   if (pReq == NULL)
+   {  // Not a buffer from NWK_DataRequestAlloc
+      BM_free(pBuf);
+      return NWK_INVALID_HANDLE_ID;
    }
-   return NWK_INVALID_HANDLE_ID;
+   pReq->handleId = NextRequestHandle();
+   pReq->pConfirmHandler = confirm_cb;
+
+   pReq->Service.DataReq.qos           = qos;
+   pReq->Service.DataReq.payloadLength = size;
+   pReq->Service.DataReq.callback      = callback;
+   pReq->Service.DataReq.port          = port;
+   pReq->Service.DataReq.dstAddress    = *dst_addr;
+   pReq->Service.DataReq.override      = *override;
+
+   OS_MSGQ_Post(&NWK_msgQueue, (void *)pBuf); // Function will not return if it fails
+   return pReq->handleId;
 }
 
 #if 0
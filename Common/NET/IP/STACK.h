@@ -156,6 +156,16 @@ uint32_t NWK_DataRequest(
    MAC_dataConfCallback callback,          // Data Confirm Callback
    NWK_ConfirmHandler confirm_cb);
 
+buffer_t *NWK_DataRequestAlloc( uint16_t size );
+uint32_t NWK_DataRequestSend(
+   buffer_t *pBuf,
+   uint8_t port,  /* UDP port number   */
+   uint8_t qos,
+   NWK_Address_t const *dst_addr,
+   NWK_Override_t const *override,
+   MAC_dataConfCallback callback,          // Data Confirm Callback
+   NWK_ConfirmHandler confirm_cb);
+
 uint16_t NWK_UdpPortIdToNum(uint8_t id);
 uint8_t NWK_UdpPortNumToId(uint16_t num);
 
@@ -350,6 +350,9 @@ typedef struct {
    uint8_t *data; /*!< payload */
 } IP_Frame_t;
 
+/* Room kept in front of NWK_DataReq_t.data so the NWK task can prepend the compressed IP/UDP header in place */
+#define NWK_DATA_REQ_HDR_ROOM 10
+
 /* Data.Request */
 typedef struct
 {
@@ -360,6 +363,7 @@ typedef struct
    uint16_t       payloadLength;
    MAC_dataConfCallback callback; /* optional function pointer to be called with tx result (QoS dictates 'success') */
    uint8_t        port;    /* UDP port number   */
+   uint8_t        hdrRoom[NWK_DATA_REQ_HDR_ROOM]; /* IP/UDP header is built here, immediately before data */
    uint8_t        data[];
 } NWK_DataReq_t;
 
@@ -27,6 +27,7 @@
 #include "time_util.h"
 #include "DBG_SerialDebug.h"
 #include "BUF_MemoryBuffers.h"
+#include "dB_util.h"
 #if (DCU == 1)
 #include "MAINBD_Handler.h" //DCU2+
 #include "STAR.h"           //DCU2+
@@ -58,6 +59,16 @@
 #define NUM_CONCURRENT_RX_BUFFERS ((uint16_t)5)
 #define SEGMENT_STORAGE_POOL_SIZE ((uint16_t)26)
 #endif
+
+/* Slots in the MAC address hash indexes.  Must be a power of 2 and at least twice the number of entries indexed so the
+   load factor stays under 1/2 and probe sequences stay short. */
+#if ( DCU == 1 )
+#define RX_BUFFER_INDEX_SLOTS ((uint16_t)2048)
+#define PACKET_ID_INDEX_SLOTS ((uint16_t)2048)
+#else
+#define RX_BUFFER_INDEX_SLOTS ((uint16_t)16)
+#define PACKET_ID_INDEX_SLOTS ((uint16_t)32)
+#endif
 #if( RTOS_SELECTION == FREE_RTOS )
 #define RX_BUF_EXPIRE_NUM_MSGQ_ITEMS  10 //NRJ: TODO Figure out sizing
 #else
@@ -119,6 +130,19 @@ typedef struct
    float    danl_dbm;
 } RxSegmentInfo_s;
 
+/* Open addressed (linear probing) hash index on the MAC address of a table of entries, plus a stack of the entries that
+   are free for allocation.  Used to replace linear searches of the rx buffers and packet ID pairs, which on a DCU are
+   hundreds of entries long and are searched for every received frame.  Only accessed from the MAC task. */
+typedef struct
+{
+   uint16_t      *slots;      /* Entry number + 1 of the entry hashed to this slot, 0 for an empty slot */
+   uint16_t      *freeList;   /* Stack of entry numbers available for allocation */
+   uint8_t const *addrBase;   /* MAC address of entry 0 */
+   uint16_t       addrStride; /* Distance in bytes between the MAC addresses of consecutive entries */
+   uint16_t       mask;       /* Number of slots - 1 */
+   uint16_t       freeCount;  /* Number of entries on freeList */
+} AddrIndex_s;
+
 static struct{
    uint16_t           InUseCount;    // Total number of buffers in use
    uint16_t           UnicastCount;  // Total number of Unicast in use
@@ -142,12 +166,23 @@ static BUF_Obj MAC_FrameRxBufObj;
 static RxSegmentInfo_s RxSegmentStorage[(SEGMENT_STORAGE_POOL_SIZE)] @ "EXTERNAL_RAM" ; /*lint !e430*/
 static PacketIdPair_s PacketIdPairs[NUM_NODES_TRACKED]               @ "EXTERNAL_RAM" ; /*lint !e430*/
 static MAC_FrameManagBuf_s FrameManagTxData[MAX_MAC_FRAME_BUFFERS]   @ "EXTERNAL_RAM" ; /*lint !e430*/
+static uint16_t RxBufferSlots[RX_BUFFER_INDEX_SLOTS]                  @ "EXTERNAL_RAM" ; /*lint !e430*/
+static uint16_t RxBufferFreeList[NUM_CONCURRENT_RX_BUFFERS]           @ "EXTERNAL_RAM" ; /*lint !e430*/
+static uint16_t PacketIdSlots[PACKET_ID_INDEX_SLOTS]                  @ "EXTERNAL_RAM" ; /*lint !e430*/
+static uint16_t PacketIdFreeList[NUM_NODES_TRACKED]                   @ "EXTERNAL_RAM" ; /*lint !e430*/
 #else
 static RxSegmentInfo_s RxSegmentStorage[(SEGMENT_STORAGE_POOL_SIZE)];
 static PacketIdPair_s PacketIdPairs[NUM_NODES_TRACKED];
 static MAC_FrameManagBuf_s FrameManagTxData[MAX_MAC_FRAME_BUFFERS];
+static uint16_t RxBufferSlots[RX_BUFFER_INDEX_SLOTS];
+static uint16_t RxBufferFreeList[NUM_CONCURRENT_RX_BUFFERS];
+static uint16_t PacketIdSlots[PACKET_ID_INDEX_SLOTS];
+static uint16_t PacketIdFreeList[NUM_NODES_TRACKED];
 #endif
 
+static AddrIndex_s RxBufferIndex;   /* Rx buffers in reassembly (or stale) by source address */
+static AddrIndex_s PacketIdIndex;   /* Packet ID pairs by source address */
+
 static uint8_t NextReqNum = 0;
 
 extern TimeSync_t TimeSync;
@@ -167,6 +202,12 @@ static void FindRxBuffer( const uint8_t *macAddr, RxBufferTracking_s **matchingB
 static void FindUnusedRxBuffer( RxBufferTracking_s **unusedBuffer );
 static void FindPacketIdPair( const uint8_t *macAddr, PacketIdPair_s **matchingPair );
 static void FindUnusedPacketIdPair( PacketIdPair_s **unusedPair );
+static void AddrIndexInit( AddrIndex_s *index, uint16_t *slots, uint16_t numSlots, uint16_t *freeList, uint16_t numEntries,
+                           uint8_t const *addrBase, uint16_t addrStride );
+static uint16_t AddrIndexHome( AddrIndex_s const *index, uint8_t const *macAddr );
+static void AddrIndexInsert( AddrIndex_s *index, uint16_t entry );
+static void AddrIndexRemoveSlot( AddrIndex_s *index, uint16_t slot );
+static bool AddrIndexRemove( AddrIndex_s *index, uint16_t entry );
 
 extern MAC_GET_STATUS_e MAC_Attribute_Get(MAC_GetReq_t const *pGetReq, MAC_ATTRIBUTES_u *val);  // Prototype should be only used by MAC.c and MAC_FrameManagement.c.
                                                                                                 // We don't want outsiders to call this function directly.
@@ -238,6 +279,11 @@ returnStatus_t MAC_FrameManag_init ( void )
       PacketIdPairs[i].inUse = (bool)false;
    }
 
+   AddrIndexInit( &RxBufferIndex, RxBufferSlots, RX_BUFFER_INDEX_SLOTS, RxBufferFreeList, NUM_CONCURRENT_RX_BUFFERS,
+                  RxBuffers.Buffers[0].srcAddr, (uint16_t)sizeof(RxBuffers.Buffers[0]) );
+   AddrIndexInit( &PacketIdIndex, PacketIdSlots, PACKET_ID_INDEX_SLOTS, PacketIdFreeList, NUM_NODES_TRACKED,
+                  PacketIdPairs[0].macAddr, (uint16_t)sizeof(PacketIdPairs[0]) );
+
    NextReqNum = 0;
 
    return ( RetVal );
@@ -526,6 +572,7 @@ bool MAC_FrameManag_DataIndHandler ( const mac_frame_t *macFrame, TIMESTAMP_t Ti
             rxBuff->packetId        = macFrame->packet_id;
             (void)memcpy(rxBuff->srcAddr, macFrame->src_addr, MAC_ADDRESS_SIZE);
             (void)memcpy(rxBuff->dstAddr, macFrame->dst_addr, MAC_ADDRESS_SIZE);
+            AddrIndexInsert( &RxBufferIndex, (uint16_t)(rxBuff - RxBuffers.Buffers) );
 
             /* Track the number of buffers in use */
             RxBuffers.InUseCount++;
@@ -677,16 +724,16 @@ static void MAC_FrameManag_AssemblePacket( RxBufferTracking_s *rxBuff )
          numBytesCopied  += num_bytes;
          bytes_remaining -= num_bytes;
 
-         totalRssi += powf((float)10.0, (float) segment->rssi_dbm / (float) 10.0 );
-         totalDanl += powf((float)10.0, (float) segment->danl_dbm / (float) 10.0 );
+         totalRssi += DB_toLinear( (float)segment->rssi_dbm );
+         totalDanl += DB_toLinear( (float)segment->danl_dbm );
 
          segment = OS_LINKEDLIST_Next ( &rxBuff->frameQueue, segment );
       }
       mac_indication->segmentCount = rxBuff->segmentCount;
       mac_indication->channel = rxBuff->channel;
 
-      mac_indication->rssi = PHY_DBM_TO_MAC_SCALING( 10.0 * log10( (double)totalRssi / max(NumElements,1 ) ) ); // Average the linear RSSI across all segments and convert back to dBm then remap to 0-4095
-      mac_indication->danl = PHY_DBM_TO_MAC_SCALING( 10.0 * log10( (double)totalDanl / max(NumElements,1 ) ) ); // Average the linear RSSI across all segments and convert back to dBm then remap to 0-4095
+      mac_indication->rssi = PHY_DBM_TO_MAC_SCALING( DB_fromLinear( totalRssi / max(NumElements,1 ) ) ); // Average the linear RSSI across all segments and convert back to dBm then remap to 0-4095
+      mac_indication->danl = PHY_DBM_TO_MAC_SCALING( DB_fromLinear( totalDanl / max(NumElements,1 ) ) ); // Average the linear RSSI across all segments and convert back to dBm then remap to 0-4095
 
       mac_indication->timeStamp       = rxBuff->timeStamp;
       mac_indication->timeStampCYCCNT = rxBuff->timeStampCYCCNT;
@@ -701,6 +748,7 @@ static void MAC_FrameManag_AssemblePacket( RxBufferTracking_s *rxBuff )
          packetIdPair->inUse = (bool)true;
          packetIdPair->packetId = rxBuff->packetId;
          (void)memcpy(packetIdPair->macAddr, rxBuff->srcAddr, MAC_ADDRESS_SIZE);
+         AddrIndexInsert( &PacketIdIndex, (uint16_t)(packetIdPair - PacketIdPairs) );
          (void)addPacketIdTrackingTimeout(packetIdPair);
       }
       else
@@ -769,6 +817,10 @@ _task_start_preemption();
             /* source address device moved on to different packet ID, no longer need to track this one */
             (void) TMR_DeleteTimer(packetIdPair->timerId);
             packetIdPair->inUse = (bool)false;
+            if ( AddrIndexRemove( &PacketIdIndex, (uint16_t)(packetIdPair - PacketIdPairs) ) )
+            {
+               PacketIdIndex.freeList[PacketIdIndex.freeCount++] = (uint16_t)(packetIdPair - PacketIdPairs);
+            }
          }
       }
    }
@@ -844,6 +896,12 @@ static void MAC_FrameManag_EmptyRxBuffer( RxBufferTracking_s *rxBuff )
 
    rxBuff->state = eMAC_RXBUFF_UNUSED;
 
+   /* Only return the buffer to the free list once, even if it is emptied a second time */
+   if ( AddrIndexRemove( &RxBufferIndex, (uint16_t)(rxBuff - RxBuffers.Buffers) ) )
+   {
+      RxBufferIndex.freeList[RxBufferIndex.freeCount++] = (uint16_t)(rxBuff - RxBuffers.Buffers);
+   }
+
    if (RxBuffers.InUseCount > NUM_CONCURRENT_RX_BUFFERS)
    {
       DBG_logPrintf ('E', "###In Use RX Buffer tracking is out of sync###");
@@ -992,6 +1050,157 @@ static returnStatus_t addPacketIdTrackingTimeout (PacketIdPair_s *PacketIdPairTo
    return retStatus;
 }
 
+/***********************************************************************************************************************
+Function Name: AddrIndexInit
+
+Purpose:  Set up an empty MAC address index with every entry on the free list.
+
+Arguments:
+   index - index to set up
+   slots - storage for the hash slots
+   numSlots - number of hash slots, a power of 2 larger than numEntries
+   freeList - storage for the free list, numEntries long
+   numEntries - number of entries in the indexed table
+   addrBase - address of the MAC address in entry 0 of the indexed table
+   addrStride - size of an entry in the indexed table
+
+Returns: none
+***********************************************************************************************************************/
+static void AddrIndexInit( AddrIndex_s *index, uint16_t *slots, uint16_t numSlots, uint16_t *freeList, uint16_t numEntries,
+                           uint8_t const *addrBase, uint16_t addrStride )
+{
+   uint16_t i;
+
+   (void)memset(slots, 0, numSlots * sizeof(slots[0]));
+   index->slots      = slots;
+   index->freeList   = freeList;
+   index->addrBase   = addrBase;
+   index->addrStride = addrStride;
+   index->mask       = (uint16_t)( numSlots - 1 );
+
+   /* Stack the entries so the lowest numbered one is handed out first */
+   for (i = 0; i < numEntries; i++)
+   {
+      freeList[i] = (uint16_t)( ( numEntries - 1 ) - i );
+   }
+   index->freeCount = numEntries;
+}
+
+/***********************************************************************************************************************
+Function Name: AddrIndexHome
+
+Purpose:  Hash a MAC address (FNV-1a) to the first slot of its probe sequence.
+
+Arguments:
+   index - index being searched
+   macAddr - pointer to 5 byte MAC address
+
+Returns: home slot of the address
+***********************************************************************************************************************/
+static uint16_t AddrIndexHome( AddrIndex_s const *index, uint8_t const *macAddr )
+{
+   uint32_t hash = 2166136261UL;
+   uint8_t  i;
+
+   for (i = 0; i < MAC_ADDRESS_SIZE; i++)
+   {
+      hash ^= macAddr[i];
+      hash *= 16777619UL;
+   }
+   return (uint16_t)( ( hash ^ ( hash >> 16 ) ) & index->mask );
+}
+
+/***********************************************************************************************************************
+Function Name: AddrIndexInsert
+
+Purpose:  Add an entry to the index under the MAC address it currently holds.
+
+Arguments:
+   index - index to update
+   entry - entry number in the indexed table
+
+Returns: none
+
+Notes: There are always more slots than entries so an empty slot is always found.
+***********************************************************************************************************************/
+static void AddrIndexInsert( AddrIndex_s *index, uint16_t entry )
+{
+   uint16_t slot;
+
+   slot = AddrIndexHome( index, &index->addrBase[ entry * index->addrStride ] );
+   while ( index->slots[slot] != 0 )
+   {
+      slot = (uint16_t)( ( slot + 1 ) & index->mask );
+   }
+   index->slots[slot] = (uint16_t)( entry + 1 );
+}
+
+/***********************************************************************************************************************
+Function Name: AddrIndexRemoveSlot
+
+Purpose:  Empty a slot and shift back any following entries of the probe run that can now sit closer to their home slot,
+   so lookups never need to skip over deleted slots.
+
+Arguments:
+   index - index to update
+   slot - occupied slot to empty
+
+Returns: none
+***********************************************************************************************************************/
+static void AddrIndexRemoveSlot( AddrIndex_s *index, uint16_t slot )
+{
+   uint16_t hole = slot;
+   uint16_t next = slot;
+   uint16_t home;
+
+   for ( ;; )
+   {
+      next = (uint16_t)( ( next + 1 ) & index->mask );
+      if ( index->slots[next] == 0 )
+      {
+         break;
+      }
+      home = AddrIndexHome( index, &index->addrBase[ ( index->slots[next] - 1 ) * index->addrStride ] );
+      /* The entry can fill the hole if the hole lies between its home slot and where it is now */
+      if ( ( ( next - home ) & index->mask ) >= ( ( next - hole ) & index->mask ) )
+      {
+         index->slots[hole] = index->slots[next];
+         hole = next;
+      }
+   }
+   index->slots[hole] = 0;
+}
+
+/***********************************************************************************************************************
+Function Name: AddrIndexRemove
+
+Purpose:  Remove an entry from the index.  The entry must still hold the MAC address it was inserted with.
+
+Arguments:
+   index - index to update
+   entry - entry number in the indexed table
+
+Returns: true if the entry was in the index, false otherwise
+***********************************************************************************************************************/
+static bool AddrIndexRemove( AddrIndex_s *index, uint16_t entry )
+{
+   uint16_t slot;
+   bool     found = (bool)false;
+
+   slot = AddrIndexHome( index, &index->addrBase[ entry * index->addrStride ] );
+   while ( index->slots[slot] != 0 )
+   {
+      if ( index->slots[slot] == ( entry + 1 ) )
+      {
+         AddrIndexRemoveSlot( index, slot );
+         found = (bool)true;
+         break;
+      }
+      slot = (uint16_t)( ( slot + 1 ) & index->mask );
+   }
+   return found;
+}
+
 /***********************************************************************************************************************
 Function Name: FindRxBuffer
 
@@ -1002,20 +1211,26 @@ Arguments:
    matchingBuffer - Populated with buffer address if matching buffer was found.  Populated with NULL otherwise.
 
 Returns: none
+
+Notes: Stale buffers stay in the index until they are emptied, so the probe skips anything not in use.
 ***********************************************************************************************************************/
 static void FindRxBuffer( const uint8_t *macAddr, RxBufferTracking_s **matchingBuffer )
 {
-   uint16_t i;
+   RxBufferTracking_s *rxBuff;
+   uint16_t slot;
    *matchingBuffer = NULL;
 
-   for (i = 0; i < NUM_CONCURRENT_RX_BUFFERS; i++)
+   slot = AddrIndexHome( &RxBufferIndex, macAddr );
+   while ( RxBufferSlots[slot] != 0 )
    {
-      if ( ( RxBuffers.Buffers[i].state == eMAC_RXBUFF_INUSE ) &&
-           ( memcmp( RxBuffers.Buffers[i].srcAddr, macAddr, MAC_ADDRESS_SIZE) == 0 ) )
+      rxBuff = &RxBuffers.Buffers[ RxBufferSlots[slot] - 1 ];
+      if ( ( rxBuff->state == eMAC_RXBUFF_INUSE ) &&
+           ( memcmp( rxBuff->srcAddr, macAddr, MAC_ADDRESS_SIZE) == 0 ) )
       {
-         *matchingBuffer = &RxBuffers.Buffers[i];
+         *matchingBuffer = rxBuff;
          break;
       }
+      slot = (uint16_t)( ( slot + 1 ) & RxBufferIndex.mask );
    }
 }
 
@@ -1029,71 +1244,94 @@ Arguments:
    matchingPair - Populated with address if matching Packet ID pair was found.  Populated with NULL otherwise.
 
 Returns: none
+
+Notes: Pairs released by their tracking timer stay in the index until FindUnusedPacketIdPair reclaims them.
 ***********************************************************************************************************************/
 static void FindPacketIdPair( const uint8_t *macAddr, PacketIdPair_s **matchingPair )
 {
-   uint16_t i;
+   PacketIdPair_s *pair;
+   uint16_t slot;
    *matchingPair = NULL;
 
-   for (i = 0; i < NUM_NODES_TRACKED; i++)
+   slot = AddrIndexHome( &PacketIdIndex, macAddr );
+   while ( PacketIdSlots[slot] != 0 )
    {
+      pair = &PacketIdPairs[ PacketIdSlots[slot] - 1 ];
       /* check if device has been heard from recently */
-      if ( ( PacketIdPairs[i].inUse ) && ( memcmp( PacketIdPairs[i].macAddr, macAddr, MAC_ADDRESS_SIZE) == 0 ) )
+      if ( ( pair->inUse ) && ( memcmp( pair->macAddr, macAddr, MAC_ADDRESS_SIZE) == 0 ) )
       {
-         *matchingPair = &PacketIdPairs[i];
+         *matchingPair = pair;
          break;
       }
+      slot = (uint16_t)( ( slot + 1 ) & PacketIdIndex.mask );
    }
 }
 
 /***********************************************************************************************************************
 Function Name: FindUnusedRxBuffer
 
-Purpose:  search rx buffers for an unused buffer
+Purpose:  take an unused buffer off the rx buffer free list
 
 Arguments:
    unusedBuffer - Populated with buffer address if unsued buffer was found.  Populated with NULL otherwise.
 
 Returns: none
+
+Notes: The caller adds the buffer to RxBufferIndex once its source address is filled in.
 ***********************************************************************************************************************/
 static void FindUnusedRxBuffer( RxBufferTracking_s **unusedBuffer )
 {
-   uint16_t i;
    *unusedBuffer = NULL;
 
-   for (i = 0; i < NUM_CONCURRENT_RX_BUFFERS; i++)
+   if ( RxBufferIndex.freeCount > 0 )
    {
-      if ( RxBuffers.Buffers[i].state == eMAC_RXBUFF_UNUSED )
-      {
-         *unusedBuffer = &RxBuffers.Buffers[i];
-         break;
-      }
+      *unusedBuffer = &RxBuffers.Buffers[ RxBufferIndex.freeList[ --RxBufferIndex.freeCount ] ];
    }
 }
 
 /***********************************************************************************************************************
 Function Name: FindUnusedPacketIdPair
 
-Purpose:  search packet ID pair tracking for an unused entry
+Purpose:  take an unused entry off the packet ID pair free list
 
 Arguments:
    unusedBuffer - Populated with tracking entry address if unsued entry was found.  Populated with NULL otherwise.
 
 Returns: none
+
+Notes: The tracking timer releases a pair from the timer task by clearing inUse, so released pairs are still in the
+   index.  When the free list runs dry all released pairs are swept out of the index and back onto the free list.
+   The caller adds the pair to PacketIdIndex once its address is filled in.
 ***********************************************************************************************************************/
 static void FindUnusedPacketIdPair( PacketIdPair_s **unusedPair )
 {
-   uint16_t i;
+   uint16_t slot;
+   uint16_t entry;
    *unusedPair = NULL;
 
-   for (i = 0; i < NUM_NODES_TRACKED; i++)
+   if ( PacketIdIndex.freeCount == 0 )
    {
-      if ( ! PacketIdPairs[i].inUse )
+      slot = 0;
+      while ( slot <= PacketIdIndex.mask )
       {
-         *unusedPair = &PacketIdPairs[i];
-         break;
+         entry = PacketIdSlots[slot];
+         if ( ( entry != 0 ) && ( ! PacketIdPairs[entry - 1].inUse ) )
+         {
+            /* Removing may shift a later entry into this slot, so check the slot again */
+            AddrIndexRemoveSlot( &PacketIdIndex, slot );
+            PacketIdIndex.freeList[PacketIdIndex.freeCount++] = (uint16_t)( entry - 1 );
+         }
+         else
+         {
+            slot++;
+         }
       }
    }
+
+   if ( PacketIdIndex.freeCount > 0 )
+   {
+      *unusedPair = &PacketIdPairs[ PacketIdIndex.freeList[ --PacketIdIndex.freeCount ] ];
+   }
 }
 
 /***********************************************************************************************************************
@@ -1121,20 +1359,10 @@ bool MAC_FrameManag_IsPacketInReassembly()
  */
 bool MAC_FrameManag_IsUnitTransmitting(uint8_t const mac_addr[MAC_ADDRESS_SIZE])
 {
-   uint16_t i;
-   bool bPacketInReassembly = (bool)false;
-   for (i = 0; i < NUM_CONCURRENT_RX_BUFFERS; i++)
-   {
-      if ( RxBuffers.Buffers[i].state == eMAC_RXBUFF_INUSE )
-      {
-         if(memcmp(mac_addr, RxBuffers.Buffers[i].srcAddr, MAC_ADDRESS_SIZE) == 0)
-         {
-            bPacketInReassembly = (bool)true;
-            break;
-         }
-      }
-   }
-   return bPacketInReassembly;
+   RxBufferTracking_s *rxBuff;
+
+   FindRxBuffer(mac_addr, &rxBuff);
+   return ( rxBuff != NULL );
 }
 
 
@@ -36,6 +36,9 @@
 #define MAX_TX_PACKET_BUFFERS 20 /* number of MAC packets that can be buffered prior to transmission */
 #endif
 
+#define MAC_TX_PRIORITY_LEVELS 8      /* Request priorities are 0 (lowest) to 7 (highest) */
+#define TX_QUEUE_NIL ((uint16_t)0xFFFF)  /* End of a tx queue list */
+
 #if ( DCU == 1 ) // DCU2+
 #define SRFN_TX_DISABLE_TIMEOUT 15 /* Don't disable SRFN for more than 15 seconds */
 #endif
@@ -60,23 +63,62 @@ typedef struct
 
 static MacPacketTracking_s CurrentPacketTracking;
 
+/* Tx queue links for each entry of PacketTxData, kept beside the packets so the queue can be walked and sorted without
+   looking into the upper layer request of each packet */
+typedef struct
+{
+   uint16_t next;             /* Next (newer) packet of the same priority */
+   uint16_t prev;             /* Previous (older) packet of the same priority */
+   uint16_t dropNext;         /* Next droppable packet of the same priority */
+   uint16_t dropPrev;         /* Previous droppable packet of the same priority */
+   uint8_t  priority;         /* Request priority, copied when the packet is queued */
+   bool     droppable;        /* Request droppable flag, copied when the packet is queued */
+   bool     queued;           /* Packet is waiting in a priority FIFO */
+} TxQueueLink_s;
+
+/* FIFO of the packets waiting at one priority, plus the droppable packets among them */
+typedef struct
+{
+   uint16_t head;
+   uint16_t tail;
+   uint16_t dropHead;
+   uint16_t dropTail;
+} TxQueueBucket_s;
+
 /* CONSTANTS */
 
 /* FILE VARIABLE DEFINITIONS */
 
 /* When messages to transmit are coming in faster than the Radio can send them
-   out (typically head end generated), this queue is where messages buffer up. */
-static OS_List_Obj MAC_PacketTxQueue;
+   out (typically head end generated), this queue is where messages buffer up.
+   The packet being transmitted (txInProgress) stays at the head until it is done.  Behind it packets are sent highest
+   priority first and in arrival order within a priority, so the queue is kept as one FIFO per priority with a bitmap of
+   the non-empty ones. */
+static struct
+{
+   MacPacket_s     *active;                            /* Packet being transmitted, NULL if none */
+   uint16_t         count;                             /* Packets queued, including the active one */
+   uint8_t          busyMap;                           /* Bit n set when priority n has packets waiting */
+   uint8_t          dropMap;                           /* Bit n set when priority n has droppable packets waiting */
+   TxQueueBucket_s  bucket[MAC_TX_PRIORITY_LEVELS];
+} MAC_PacketTxQueue;
 static BUF_Obj MAC_PacketTxBufObj;
 
 #if ( DCU == 1 )
 static MacPacket_s PacketTxData[MAX_TX_PACKET_BUFFERS] @ "EXTERNAL_RAM" ; /*lint !e430*/
+static TxQueueLink_s TxQueueLinks[MAX_TX_PACKET_BUFFERS] @ "EXTERNAL_RAM" ; /*lint !e430*/
 #else
 static MacPacket_s PacketTxData[MAX_TX_PACKET_BUFFERS];
+static TxQueueLink_s TxQueueLinks[MAX_TX_PACKET_BUFFERS];
 #endif
 
 /* FUNCTION PROTOTYPES */
-static bool PrioritizeAndInsert( MacPacket_s *packet );
+static void PrioritizeAndInsert( MacPacket_s *packet );
+static bool EvictForPriority( uint8_t priority, MacPacket_s **packet );
+static void NotifyPacketDone( MacPacket_s const *packet, MAC_DataReq_t const *macRequest, MAC_DATA_STATUS_e status );
+static MacPacket_s *TxQueueHead( void );
+static void TxQueueRemove( MacPacket_s *packet );
+static void TxQueueSetActive( MacPacket_s *packet );
 
 /* FUNCTION DEFINITIONS */
 
@@ -97,12 +139,21 @@ returnStatus_t MAC_PacketManag_init ( void )
 {
 /* Local Variables */
    returnStatus_t RetVal = eSUCCESS;
+   uint8_t        i;
 /* End Local Variables */
 
-   if ( !OS_LINKEDLIST_Create(&MAC_PacketTxQueue) )
+   MAC_PacketTxQueue.active  = NULL;
+   MAC_PacketTxQueue.count   = 0;
+   MAC_PacketTxQueue.busyMap = 0;
+   MAC_PacketTxQueue.dropMap = 0;
+   for ( i = 0; i < MAC_TX_PRIORITY_LEVELS; i++ )
    {
-      RetVal = eFAILURE;
-   } /* end if() */
+      MAC_PacketTxQueue.bucket[i].head     = TX_QUEUE_NIL;
+      MAC_PacketTxQueue.bucket[i].tail     = TX_QUEUE_NIL;
+      MAC_PacketTxQueue.bucket[i].dropHead = TX_QUEUE_NIL;
+      MAC_PacketTxQueue.bucket[i].dropTail = TX_QUEUE_NIL;
+   }
+   (void)memset(TxQueueLinks, 0, sizeof(TxQueueLinks));
 
    if ( !BUF_Create(&MAC_PacketTxBufObj, &(PacketTxData[0]), MAX_TX_PACKET_BUFFERS, sizeof(MacPacket_s)) )
    {
@@ -136,7 +187,7 @@ bool MAC_PacketManag_IsTxMessagePending(MacPacket_s **PacketData)
 {
    MacPacket_s *pPacketData;
 
-   pPacketData = OS_LINKEDLIST_Head ( &MAC_PacketTxQueue );
+   pPacketData = TxQueueHead();
 
    if ( NULL != pPacketData )
    {
@@ -162,31 +213,29 @@ Returns: true/false
 bool MAC_PacketManag_Purge (uint16_t handle )
 {
    MacPacket_s *PacketData;
-   int i;
-   uint16_t numElements;
+   uint16_t i;
    MAC_DataReq_t *macRequest;
-   numElements = OS_LINKEDLIST_NumElements ( &MAC_PacketTxQueue );
 
-   INFO_printf("numElements = %d:",  numElements);
+   INFO_printf("numElements = %d:",  MAC_PacketTxQueue.count);
 
-   if ( numElements > 0 )
+   /* Purging is rare, so just look at every tx buffer that is queued */
+   for ( i=0; i<MAX_TX_PACKET_BUFFERS; i++ )
    {
-      PacketData = OS_LINKEDLIST_Head ( &MAC_PacketTxQueue );
-      for ( i=0; i<numElements; i++ )
+      PacketData = &PacketTxData[i];
+      if ( ( PacketData == MAC_PacketTxQueue.active ) || ( TxQueueLinks[i].queued ) )
       {
          macRequest = MAC_GetDataReqFromBuffer( (buffer_t*)(PacketData->memToFree) );
 
          INFO_printf("handle = %d", macRequest->handle);
          if(macRequest->handle == handle)
          {
-            OS_LINKEDLIST_Remove ( &MAC_PacketTxQueue, PacketData );
+            TxQueueRemove( PacketData );
             if ( BUF_Put(&MAC_PacketTxBufObj, PacketData) != BUF_ERR_NONE )
             {
                DBG_logPrintf('E',"BUF_PUT failed" );
             }
             return (bool)true;
          }
-         PacketData = OS_LINKEDLIST_Next ( &MAC_PacketTxQueue, PacketData );
       }
    }
    return (bool)false;
@@ -206,24 +255,19 @@ Returns: true/false
 bool MAC_PacketManag_Flush ( void )
 {
    MacPacket_s *PacketData;
-   int i;
-   uint16_t numElements;
-   numElements = OS_LINKEDLIST_NumElements ( &MAC_PacketTxQueue );
-   INFO_printf("numElements = %d:",  numElements);
 
-   if ( numElements > 0 )
+   INFO_printf("numElements = %d:",  MAC_PacketTxQueue.count);
+
+   PacketData = TxQueueHead();
+   while ( PacketData != NULL )
    {
-      PacketData = OS_LINKEDLIST_Head ( &MAC_PacketTxQueue );
-      for ( i=0; i<numElements; i++ )
+      INFO_printf("handle = %d", PacketData->handle);
+      TxQueueRemove( PacketData );
+      if ( BUF_Put(&MAC_PacketTxBufObj, PacketData) != BUF_ERR_NONE )
       {
-         INFO_printf("handle = %d", PacketData->handle);
-         OS_LINKEDLIST_Remove ( &MAC_PacketTxQueue, PacketData );
-         if ( BUF_Put(&MAC_PacketTxBufObj, PacketData) != BUF_ERR_NONE )
-         {
-            DBG_logPrintf('E',"BUF_PUT failed" );
-         }
-         PacketData = OS_LINKEDLIST_Next ( &MAC_PacketTxQueue, PacketData );
+         DBG_logPrintf('E',"BUF_PUT failed" );
       }
+      PacketData = TxQueueHead();
    }
    return (bool)true;
 }
@@ -248,7 +292,7 @@ MacPacket_s *MAC_PacketManag_GetNextTxMsg ( void )
    MAC_DataReq_t *macRequest;
    static uint16_t maxTxPayload = PHY_DEFAULT_TX_PAYLOAD; // Use a static variable because we want to avoid changing the segment size in the middle of segmenting a frame.
 
-   PacketData = OS_LINKEDLIST_Head ( &MAC_PacketTxQueue );
+   PacketData = TxQueueHead();
    if ( NULL != PacketData )
    {
       macRequest = MAC_GetDataReqFromBuffer(PacketData->memToFree);
@@ -257,6 +301,7 @@ MacPacket_s *MAC_PacketManag_GetNextTxMsg ( void )
       {
          /* this new packet is now being transmitted */
          PacketData->txInProgress = (bool)true;
+         TxQueueSetActive( PacketData );
          if ( CurrentPacketTracking.retryCount == 0 )
          {
 
@@ -393,7 +438,7 @@ void MAC_PacketManag_Acknowledge ( uint8_t seqNum, MAC_DATA_STATUS_e status )
    uint8_t i;
    MAC_DataReq_t *macRequest;
 
-   PacketData = OS_LINKEDLIST_Head ( &MAC_PacketTxQueue );
+   PacketData = TxQueueHead();
    if ( NULL != PacketData )
    {
       macRequest = MAC_GetDataReqFromBuffer( (buffer_t*)(PacketData->memToFree) );
@@ -462,32 +507,10 @@ void MAC_PacketManag_Acknowledge ( uint8_t seqNum, MAC_DATA_STATUS_e status )
                      }
                   }
                   /* transmission of this packet is complete, notify the upper layer */
-                  if ( macRequest->callback != NULL )
-                  {
-                     (*macRequest->callback)(finalStatus, PacketData->handle);
-                  }
-
-                  // call the confirm handler
-                  {
-                     MAC_Confirm_t Conf;
-                     Conf.Type = eMAC_DATA_CONF;
-                     Conf.handleId = PacketData->handle;
-
-                     // Create the confirmation and call the Confirm Handler
-                     Conf.DataConf.status        = finalStatus;
-                     Conf.DataConf.handle        = PacketData->handle;
-                     Conf.DataConf.payloadLength = macRequest->payloadLength;
-                     MAC_SendConfirm(&Conf, PacketData->memToFree);
-                  }
-
-                  /* free the memory passed down with the upper layer request */
-                  if (NULL != PacketData->memToFree )
-                  {
-                     BM_free(PacketData->memToFree);
-                  }
+                  NotifyPacketDone( PacketData, macRequest, finalStatus );
 
                   /* free the packet from tx buffer */
-                  OS_LINKEDLIST_Remove ( &MAC_PacketTxQueue, PacketData );
+                  TxQueueRemove( PacketData );
                   if ( BUF_Put(&MAC_PacketTxBufObj, PacketData) != BUF_ERR_NONE )
                   {
                      DBG_logPrintf('E',"BUF_PUT failed" );
@@ -534,7 +557,8 @@ bool MAC_Transaction_Create ( buffer_t *macBuffer, uint8_t frameType, bool skip_
    MAC_Request_t *pReq = (MAC_Request_t*)macBuffer->data; /*lint !e740 !e826 payload holds the PHY_DataReq_t information */
    MAC_DataReq_t *macRequest = (MAC_DataReq_t *)&pReq->Service.DataReq;    /*lint !e740 !e826 */
 
-   if ( BUF_Get(&MAC_PacketTxBufObj, (void **)&PacketData) == BUF_ERR_NONE )
+   if ( ( BUF_Get(&MAC_PacketTxBufObj, (void **)&PacketData) == BUF_ERR_NONE ) ||
+        ( EvictForPriority( MAC_GetDataReqFromBuffer( macBuffer )->priority, &PacketData ) ) )
    {
       PacketData->memToFree    = macBuffer;
       PacketData->handle       = macRequest->handle;
@@ -546,14 +570,7 @@ bool MAC_Transaction_Create ( buffer_t *macBuffer, uint8_t frameType, bool skip_
       macRequest->ackRequired = NO_ACK_REQUIRED;
 
       INFO_printf("\t\t>>>packet Total segments:  %u", (MAC_CalcNumSegments(macRequest, PHY_GetMaxTxPayload()) + 1) );
-      returnVal = PrioritizeAndInsert(PacketData);
-      if ( !returnVal )
-      {
-         if ( BUF_Put(&MAC_PacketTxBufObj, PacketData) != BUF_ERR_NONE )
-         {  // Failed, but there is not recovery.  Not sure why this would ever occur!
-            ERR_printf("Unable to return tx queue buffer back" );
-         }
-      }
+      PrioritizeAndInsert(PacketData);
    }else
    {
       ERR_printf("Failed to get a MAC tx queue buffer" );
@@ -570,107 +587,260 @@ bool MAC_Transaction_Create ( buffer_t *macBuffer, uint8_t frameType, bool skip_
 /***********************************************************************************************************************
 Function Name: PrioritizeAndInsert
 
-Purpose: This function attempts to insert a packet into the packet tx queue according to QoS rules
+Purpose: This function inserts a packet into the packet tx queue according to QoS rules: behind any packet of the same
+   or higher priority and ahead of all lower priority packets.
 
   Arguments: MacPacket_s - pointer to the packet to insert
 
-  Returns:  true if packet was successfully added to queue
-            false if the packet did not fit or a memory error occurred
+  Returns: none
+
+  Notes: Requests are validated to priority 0 - 7; anything higher is queued with priority 7.
 ***********************************************************************************************************************/
-static bool PrioritizeAndInsert( MacPacket_s *packet )
+static void PrioritizeAndInsert( MacPacket_s *packet )
 {
-   MacPacket_s *TrackPointPacket;
-   MacPacket_s *QosSortingPacket;
-   uint16_t i;
-   uint16_t NumElements;
-   bool returnVal = (bool)true;
-   MAC_DataReq_t *newMacRequest;
-   MAC_DataReq_t *sortingMacRequest;
+   MAC_DataReq_t   *newMacRequest;
+   TxQueueLink_s   *link;
+   TxQueueBucket_s *bucket;
+   uint16_t         entry;
 
    newMacRequest = MAC_GetDataReqFromBuffer( (buffer_t*)(packet->memToFree) );
 
-   NumElements = OS_LINKEDLIST_NumElements ( &MAC_PacketTxQueue );
-   if ( 0 == NumElements )
+   entry = (uint16_t)( packet - PacketTxData );
+   link  = &TxQueueLinks[entry];
+   link->priority  = min( newMacRequest->priority, MAC_TX_PRIORITY_LEVELS - 1 );
+   link->droppable = newMacRequest->droppable;
+   link->queued    = (bool)true;
+   bucket = &MAC_PacketTxQueue.bucket[link->priority];
+
+   /* Add to the end of the packets of this priority */
+   link->next = TX_QUEUE_NIL;
+   link->prev = bucket->tail;
+   if ( bucket->tail == TX_QUEUE_NIL )
    {
-      /* no existing elements in queue to prioritize against */
-      OS_LINKEDLIST_Enqueue(&MAC_PacketTxQueue, packet); // Function will not return if it fails
+      bucket->head = entry;
    }
    else
    {
-      if ( NumElements == MAX_TX_PACKET_BUFFERS )
+      TxQueueLinks[bucket->tail].next = entry;
+   }
+   bucket->tail = entry;
+   MAC_PacketTxQueue.busyMap |= (uint8_t)( 1U << link->priority );
+
+   link->dropNext = TX_QUEUE_NIL;
+   link->dropPrev = TX_QUEUE_NIL;
+   if ( link->droppable )
+   {
+      link->dropPrev = bucket->dropTail;
+      if ( bucket->dropTail == TX_QUEUE_NIL )
       {
-         /* queue is full, see if an existing element is both droppable & lower priority than the new element */
-         QosSortingPacket = OS_LINKEDLIST_Head ( &MAC_PacketTxQueue );
-         TrackPointPacket = NULL;
-         /* find the lowest priority packet that is droppable and drop it */
-         for ( i=0; i<NumElements; i++ )
-         {
-            sortingMacRequest = MAC_GetDataReqFromBuffer( (buffer_t*)(QosSortingPacket->memToFree) );
-            if ( ( sortingMacRequest->droppable ) &&
-                 ( !QosSortingPacket->txInProgress ) &&
-                 ( sortingMacRequest->priority >= newMacRequest->priority ) )
-            {
-               /* we found a droppable element, but keep searching in case there is an even lower priority candidate */
-               TrackPointPacket = QosSortingPacket;
-            }
-            QosSortingPacket = OS_LINKEDLIST_Next( &MAC_PacketTxQueue, QosSortingPacket );
-         }
-         if (TrackPointPacket == NULL)
+         bucket->dropHead = entry;
+      }
+      else
+      {
+         TxQueueLinks[bucket->dropTail].dropNext = entry;
+      }
+      bucket->dropTail = entry;
+      MAC_PacketTxQueue.dropMap |= (uint8_t)( 1U << link->priority );
+   }
+   MAC_PacketTxQueue.count++;
+}
+
+/***********************************************************************************************************************
+Function Name: EvictForPriority
+
+Purpose: Called when every tx buffer is in use.  Drops the lowest priority droppable packet that is not being
+   transmitted and is lower priority than the new packet, so its buffer can be used for the new packet.  Among packets
+   of that priority the most recently queued one is dropped.
+
+  Arguments: priority - priority of the new packet
+             packet - populated with the freed buffer if a packet was dropped
+
+  Returns:  true if a packet was dropped, false if the new packet must be dropped instead
+***********************************************************************************************************************/
+static bool EvictForPriority( uint8_t priority, MacPacket_s **packet )
+{
+   MacPacket_s *dropPacket;
+   uint8_t      candidates;
+   uint8_t      bit = 0;
+   bool         evicted = (bool)false;
+
+   candidates = MAC_PacketTxQueue.dropMap & (uint8_t)( ( 1U << min( priority, MAC_TX_PRIORITY_LEVELS - 1 ) ) - 1U );
+   if ( candidates == 0 )
+   {
+      DBG_logPrintf('I',"Transmit queue full, new packet tx request will be dropped" );
+   }
+   else
+   {
+      while ( ( candidates & ( 1U << bit ) ) == 0 )
+      {
+         bit++;
+      }
+      dropPacket = &PacketTxData[MAC_PacketTxQueue.bucket[bit].dropTail];
+      TxQueueRemove( dropPacket );
+      DBG_logPrintf('I',"Transmit queue full, dropped packet handle %u for a higher priority packet", dropPacket->handle );
+      NotifyPacketDone( dropPacket, MAC_GetDataReqFromBuffer( dropPacket->memToFree ), eMAC_DATA_TRANSACTION_OVERFLOW );
+      MAC_CounterInc(eMAC_TransactionOverflowCount);
+      *packet = dropPacket;
+      evicted = (bool)true;
+   }
+   return evicted;
+}
+
+/***********************************************************************************************************************
+Function Name: NotifyPacketDone
+
+Purpose: Tell the upper layer a packet is finished (callback and confirmation) and free the request it passed down
+
+  Arguments: packet - the finished packet
+             macRequest - the request held by the packet
+             status - final status of the packet
+
+  Returns: none
+***********************************************************************************************************************/
+static void NotifyPacketDone( MacPacket_s const *packet, MAC_DataReq_t const *macRequest, MAC_DATA_STATUS_e status )
+{
+   MAC_Confirm_t Conf;
+
+   if ( macRequest->callback != NULL )
+   {
+      (*macRequest->callback)(status, packet->handle);
+   }
+
+   // Create the confirmation and call the Confirm Handler
+   Conf.Type = eMAC_DATA_CONF;
+   Conf.handleId = packet->handle;
+   Conf.DataConf.status        = status;
+   Conf.DataConf.handle        = packet->handle;
+   Conf.DataConf.payloadLength = macRequest->payloadLength;
+   MAC_SendConfirm(&Conf, packet->memToFree);
+
+   /* free the memory passed down with the upper layer request */
+   if (NULL != packet->memToFree )
+   {
+      BM_free(packet->memToFree);
+   }
+}
+
+/***********************************************************************************************************************
+Function Name: TxQueueHead
+
+Purpose: Find the next packet to transmit: the one already being transmitted, or else the oldest packet of the highest
+   priority waiting
+
+  Arguments: none
+
+  Returns: the packet, NULL if the queue is empty
+***********************************************************************************************************************/
+static MacPacket_s *TxQueueHead( void )
+{
+   MacPacket_s *packet = MAC_PacketTxQueue.active;
+   uint8_t      bit = MAC_TX_PRIORITY_LEVELS - 1;
+
+   if ( ( packet == NULL ) && ( MAC_PacketTxQueue.busyMap != 0 ) )
+   {
+      while ( ( MAC_PacketTxQueue.busyMap & ( 1U << bit ) ) == 0 )
+      {
+         bit--;
+      }
+      packet = &PacketTxData[MAC_PacketTxQueue.bucket[bit].head];
+   }
+   return packet;
+}
+
+/***********************************************************************************************************************
+Function Name: TxQueueRemove
+
+Purpose: Take a packet out of the tx queue
+
+  Arguments: packet - a packet in the queue
+
+  Returns: none
+***********************************************************************************************************************/
+static void TxQueueRemove( MacPacket_s *packet )
+{
+   TxQueueLink_s   *link;
+   TxQueueBucket_s *bucket;
+
+   if ( packet == MAC_PacketTxQueue.active )
+   {
+      MAC_PacketTxQueue.active = NULL;
+   }
+   else
+   {
+      link   = &TxQueueLinks[packet - PacketTxData];
+      bucket = &MAC_PacketTxQueue.bucket[link->priority];
+
+      if ( link->prev == TX_QUEUE_NIL )
+      {
+         bucket->head = link->next;
+      }
+      else
+      {
+         TxQueueLinks[link->prev].next = link->next;
+      }
+      if ( link->next == TX_QUEUE_NIL )
+      {
+         bucket->tail = link->prev;
+      }
+      else
+      {
+         TxQueueLinks[link->next].prev = link->prev;
+      }
+      if ( bucket->head == TX_QUEUE_NIL )
+      {
+         MAC_PacketTxQueue.busyMap &= (uint8_t)~( 1U << link->priority );
+      }
+
+      if ( link->droppable )
+      {
+         if ( link->dropPrev == TX_QUEUE_NIL )
          {
-            /* no droppable messages found, drop the new element instead */
-            DBG_logPrintf('I',"Transmit queue full, new packet tx request will be dropped" );
-            returnVal = (bool)false;
+            bucket->dropHead = link->dropNext;
          }
          else
          {
-            OS_LINKEDLIST_Remove( &MAC_PacketTxQueue, TrackPointPacket );
+            TxQueueLinks[link->dropPrev].dropNext = link->dropNext;
          }
-      }
-
-      if (returnVal)
-      {
-         /* there is space in the queue, insert this element based on priority */
-         QosSortingPacket = OS_LINKEDLIST_Head ( &MAC_PacketTxQueue );
-         sortingMacRequest = MAC_GetDataReqFromBuffer( (buffer_t*)(QosSortingPacket->memToFree) );
-         if ( (sortingMacRequest->priority < newMacRequest->priority) && (!QosSortingPacket->txInProgress ) )
+         if ( link->dropNext == TX_QUEUE_NIL )
          {
-            /* the first element is lower priority than the new element, add it to the begining */
-            if ( !OS_LINKEDLIST_Insert( &MAC_PacketTxQueue, NULL, packet ) )
-            {
-               returnVal = (bool)false;
-               DBG_logPrintf('E',"OS_LINKEDLIST_Insert(MAC_PacketTxQueue) failed" );
-            }
+            bucket->dropTail = link->dropPrev;
          }
          else
          {
-            /* First element is higher priority than new element or is already transmitting, so start from there */
-            TrackPointPacket = QosSortingPacket;
-            QosSortingPacket = OS_LINKEDLIST_Next( &MAC_PacketTxQueue, QosSortingPacket );
-            for ( i=1; i<NumElements; i++ )
-            {
-               sortingMacRequest = MAC_GetDataReqFromBuffer( (buffer_t*)(QosSortingPacket->memToFree) );
-               if (sortingMacRequest->priority < newMacRequest->priority)
-               {
-                  /* TrackPointPacket points to the previous element, insert after that element */
-                  if ( !OS_LINKEDLIST_Insert( &MAC_PacketTxQueue, TrackPointPacket, packet ) )
-                  {
-                     returnVal = (bool)false;
-                     DBG_logPrintf('E',"OS_LINKEDLIST_Insert(MAC_PacketTxQueue) failed" );
-                  }
-                  break;
-               }
-               TrackPointPacket = QosSortingPacket;
-               QosSortingPacket = OS_LINKEDLIST_Next( &MAC_PacketTxQueue, QosSortingPacket );
-            }
-            if ( NULL == QosSortingPacket )
-            {
-               /* the new element is the lowest priority packet, add to the end */
-               (void)OS_LINKEDLIST_Insert( &MAC_PacketTxQueue, TrackPointPacket, packet );
-            }
+            TxQueueLinks[link->dropNext].dropPrev = link->dropPrev;
+         }
+         if ( bucket->dropHead == TX_QUEUE_NIL )
+         {
+            MAC_PacketTxQueue.dropMap &= (uint8_t)~( 1U << link->priority );
          }
       }
+      link->next     = TX_QUEUE_NIL;
+      link->prev     = TX_QUEUE_NIL;
+      link->dropNext = TX_QUEUE_NIL;
+      link->dropPrev = TX_QUEUE_NIL;
+      link->queued   = (bool)false;
+   }
+   MAC_PacketTxQueue.count--;
+}
+
+/***********************************************************************************************************************
+Function Name: TxQueueSetActive
+
+Purpose: Mark the head packet as being transmitted.  It stays at the head of the queue, ahead of any higher priority
+   packet queued later, and can't be dropped until it is removed.
+
+  Arguments: packet - the head of the queue
+
+  Returns: none
+***********************************************************************************************************************/
+static void TxQueueSetActive( MacPacket_s *packet )
+{
+   if ( packet != MAC_PacketTxQueue.active )
+   {
+      TxQueueRemove( packet );
+      MAC_PacketTxQueue.active = packet;
+      MAC_PacketTxQueue.count++;
    }
-   return returnVal;
 }
 
 /***********************************************************************************************************************
@@ -24,6 +24,9 @@
 #include <stdint.h>
 #include "SoftDemodulator.h" //NUMBER_OF_FILTER_TAPS
 #include "fir_filt_circ_buff.h"
+#ifdef TM_SOFTDEMOD_UNIT_TEST
+#include "DBG_SerialDebug.h"
+#endif
 
 // Glenn's 16 tap filter
 //static const float fv0[NUMBER_OF_FILTER_TAPS] = {
@@ -128,15 +131,106 @@ static const float fv0[NUMBER_OF_FILTER_TAPS] = {
 /* Variable Definitions */
 static uint32_t multiple_of_FSPE;
 
+#if ( SD_FIR_KERNEL == SD_FIR_Q15 )
+/* The inputs are resampled 7 bit frequency samples (-64 to 63), kept with 8 fractional bits. A folded pair of them
+   (-32768 to 32256) still fits in 16 bits. The resampler can overshoot, so samples are saturated to half the 16 bit
+   range to keep SADD16 (which wraps) from overflowing. Taps are Q15, the accumulator is Q23. */
+#define FIR_Q15_IN_SCALE   256.0F
+#define FIR_Q15_OUT_SCALE  ( 1.0F / ( FIR_Q15_IN_SCALE * 32768.0F ) )
+#define FIR_Q15_TAP_MAX    32767.0F                        /* Taps saturate to -32768 to 32767 */
+#define FIR_Q15_SAMPLE_MAX 16383.0F                        /* Samples saturate to -16384 to 16383 */
+#define FIR_TAP_PAIRS      ( NUMBER_OF_FILTER_TAPS / 2 )  /* Folded (symmetric) sample pairs per output */
+
+#if defined( __ICCARM__ )
+#define FIR_SADD16( a, b )       __SADD16( (a), (b) )
+#define FIR_SMLAD( a, b, acc )   (int32_t)__SMLAD( (a), (b), (uint32_t)(acc) )
+#define FIR_SWAP16( a )          __ROR( (a), 16 )
+#else
+/* Portable equivalents of the Cortex-M4 DSP instructions */
+static inline uint32_t FIR_SADD16( uint32_t a, uint32_t b )
+{
+   return ( (uint32_t)(uint16_t)( (int16_t)a + (int16_t)b ) ) |
+          ( (uint32_t)(uint16_t)( (int16_t)( a >> 16 ) + (int16_t)( b >> 16 ) ) << 16 );
+}
+static inline int32_t FIR_SMLAD( uint32_t a, uint32_t b, int32_t acc )
+{
+   return acc + ( (int32_t)(int16_t)a * (int16_t)b ) + ( (int32_t)(int16_t)( a >> 16 ) * (int16_t)( b >> 16 ) );
+}
+#define FIR_SWAP16( a )          ( ( (a) >> 16 ) | ( (a) << 16 ) )
+#endif
+
+/* Symmetric taps 0-15 in Q15, two per word: tap j in the low half, tap j + 1 in the high half */
+static uint32_t firTapPairs_[NUMBER_OF_FILTER_TAPS / 4];
+
+/* Circular history. Word k holds samples k (low half) and k + 1 (high half) so any two consecutive samples can be
+   read with one aligned word read, and words k and k + NUMBER_OF_FILTER_TAPS hold the same samples so the window
+   never wraps. */
+static union
+{
+   uint32_t pair[2 * NUMBER_OF_FILTER_TAPS];
+   int16_t  sample[4 * NUMBER_OF_FILTER_TAPS];
+} firHistory_;
+static uint32_t firNewest_;   /* Word holding the newest sample in its low half */
+#endif
+
 /* Function Definitions */
+#if ( SD_FIR_KERNEL == SD_FIR_Q15 )
+/* Round to the nearest integer, saturated to -( max + 1 ) to max */
+static int16_t fir_q15_round(float x, float max)
+{
+   x += ( x >= 0.0F ) ? 0.5F : -0.5F;
+   if ( x > max )
+   {
+      x = max;
+   }
+   else if ( x < ( -max - 1.0F ) )
+   {
+      x = -max - 1.0F;
+   }
+   return (int16_t)x;
+}
+
+/* Filter one sample with the fixed point kernel */
+static float fir_q15_sample(float input)
+{
+   uint32_t first;   /* Word holding the oldest sample of the window in its low half */
+   uint32_t j;
+   int32_t  acc = 0;
+   int16_t  x;
+
+   x = fir_q15_round( input * FIR_Q15_IN_SCALE, FIR_Q15_SAMPLE_MAX );
+   firNewest_ = ( firNewest_ + 1 ) % NUMBER_OF_FILTER_TAPS;
+   first      = ( firNewest_ + 1 ) % NUMBER_OF_FILTER_TAPS;
+
+   /* Newest sample is the low half of its word and the high half of the previous word (and their copies) */
+   firHistory_.sample[  2 * firNewest_ ] = x;
+   firHistory_.sample[( 2 * firNewest_ ) + ( 2 * NUMBER_OF_FILTER_TAPS )] = x;
+   j = ( firNewest_ + NUMBER_OF_FILTER_TAPS - 1 ) % NUMBER_OF_FILTER_TAPS;
+   firHistory_.sample[( 2 * j ) + 1] = x;
+   firHistory_.sample[( 2 * j ) + 1 + ( 2 * NUMBER_OF_FILTER_TAPS )] = x;
+
+   /* Window w[0..31] is oldest to newest, words first .. first + 30. w[j] + w[31 - j] and w[j + 1] + w[30 - j] are
+      added in one SADD16 (word first + 30 - j swapped), then multiplied by taps j and j + 1 in one SMLAD. */
+   for ( j = 0; j < FIR_TAP_PAIRS; j += 2 )
+   {
+      acc = FIR_SMLAD( FIR_SADD16( firHistory_.pair[first + j],
+                                   FIR_SWAP16( firHistory_.pair[first + NUMBER_OF_FILTER_TAPS - 2 - j] ) ),
+                       firTapPairs_[j / 2], acc );
+   }
+   return (float)acc * FIR_Q15_OUT_SCALE;
+}
+#endif
+
 boolean_T fir_filt_circ_buff(unProcessedData_t *unProcessedData)
 {
    bool samplesAvailable = false;
    float acc;
    uint32_t n;
+#if ( SD_FIR_KERNEL != SD_FIR_Q15 )
    uint32_t j;
    float *src;
    float *dest;
+#endif
    //float const *tap;
 
    /* PURPOSE: fixed-point FIR filter with persistent variable for buffer, buffer_pointer
@@ -146,25 +240,37 @@ boolean_T fir_filt_circ_buff(unProcessedData_t *unProcessedData)
       9Nov17: Initial version replaces in-line-code in DemodPhaseSeqFromIC6_fw.m
       6/17/19: Optimized for loops, reduced variables, changed to native types,
                changed input data structure, reducing CPU load from 18.3% to 8.9%
-
-      To-Do : This module can be substituted with arm-library CMSIS optimized
-      code. Need to get the function syntax and adjust the arguments if
-      necessary. If embedded coder license is available, then need to figure
-      out how to do code substitutions, it not manually call the function.
+      SD_FIR_KERNEL selects the kernel. The taps are symmetric (fv0[j] == fv0[31 - j]), so SD_FIR_SYMMETRIC adds the
+               two samples of each tap pair and multiplies once, and SD_FIR_Q15 does the same on 16 bit samples, two
+               pairs per SMLAD, with its own circular history (unProcessedData->history is not used). The CMSIS-DSP
+               arm_fir_q15/arm_fir_f32 kernels were not used: they do not fold symmetric taps, so they do twice the
+               multiplies of SD_FIR_Q15/SD_FIR_SYMMETRIC.
+      fir_filt_circ_buff_unitTest compares the selected kernel with the direct float filter.
       FirFiltBuff, ptrBuff variables maintain state-of-filter from call to call */
 
    for (n = 0; n < unProcessedData->size; n++)
    {
+#if ( SD_FIR_KERNEL == SD_FIR_Q15 )
+      acc = fir_q15_sample(unProcessedData->data[n]);
+#else
       acc = 0.0F;
       src = &unProcessedData->history[n]; //Start processing the first 31 historical values and then the 1st
                                           // recent value. As this slides it will move out of the historical
                                           // data completely.
+#if ( SD_FIR_KERNEL == SD_FIR_SYMMETRIC )
+      for (j = 0; j < (NUMBER_OF_FILTER_TAPS / 2); j++)
+      {
+         acc += fv0[j] * (src[j] + src[(NUMBER_OF_FILTER_TAPS - 1) - j]);
+      }
+#else
       for (j = 0; j < NUMBER_OF_FILTER_TAPS; j++)
       {
          acc += fv0[j] * *src++;
          /*Manually unrolling this provides no benefit over the current compiler
            optimization (high optimization for speed)*/
       }
+#endif
+#endif
 
       filteredPhaseSamplesBuffer[filteredPhaseSamplesBufferWriteIndex++] = acc;
 
@@ -180,6 +286,7 @@ boolean_T fir_filt_circ_buff(unProcessedData_t *unProcessedData)
       }
    }
 
+#if ( SD_FIR_KERNEL != SD_FIR_Q15 )
    //Once the filter has been applied to everything, move the last 31 samples into the historical buffer
    //Doing this manually is faster than calling memcpy
    dest = &unProcessedData->history[0];
@@ -196,11 +303,107 @@ boolean_T fir_filt_circ_buff(unProcessedData_t *unProcessedData)
       optimization for speed set to high), manually unrolling doesn't do much. So
       for the sake of flexibility the above code is used (in case the number of
       taps changes), assuming the compiler does some unrolling.*/
+#endif
 
    return samplesAvailable;
 }
 
 void fir_filt_circ_buff_init(void)
 {
+#if ( SD_FIR_KERNEL == SD_FIR_Q15 )
+   uint32_t j;
+
+#endif
    multiple_of_FSPE = FILTERED_SAMPLES_PER_EVENT;
-}
\ No newline at end of file
+#if ( SD_FIR_KERNEL == SD_FIR_Q15 )
+   for (j = 0; j < FIR_TAP_PAIRS; j += 2)
+   {
+      firTapPairs_[j / 2] = (uint32_t)(uint16_t)fir_q15_round( fv0[j] * 32768.0F, FIR_Q15_TAP_MAX ) |
+                            ( (uint32_t)(uint16_t)fir_q15_round( fv0[j + 1] * 32768.0F, FIR_Q15_TAP_MAX ) << 16 );
+   }
+   (void)memset(&firHistory_, 0, sizeof(firHistory_));
+   firNewest_ = 0;
+#endif
+}
+
+#ifdef TM_SOFTDEMOD_UNIT_TEST
+#define FIR_UT_SAMPLES     1024U    /* Samples compared */
+#define FIR_UT_MAX_ERROR   0.05F    /* Allowed difference, in frequency steps (input is -64 to 63) */
+#define FIR_UT_OVERRANGE   200.0F   /* Input past the Q15 sample range */
+
+/*****************************************************************************************************************
+
+   Function name: fir_filt_circ_buff_unitTest
+
+   Purpose: Filter pseudo random in range samples with the Q15 kernel and with the direct float filter and report the
+            largest difference, then check that an out of range input saturates instead of wrapping.
+
+   Arguments: None
+
+   Returns: bool - true if the Q15 output is within FIR_UT_MAX_ERROR of the float output and saturates
+
+   Side effects: Resets the filter state (fir_filt_circ_buff_init), so it must not run while the radio uses the soft
+                 demodulator.
+
+   Reentrant: No
+
+  *****************************************************************************************************************/
+bool fir_filt_circ_buff_unitTest(void)
+{
+   bool passed = (bool)true;
+#if ( SD_FIR_KERNEL == SD_FIR_Q15 )
+   float    window[NUMBER_OF_FILTER_TAPS] = {0};  /* Float filter history, oldest first */
+   float    input;
+   float    ref;
+   float    out = 0.0F;
+   float    maxError = 0.0F;
+   float    error;
+   uint32_t seed = 1;
+   uint32_t n;
+   uint32_t j;
+
+   fir_filt_circ_buff_init();
+   for (n = 0; n < FIR_UT_SAMPLES; n++)
+   {
+      seed  = ( seed * 1664525UL ) + 1013904223UL;    /* Numerical Recipes LCG */
+      input = ( (float)( seed >> 8 ) / 131072.0F ) - 64.0F;  /* -64 to 64 */
+      input = ( input > 63.0F ) ? 63.0F : input;
+      (void)memmove(&window[0], &window[1], sizeof(window) - sizeof(window[0]));
+      window[NUMBER_OF_FILTER_TAPS - 1] = input;
+      ref = 0.0F;
+      for (j = 0; j < NUMBER_OF_FILTER_TAPS; j++)
+      {
+         ref += fv0[j] * window[j];
+      }
+      error = fabsf( fir_q15_sample(input) - ref );
+      maxError = ( error > maxError ) ? error : maxError;
+   }
+   passed = ( maxError <= FIR_UT_MAX_ERROR );
+   DBG_logPrintf('U', "FIR Q15 vs float: %lu samples, max error %lu/1000 (limit %lu/1000) %s", FIR_UT_SAMPLES,
+                 (uint32_t)( maxError * 1000.0F ), (uint32_t)( FIR_UT_MAX_ERROR * 1000.0F ), passed ? "PASS" : "FAIL");
+
+   /* A constant over range input must saturate to the largest sample, not wrap to a negative one */
+   fir_filt_circ_buff_init();
+   for (n = 0; n < NUMBER_OF_FILTER_TAPS; n++)
+   {
+      out = fir_q15_sample(FIR_UT_OVERRANGE);
+   }
+   ref = 0.0F;
+   for (j = 0; j < NUMBER_OF_FILTER_TAPS; j++)
+   {
+      ref += fv0[j] * ( FIR_Q15_SAMPLE_MAX / FIR_Q15_IN_SCALE );
+   }
+   if ( fabsf( out - ref ) > FIR_UT_MAX_ERROR )
+   {
+      passed = (bool)false;
+   }
+   DBG_logPrintf('U', "FIR Q15 saturation: output %ld/1000 (expected %ld/1000) %s", (int32_t)( out * 1000.0F ),
+                 (int32_t)( ref * 1000.0F ), ( fabsf( out - ref ) <= FIR_UT_MAX_ERROR ) ? "PASS" : "FAIL");
+
+   fir_filt_circ_buff_init();
+#else
+   DBG_logPrintf('U', "FIR Q15 test skipped: SD_FIR_KERNEL is not SD_FIR_Q15");
+#endif
+   return passed;
+}
+#endif
\ No newline at end of file
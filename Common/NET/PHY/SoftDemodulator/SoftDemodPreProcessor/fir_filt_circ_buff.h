@@ -32,6 +32,15 @@
 
 #define NUMBER_OF_FILTER_TAPS 32
 
+/* FIR kernel selection */
+#define SD_FIR_DIRECT      0  /* Float, one multiply per tap (original kernel) */
+#define SD_FIR_SYMMETRIC   1  /* Float, symmetric taps folded: one multiply per pair of taps */
+#define SD_FIR_Q15         2  /* Fixed point, symmetric taps folded, two taps per dual 16 bit MAC (SMLAD) */
+
+#ifndef SD_FIR_KERNEL
+#define SD_FIR_KERNEL      SD_FIR_SYMMETRIC
+#endif
+
 /* Function Declarations */
 
 //extern boolean_T fir_filt_circ_buff(const float Inp[225], uint32_t lenInp); //old
@@ -40,5 +49,8 @@ extern boolean_T fir_filt_circ_buff(unProcessedData_t *unProcessedData);
 #endif
 
 extern void fir_filt_circ_buff_init(void);
+#ifdef TM_SOFTDEMOD_UNIT_TEST
+extern bool fir_filt_circ_buff_unitTest(void);
+#endif
 
 #endif
\ No newline at end of file
@@ -70,6 +70,27 @@ static bool SD_Unblock_Sync_Payload_Task(void);
 static void SD_ReleaseFilteredSamplesSemaphore(uint8_t id);
 static bool SD_FindSync( int8_t *buf, uint32_t size, uint32_t intFIFOCYCCNTTimeStamp );
 
+#if ( ( TM_SD_STAGE_TIMING == 1 ) || defined( TM_SOFTDEMOD_UNIT_TEST ) )
+typedef struct
+{
+   SD_StageStats_t stats;  /* Only written by the task that runs the stage */
+   volatile bool   clear;  /* Set by SD_GetStageStats, the stats are cleared by their writer on its next call */
+} SD_StageSlot_t;
+
+static void SD_StageDone( SD_StageSlot_t *slot, uint32_t samples, uint32_t *stamp );
+#endif
+
+#if ( TM_SD_STAGE_TIMING == 1 )
+/* Each sync & payload task has its own slot so that every slot has a single writer */
+#define SD_SYNC_PAYLOAD_SLOT(semId)    ( (uint32_t)eSD_STAGE_SYNC_PAYLOAD + (uint32_t)(semId) - 1U )
+#define SD_STAGE_SLOTS                 ( (uint32_t)eSD_STAGE_SYNC_PAYLOAD + SOFT_DEMOD_MAX_SYNC_PAYL_TASKS )
+#define SD_STAGE_START(stamp)          (stamp) = DWT_CYCCNT
+#define SD_STAGE_DONE(slot, samples, stamp) SD_StageDone( &SD_StageSlots[slot], (samples), &(stamp) )
+#else
+#define SD_STAGE_START(stamp)
+#define SD_STAGE_DONE(slot, samples, stamp)
+#endif
+
 OS_EVNT_Obj  SD_Events;
 OS_MUTEX_Obj SD_Payload_Mutex;
 
@@ -82,6 +103,11 @@ static int8_t   rawPhaseSamplesBuffer[RAW_PHASE_SAMPLES_BUFFER_SIZE];
        uint16_t filteredPhaseSamplesBufferWriteIndex = 0;
 static uint16_t preambleDetectorReadIndex = 0;
 
+#if ( TM_SD_STAGE_TIMING == 1 )
+static SD_StageSlot_t SD_StageSlots[SD_STAGE_SLOTS]; // Per stage cycle counts, see SD_GetStageStats
+static uint32_t       SD_StageStatsStartMs = 0;      // When SD_StageSlots were last cleared
+#endif
+
 returnStatus_t SoftDemodulator_Initialize(void)
 {
    returnStatus_t retval = eSUCCESS;
@@ -154,6 +180,94 @@ static void SD_ReleaseFilteredSamplesSemaphore(uint8_t id)
    OS_MUTEX_Unlock(&SD_FilteredPhaseSamples_Mutex);
 }
 
+#if ( ( TM_SD_STAGE_TIMING == 1 ) || defined( TM_SOFTDEMOD_UNIT_TEST ) )
+/*****************************************************************************************************************
+
+   Function name: SD_StageDone
+
+   Purpose: Account the cycles spent in a pipeline stage since *stamp.
+
+   Arguments: SD_StageSlot_t *slot: statistics of the stage that just ran
+              uint32_t samples: number of input samples the stage processed
+              uint32_t *stamp: CYCCNT when the stage started. Updated to now so the next stage can be chained.
+
+   Returns: None
+
+   Side effects: Clears the statistics first when SD_GetStageStats asked for it
+
+   Reentrant: No. Each slot must only be updated from one task, so the fields are written without a critical section.
+
+  *****************************************************************************************************************/
+static void SD_StageDone( SD_StageSlot_t *slot, uint32_t samples, uint32_t *stamp )
+{
+   uint32_t now = DWT_CYCCNT;
+   uint32_t cycles = now - *stamp;
+
+   *stamp = now;
+   if ( slot->clear )
+   {
+      (void)memset( &slot->stats, 0, sizeof(slot->stats) );
+      slot->clear = (bool)false;
+   }
+   slot->stats.calls++;
+   slot->stats.cycles  += cycles;
+   slot->stats.samples += samples;
+   if ( cycles > slot->stats.maxCycles )
+   {
+      slot->stats.maxCycles = cycles;
+   }
+}
+#endif
+
+#if ( TM_SD_STAGE_TIMING == 1 )
+/*****************************************************************************************************************
+
+   Function name: SD_GetStageStats
+
+   Purpose: Return the cycles spent in each stage of the soft demodulator pipeline.
+
+   Arguments: SD_StageStats_t stats[]: Filled with a copy of the statistics of each stage. The sync & payload tasks
+                                       are summed into eSD_STAGE_SYNC_PAYLOAD.
+              uint32_t *elapsedMs: Filled with the time over which the statistics were gathered
+              bool reset: Clear the statistics after reading them
+
+   Returns: None
+
+   Side effects: None
+
+   Reentrant: No. The copy is not atomic: a stage that runs while it is taken may show one call partly accounted.
+
+  *****************************************************************************************************************/
+void SD_GetStageStats( SD_StageStats_t stats[eSD_STAGE_LAST], uint32_t *elapsedMs, bool reset )
+{
+   uint32_t now = OS_TICK_Get_ElapsedMilliseconds();
+   uint32_t slot;
+   uint32_t stage;
+
+   (void)memset( stats, 0, sizeof(SD_StageStats_t) * (uint32_t)eSD_STAGE_LAST );
+   for ( slot = 0; slot < SD_STAGE_SLOTS; slot++ )
+   {
+      stage = min( slot, (uint32_t)eSD_STAGE_SYNC_PAYLOAD );
+      if ( !SD_StageSlots[slot].clear ) /* A pending clear means no call since the last reset */
+      {
+         stats[stage].calls   += SD_StageSlots[slot].stats.calls;
+         stats[stage].cycles  += SD_StageSlots[slot].stats.cycles;
+         stats[stage].samples += SD_StageSlots[slot].stats.samples;
+         stats[stage].maxCycles = max( stats[stage].maxCycles, SD_StageSlots[slot].stats.maxCycles );
+      }
+      if ( reset )
+      {
+         SD_StageSlots[slot].clear = (bool)true;
+      }
+   }
+   *elapsedMs = now - SD_StageStatsStartMs;
+   if ( reset )
+   {
+      SD_StageStatsStartMs = now;
+   }
+}
+#endif
+
 /*****************************************************************************************************************
 
    Function name: SD_FindSync
@@ -295,6 +409,9 @@ void SD_PhaseSamplesListenerTask(taskParameter)
    #if ( RTOS_SELECTION == MQX_RTOS )
    (void)   Arg0;
    #endif
+#if ( TM_SD_STAGE_TIMING == 1 )
+   uint32_t stageStart;
+#endif
 
    for (;;)
    {
@@ -320,21 +437,26 @@ void SD_PhaseSamplesListenerTask(taskParameter)
       memcpy(phase2FreqBuf, &phase2FreqBuf[MAX_PHASE_SAMPLES_FROM_RADIO_PER_INTERRUPT], sizeof(phase2FreqBuf)-MAX_PHASE_SAMPLES_FROM_RADIO_PER_INTERRUPT);
 
 /// Preprocessor part
+      SD_STAGE_START(stageStart);
       // Before optimization: 2905 cycles/call*260.4/120M = 0.63%
       // After  optimization: 1780 cycles/call*260.4/120M = 0.39%
       phase2freq_wi_unwrap((const signed char*)&rawPhaseSamplesBuffer[0], (signed char*)&phase2FreqBuf[sizeof(phase2FreqBuf)-MAX_PHASE_SAMPLES_FROM_RADIO_PER_INTERRUPT], MAX_PHASE_SAMPLES_FROM_RADIO_PER_INTERRUPT);
+      SD_STAGE_DONE(eSD_STAGE_PHASE2FREQ, MAX_PHASE_SAMPLES_FROM_RADIO_PER_INTERRUPT, stageStart);
 
       // Check if we have a SYNC
       // This is necessary for phase detection and better TimeSync timestamps
       (void)SD_FindSync(phase2FreqBuf, sizeof(phase2FreqBuf)/sizeof(phase2FreqBuf[0]), RADIO_Get_IntFIFOCYCCNTTimeStamp((uint8_t)RADIO_0));
+      SD_STAGE_DONE(eSD_STAGE_FIND_SYNC, MAX_PHASE_SAMPLES_FROM_RADIO_PER_INTERRUPT, stageStart);
 
       // Before optimization: 40075 cycles/call*260.4/120M = 8.7%
       // After  optimization: 13542 cycles/call*260.4/120M = 2.9%
       unProcessedData.size = gresample((const signed char*)&phase2FreqBuf[sizeof(phase2FreqBuf)-MAX_PHASE_SAMPLES_FROM_RADIO_PER_INTERRUPT], &unProcessedData.data[0], MAX_PHASE_SAMPLES_FROM_RADIO_PER_INTERRUPT);
+      SD_STAGE_DONE(eSD_STAGE_RESAMPLE, MAX_PHASE_SAMPLES_FROM_RADIO_PER_INTERRUPT, stageStart);
 
       // Before optimization: 82172 cycles/call*260.4/120M = 17.8%
       // After  optimization: 41622 cycles/call*260.4/120M = 9.0%
       samplesAvailable = fir_filt_circ_buff(&unProcessedData);
+      SD_STAGE_DONE(eSD_STAGE_FIR, unProcessedData.size, stageStart);
 /// End of preprocessor
 
       if (samplesAvailable)
@@ -478,6 +600,9 @@ void SD_PreambleDetectorTask(taskParameter)
    boolean_T FoundPA = false;
    uint32_t LoP = 0; //Length_of_Preamble
    uint32_t samplesInPreambleBuffer = 0;
+#if ( TM_SD_STAGE_TIMING == 1 )
+   uint32_t stageStart;
+#endif
    preambleDetector_initialize();
 
    for (;;)
@@ -486,12 +611,14 @@ void SD_PreambleDetectorTask(taskParameter)
       // Before optimization: 153k cycles* (781/3)/120M = 33.2% of CPU
       // After optimization: 31561 cycles * (781/3)/120M = 6.8% of CPU
       //DBG_LW_printf("\nPREPRO: [%d] ",preambleDetectorReadIndex);
+      SD_STAGE_START(stageStart);
       preambleDetector(&filteredPhaseSamplesBuffer[preambleDetectorReadIndex],
                        resetPreambleDetector,
                        &FoundPA,
                        &LoP,
                        &samplesInPreambleBuffer,
                        &MeanMaxAbsIFrq);
+      SD_STAGE_DONE(eSD_STAGE_PREAMBLE, FILTERED_SAMPLES_PER_EVENT, stageStart);
       resetPreambleDetector = false;
       preambleDetectorReadIndex += FILTERED_SAMPLES_PER_EVENT;
       if (preambleDetectorReadIndex == FILTERED_PHASE_SAMPLES_BUFFER_SIZE)
@@ -581,6 +708,9 @@ void SD_SyncPayloadDemodTask(taskParameter)
 #endif
    eSyncAndPayloadDemodFailCodes_t FailureCode;
    uint16_t readIndex;
+#if ( TM_SD_STAGE_TIMING == 1 )
+   uint32_t stageStart;
+#endif
 
    for (;;)
    {
@@ -621,9 +751,11 @@ void SD_SyncPayloadDemodTask(taskParameter)
          if (OS_SEM_Pend(&SD_FilteredPhaseSamplesSemaphores[semId].semaphore, 100) == true)
          {
             //DBG_LW_printf("DEMOD%d: [%d] ",semId,readIndex);
+            SD_STAGE_START(stageStart);
             SyncAndPayloadDemodulator(&SPD_Pers,
                                       &filteredPhaseSamplesBuffer[readIndex],
                                       &FailureCode);
+            SD_STAGE_DONE(SD_SYNC_PAYLOAD_SLOT(semId), FILTERED_SAMPLES_PER_EVENT, stageStart);
 
             readIndex += FILTERED_SAMPLES_PER_EVENT; // += 150
             if (readIndex >= FILTERED_PHASE_SAMPLES_BUFFER_SIZE)//If we are at (or past) the end
@@ -638,3 +770,277 @@ void SD_SyncPayloadDemodTask(taskParameter)
       SD_ReleaseFilteredSamplesSemaphore(semId);
    }
 }
+
+#ifdef TM_SOFTDEMOD_UNIT_TEST
+#define SD_UT_FRAMES              20       // Frames replayed
+#define SD_UT_IDLE_SYMBOLS        48       // Noise only (no signal change) before each preamble
+#define SD_UT_PREAMBLE_SYMBOLS    96       // Alternating outer symbols
+#define SD_UT_PAYLOAD_SYMBOLS     64       // Random 4GFSK symbols scored by the slicer
+#define SD_UT_TAIL_SYMBOLS        32       // Flushes the pipeline delay after the payload
+#define SD_UT_FRAME_SYMBOLS       ( SD_UT_IDLE_SYMBOLS + SD_UT_PREAMBLE_SYMBOLS + SD_UT_PAYLOAD_SYMBOLS + SD_UT_TAIL_SYMBOLS )
+#define SD_UT_DEVIATION_HZ        2400.0F  // Outer symbol deviation, inner symbols are a third of it
+#define SD_UT_NOISE               4.0F     // Peak uniform frequency noise, in phase steps (128 = 2 pi) per sample
+#define SD_UT_SAMPLES_PER_SYMBOL  8U       // gresample output rate: OSR / INPUTS_PER_OUTPUT
+#define SD_UT_MAX_DELAY           32U      // Largest pipeline delay searched by the slicer, in filtered samples
+
+static unProcessedData_t SD_UT_Data;
+static float   SD_UT_Payload[( SD_UT_PAYLOAD_SYMBOLS * SD_UT_SAMPLES_PER_SYMBOL ) + SD_UT_MAX_DELAY];
+static uint8_t SD_UT_Symbols[SD_UT_PAYLOAD_SYMBOLS];
+static uint32_t SD_UT_Seed;
+
+/* Repeatable pseudo random numbers (Numerical Recipes LCG) */
+static uint32_t SD_UT_Random( void )
+{
+   SD_UT_Seed = ( SD_UT_Seed * 1664525UL ) + 1013904223UL;
+   return SD_UT_Seed;
+}
+
+/* Hard slicer symbol errors of the payload, for the best pipeline delay. Thresholds are the mid points between the mean
+   filter output of each symbol, so the result does not depend on the filter gain. */
+static uint32_t SD_UT_SymbolErrors( void )
+{
+   uint32_t best = SD_UT_PAYLOAD_SYMBOLS;
+   uint32_t delay;
+   uint32_t i;
+   uint32_t errors;
+   uint32_t count[4];
+   float    mean[4];
+   float    y;
+   uint8_t  sym;
+
+   for ( delay = 0; delay < SD_UT_MAX_DELAY; delay++ )
+   {
+      (void)memset( count, 0, sizeof(count) );
+      (void)memset( mean, 0, sizeof(mean) );
+      for ( i = 0; i < SD_UT_PAYLOAD_SYMBOLS; i++ )
+      {
+         mean[SD_UT_Symbols[i]] += SD_UT_Payload[( i * SD_UT_SAMPLES_PER_SYMBOL ) + delay];
+         count[SD_UT_Symbols[i]]++;
+      }
+      for ( i = 0; i < 4; i++ )
+      {
+         mean[i] = ( count[i] != 0 ) ? ( mean[i] / (float)count[i] ) : 0.0F;
+      }
+      errors = 0;
+      for ( i = 0; i < SD_UT_PAYLOAD_SYMBOLS; i++ )
+      {
+         y = SD_UT_Payload[( i * SD_UT_SAMPLES_PER_SYMBOL ) + delay];
+         if ( y < ( ( mean[0] + mean[1] ) / 2.0F ) )
+         {
+            sym = 0;
+         }
+         else if ( y < ( ( mean[1] + mean[2] ) / 2.0F ) )
+         {
+            sym = 1;
+         }
+         else if ( y < ( ( mean[2] + mean[3] ) / 2.0F ) )
+         {
+            sym = 2;
+         }
+         else
+         {
+            sym = 3;
+         }
+         if ( sym != SD_UT_Symbols[i] )
+         {
+            errors++;
+         }
+      }
+      if ( errors < best )
+      {
+         best = errors;
+      }
+   }
+   return best;
+}
+#endif
+
+/*****************************************************************************************************************
+
+   Function name: SD_unitTest
+
+   Purpose: Replay synthesized 4GFSK phase samples through the soft demodulator stages in line (without the task split)
+            and report the cycles per stage, the real time margin, the preamble detection rate and the payload symbol
+            error rate of a hard slicer on the filter output.
+
+   Arguments: None
+
+   Returns: None
+
+   Side effects: Shares the preprocessor and preamble detector state with the soft demodulator tasks, so it must not run
+                 while the radio uses the soft demodulator. The replay is timed in its own statistics, not in sdstats.
+                 SD_FindSync and SyncAndPayloadDemodulator are not replayed: they report to the radio and PHY.
+
+   Reentrant: No
+
+  *****************************************************************************************************************/
+void SD_unitTest( void )
+{
+#ifdef TM_SOFTDEMOD_UNIT_TEST
+   static const float level[4] = { -1.0F, -1.0F / 3.0F, 1.0F / 3.0F, 1.0F };
+   static const char * const stageName[eSD_STAGE_LAST] = { "phase2freq", "findSync", "resample", "fir", "preamble", "syncPayload" };
+   SD_StageSlot_t slots[eSD_STAGE_LAST];
+   signed char  raw[MAX_PHASE_SAMPLES_FROM_RADIO_PER_INTERRUPT];
+   signed char  freq[MAX_PHASE_SAMPLES_FROM_RADIO_PER_INTERRUPT];
+   float        deviation = ( SD_UT_DEVIATION_HZ * 128.0F ) / ( OSR * 4800.0F ); // Phase steps per sample
+   float        phase = 0.0F;
+   float        meanMaxAbsIFrq = 0.0F;
+   boolean_T    foundPA = false;
+   uint32_t     LoP = 0;
+   uint32_t     samplesInPreambleBuffer = 0;
+   bool         resetPreamble = true;
+   bool         detected;
+   bool         available;
+   uint32_t     frame;
+   uint32_t     sample;
+   uint32_t     symbol;
+   uint32_t     filtered;         // Filtered samples produced in this frame
+   uint32_t     readIndex = 0;
+   uint32_t     writeIndex;
+   uint32_t     stageStart;
+   uint32_t     cpuFreq;
+   uint32_t     detections = 0;
+   uint32_t     falseDetections = 0;
+   uint32_t     symbolErrors = 0;
+   uint32_t     rawSamples = 0;
+   uint64_t     totalCycles = 0;
+   uint32_t     i;
+
+   (void)fir_filt_circ_buff_unitTest();
+   SD_UT_Seed = 1;
+   (void)TIME_SYS_GetRealCpuFreq( &cpuFreq, NULL, NULL );
+   (void)memset( &SD_UT_Data, 0, sizeof(SD_UT_Data) );
+   phase2freq_wi_unwrap_init();
+   gresample_px_sinc_table_init();
+   fir_filt_circ_buff_init();
+   filteredPhaseSamplesBufferWriteIndex = 0;
+   (void)memset( slots, 0, sizeof(slots) );
+
+   for ( frame = 0; frame < SD_UT_FRAMES; frame++ )
+   {
+      for ( i = 0; i < SD_UT_PAYLOAD_SYMBOLS; i++ )
+      {
+         SD_UT_Symbols[i] = (uint8_t)( SD_UT_Random() >> 30 );
+      }
+      detected = false;
+      filtered = 0;
+      for ( sample = 0; sample < (uint32_t)( SD_UT_FRAME_SYMBOLS * OSR ); sample += MAX_PHASE_SAMPLES_FROM_RADIO_PER_INTERRUPT )
+      {
+         /* Radio phase samples: integrated frequency plus noise, 7 bits per turn */
+         for ( i = 0; i < MAX_PHASE_SAMPLES_FROM_RADIO_PER_INTERRUPT; i++ )
+         {
+            symbol = (uint32_t)( (float)( sample + i ) / OSR );
+            if ( symbol < SD_UT_IDLE_SYMBOLS )
+            {
+               /* No signal change, only noise */
+            }
+            else if ( symbol < ( SD_UT_IDLE_SYMBOLS + SD_UT_PREAMBLE_SYMBOLS ) )
+            {
+               phase += ( ( symbol & 1U ) != 0 ) ? deviation : -deviation;
+            }
+            else if ( symbol < ( SD_UT_IDLE_SYMBOLS + SD_UT_PREAMBLE_SYMBOLS + SD_UT_PAYLOAD_SYMBOLS ) )
+            {
+               phase += level[SD_UT_Symbols[symbol - ( SD_UT_IDLE_SYMBOLS + SD_UT_PREAMBLE_SYMBOLS )]] * deviation;
+            }
+            phase += ( ( (float)( SD_UT_Random() >> 8 ) / 8388608.0F ) - 1.0F ) * SD_UT_NOISE;
+            while ( phase >= 64.0F )
+            {
+               phase -= 128.0F;
+            }
+            while ( phase < -64.0F )
+            {
+               phase += 128.0F;
+            }
+            raw[i] = (signed char)phase;
+         }
+         rawSamples += MAX_PHASE_SAMPLES_FROM_RADIO_PER_INTERRUPT;
+
+         /* Same stages as SD_PhaseSamplesListenerTask */
+         stageStart = DWT_CYCCNT;
+         phase2freq_wi_unwrap( raw, freq, MAX_PHASE_SAMPLES_FROM_RADIO_PER_INTERRUPT );
+         SD_StageDone( &slots[eSD_STAGE_PHASE2FREQ], MAX_PHASE_SAMPLES_FROM_RADIO_PER_INTERRUPT, &stageStart );
+         SD_UT_Data.size = gresample( freq, &SD_UT_Data.data[0], MAX_PHASE_SAMPLES_FROM_RADIO_PER_INTERRUPT );
+         SD_StageDone( &slots[eSD_STAGE_RESAMPLE], MAX_PHASE_SAMPLES_FROM_RADIO_PER_INTERRUPT, &stageStart );
+         writeIndex = filteredPhaseSamplesBufferWriteIndex;
+         available = fir_filt_circ_buff( &SD_UT_Data );
+         SD_StageDone( &slots[eSD_STAGE_FIR], SD_UT_Data.size, &stageStart );
+
+         /* Keep the filtered payload for the slicer */
+         for ( i = 0; i < SD_UT_Data.size; i++, filtered++ )
+         {
+            if ( ( filtered >= ( ( SD_UT_IDLE_SYMBOLS + SD_UT_PREAMBLE_SYMBOLS ) * SD_UT_SAMPLES_PER_SYMBOL ) ) &&
+                 ( ( filtered - ( ( SD_UT_IDLE_SYMBOLS + SD_UT_PREAMBLE_SYMBOLS ) * SD_UT_SAMPLES_PER_SYMBOL ) ) <
+                   ( sizeof(SD_UT_Payload) / sizeof(SD_UT_Payload[0]) ) ) )
+            {
+               SD_UT_Payload[filtered - ( ( SD_UT_IDLE_SYMBOLS + SD_UT_PREAMBLE_SYMBOLS ) * SD_UT_SAMPLES_PER_SYMBOL )] =
+                  filteredPhaseSamplesBuffer[( writeIndex + i ) % ( FILTERED_PHASE_SAMPLES_BUFFER_SIZE )];
+            }
+         }
+
+         /* Same as SD_PreambleDetectorTask */
+         if ( available )
+         {
+            if ( resetPreamble )
+            {
+               preambleDetector_initialize();
+            }
+            stageStart = DWT_CYCCNT;
+            preambleDetector( &filteredPhaseSamplesBuffer[readIndex], resetPreamble, &foundPA, &LoP,
+                              &samplesInPreambleBuffer, &meanMaxAbsIFrq );
+            SD_StageDone( &slots[eSD_STAGE_PREAMBLE], FILTERED_SAMPLES_PER_EVENT, &stageStart );
+            resetPreamble = false;
+            readIndex = ( readIndex + FILTERED_SAMPLES_PER_EVENT ) % ( FILTERED_PHASE_SAMPLES_BUFFER_SIZE );
+            if ( foundPA )
+            {
+               if ( FailCode == 0 )
+               {
+                  if ( filtered < ( SD_UT_IDLE_SYMBOLS * SD_UT_SAMPLES_PER_SYMBOL ) )
+                  {
+                     falseDetections++;
+                  }
+                  else
+                  {
+                     detected = true;
+                  }
+               }
+               resetPreamble = true;
+               foundPA = false;
+               LoP = 0;
+               samplesInPreambleBuffer = 0;
+               meanMaxAbsIFrq = 0.0F;
+            }
+         }
+      }
+      if ( detected )
+      {
+         detections++;
+      }
+      symbolErrors += SD_UT_SymbolErrors();
+   }
+
+   for ( i = 0; i < (uint32_t)eSD_STAGE_LAST; i++ )
+   {
+      if ( slots[i].stats.calls != 0 )
+      {
+         totalCycles += slots[i].stats.cycles;
+         DBG_logPrintf( 'U', "SD %-11s %5lu calls %7lu cycles/call (max %7lu) %4lu cycles/sample", stageName[i],
+                        slots[i].stats.calls, (uint32_t)( slots[i].stats.cycles / slots[i].stats.calls ),
+                        slots[i].stats.maxCycles, (uint32_t)( slots[i].stats.cycles / slots[i].stats.samples ) );
+      }
+   }
+   /* The radio delivers OSR * 4800 samples per second */
+   DBG_logPrintf( 'U', "SD %lu raw samples, %lu samples/s (real time is %lu), CPU load at real time %lu.%lu%%",
+                  rawSamples, (uint32_t)( ( (uint64_t)rawSamples * cpuFreq ) / totalCycles ),
+                  (uint32_t)( OSR * 4800.0F ),
+                  (uint32_t)( ( totalCycles * (uint64_t)( OSR * 4800.0F ) * 100U ) / ( (uint64_t)rawSamples * cpuFreq ) ),
+                  (uint32_t)( ( ( totalCycles * (uint64_t)( OSR * 4800.0F ) * 1000U ) / ( (uint64_t)rawSamples * cpuFreq ) ) % 10U ) );
+   DBG_logPrintf( 'U', "SD preambles %lu/%lu, false %lu, payload symbol errors %lu/%lu", detections, SD_UT_FRAMES,
+                  falseDetections, symbolErrors, SD_UT_FRAMES * SD_UT_PAYLOAD_SYMBOLS );
+
+   /* Leave the preprocessor as SoftDemodulator_Initialize does */
+   phase2freq_wi_unwrap_init();
+   gresample_px_sinc_table_init();
+   fir_filt_circ_buff_init();
+   filteredPhaseSamplesBufferWriteIndex = 0;
+#endif
+}
@@ -67,6 +67,26 @@ typedef struct //Used in fir_filt_circ_buff also
    uint32_t size;
 } unProcessedData_t ;
 
+/* Pipeline stages timed with the cycle counter when TM_SD_STAGE_TIMING is set (see SD_GetStageStats) */
+typedef enum
+{
+   eSD_STAGE_PHASE2FREQ = 0,  /* phase2freq_wi_unwrap, 75 raw samples per call */
+   eSD_STAGE_FIND_SYNC,       /* SD_FindSync, 75 raw samples per call */
+   eSD_STAGE_RESAMPLE,        /* gresample, 75 raw samples per call */
+   eSD_STAGE_FIR,             /* fir_filt_circ_buff, ~49 resampled samples per call */
+   eSD_STAGE_PREAMBLE,        /* preambleDetector, 150 filtered samples per call */
+   eSD_STAGE_SYNC_PAYLOAD,    /* SyncAndPayloadDemodulator, 150 filtered samples per call */
+   eSD_STAGE_LAST
+} SD_Stage_e;
+
+typedef struct
+{
+   uint32_t calls;      /* Number of times the stage ran */
+   uint32_t maxCycles;  /* Longest single call */
+   uint64_t cycles;     /* Total cycles spent in the stage */
+   uint64_t samples;    /* Total input samples processed by the stage */
+} SD_StageStats_t;
+
 extern OS_EVNT_Obj   SD_Events;
 extern OS_MUTEX_Obj  SD_Payload_Mutex;
 extern float filteredPhaseSamplesBuffer[FILTERED_PHASE_SAMPLES_BUFFER_SIZE];
@@ -74,6 +94,10 @@ extern uint16_t filteredPhaseSamplesBufferWriteIndex;
 //extern filteredPhaseSamples_sem_t SD_FilteredPhaseSamplesSemaphores[SOFT_DEMOD_MAX_SYNC_PAYL_TASKS + 1]; // +1 for preamble detector task
 
 returnStatus_t SoftDemodulator_Initialize(void);
+#if ( TM_SD_STAGE_TIMING == 1 )
+void SD_GetStageStats(SD_StageStats_t stats[eSD_STAGE_LAST], uint32_t *elapsedMs, bool reset);
+#endif
+void SD_unitTest(void);
 
 void SD_PhaseSamplesListenerTask(taskParameter);
 void SD_PreprocessorTask(taskParameter);
@@ -100,6 +100,9 @@
 
 #include "PHY_Protocol.h"
 #include "rs.h"
+#ifdef TM_RS_UNIT_TEST
+#include "DBG_SerialDebug.h"
+#endif
 
 // Maximum values for MM, N, NN, TT and KK of any RS code used
 #define MM  8         // RS code over GF(2^mm) - change to suit
@@ -423,6 +426,9 @@ void gen_poly(RSCodeAttr_t *rscode)
 }
 #endif
 
+/* x modulo nn for 0 <= x < 2*nn, i.e. the sum of two exponents in index form, without a division */
+#define MODNN(x, nn) ( ((x) >= (nn)) ? ((x) - (nn)) : (x) )
+
 static void encode_rs(RSCodeAttr_t const *rscode)
 /*
    0) INPUT: recd[], bb[] in poly-form but gg[] in index-form. Tables.
@@ -459,11 +465,11 @@ static void encode_rs(RSCodeAttr_t const *rscode)
       {
          for (j = (nn-kk)-1; j > 0; j--) {
             if (gg[j] != -1)
-               bb[j] = bb[j-1] ^ alpha_to[(gg[j] + feedback)%nn];
+               bb[j] = bb[j-1] ^ alpha_to[MODNN(gg[j] + feedback, nn)];
             else
                bb[j] = bb[j-1];
          }
-         bb[0] = alpha_to[(gg[0] + feedback)%nn];
+         bb[0] = alpha_to[MODNN(gg[0] + feedback, nn)];
       }
       else /* feedback term is zero. encoder becomes a single-byte shifter */
       {
@@ -474,29 +480,72 @@ static void encode_rs(RSCodeAttr_t const *rscode)
    }
 }
 
-static bool eras_dec_rs(RSCodeAttr_t const *rscode, int16_t no_erase)
+static bool syndromes_rs(RSCodeAttr_t const *rscode, int16_t s[])
+/*
+    0) INPUT: recd[] in poly form, nn, kk, Tables.
+    1) OUTPUT: syndromes s[1], ..., s[nn-kk] in index form. recd[] is not changed.
+    2) Evaluate recd(x) at the roots of g(x), namely @^(b0+i), i = 0, ... ,(2*tt-1).
+       Only the non-zero symbols are visited (most of a shortened codeword is zero padding), and the exponent of each
+       term is stepped by j from one root to the next instead of being multiplied and reduced modulo nn.
+    3) Return value is true when a syndrome is non-zero, i.e. recd[] is not a codeword
+*/
+{
+   int16_t i, j, e;
+   int16_t syn[2*TT+1] = {0}; /* Syndromes in poly form */
+   bool syn_error = false;
+   int16_t kk, nn;           // RS variables
+   int16_t const *alpha_to;  // Galois field 2^MM from polynomial
+   int16_t const *index_of;  // Galois field 2^MM from polynomial
+
+   kk = rscode->kk;
+   nn = rscode->nn;
+   alpha_to = rscode->alpha_to;
+   index_of = rscode->index_of;
+
+   for (j=0; j < nn; j++)
+   {
+      if (recd[j] != 0)
+      {
+         e = (int16_t)((index_of[recd[j]] + ((b0*j)%nn))%nn); /* recd[j] * @^(b0*j) in index form */
+         for (i=1; i <= nn-kk; i++)
+         {
+            syn[i] ^= alpha_to[e];
+            e = (int16_t)MODNN(e+j, nn);
+         }
+      }
+   }
+
+   for (i=1; i <= nn-kk; i++)
+   {
+      if (syn[i] != 0) syn_error = true; /* set flag if non-zero syndrome => error */
+      s[i] = index_of[syn[i]];           /* convert syndrome from polynomial form to index form */
+   }
+   return syn_error;
+}
+
+static bool eras_dec_rs(RSCodeAttr_t const *rscode, int16_t no_erase, int16_t const s[])
 /*
     0) INPUT: recd[] in poly form, nn, kk, Tables.
                  int no_eras = # of erasures in i/p received vector.
                  int [16] eras_pos[] = Error Location Numbers (@^err_loc[l] where 0 <= err_loc[0] < err_loc[1] < ... n).
+                 s[] = the non-zero syndromes of recd[] in index form, from syndromes_rs().
     1) OUTPUT: DecodedCW recd[] in poly form (if successful) OR un-changed recd[].
     2) Perform Errors + Erasures decoding of RS-code.
     4) Return value is 1 when success, 0 when failure to decode
 */
 {
-   int16_t i, j, r, q, tmp, /*tmp1,*/ num1, den, pres_root, pres_loc;
+   int16_t i, j, r, q, tmp, /*tmp1,*/ num1, den, pres_root, e;
    int16_t phi[2*TT+1] = {0}, tmp_pol[2*TT+1] = {0}; /* The Erasure locator polynomial (RLP) in poly form */
    int16_t /*U,*/ discr_r, deg_phi, deg_lambda, L, deg_omega;
-   int16_t lambda[2*TT+1] = {0}, s[2*TT+1] = {0}, lambda_pr[2*TT+1];/* Error+Erasure Locator Poly (ERLP) and Syndrome poly */
+   int16_t lambda[2*TT+1] = {0}, lambda_pr[2*TT+1];/* Error+Erasure Locator Poly (ERLP) */
    int16_t b[2*TT+1] = {0}, T[2*TT+1], omega[2*TT+1];
-   int16_t syn_error=0, root[2*TT] = {0}, err[NN] = {0}, reg[2*TT+1] = {0} ;
+   int16_t root[2*TT] = {0}, err[2*TT] = {0}, reg[2*TT+1] = {0} ;
    int16_t loc[2*TT] = {0}, cnt = 0;
    bool result = true; // Default to success
-   int16_t kk, nn, tt;       // RS variables
+   int16_t nn, tt;           // RS variables
    int16_t const *alpha_to;  // Galois field 2^MM from polynomial
    int16_t const *index_of;  // Galois field 2^MM from polynomial
 
-   kk = rscode->kk;
    nn = rscode->nn;
    tt = rscode->tt;
    alpha_to = rscode->alpha_to;
@@ -551,209 +600,182 @@ static bool eras_dec_rs(RSCodeAttr_t const *rscode, int16_t no_erase)
       }
    }
 #endif
-   /* recd[] is in polynomial form, convert to index form */
-   for (i= 0; i < nn; i++) recd[i] = index_of[recd[i]];
+   /* Begin Berlekamp-Massey algorithm to determine error+erasure locator polynomial */
+   r = no_erase;
+   deg_phi = no_erase;
+   L = no_erase;
+   if (no_erase > 0) /* Initialize lambda(x) and b(x) (in poly-form) to phi(x) */
+   {
+      for (i=0; i < deg_phi +1; i++)
+         lambda[i] = (phi[i] == -1)? 0 : alpha_to[phi[i]];
 
-   /* first form the syndromes; i.e., evaluate recd(x) at roots of g(x) namely
-      @^(b0+i), i = 0, ... ,(2*tt-1) */
-   for (i=1; i <= nn-kk; i++)
+      for (i=deg_phi+1;i < 2*tt+1;i++) lambda[i] = 0;
+
+      for (i= 0; i < 2*tt +1; i++)
+         b[i] = lambda[i];
+   }
+   else
    {
-      s[i] = 0 ;
-      for (j=0; j < nn; j++)
-         if (recd[j] != -1)
-            s[i] ^= alpha_to[(recd[j] + (b0+i-1)*j)%nn] ; /* recd[j] in index form */
-      /* convert syndrome from polynomial form to index form  */
-      if (s[i] != 0)  syn_error = 1 ;   /* set flag if non-zero syndrome => error */
-      s[i] = index_of[s[i]] ;
+      lambda[0] = 1;
+      for (i=1;i < 2*tt+1;i++) lambda[i] = 0;
+      for (i=0;i < 2*tt+1;i++) b[i] = lambda[i];
    }
 
-   if (syn_error) /* if syndrome is zero, modified recd[] is a codeword */
+   while (++r <= 2*tt) /* r is the step number */
    {
-      /* Begin Berlekamp-Massey algorithm to determine error+erasure locator polynomial */
-      r = no_erase;
-      deg_phi = no_erase;
-      L = no_erase;
-      if (no_erase > 0) /* Initialize lambda(x) and b(x) (in poly-form) to phi(x) */
+      /* Compute discrepancy at the r-th step in poly-form */
+      discr_r = 0;
+      for (i= 0; i <= r; i++)  /* s[r-i] with i > r is not a syndrome */
       {
-         for (i=0; i < deg_phi +1; i++)
-            lambda[i] = (phi[i] == -1)? 0 : alpha_to[phi[i]];
-
-         for (i=deg_phi+1;i < 2*tt+1;i++) lambda[i] = 0;
-
-         for (i= 0; i < 2*tt +1; i++)
-            b[i] = lambda[i];
+         if ((lambda[i] != 0) && (s[r-i] != -1))
+         {
+            tmp = alpha_to[MODNN(index_of[lambda[i]]+s[r-i], nn)];
+            discr_r ^= tmp;
+         }
       }
-      else
+
+      if (discr_r == 0)
       {
-         lambda[0] = 1;
-         for (i=1;i < 2*tt+1;i++) lambda[i] = 0;
-         for (i=0;i < 2*tt+1;i++) b[i] = lambda[i];
+         /* 3 lines below: B(x) <-- x*B(x) */
+         tmp_pol[0] = 0;
+         for (i=1;i < 2*tt+1;i++) tmp_pol[i] = b[i-1];
+         for (i=0;i < 2*tt+1;i++) b[i] = tmp_pol[i];
       }
-
-      while (++r <= 2*tt) /* r is the step number */
+      else
       {
-         /* Compute discrepancy at the r-th step in poly-form */
-         discr_r = 0;
-         for (i= 0; i < 2*tt +1; i++)
+         /* 5 lines below: T(x) <-- lambda(x) - discr_r*x*b(x) */
+         T[0] = lambda[0];
+         for (i=1;i < 2*tt+1;i++)
          {
-            if ((lambda[i] != 0) && (s[r-i] != -1))
-            {
-               tmp = alpha_to[(index_of[lambda[i]]+s[r-i])%nn];
-               discr_r ^= tmp;
-            }
+            tmp =  (b[i-1] == 0)? 0 : alpha_to[MODNN(index_of[discr_r]+index_of[b[i-1]], nn)];
+            T[i] = lambda[i]^tmp;
          }
 
-         if (discr_r == 0)
+         if (2*L <= r+no_erase-1)
          {
-            /* 3 lines below: B(x) <-- x*B(x) */
-            tmp_pol[0] = 0;
-            for (i=1;i < 2*tt+1;i++) tmp_pol[i] = b[i-1];
-            for (i=0;i < 2*tt+1;i++) b[i] = tmp_pol[i];
+            L = r+no_erase-L;
+            /* 2 lines below: B(x) <-- inv(discr_r) * lambda(x) */
+            for (i=0; i < 2*tt+1; i++)
+               b[i] = (lambda[i] == 0) ? 0 : alpha_to[MODNN((index_of[lambda[i]]-index_of[discr_r])+nn, nn)];
+            for (i=0; i < 2*tt+1; i++) lambda[i] = T[i];
          }
          else
          {
-            /* 5 lines below: T(x) <-- lambda(x) - discr_r*x*b(x) */
-            T[0] = lambda[0];
-            for (i=1;i < 2*tt+1;i++)
-            {
-               tmp =  (b[i-1] == 0)? 0 : alpha_to[(index_of[discr_r]+index_of[b[i-1]])%nn];
-               T[i] = lambda[i]^tmp;
-            }
-
-            if (2*L <= r+no_erase-1)
-            {
-               L = r+no_erase-L;
-               /* 2 lines below: B(x) <-- inv(discr_r) * lambda(x) */
-               for (i=0; i < 2*tt+1; i++)
-                  b[i] = (lambda[i] == 0) ? 0 : alpha_to[((index_of[lambda[i]]-index_of[discr_r])+nn)%nn];
-               for (i=0; i < 2*tt+1; i++) lambda[i] = T[i];
-            }
-            else
-            {
-               for (i=0; i < 2*tt+1; i++) lambda[i] = T[i];
-               /* 3 lines below: B(x) <-- x*B(x) */
-               tmp_pol[0] = 0;
-               for (i=1; i < 2*tt+1; i++) tmp_pol[i] = b[i-1];
-               for (i=0; i < 2*tt+1; i++) b[i] = tmp_pol[i];
-            }
+            for (i=0; i < 2*tt+1; i++) lambda[i] = T[i];
+            /* 3 lines below: B(x) <-- x*B(x) */
+            tmp_pol[0] = 0;
+            for (i=1; i < 2*tt+1; i++) tmp_pol[i] = b[i-1];
+            for (i=0; i < 2*tt+1; i++) b[i] = tmp_pol[i];
          }
       }
+   }
 
-      /* Put lambda(x) into index form */
-      for (i=0; i < 2*tt+1; i++)
-         lambda[i] = index_of[lambda[i]];
+   /* Put lambda(x) into index form */
+   for (i=0; i < 2*tt+1; i++)
+      lambda[i] = index_of[lambda[i]];
 
-      /* Compute deg(lambda(x)) */
-      deg_lambda = (int16_t)(2*tt);
-      while ((lambda[deg_lambda] == -1) && (deg_lambda > 0))
-         --deg_lambda;
+   /* Compute deg(lambda(x)) */
+   deg_lambda = (int16_t)(2*tt);
+   while ((lambda[deg_lambda] == -1) && (deg_lambda > 0))
+      --deg_lambda;
 
-      if (deg_lambda <= 2*tt)
+   if (deg_lambda <= 2*tt)
+   {
+      /* Find roots of the error+erasure locator polynomial. By Chien Search */
+      for (i=1; i < 2*tt+1; i++) reg[i] = lambda[i] ;
+      cnt = 0 ; /* Number of roots of lambda(x) */
+      for (i=1; (i <= nn) && (cnt < deg_lambda); i++) /* lambda(x) has no more than deg_lambda roots */
       {
-         /* Find roots of the error+erasure locator polynomial. By Chien Search */
-         for (i=1; i < 2*tt+1; i++) reg[i] = lambda[i] ;
-         cnt = 0 ; /* Number of roots of lambda(x) */
-         for (i=1; i <= nn; i++)
+         q = 1 ;
+         for (j=1; j <= deg_lambda; j++)
+         if (reg[j] != -1)
          {
-            q = 1 ;
-            for (j=1; j <= deg_lambda; j++)
-            if (reg[j] != -1)
-            {
-               reg[j] = (reg[j]+j)%nn ;
-               q ^= alpha_to[(reg[j])%nn] ;
-            }
-            if (!q)        /* store root (index-form) and error location number */
+            reg[j] = (int16_t)MODNN(reg[j]+j, nn) ;
+            q ^= alpha_to[reg[j]] ;
+         }
+         if (!q)        /* store root (index-form) and error location number */
+         {
+            root[cnt] = i;
+            loc[cnt] = nn-i;
+            cnt++;
+         }
+      }
+
+      if (deg_lambda == cnt) // Compute err+eras evaluator poly omega(x) = s(x)*lambda(x) (modulo x^(nn-kk)).
+      {  /* correctable error */
+         for (i=0; i < 2*tt; i++)
+         {
+            omega[i] = 0;
+            for (j=0;(j < deg_lambda+1) && (j < i+1);j++)
             {
-               root[cnt] = i;
-               loc[cnt] = nn-i;
-               cnt++;
+               if ((s[i+1-j] != -1) && (lambda[j] != -1))
+                  tmp = alpha_to[MODNN(s[i+1-j]+lambda[j], nn)];
+               else
+                  tmp = 0;
+               omega[i] ^= tmp;
             }
          }
 
-         if (deg_lambda == cnt) // Compute err+eras evaluator poly omega(x) = s(x)*lambda(x) (modulo x^(nn-kk)).
-         {  /* correctable error */
-            for (i=0; i < 2*tt; i++)
+         omega[2*tt] = 0;
+         /* Compute lambda_pr(x) = formal derivative of lambda(x) in poly-form */
+         for (i= 0; i < tt; i++)
+         {
+            lambda_pr[2*i+1] = 0;
+            lambda_pr[2*i] = (lambda[2*i+1] == -1)? 0 : alpha_to[lambda[2*i+1]];
+         }
+
+         lambda_pr[2*tt] = 0;
+         /* Compute deg(omega(x)) */
+         deg_omega = (int16_t)(2*tt);
+         while ((omega[deg_omega] == 0) && (deg_omega > 0))
+            --deg_omega;
+
+         /* Compute error values in poly-form. num1 = omega(inv(X(l))),
+         num2 = inv(X(l))^(b0-1) and den = lambda_pr(inv(X(l))) all in poly-form.
+         e is i*pres_root modulo nn, stepped with i. */
+         for (j= 0; j < cnt; j++)
+         {
+            pres_root = (int16_t)MODNN(root[j], nn);
+            num1 = 0;
+            for (i=0, e=0;i < deg_omega+1;i++, e=(int16_t)MODNN(e+pres_root, nn))
             {
-               omega[i] = 0;
-               for (j=0;(j < deg_lambda+1) && (j < i+1);j++)
-               {
-                  if ((s[i+1-j] != -1) && (lambda[j] != -1))
-                     tmp = alpha_to[(s[i+1-j]+lambda[j])%nn];
-                  else
-                     tmp = 0;
-                  omega[i] ^= tmp;
-               }
+               if (omega[i] != 0)
+                  tmp = alpha_to[MODNN(index_of[omega[i]]+e, nn)];
+               else
+                  tmp = 0;
+
+               num1 ^= tmp;
             }
 
-            omega[2*tt] = 0;
-            /* Compute lambda_pr(x) = formal derivative of lambda(x) in poly-form */
-            for (i= 0; i < tt; i++)
+            den = 0;
+            for (i=0, e=0;i < deg_lambda+1;i++, e=(int16_t)MODNN(e+pres_root, nn))
             {
-               lambda_pr[2*i+1] = 0;
-               lambda_pr[2*i] = (lambda[2*i+1] == -1)? 0 : alpha_to[lambda[2*i+1]];
-            }
+               if (lambda_pr[i] != 0)
+                  tmp = alpha_to[MODNN(index_of[lambda_pr[i]]+e, nn)];
+               else
+                  tmp = 0;
 
-            lambda_pr[2*tt] = 0;
-            /* Compute deg(omega(x)) */
-            deg_omega = (int16_t)(2*tt);
-            while ((omega[deg_omega] == 0) && (deg_omega > 0))
-               --deg_omega;
+               den ^= tmp;
+            }
 
-            /* Compute error values in poly-form. num1 = omega(inv(X(l))),
-            num2 = inv(X(l))^(b0-1) and den = lambda_pr(inv(X(l))) all in poly-form */
-            for (j= 0; j < cnt; j++)
+            err[j] = 0;
+            if (num1 != 0)
             {
-               pres_root = root[j];
-               pres_loc = loc[j];
-               num1 = 0;
-               for (i=0;i < deg_omega+1;i++)
-               {
-                  if (omega[i] != 0)
-                     tmp = alpha_to[(index_of[omega[i]]+i*pres_root)%nn];
-                  else
-                     tmp = 0;
-
-                  num1 ^= tmp;
-               }
-
-               den = 0;
-               for (i= 0; i < deg_lambda +1; i++)
-               {
-                  if (lambda_pr[i] != 0)
-                     tmp = alpha_to[(index_of[lambda_pr[i]]+i*pres_root)%nn];
-                  else
-                     tmp = 0;
-
-                  den ^= tmp;
-               }
-
-               err[pres_loc] = 0;
-               if (num1 != 0)
-               {
-                  err[pres_loc] = alpha_to[(index_of[num1]+index_of[alpha_to[0]]+(nn-index_of[den]))%nn];
-               }
+               err[j] = alpha_to[(index_of[num1]+index_of[alpha_to[0]]+(nn-index_of[den]))%nn];
             }
+         }
 
-            /* Correct word by subtracting out error bytes. First convert recd[] into poly-form */
-            for (i=0; i < nn; i++) recd[i] = (recd[i] == -1)? 0 : alpha_to[recd[i]];
-            for (j=0; j < cnt; j++)
-               recd[loc[j]] ^= err[loc[j]];
+         /* Correct word by subtracting out error bytes. recd[] is still in poly-form */
+         for (j=0; j < cnt; j++)
+            recd[loc[j]] ^= err[j];
 
-            return (true);
-         }
-         else /* deg(lambda) unequal to number of roots => uncorrectable error detected */
-            result = false;
+         return (true);
       }
-      else /* deg(lambda) > 2*tt => uncorrectable error detected */
+      else /* deg(lambda) unequal to number of roots => uncorrectable error detected */
          result = false;
    }
-
-   /* Convert recd[] to polynomial form */
-   for (i=0; i < nn; i++) {
-      if (recd[i]!=-1)
-         recd[i] = alpha_to[recd[i]];
-      else recd[i] = 0;
-   }
+   else /* deg(lambda) > 2*tt => uncorrectable error detected */
+      result = false;
 
    return result;
 }
@@ -792,6 +814,11 @@ void RS_Encode(RSCode_e rscode, uint8_t const * const msg, uint8_t * const parit
             recd[(slen-(i/mm2))-1] |= (int16_t)(1u<<(i%mm2));
          }
       }
+   } else if (mm2 == 8) {
+      // One symbol per byte
+      for (i=0; i<len; i++) {
+         recd[i] = msg[i];
+      }
    } else {
       // Remap msg into an array of Galois field 2^mm bit by bit MSB first
       for (i=0; i<len*8; i++) {
@@ -824,6 +851,10 @@ void RS_Encode(RSCode_e rscode, uint8_t const * const msg, uint8_t * const parit
             parity[i/8] &= ~(1u<<(i%8));
          }
       }
+   } else if (mm2 == 8) {
+      for (i=0; i<2*tt; i++) {
+         parity[i] = (uint8_t)bb[i];
+      }
    } else {
       for (i=0; i<2*tt*mm2; i++) {
          if (bb[i/mm2] & (int16_t)(mask >> (i%mm2))) {
@@ -844,6 +875,7 @@ bool RS_Decode(RSCode_e rscode, uint8_t * const msg, uint8_t * const parity, uin
    uint16_t offset; // Size of zero padding when doing STAR
    bool     result;
    uint32_t slen=0; // Message length in symbols
+   int16_t  s[2*TT+1] = {0}; // Syndromes in index form
 
    kk = (uint16_t)RSCode[rscode].kk;
    mm2 = (uint16_t)RSCode[rscode].mm;
@@ -869,6 +901,14 @@ bool RS_Decode(RSCode_e rscode, uint8_t * const msg, uint8_t * const parity, uin
             recd[(nn+kk-(i/mm2))-1] |= (int16_t)(1u<<(i%mm2));
          }
       }
+   } else if (mm2 == 8) {
+      // One symbol per byte, parity after the gap left by the shortened block
+      for (i=0; i<len; i++) {
+         recd[i] = msg[i];
+      }
+      for (i=0; i<nn-kk; i++) {
+         recd[kk+i] = parity[i];
+      }
    } else {
       // Remap msg into an array of Galois field 2^mm bit by bit
       for (i=0; i<len*8; i++) {
@@ -885,8 +925,16 @@ bool RS_Decode(RSCode_e rscode, uint8_t * const msg, uint8_t * const parity, uin
       }
    }
 
-   // Decode message
-   result=eras_dec_rs(&RSCode[rscode], 0);
+   // Decode message. Most frames are clean: when all the syndromes are zero recd[] is already a codeword.
+   if (syndromes_rs(&RSCode[rscode], s)) {
+      result=eras_dec_rs(&RSCode[rscode], 0, s);
+   } else {
+      result = true;
+      if (rscode != RS_STAR_63_59) {
+         // msg and parity would be rewritten unchanged and the padding is still 0
+         return (result);
+      }
+   }
 
    // Remap symbols into msg
    // Different processing for STAR and SRFN
@@ -910,6 +958,13 @@ bool RS_Decode(RSCode_e rscode, uint8_t * const msg, uint8_t * const parity, uin
              parity[(j/8)+offset] &= ~(1u<<(j%8));
           }
        }
+   } else if (mm2 == 8) {
+      for (i=0; i<len; i++) {
+         msg[i] = (uint8_t)recd[i];
+      }
+      for (i=0; i<nn-kk; i++) {
+         parity[i] = (uint8_t)recd[kk+i];
+      }
    } else {
       for (i=0; i<len*8; i++) {
          if (recd[i/mm2] & (mask >> (i%mm2))) {
@@ -935,6 +990,15 @@ bool RS_Decode(RSCode_e rscode, uint8_t * const msg, uint8_t * const parity, uin
       // Compute first bit position used as padding
       if (rscode == RS_STAR_63_59) {
          i = (uint16_t)(slen*mm2);
+      } else if (mm2 == 8) {
+         // One symbol per byte
+         for (j=len; j<kk; j++) {
+            if (recd[j] != 0) {
+               result = false;
+               break;
+            }
+         }
+         i = (uint16_t)(kk*mm2); // Padding checked above
       } else {
          i = len*8;
       }
@@ -952,6 +1016,64 @@ bool RS_Decode(RSCode_e rscode, uint8_t * const msg, uint8_t * const parity, uin
 }
 
 
+
+/*
+   RS_unitTest: Encode random messages with each code, corrupt up to the number of bytes each code always corrects
+   (tt for 255/239, 1 for the 6 bit codes since a byte can straddle two symbols), decode and check that the original
+   message and parity come back. Also times the decoder for each error count.
+*/
+void RS_unitTest(void)
+{
+#ifdef TM_RS_UNIT_TEST
+   static const char * const codeName[RS_LAST] = { "SRFN 63/59", "SRFN 255/239", "STAR 63/59" };
+   uint8_t  sent[64+32];     // Message + parity as encoded
+   uint8_t  frame[64+32];    // Message + parity as received and decoded
+   uint32_t seed = 1;
+   uint32_t errors;
+   uint32_t startMs;
+   uint16_t pass;
+   uint8_t  len;
+   uint8_t  plen;
+   uint8_t  maxErr;
+   uint8_t  nerr;
+   uint8_t  e;
+   uint8_t  i;
+   RSCode_e code;
+
+   for (code = RS_SRFN_63_59; code < RS_LAST; code++) {
+      // Longest message that fits the code (STAR pads the message to a multiple of 3 bytes)
+      len = (code == RS_STAR_63_59) ? (uint8_t)(((RS_GetKK(code)/4)*3)) : (uint8_t)((RS_GetKK(code)*RS_GetMM(code))/8);
+      if (len > 64) {
+         len = 64;
+      }
+      plen = (uint8_t)RS_GetParityLength(code);
+      maxErr = (code == RS_SRFN_255_239) ? (uint8_t)RSCode[code].tt : 1;
+      for (nerr = 0; nerr <= maxErr; nerr++) {
+         errors = 0;
+         startMs = OS_TICK_Get_ElapsedMilliseconds();
+         for (pass = 0; pass < 200; pass++) {
+            (void)memset(sent, 0, sizeof(sent));
+            for (i = 0; i < len; i++) {
+               seed = (seed * 1664525UL) + 1013904223UL;
+               sent[i] = (uint8_t)(seed >> 24);
+            }
+            RS_Encode(code, sent, &sent[len], len);
+            (void)memcpy(frame, sent, sizeof(frame));
+            for (e = 0; e < nerr; e++) {  // Corrupt nerr different bytes
+               i = (uint8_t)((((uint32_t)pass * 7U) + ((uint32_t)e * ((len + plen) / maxErr))) % (len + plen));
+               frame[i] ^= (uint8_t)(0x5AU + e);
+            }
+            if (!RS_Decode(code, frame, &frame[len], len) || (memcmp(frame, sent, (size_t)len + plen) != 0)) {
+               errors++;
+            }
+         }
+         DBG_logPrintf('U', "RS %s %u byte errors: %u frames in %lu ms, %lu failures", codeName[code], nerr, pass,
+                       OS_TICK_Get_ElapsedMilliseconds() - startMs, errors);
+      }
+   }
+#endif
+}
+
 #if 0
 void testrs()
 {
@@ -35,6 +35,7 @@ RSCode_e RS_GetCode(PHY_MODE_e mode, PHY_MODE_PARAMETERS_e modeParameters);
 void RS_Encode(RSCode_e rscode, uint8_t const * const msg, uint8_t * const parity, uint8_t len);
 bool RS_Decode(RSCode_e rscode, uint8_t * const msg, uint8_t * const parity, uint8_t len);
 void testrs(void);
+void RS_unitTest(void);
 
 #endif
 
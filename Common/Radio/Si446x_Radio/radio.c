@@ -37,6 +37,7 @@
 #include "si446x_cmd.h"
 #include "si446x_prop.h"
 #include "DBG_SerialDebug.h"
+#include "dB_util.h"
 #if ( TM_ENHANCE_NOISEBAND_FOR_RA6E1 == 1 )
 #include "DBG_CommandLine.h"
 #endif
@@ -3225,9 +3226,9 @@ static void validatePhyPayload(uint8_t radioNum)
       }
 
       for (i=0; i<max; i++) {
-         sum += powf(10.0f, (float)(radio[radioNum].rssi[i])/10.0f); // Convert to linear and average.
+         sum += DB_toLinearTbl((int16_t)radio[radioNum].rssi[i]); // Convert to linear and average.
       }
-      radio[radioNum].buf.RxBuffer.rssi_dbm = RSSI_RAW_TO_DBM(log10f(sum/max(1,i))*10.0f);   // Save RSSI in dBm. Avoid division by 0.
+      radio[radioNum].buf.RxBuffer.rssi_dbm = RSSI_RAW_TO_DBM(DB_fromLinear(sum/max(1,i)));   // Save RSSI in dBm. Avoid division by 0.
 
       (void)memcpy(  radio[radioNum].buf.RxBuffer.Payload,
                      radio[radioNum].RadioBuffer,
@@ -4954,9 +4955,9 @@ float32_t RADIO_Filter_CCA(uint8_t radioNum, CCA_RSSI_TYPEe *processingType, uin
       // Average the values together
       sum = 0;
       for (i=0; i<RSSI_AVERAGE_SIZE; i++) {
-         sum += powf(10.0f, (float)(rssi[i])/10.0f); // Convert to linear and average.
+         sum += DB_toLinearTbl((int16_t)rssi[i]); // Convert to linear and average.
       }
-      currentRSSI = log10f(sum/RSSI_AVERAGE_SIZE)*10.0f; // Convert to dB
+      currentRSSI = DB_fromLinear(sum/RSSI_AVERAGE_SIZE); // Convert to dB
 
       // There should not be more than 8dBm difference between max and min values to be considered noise.
       // This is to reject unexpected distributions
@@ -5490,7 +5491,7 @@ static bool RADIO_NoiseEstimateBoostOn_Set(int16_t const *NoiseEstimate)
          // All values are good. Compute linear sum.
          *sum = 0;
          for ( i = 0; i < averageCount; i++ ) {
-            *sum += powf( 10.0f, averageRSSI[i] / 10.0f ); // Convert to linear.
+            *sum += DB_toLinear( averageRSSI[i] ); // Convert to linear.
          }
          return true;
       } else {
@@ -5657,7 +5658,7 @@ bool RADIO_Update_Noise_Floor(void)
                      (void)PHY_Attribute_Get( &GetReq, (PHY_ATTRIBUTES_u*)(void *)&NoiseEstimate[0]); //lint !e826 !e433  Suspicious pointer-to-pointer conversion
 
                      // Update noise
-                     NoiseEstimate[i] = (int16_t)RSSI_RAW_TO_DBM(log10f(sum/averageCount)*10.0f); // Convert to dB
+                     NoiseEstimate[i] = (int16_t)RSSI_RAW_TO_DBM(DB_fromLinear(sum/averageCount)); // Convert to dB
 
                      // Save updated noise estimate
 #if ( EP == 1 )
@@ -5890,7 +5891,7 @@ bool RADIO_Build_Noise_Floor(uint16_t const *Channels_list, uint8_t radioNum, bo
                   // Keep previous value
                } else {
                   // Update value
-                  pNoiseEstimate[i] = (int16_t)RSSI_RAW_TO_DBM(log10f(sum/averageCount)*10.0f); // Convert to dB
+                  pNoiseEstimate[i] = (int16_t)RSSI_RAW_TO_DBM(DB_fromLinear(sum/averageCount)); // Convert to dB
                }
             } else {
                // Used default value if error
@@ -5899,7 +5900,7 @@ bool RADIO_Build_Noise_Floor(uint16_t const *Channels_list, uint8_t radioNum, bo
                   pNoiseEstimate[i] = PHY_CCA_THRESHOLD_MAX;
                } else {
                   // Update value
-                  pNoiseEstimate[i] = (int16_t)RSSI_RAW_TO_DBM(log10f(sum/averageCount)*10.0f); // Convert to dB
+                  pNoiseEstimate[i] = (int16_t)RSSI_RAW_TO_DBM(DB_fromLinear(sum/averageCount)); // Convert to dB
                }
             }
             // Be nice to other tasks since we just used a lot of CPU time.
@@ -18,8 +18,17 @@
    meta-data to be maintained for *all* buffers, otherwise the extra meta-data should be placed in the data payload
    area.)
 
-   The free buffer pools are implemented using FreeRTOS queues to hold pointers to free buffers.  This leverages the
-   existing queue mechanism to support re-entrancy of these routines.
+   The free buffer pools are implemented as intrusive LIFO lists linked through the (otherwise unused while free) queue
+   element of each buffer header.  A free buffer is never on an OS queue, so no RTOS queue/semaphore object is needed;
+   push and pop are done in a short critical section that also updates the pool statistics.  A bit mask of non-empty
+   pools and a per-usage table of pool sizes built by BM_init() let bufAlloc() find the smallest non-empty pool that
+   fits the request without walking BM_bufferPoolParams.
+
+   The critical section is global, not per pool.  The pools share the non-empty pool mask and the statistics, and the
+   targets are single core, so a lock is never contended by code running in parallel: the only cost of the global lock
+   is the interrupt latency of the few instructions it covers.  A per-pool RTOS mutex would take longer than that, and
+   would still need a global lock for the mask.  BM_unitTest() reports the longest interrupts-off window and the
+   alloc/free latency percentiles.
 
    The utility also implements logic to detect attempts to free a buffer that is already free.  This is done even if the
    statistics option is disabled, although a separate statistics counter can be maintained for this software fault.
@@ -50,6 +59,7 @@
  ***********************************************************************************************************************
    Revision History:
    v0.1 - 5/1/2010 - Initial Release
+   v0.2 - Free pools are intrusive lists with a non-empty pool mask and a size-class lookup instead of RTOS queues.
 
    @version    0.1 - Ported from F1 electric
    #since      2010-05-1
@@ -57,6 +67,7 @@
 /* ****************************************************************************************************************** */
 /* INCLUDE FILES */
 #include "project.h"
+#include <assert.h>  /* static_assert */
 #if ( MCU_SELECTED == NXP_K24 )
 #include <bsp.h>
 #endif
@@ -83,6 +94,21 @@
 #else
 #define BUFFERS_NUM_MSGQ_ITEMS 0
 #endif
+#define BM_N_USAGE_TYPES       3                          /* eBM_APP, eBM_STACK and eBM_DEBUG */
+#define BM_POOL_BIT( pool )    ( ( uint32_t )1 << ( pool ) )
+#define BM_LOWEST_POOL( mask ) ( ( uint8_t )__CLZ( __RBIT( mask ) ) ) /* Index of least significant bit set in mask */
+#ifdef TM_BM_UNIT_TEST
+#if ( MCU_SELECTED == RA6E1 )
+#define BM_CYCLES()            ( DWT->CYCCNT )
+#else
+#define BM_CYCLES()            ( DWT_CYCCNT )
+#endif
+#define BM_CRIT_START( t )     ( t ) = BM_CYCLES()    /* Call right after OS_INT_disable() */
+#define BM_CRIT_END( t )       bmCritCycles( t )      /* Call right before OS_INT_enable() */
+#else
+#define BM_CRIT_START( t )
+#define BM_CRIT_END( t )
+#endif
 /* ****************************************************************************************************************** */
 /* TYPE DEFINITIONS */
 
@@ -99,12 +125,29 @@ typedef struct specLibBuffer
    void     *data;               /* void * pointer given to caller         */
 } specLibBuf_t, *pspecLibBuf_t;
 
+/* Free buffer list for one pool. Buffers are linked through x.queue.NEXT while they are free. */
+typedef struct
+{
+   buffer_t *pHead;              /* Most recently freed buffer, NULL when the pool is empty */
+   uint16_t nFree;               /* Number of buffers on the list */
+} bufferFreeList_t;
+
+/* Pools of one usage type, in increasing buffer size (and increasing pool index) order. */
+typedef struct
+{
+   uint16_t size[BUFFER_N_POOLS];      /* Buffer size of each pool of this type */
+   uint32_t fitMask[BUFFER_N_POOLS];   /* Pools of this type whose buffers are at least size[i] bytes */
+   uint8_t  nPools;                    /* Number of valid entries */
+} bufferSizeClass_t;
+
 
 /* ****************************************************************************************************************** */
 /* CONSTANTS  */
 
-/** Buffer pool queue handles */
-STATIC OS_MSGQ_Obj bufferPools_[BUFFER_N_POOLS];
+/** Buffer pool free lists */
+STATIC bufferFreeList_t bufferPools_[BUFFER_N_POOLS];
+static uint32_t poolAvailMask_;                    /* Bit n is set when pool n has at least one free buffer */
+static bufferSizeClass_t sizeClass_[BM_N_USAGE_TYPES]; /* Size-class lookup per eBM_BufferUsage_t */
 
 /* ****************************************************************************************************************** */
 
@@ -120,16 +163,27 @@ static uint32_t bExtMetaNbBuffers = 0;             // Number of external metadat
 static uint8_t      extMemPool[644000] @ "EXTERNAL_RAM" ; /*lint !e430*/
 #endif
 static OS_TICK_Struct AllocWatchDog[2];            // Keep track of the first time when run out of buffers.  Used as a form of watchdog.
+#ifdef TM_BM_UNIT_TEST
+static uint32_t bmCritMax_;                        // Longest pool critical section, in CPU cycles
+#endif
                                                    // Assume that eBM_APP = 0 and eBM_STACK = 1.
 #ifndef _lint
 static_assert( eBM_APP == 0,   "Code relies on eBM_APP being 0" );
-static_assert( eBM_STACK == 1, "Code relies on eBM_STACK being 0" );
+static_assert( eBM_STACK == 1, "Code relies on eBM_STACK being 1" );
+static_assert( eBM_DEBUG == 2, "Code relies on eBM_DEBUG being 2" );
+static_assert( BUFFER_N_POOLS <= 32, "Pool masks are 32 bits" );
 #endif
 
 /* ****************************************************************************************************************** */
 /* LOCAL FUNCTION PROTOTYPES */
 
 static buffer_t *bufAlloc( uint16_t minSize, eBM_BufferUsage_t type, const char *file, int line );
+static returnStatus_t buildSizeClasses( void );
+static uint32_t fitMask( uint16_t minSize, eBM_BufferUsage_t type );
+static void poolPush( uint8_t pool, buffer_t *pBuf );
+#ifdef TM_BM_UNIT_TEST
+static void bmCritCycles( uint32_t start );
+#endif
 
 /* ****************************************************************************************************************** */
 /* LOCAL FUNCTION DEFINITIONS */
@@ -138,8 +192,8 @@ static buffer_t *bufAlloc( uint16_t minSize, eBM_BufferUsage_t type, const char
 
    Function name: BM_init
 
-   Purpose: This routine allocates RTOS queues for the buffer pools and allocates the buffers from the system heap RAM.
-            It also clears the buffer allocation statistics.
+   Purpose: This routine builds the free lists and size-class lookup for the buffer pools and allocates the buffers
+            from the system heap RAM.  It also clears the buffer allocation statistics.
 
    Arguments: None
 
@@ -173,6 +227,8 @@ returnStatus_t BM_init( void )
    else
    {
       ( void )memset( &BM_bufferStats, 0, sizeof( BM_bufferStats ) ); //clear buffer allocation statistics
+      poolAvailMask_ = 0;
+      retVal = buildSizeClasses();
 
       // Align each meta buffer on a 32 bit boundary
       bMetaSize = ( sizeof( buffer_t ) + 3 ) & 0xFFFFFFFC;
@@ -215,13 +271,9 @@ returnStatus_t BM_init( void )
          // Allocate all buffer's data
          for ( pool = 0; ( eSUCCESS == retVal ) && ( pool < BUFFER_N_POOLS ); pool++ )
          {
-            // Create a queue to hold the buffer pointers for this pool
-            if ( OS_MSGQ_Create( &bufferPools_[pool], BM_bufferPoolParams[pool].cnt, (char *)BM_bufferPoolParams[pool].pName ) == false )
-            {
-               //Message queue creation failed
-               return eFAILURE;
-            }
-            else
+            // Start with an empty free list for this pool
+            bufferPools_[pool].pHead = NULL;
+            bufferPools_[pool].nFree = 0;
             {
                // Allocate all buffer's data
                // Align each buffer on a 32 bit boundary
@@ -255,8 +307,9 @@ returnStatus_t BM_init( void )
                         pIntMeta->x.flag.isStatic = false;
                         pIntMeta->x.flag.inQueue  = 0;
                         pIntMeta->x.dataLen       = 0;
+                        pIntMeta->headroom        = 0;
                         pIntMeta->data            = pData;
-                        OS_MSGQ_POST( &bufferPools_[pool], pIntMeta, ( bool )false, __FILE__, __LINE__ ); // Function will not return if it fails
+                        poolPush( pool, pIntMeta );
                         pIntMeta = ( buffer_t* )( void* )( ( ( uint8_t* )pIntMeta ) + bMetaSize );
                         pData += bsize;
                      }
@@ -289,8 +342,9 @@ returnStatus_t BM_init( void )
                         pExtMeta->x.flag.isStatic = false;
                         pExtMeta->x.flag.inQueue  = 0;
                         pExtMeta->x.dataLen       = 0;
+                        pExtMeta->headroom        = 0;
                         pExtMeta->data            = pData;
-                        OS_MSGQ_POST( &bufferPools_[pool], pExtMeta, ( bool )false, __FILE__, __LINE__ ); // Function will not return if it fails
+                        poolPush( pool, pExtMeta );
                         pExtMeta = ( buffer_t* )( void* )( ( ( uint8_t* )pExtMeta ) + bMetaSize );
                         pData += bsize;
                      }
@@ -310,6 +364,116 @@ returnStatus_t BM_init( void )
 #endif
    return ( retVal );
 }
+/***********************************************************************************************************************
+
+   Function name: buildSizeClasses
+
+   Purpose: Build the per-usage size-class lookup used by bufAlloc().  For each usage type, the pools of that type are
+            listed in increasing size order along with the mask of pools of that type large enough for each size.
+
+   Arguments: None
+
+   Returns: returnStatus_t - eFAILURE if the pools of a type are not listed in increasing size order in
+                             BM_bufferPoolParams (bufAlloc() relies on the lowest pool index being the smallest buffer).
+
+   Side Effects: None
+
+   Reentrant Code: No
+
+   Notes:   Called once from BM_init().
+
+ ******************************************************************************************************************** */
+static returnStatus_t buildSizeClasses( void )
+{
+   returnStatus_t     retVal = eSUCCESS;
+   bufferSizeClass_t *pClass;
+   uint8_t            pool;
+   uint8_t            i;
+
+   ( void )memset( sizeClass_, 0, sizeof( sizeClass_ ) );
+   for ( pool = 0; pool < BUFFER_N_POOLS; pool++ )
+   {
+      pClass = &sizeClass_[BM_bufferPoolParams[pool].type];
+      if ( ( 0 != pClass->nPools ) && ( BM_bufferPoolParams[pool].size <= pClass->size[pClass->nPools - 1] ) )
+      {
+         DBG_LW_printf( "BM_init: pool %u is not in increasing size order for its type\n", pool );
+         retVal = eFAILURE;
+      }
+      pClass->size[pClass->nPools] = BM_bufferPoolParams[pool].size;
+      pClass->nPools++;
+      /* This pool (and all larger ones of the same type that follow) satisfy any size up to its own */
+      for ( i = 0; i < pClass->nPools; i++ )
+      {
+         pClass->fitMask[i] |= BM_POOL_BIT( pool );
+      }
+   }
+   return retVal;
+}
+/***********************************************************************************************************************
+
+   Function name: fitMask
+
+   Purpose: Return the pools of the given usage type that have buffers of at least minSize bytes.
+
+   Arguments: uint16_t minSize - The minimum buffer size required
+              eBM_BufferUsage_t type - Usage type
+
+   Returns: uint32_t - Bit n set if pool n is of the right type and large enough. 0 if no pool is large enough.
+
+   Side Effects: None
+
+   Reentrant Code: Yes
+
+   Notes:   Binary search over the (at most a handful of) pool sizes of one type.
+
+ ******************************************************************************************************************** */
+static uint32_t fitMask( uint16_t minSize, eBM_BufferUsage_t type )
+{
+   const bufferSizeClass_t *pClass = &sizeClass_[type];
+   uint8_t lo = 0;
+   uint8_t hi = pClass->nPools;
+   uint8_t mid;
+
+   while ( lo < hi )
+   {
+      mid = ( uint8_t )( ( lo + hi ) / 2 );
+      if ( pClass->size[mid] < minSize )
+      {
+         lo = mid + 1;
+      }
+      else
+      {
+         hi = mid;
+      }
+   }
+   return ( lo < pClass->nPools ) ? pClass->fitMask[lo] : 0;
+}
+/***********************************************************************************************************************
+
+   Function name: poolPush
+
+   Purpose: Put a buffer on the free list of its pool.
+
+   Arguments: uint8_t pool - Pool index
+              buffer_t *pBuf - Buffer to return
+
+   Returns: None
+
+   Side Effects: None
+
+   Reentrant Code: No
+
+   Notes:   Must be called with interrupts disabled once the system is running (BM_init() calls it before any task or
+            ISR may allocate a buffer).
+
+ ******************************************************************************************************************** */
+static void poolPush( uint8_t pool, buffer_t *pBuf )
+{
+   pBuf->x.queue.NEXT = ( void * )bufferPools_[pool].pHead;
+   bufferPools_[pool].pHead = pBuf;
+   bufferPools_[pool].nFree++;
+   poolAvailMask_ |= BM_POOL_BIT( pool );
+}
 /***********************************************************************************************************************
 
    Function name: BM_alloc
@@ -422,6 +586,7 @@ void BM_AllocStatic( buffer_t *ptr, eSysFormat_t sysFormat )
    ptr->x.flag.isFree   = false;
    ptr->x.flag.isStatic = true; // Buffer is static. It wasn't taken from the BM pool of buffers.
    ptr->x.flag.inQueue  = 0;    // Not in a queue yet.
+   ptr->headroom        = 0;
 }
 /***********************************************************************************************************************
 
@@ -449,71 +614,93 @@ void BM_AllocStatic( buffer_t *ptr, eSysFormat_t sysFormat )
    Notes:   There is currently no concept of allocation "priority" (i.e., keeping some buffers in reserve for high-
             priority use).  Any & all callers will be given a buffer if there are any available of a satisfactory size.
 
+            The pool is chosen from the size-class lookup and the non-empty pool mask; the pop from the free list and
+            the statistics update share one critical section (global, see the file header for why it is not per pool).
+
  ******************************************************************************************************************** */
 static buffer_t *bufAlloc( uint16_t minSize, eBM_BufferUsage_t type, const char *file, int line )
 {
-   uint8_t pool;
+   uint8_t pool = 0;
+   uint32_t candidates;    /* Pools of the requested type large enough for minSize */
+   uint32_t available;     /* Candidate pools that are not empty */
+   uint32_t empty;         /* Candidate pools smaller than the one used that had no free buffer */
    buffer_t *pBuf = NULL;
    OS_TICK_Struct CurrentTime;
 #if ( RTOS_SELECTION == MQX_RTOS )
    bool           overflow;
+#endif
+#ifdef TM_BM_UNIT_TEST
+   uint32_t critStart;     /* Cycle count when interrupts were disabled */
 #endif
    static bool outOfBuffErrorLogged_ = false; //To restrict logging out of buffers event/error once per power up
 
-   for ( pool = 0; pool < BUFFER_N_POOLS; pool++ )
+   candidates = fitMask( minSize, type );
+
+   OS_INT_disable( );
+   BM_CRIT_START( critStart );
+   available = candidates & poolAvailMask_;
+   if ( 0 != available )
    {
-      if ( ( type != BM_bufferPoolParams[pool].type ) || ( BM_bufferPoolParams[pool].size < minSize ) )
+      /* Pools of a type are in increasing size order, so the lowest pool index is the smallest buffer that fits */
+      pool = BM_LOWEST_POOL( available );
+      pBuf = bufferPools_[pool].pHead;
+      bufferPools_[pool].pHead = ( buffer_t * )( void * )pBuf->x.queue.NEXT;
+      bufferPools_[pool].nFree--;
+      if ( 0 == bufferPools_[pool].nFree )
+      {
+         poolAvailMask_ &= ~BM_POOL_BIT( pool );
+      }
+      pBuf->x.queue.NEXT = NULL;
+
+      BM_bufferStats.pool[pool].allocOk++;
+      BM_bufferStats.pool[pool].currAlloc++;
+      if ( BM_bufferStats.pool[pool].currAlloc > BM_bufferStats.pool[pool].highwater )
       {
-         /* Wrong type or buffer size of this pool is too small - keep searching */
-         continue;
+         BM_bufferStats.pool[pool].highwater = BM_bufferStats.pool[pool].currAlloc;
       }
-      if ( OS_MSGQ_PEND( &bufferPools_[pool], ( void * )&pBuf, 0, ( bool )false, __FILE__, __LINE__ ) )
+      empty = candidates & ( BM_POOL_BIT( pool ) - 1U );  /* Smaller pools that fit but were empty */
+   }
+   else
+   {
+      empty = candidates;
+   }
+   while ( 0 != empty )
+   {
+      /* pool empty - the remaining pools (in increasing size order) were tried */
+      BM_bufferStats.pool[BM_LOWEST_POOL( empty )].allocFail++;
+      empty &= empty - 1U;
+   }
+   BM_CRIT_END( critStart );
+   OS_INT_enable( );
+
+   if ( NULL != pBuf )
+   {
+      // Do some sanity check
+      if ( pBuf->x.flag.inQueue )
       {
-         /* was able to allocate a buffer */
-         // Do some sanity check
-         if ( pBuf->x.flag.inQueue )
-         {
-            // The buffer is in use.
+         // The buffer is in use.
 #if ( MCU_SELECTED == RA6E1 )
-            DBG_LW_printf( "\nERROR: BM_alloc got a buffer marked as in used (pending on a queue). Size: %u, pool = %u, addr=0x%p\n"
-                        "ERROR: BM_alloc called from %s:%d", minSize, pool, pBuf, file, line );
+         DBG_LW_printf( "\nERROR: BM_alloc got a buffer marked as in used (pending on a queue). Size: %u, pool = %u, addr=0x%p\n"
+                     "ERROR: BM_alloc called from %s:%d", minSize, pool, pBuf, file, line );
 #elif  ( MCU_SELECTED == NXP_K24 ) || ( DCU == 1 ) )
-            DBG_printf( "\nERROR: BM_alloc got a buffer marked as in used (pending on a queue). Size: %u, pool = %u, addr=0x%p\n"
-                        "ERROR: BM_alloc called from %s:%d", minSize, pool, pBuf, file, line );
+         DBG_printf( "\nERROR: BM_alloc got a buffer marked as in used (pending on a queue). Size: %u, pool = %u, addr=0x%p\n"
+                     "ERROR: BM_alloc called from %s:%d", minSize, pool, pBuf, file, line );
 #endif
-         }
-#if (BM_DEBUG==1)
-         if ( strcasecmp( file, "dbg_serialdebug.c" ) != 0 )
-         {
-            char *name = OS_TASK_GetTaskName();
-            DBG_printf( "\nalloc pool: %2d, reqSize: %4d, poolSize:%4d, ptr: 0x%08x, addr: 0x%08x, called from (%s) %s:%d",
-                        pool, minSize, BM_bufferPoolParams[pool].size, ( uint32_t )pBuf, pBuf->data, name, file, line );
-         }
-#endif
-         pBuf->pfile             = file;
-         pBuf->line              = ( uint32_t )line;
-         pBuf->x.flag.isFree     = false; // buffer has been allocated
-         pBuf->x.flag.isStatic   = false;
-         pBuf->x.flag.inQueue    = 0; // Not in queue yet
-         pBuf->x.dataLen         = minSize; /* Initialize this with the size requested */
-
-         OS_INT_disable( );
-
-         BM_bufferStats.pool[pool].allocOk++;
-         BM_bufferStats.pool[pool].currAlloc++;
-         if ( BM_bufferStats.pool[pool].currAlloc > BM_bufferStats.pool[pool].highwater )
-         {
-            BM_bufferStats.pool[pool].highwater = BM_bufferStats.pool[pool].currAlloc;
-         }
-         OS_INT_enable( );
-         break;
       }
-      else
+#if (BM_DEBUG==1)
+      if ( strcasecmp( file, "dbg_serialdebug.c" ) != 0 )
       {
-         OS_INT_disable( );
-         BM_bufferStats.pool[pool].allocFail++; /* pool empty - try remaining pools (in increasing size order) */
-         OS_INT_enable( );
+         char *name = OS_TASK_GetTaskName();
+         DBG_printf( "\nalloc pool: %2d, reqSize: %4d, poolSize:%4d, ptr: 0x%08x, addr: 0x%08x, called from (%s) %s:%d",
+                     pool, minSize, BM_bufferPoolParams[pool].size, ( uint32_t )pBuf, pBuf->data, name, file, line );
       }
+#endif
+      pBuf->pfile             = file;
+      pBuf->line              = ( uint32_t )line;
+      pBuf->x.flag.isFree     = false; // buffer has been allocated
+      pBuf->x.flag.isStatic   = false;
+      pBuf->x.flag.inQueue    = 0; // Not in queue yet
+      pBuf->x.dataLen         = minSize; /* Initialize this with the size requested */
    }
    if ( NULL == pBuf )
    {
@@ -641,32 +828,49 @@ void BM_Free( buffer_t *pBuf, const char *file, int line )
          }
          pBuf->x.flag.isFree = true; // Mark as free
 
+         // Give back any headroom so the next owner sees the whole data area
+         pBuf->data    -= pBuf->headroom;
+         pBuf->headroom = 0;
+
          // Free buffer only if not static
          if ( !pBuf->x.flag.isStatic )
          {
-            OS_MSGQ_POST( &bufferPools_[pool], pBuf, ( bool )false, __FILE__, __LINE__ ); // Function will not return if it fails
+            bool     countOk = ( bool )false;  /* currAlloc was non-zero when the buffer was returned */
+            uint16_t dataLen = pBuf->x.dataLen;
+            const char *pAllocFile = pBuf->pfile;
+            uint32_t allocLine = pBuf->line;
+#ifdef TM_BM_UNIT_TEST
+            uint32_t critStart;        /* Cycle count when interrupts were disabled */
+#endif
+
             // Place buffer in pool
+            OS_INT_disable( );
+            BM_CRIT_START( critStart );
+            if ( BM_bufferStats.pool[pool].currAlloc != 0 )
+            {
+               BM_bufferStats.pool[pool].currAlloc--;
+               BM_bufferStats.pool[pool].freeOk++;
+               countOk = ( bool )true;
+            }
+            poolPush( pool, pBuf );    /* pBuf may be reallocated as soon as interrupts are enabled */
+            BM_CRIT_END( critStart );
+            OS_INT_enable( );
 #if (BM_DEBUG==1)
             if ( strcasecmp( file, "dbg_serialdebug.c" ) != 0 )
             {
                char *name = _task_get_template_ptr( _task_get_id() )->TASK_NAME;
                DBG_printf( "\nfree  pool: %2d, reqSize: %4d, poolSize:%4d, ptr: 0x%08x, called from (%s) %s:%d, Allocator: %s, line: %d",
-                           pool, pBuf->x.dataLen, BM_bufferPoolParams[pool].size, ( uint32_t )pBuf, name, file, line, pBuf->pfile,
-                           pBuf->line );
+                           pool, dataLen, BM_bufferPoolParams[pool].size, ( uint32_t )pBuf, name, file, line, pAllocFile,
+                           allocLine );
             }
 #endif
-            if ( BM_bufferStats.pool[pool].currAlloc != 0 )
-            {
-               BM_bufferStats.pool[pool].currAlloc--;
-               BM_bufferStats.pool[pool].freeOk++;
-            }
-            else
+            if ( !countOk )
             {
                char *name = OS_TASK_GetTaskName();
                DBG_printf( "\nfree  pool: %2d, reqSize: %4d, poolSize:%4d, ptr: 0x%08x, "
                            "called from (%s) %s:%d, Allocator: %s, line: %d\n"
-                           "Current allocation already ZERO", pool, pBuf->x.dataLen, BM_bufferPoolParams[pool].size, ( uint32_t )pBuf,
-                           name, file, line, pBuf->pfile, pBuf->line );
+                           "Current allocation already ZERO", pool, dataLen, BM_bufferPoolParams[pool].size, ( uint32_t )pBuf,
+                           name, file, line, pAllocFile, allocLine );
             }
 
             // Reset AllocWatchdog
@@ -681,6 +885,73 @@ void BM_Free( buffer_t *pBuf, const char *file, int line )
    OS_MUTEX_Unlock( &bufMutex_ ); // Function will not return if it fails
 }
 
+/***********************************************************************************************************************
+
+   Function name: BM_Reserve
+
+   Purpose: Reserve room at the front of a freshly allocated buffer for headers that a lower layer will prepend. data is
+   moved past the reserved bytes and dataLen is reduced by the same amount, so the caller writes its payload at data as
+   usual.
+
+   Arguments: buffer_t *pBuf - The buffer
+              uint16_t len   - Number of bytes to reserve
+
+   Returns: eSUCCESS if the room was reserved, eFAILURE if the buffer is too small (the buffer is left unchanged)
+
+   Side Effects: None
+
+   Reentrant Code: Yes
+
+   Notes: Reserving is cumulative. The headroom is given back when the buffer is freed.
+
+ ******************************************************************************************************************** */
+returnStatus_t BM_Reserve( buffer_t *pBuf, uint16_t len )
+{
+   returnStatus_t retVal = eFAILURE;
+
+   if ( ( uint32_t )pBuf->headroom + len <= pBuf->bufMaxSize )
+   {
+      pBuf->data     += len;
+      pBuf->headroom += len;
+      pBuf->x.dataLen = ( pBuf->x.dataLen > len ) ? ( uint16_t )( pBuf->x.dataLen - len ) : 0U;
+      retVal = eSUCCESS;
+   }
+   return retVal;
+}
+
+/***********************************************************************************************************************
+
+   Function name: BM_Push
+
+   Purpose: Claim len bytes of headroom in front of the current data. Used by a lower layer to prepend its header to a
+   payload that was built in place.
+
+   Arguments: buffer_t *pBuf - The buffer
+              uint16_t len   - Size of the header to prepend
+
+   Returns: uint8_t * - The new start of data (where the header goes), or NULL if there is not enough headroom
+
+   Side Effects: None
+
+   Reentrant Code: Yes
+
+   Notes: dataLen grows by len.
+
+ ******************************************************************************************************************** */
+uint8_t *BM_Push( buffer_t *pBuf, uint16_t len )
+{
+   uint8_t *pData = NULL;
+
+   if ( len <= pBuf->headroom )
+   {
+      pBuf->data     -= len;
+      pBuf->headroom -= len;
+      pBuf->x.dataLen = ( uint16_t )( pBuf->x.dataLen + len );
+      pData = pBuf->data;
+   }
+   return pData;
+}
+
 /***********************************************************************************************************************
 
    Function name: BM_getStats
@@ -928,3 +1199,134 @@ void BM_SpecLibFree( void *ptr )
    origBuf = *( buffer_t **)(void *)(( uint8_t *)ptr - sizeof( buffer_t * ) );
    BM_free( origBuf );
 }
+
+#ifdef TM_BM_UNIT_TEST
+/***********************************************************************************************************************
+
+   Function Name: bmCritCycles
+
+   Purpose: Record the length of a pool critical section
+
+   Arguments: uint32_t start - BM_CYCLES() when interrupts were disabled
+
+   Returns: None
+
+   Side Effects: None
+
+   Reentrant Code: No. Called with interrupts disabled.
+
+ **********************************************************************************************************************/
+static void bmCritCycles( uint32_t start )
+{
+   uint32_t cycles = BM_CYCLES() - start;
+
+   if ( cycles > bmCritMax_ )
+   {
+      bmCritMax_ = cycles;
+   }
+}
+#endif
+/***********************************************************************************************************************
+
+   Function Name: BM_unitTest
+
+   Purpose: Check the size-class lookup against a linear search of BM_bufferPoolParams, time alloc/free pairs and report
+            the longest time interrupts were disabled by the pools.
+
+   Arguments: none
+
+   Returns: none
+
+   Side Effects: Briefly allocates one buffer of each tested size.
+
+   Reentrant Code: No
+
+   Notes: Latencies are in CPU cycles, in a histogram of BM_TST_BUCKET cycle wide buckets. The percentiles are the upper
+          edge of the bucket they fall in. Run it while the rest of the system is busy to include preemption.
+
+ **********************************************************************************************************************/
+void BM_unitTest( void )
+{
+#ifdef TM_BM_UNIT_TEST
+#define BM_TST_PAIRS    10000U   /* Alloc/free pairs timed per buffer size */
+#define BM_TST_BUCKET   32U      /* Histogram bucket width, in cycles */
+#define BM_TST_BUCKETS  64U      /* Last bucket counts everything longer */
+   static const uint16_t tstSize[] = { 40, 1000 };   /* A small and a large application buffer */
+   static uint32_t   hist[BM_TST_BUCKETS];
+   buffer_t         *pBuf;
+   uint32_t          errors = 0;
+   uint32_t          expected;
+   uint32_t          start;
+   uint32_t          cycles;
+   uint32_t          maxCycles;
+   uint32_t          p50;
+   uint32_t          p99;
+   uint32_t          sum;
+   uint32_t          i;
+   uint16_t          size;
+   uint8_t           type;
+   uint8_t           pool;
+
+   /* Size-class lookup vs linear search, every size up to one past the largest pool */
+   for ( type = 0; type < BM_N_USAGE_TYPES; type++ )
+   {
+      for ( size = 0; size <= 2048U; size++ )
+      {
+         expected = 0;
+         for ( pool = 0; pool < BUFFER_N_POOLS; pool++ )
+         {
+            if ( ( type == ( uint8_t )BM_bufferPoolParams[pool].type ) && ( BM_bufferPoolParams[pool].size >= size ) )
+            {
+               expected |= BM_POOL_BIT( pool );
+            }
+         }
+         errors += ( expected != fitMask( size, ( eBM_BufferUsage_t )type ) );
+      }
+   }
+   DBG_logPrintf( 'U', "BM size-class lookup: %lu errors", errors );
+
+   /* Latency of alloc/free pairs */
+   bmCritMax_ = 0;
+   for ( type = 0; type < ARRAY_IDX_CNT( tstSize ); type++ )
+   {
+      ( void )memset( hist, 0, sizeof( hist ) );
+      maxCycles = 0;
+      errors = 0;
+      for ( i = 0; i < BM_TST_PAIRS; i++ )
+      {
+         start = BM_CYCLES();
+         pBuf = BM_alloc( tstSize[type] );
+         if ( NULL == pBuf )
+         {
+            errors++;
+            continue;
+         }
+         BM_free( pBuf );
+         cycles = BM_CYCLES() - start;
+         hist[ min( cycles / BM_TST_BUCKET, BM_TST_BUCKETS - 1U ) ]++;
+         if ( cycles > maxCycles )
+         {
+            maxCycles = cycles;
+         }
+      }
+      p50 = 0;
+      p99 = 0;
+      sum = 0;
+      for ( i = 0; i < BM_TST_BUCKETS; i++ )
+      {
+         sum += hist[i];
+         if ( ( 0 == p50 ) && ( ( sum * 100U ) >= ( ( BM_TST_PAIRS - errors ) * 50U ) ) )
+         {
+            p50 = ( i + 1U ) * BM_TST_BUCKET;
+         }
+         if ( ( 0 == p99 ) && ( ( sum * 100U ) >= ( ( BM_TST_PAIRS - errors ) * 99U ) ) )
+         {
+            p99 = ( i + 1U ) * BM_TST_BUCKET;
+         }
+      }
+      DBG_logPrintf( 'U', "BM alloc/free %u bytes: p50 <= %lu, p99 <= %lu, max %lu cycles, %lu allocs failed",
+                     tstSize[type], p50, p99, maxCycles, errors );
+   }
+   DBG_logPrintf( 'U', "BM longest interrupts off window: %lu cycles", bmCritMax_ );
+#endif
+}
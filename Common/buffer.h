@@ -247,12 +247,17 @@ BM_EXTERN const bufferPoolParams_t BM_bufferPoolParams[14]   /* Note:  Must chan
  *    - bufMaxSize:  read-only  - indicates allocated (max) size of data field
  *    - data:        read/write - application stores data here
  *  The other fields should be consider as private and should not be accessed.
+ *
+ *  A layer that knows a lower layer will prepend a header can reserve room for it with BM_Reserve() before writing its
+ *  payload. data then points past the reserved area, and the lower layer claims the room back with BM_Push() instead of
+ *  copying the payload into a new buffer. bufMaxSize always describes the whole data area, headroom included.
  */
 typedef struct
 {
     OS_QUEUE_Element x;            /*!< ! Must be here for MQX to use this buffer in messages. */
     eSysFormat_t     eSysFmt;      /**< User filled - This is the format of the buffer */
     uint16_t         bufMaxSize;   /**< physical size of the data area */
+    uint16_t         headroom;     /**< bytes reserved in front of data. Private, use BM_Reserve/BM_Push */
     const char       *pfile;       /* Pointer to file name that allocated the buffer     */
     uint32_t         line;         /* Line number in the file that allocated the buffer  */
     /* Make sure data is on 32-bit boundary */
@@ -301,6 +306,7 @@ BM_EXTERN bufferStats_t BM_bufferStats;      /* buffer allocation statistics */
 
 #ifdef ERROR_CODES_H_
 returnStatus_t BM_init(void);
+returnStatus_t BM_Reserve( buffer_t *pBuf, uint16_t len );
 #endif
 buffer_t       *BM_Alloc(uint16_t minSize, const char *file, int line);
 buffer_t       *BM_AllocDebug( uint16_t minSize, const char *file, int line );
@@ -313,9 +319,11 @@ void           *BM_SpecLibMalloc( size_t reqSize );
 void           BM_SpecLibFree( void *ptr );
 void           BM_AllocStatic( buffer_t *ptr, eSysFormat_t sysFormat );
 void           BM_Free(buffer_t *pBuf, const char *file, int line );
+uint8_t        *BM_Push( buffer_t *pBuf, uint16_t len );
 void           BM_getStats(bufferStats_t *pStats);
 void           BM_resetStats( void );
 void           BM_showAlloc( bool safePrint );
+void           BM_unitTest( void );
 #undef BM_EXTERN
 
 #endif /* !_BUFFER_H_ */
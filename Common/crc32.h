@@ -52,6 +52,15 @@
 #define CRC32_DFW_START_VALUE    ((uint32_t)0xffffffff)
 #define CRC32_DFW_POLY           ((uint32_t)0xEDB88320)
 
+/* CRC32_SLICE_BY_4:  1 = Process four bytes per step for the DFW polynomial (adds 3K of tables), 0 = one byte per step */
+#ifndef CRC32_SLICE_BY_4
+#ifdef __BOOTLOADER
+#define CRC32_SLICE_BY_4         0
+#else
+#define CRC32_SLICE_BY_4         1
+#endif
+#endif
+
 /* ****************************************************************************************************************** */
 /* TYPE DEFINITIONS */
 
@@ -99,6 +108,16 @@ void CRC32_init(uint32_t startVal, uint32_t poly, eCRC32_Result_t invertResult,
  */
 uint32_t CRC32_calc(void const *pData, uint32_t cnt, crc32Cfg_t *pCrcCfg);
 
+/**
+ * CRC32_calcBitwise - Same as CRC32_calc but always computed one bit at a time.  Reference implementation.
+ *
+ * @param  uint8_t *pData - Source data for the CRC
+ * @param  uint32_t cnt - Number of bytes in pData
+ * @param  crc32Cfg_t *pCrcCfg - Configuration of the CRC (don't modify this!)
+ * @return uint32_t - Resulting CRC32 (ignore this until the last CRC calculation is called)
+ */
+uint32_t CRC32_calcBitwise(void const *pData, uint32_t cnt, crc32Cfg_t *pCrcCfg);
+
 
 
 #endif
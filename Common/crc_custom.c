@@ -44,6 +44,80 @@
 
 /* CONSTANTS */
 
+/* Byte-wise lookup table for CRC_CUSTOM_PHY_HDR_POLY (PHY header CRC16) */
+static const uint16_t crc16PhyHdrTable_[256] =
+{
+   0x0000, 0x53EB, 0xA7D6, 0xF43D, 0x1C47, 0x4FAC, 0xBB91, 0xE87A,
+   0x388E, 0x6B65, 0x9F58, 0xCCB3, 0x24C9, 0x7722, 0x831F, 0xD0F4,
+   0x711C, 0x22F7, 0xD6CA, 0x8521, 0x6D5B, 0x3EB0, 0xCA8D, 0x9966,
+   0x4992, 0x1A79, 0xEE44, 0xBDAF, 0x55D5, 0x063E, 0xF203, 0xA1E8,
+   0xE238, 0xB1D3, 0x45EE, 0x1605, 0xFE7F, 0xAD94, 0x59A9, 0x0A42,
+   0xDAB6, 0x895D, 0x7D60, 0x2E8B, 0xC6F1, 0x951A, 0x6127, 0x32CC,
+   0x9324, 0xC0CF, 0x34F2, 0x6719, 0x8F63, 0xDC88, 0x28B5, 0x7B5E,
+   0xABAA, 0xF841, 0x0C7C, 0x5F97, 0xB7ED, 0xE406, 0x103B, 0x43D0,
+   0x979B, 0xC470, 0x304D, 0x63A6, 0x8BDC, 0xD837, 0x2C0A, 0x7FE1,
+   0xAF15, 0xFCFE, 0x08C3, 0x5B28, 0xB352, 0xE0B9, 0x1484, 0x476F,
+   0xE687, 0xB56C, 0x4151, 0x12BA, 0xFAC0, 0xA92B, 0x5D16, 0x0EFD,
+   0xDE09, 0x8DE2, 0x79DF, 0x2A34, 0xC24E, 0x91A5, 0x6598, 0x3673,
+   0x75A3, 0x2648, 0xD275, 0x819E, 0x69E4, 0x3A0F, 0xCE32, 0x9DD9,
+   0x4D2D, 0x1EC6, 0xEAFB, 0xB910, 0x516A, 0x0281, 0xF6BC, 0xA557,
+   0x04BF, 0x5754, 0xA369, 0xF082, 0x18F8, 0x4B13, 0xBF2E, 0xECC5,
+   0x3C31, 0x6FDA, 0x9BE7, 0xC80C, 0x2076, 0x739D, 0x87A0, 0xD44B,
+   0x7CDD, 0x2F36, 0xDB0B, 0x88E0, 0x609A, 0x3371, 0xC74C, 0x94A7,
+   0x4453, 0x17B8, 0xE385, 0xB06E, 0x5814, 0x0BFF, 0xFFC2, 0xAC29,
+   0x0DC1, 0x5E2A, 0xAA17, 0xF9FC, 0x1186, 0x426D, 0xB650, 0xE5BB,
+   0x354F, 0x66A4, 0x9299, 0xC172, 0x2908, 0x7AE3, 0x8EDE, 0xDD35,
+   0x9EE5, 0xCD0E, 0x3933, 0x6AD8, 0x82A2, 0xD149, 0x2574, 0x769F,
+   0xA66B, 0xF580, 0x01BD, 0x5256, 0xBA2C, 0xE9C7, 0x1DFA, 0x4E11,
+   0xEFF9, 0xBC12, 0x482F, 0x1BC4, 0xF3BE, 0xA055, 0x5468, 0x0783,
+   0xD777, 0x849C, 0x70A1, 0x234A, 0xCB30, 0x98DB, 0x6CE6, 0x3F0D,
+   0xEB46, 0xB8AD, 0x4C90, 0x1F7B, 0xF701, 0xA4EA, 0x50D7, 0x033C,
+   0xD3C8, 0x8023, 0x741E, 0x27F5, 0xCF8F, 0x9C64, 0x6859, 0x3BB2,
+   0x9A5A, 0xC9B1, 0x3D8C, 0x6E67, 0x861D, 0xD5F6, 0x21CB, 0x7220,
+   0xA2D4, 0xF13F, 0x0502, 0x56E9, 0xBE93, 0xED78, 0x1945, 0x4AAE,
+   0x097E, 0x5A95, 0xAEA8, 0xFD43, 0x1539, 0x46D2, 0xB2EF, 0xE104,
+   0x31F0, 0x621B, 0x9626, 0xC5CD, 0x2DB7, 0x7E5C, 0x8A61, 0xD98A,
+   0x7862, 0x2B89, 0xDFB4, 0x8C5F, 0x6425, 0x37CE, 0xC3F3, 0x9018,
+   0x40EC, 0x1307, 0xE73A, 0xB4D1, 0x5CAB, 0x0F40, 0xFB7D, 0xA896
+};
+
+/* Byte-wise lookup table for CRC_CUSTOM_PHY_PAYLOAD_POLY (PHY payload CRC32) */
+static const uint32_t crc32PhyPayloadTable_[256] =
+{
+   0x00000000, 0xF4ACFB13, 0x1DF50D35, 0xE959F626, 0x3BEA1A6A, 0xCF46E179, 0x261F175F, 0xD2B3EC4C,
+   0x77D434D4, 0x8378CFC7, 0x6A2139E1, 0x9E8DC2F2, 0x4C3E2EBE, 0xB892D5AD, 0x51CB238B, 0xA567D898,
+   0xEFA869A8, 0x1B0492BB, 0xF25D649D, 0x06F19F8E, 0xD44273C2, 0x20EE88D1, 0xC9B77EF7, 0x3D1B85E4,
+   0x987C5D7C, 0x6CD0A66F, 0x85895049, 0x7125AB5A, 0xA3964716, 0x573ABC05, 0xBE634A23, 0x4ACFB130,
+   0x2BFC2843, 0xDF50D350, 0x36092576, 0xC2A5DE65, 0x10163229, 0xE4BAC93A, 0x0DE33F1C, 0xF94FC40F,
+   0x5C281C97, 0xA884E784, 0x41DD11A2, 0xB571EAB1, 0x67C206FD, 0x936EFDEE, 0x7A370BC8, 0x8E9BF0DB,
+   0xC45441EB, 0x30F8BAF8, 0xD9A14CDE, 0x2D0DB7CD, 0xFFBE5B81, 0x0B12A092, 0xE24B56B4, 0x16E7ADA7,
+   0xB380753F, 0x472C8E2C, 0xAE75780A, 0x5AD98319, 0x886A6F55, 0x7CC69446, 0x959F6260, 0x61339973,
+   0x57F85086, 0xA354AB95, 0x4A0D5DB3, 0xBEA1A6A0, 0x6C124AEC, 0x98BEB1FF, 0x71E747D9, 0x854BBCCA,
+   0x202C6452, 0xD4809F41, 0x3DD96967, 0xC9759274, 0x1BC67E38, 0xEF6A852B, 0x0633730D, 0xF29F881E,
+   0xB850392E, 0x4CFCC23D, 0xA5A5341B, 0x5109CF08, 0x83BA2344, 0x7716D857, 0x9E4F2E71, 0x6AE3D562,
+   0xCF840DFA, 0x3B28F6E9, 0xD27100CF, 0x26DDFBDC, 0xF46E1790, 0x00C2EC83, 0xE99B1AA5, 0x1D37E1B6,
+   0x7C0478C5, 0x88A883D6, 0x61F175F0, 0x955D8EE3, 0x47EE62AF, 0xB34299BC, 0x5A1B6F9A, 0xAEB79489,
+   0x0BD04C11, 0xFF7CB702, 0x16254124, 0xE289BA37, 0x303A567B, 0xC496AD68, 0x2DCF5B4E, 0xD963A05D,
+   0x93AC116D, 0x6700EA7E, 0x8E591C58, 0x7AF5E74B, 0xA8460B07, 0x5CEAF014, 0xB5B30632, 0x411FFD21,
+   0xE47825B9, 0x10D4DEAA, 0xF98D288C, 0x0D21D39F, 0xDF923FD3, 0x2B3EC4C0, 0xC26732E6, 0x36CBC9F5,
+   0xAFF0A10C, 0x5B5C5A1F, 0xB205AC39, 0x46A9572A, 0x941ABB66, 0x60B64075, 0x89EFB653, 0x7D434D40,
+   0xD82495D8, 0x2C886ECB, 0xC5D198ED, 0x317D63FE, 0xE3CE8FB2, 0x176274A1, 0xFE3B8287, 0x0A977994,
+   0x4058C8A4, 0xB4F433B7, 0x5DADC591, 0xA9013E82, 0x7BB2D2CE, 0x8F1E29DD, 0x6647DFFB, 0x92EB24E8,
+   0x378CFC70, 0xC3200763, 0x2A79F145, 0xDED50A56, 0x0C66E61A, 0xF8CA1D09, 0x1193EB2F, 0xE53F103C,
+   0x840C894F, 0x70A0725C, 0x99F9847A, 0x6D557F69, 0xBFE69325, 0x4B4A6836, 0xA2139E10, 0x56BF6503,
+   0xF3D8BD9B, 0x07744688, 0xEE2DB0AE, 0x1A814BBD, 0xC832A7F1, 0x3C9E5CE2, 0xD5C7AAC4, 0x216B51D7,
+   0x6BA4E0E7, 0x9F081BF4, 0x7651EDD2, 0x82FD16C1, 0x504EFA8D, 0xA4E2019E, 0x4DBBF7B8, 0xB9170CAB,
+   0x1C70D433, 0xE8DC2F20, 0x0185D906, 0xF5292215, 0x279ACE59, 0xD336354A, 0x3A6FC36C, 0xCEC3387F,
+   0xF808F18A, 0x0CA40A99, 0xE5FDFCBF, 0x115107AC, 0xC3E2EBE0, 0x374E10F3, 0xDE17E6D5, 0x2ABB1DC6,
+   0x8FDCC55E, 0x7B703E4D, 0x9229C86B, 0x66853378, 0xB436DF34, 0x409A2427, 0xA9C3D201, 0x5D6F2912,
+   0x17A09822, 0xE30C6331, 0x0A559517, 0xFEF96E04, 0x2C4A8248, 0xD8E6795B, 0x31BF8F7D, 0xC513746E,
+   0x6074ACF6, 0x94D857E5, 0x7D81A1C3, 0x892D5AD0, 0x5B9EB69C, 0xAF324D8F, 0x466BBBA9, 0xB2C740BA,
+   0xD3F4D9C9, 0x275822DA, 0xCE01D4FC, 0x3AAD2FEF, 0xE81EC3A3, 0x1CB238B0, 0xF5EBCE96, 0x01473585,
+   0xA420ED1D, 0x508C160E, 0xB9D5E028, 0x4D791B3B, 0x9FCAF777, 0x6B660C64, 0x823FFA42, 0x76930151,
+   0x3C5CB061, 0xC8F04B72, 0x21A9BD54, 0xD5054647, 0x07B6AA0B, 0xF31A5118, 0x1A43A73E, 0xEEEF5C2D,
+   0x4B8884B5, 0xBF247FA6, 0x567D8980, 0xA2D17293, 0x70629EDF, 0x84CE65CC, 0x6D9793EA, 0x993B68F9
+};
+
 /* ****************************************************************************************************************** */
 
 /* GLOBAL VARIABLES */
@@ -74,6 +148,41 @@ uint16_t CRC_CUSTOM_16cal( uint16_t crc16Polynomial, uint16_t seed, const void *
 {
    uint16_t calculatedCRC = seed;
 
+   if ( CRC_CUSTOM_PHY_HDR_POLY == crc16Polynomial )
+   {
+      const unsigned char *x = (const unsigned char *)data;
+      while ( length-- )
+      {
+         calculatedCRC = (uint16_t)( ( calculatedCRC << 8 ) ^ crc16PhyHdrTable_[( calculatedCRC >> 8 ) ^ *x++] );
+      }
+   }
+   else
+   {  /* No table for this polynomial */
+      calculatedCRC = CRC_CUSTOM_16calBitwise( crc16Polynomial, seed, data, length );
+   }
+
+   return calculatedCRC;
+}
+/*******************************************************************************
+
+   Function name: CRC_CUSTOM_16calBitwise
+
+   Purpose: Bit at a time version of CRC_CUSTOM_16cal
+
+   Arguments: uint16_t crc16Polynomial - Polynomial for the crc16 calculation
+              uint16_t seed - inital value of the CRC
+              const void *data - data buffer
+              size_t length  - size of the data buffer
+
+   Returns: calculated CRC16 value
+
+   Notes: Used for polynomials without a lookup table and as the reference for the table driven calculation
+
+*******************************************************************************/
+uint16_t CRC_CUSTOM_16calBitwise( uint16_t crc16Polynomial, uint16_t seed, const void *data, size_t length )
+{
+   uint16_t calculatedCRC = seed;
+
    size_t i, j;
 
    const unsigned char *x = (const unsigned char *)data;
@@ -113,6 +222,41 @@ uint32_t CRC_CUSTOM_32cal(uint32_t crc32Polynomial, uint32_t seed, const void *d
 {
    uint32_t calculatedCRC = seed;
 
+   if ( CRC_CUSTOM_PHY_PAYLOAD_POLY == crc32Polynomial )
+   {
+      const unsigned char *x = (const unsigned char *)data;
+      while ( length-- )
+      {
+         calculatedCRC = ( calculatedCRC << 8 ) ^ crc32PhyPayloadTable_[( calculatedCRC >> 24 ) ^ *x++];
+      }
+   }
+   else
+   {  /* No table for this polynomial */
+      calculatedCRC = CRC_CUSTOM_32calBitwise( crc32Polynomial, seed, data, length );
+   }
+
+   return calculatedCRC;
+}
+/*******************************************************************************
+
+   Function name: CRC_CUSTOM_32calBitwise
+
+   Purpose: Bit at a time version of CRC_CUSTOM_32cal
+
+   Arguments: uint32_t crc132Polynomial - Polynomial for the crc32 calculation
+              uint32_t seed - inital value of the CRC
+              const void *data - data buffer
+              size_t length  - size of the data buffer
+
+   Returns: calculated CRC32 value
+
+   Notes: Used for polynomials without a lookup table and as the reference for the table driven calculation
+
+*******************************************************************************/
+uint32_t CRC_CUSTOM_32calBitwise(uint32_t crc32Polynomial, uint32_t seed, const void *data, size_t length)
+{
+   uint32_t calculatedCRC = seed;
+
    size_t i, j;
 
    const unsigned char *x = (const unsigned char *)data;
@@ -29,6 +29,8 @@
 /* ****************************************************************************************************************** */
 
 /* MACRO DEFINITIONS */
+#define CRC_CUSTOM_PHY_HDR_POLY        ((uint16_t)0x53EB)      /* PHY header CRC16 polynomial (has a lookup table) */
+#define CRC_CUSTOM_PHY_PAYLOAD_POLY    ((uint32_t)0xF4ACFB13)  /* PHY payload CRC32 polynomial (has a lookup table) */
 
 /* ****************************************************************************************************************** */
 
@@ -47,5 +49,7 @@
 /* FUNCTION PROTOTYPES */
 uint16_t CRC_CUSTOM_16cal( uint16_t crc16Polynomial, uint16_t seed, const void *data, size_t length );
 uint32_t CRC_CUSTOM_32cal(uint32_t crc32Polynomial, uint32_t seed, const void *data, size_t length);
+uint16_t CRC_CUSTOM_16calBitwise( uint16_t crc16Polynomial, uint16_t seed, const void *data, size_t length );
+uint32_t CRC_CUSTOM_32calBitwise(uint32_t crc32Polynomial, uint32_t seed, const void *data, size_t length);
 
 #endif /* CRC16_CUSTOM_H */
\ No newline at end of file
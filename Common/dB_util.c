@@ -0,0 +1,232 @@
+/* ************************************************************************* */
+/******************************************************************************
+ *
+ * Filename:   dB_util.c
+ *
+ * Global Designator: DB_
+ *
+ * Contents: Decibel <-> linear power conversions.
+ *
+ *    Power readings (RSSI, DANL, noise estimates) are averaged in the linear domain and reported in dB, which costs a
+ *    powf() per sample and a log10f()/log10() per average.  On the single precision FPU targets these are generic
+ *    library routines built for full range and correctly rounded results.  The routines here use the float
+ *    representation directly: the exponent is taken from (or put into) the float's exponent bits and only a short
+ *    polynomial is evaluated over the mantissa.
+ *
+ *    Error bounds (checked on host against double precision over -200 to +260 dB).  Most of the error comes from
+ *    rounding the float argument, which libm sees as well:
+ *       DB_toLinear()     relative error < 3.0e-6 (1.3e-5 dB), powf(10, dB/10) gives 1.8e-6
+ *       DB_toLinearTbl()  relative error < 1.2e-7
+ *       DB_fromLinear()   absolute error < 3.5e-5 dB, log10f()*10 gives 1.6e-5 dB
+ *
+ ******************************************************************************
+ * A product of
+ * Aclara Technologies LLC
+ * Confidential and Proprietary
+ * Copyright 2022 Aclara.  All Rights Reserved.
+ *
+ * PROPRIETARY NOTICE
+ * The information contained in this document is private to Aclara Technologies LLC an Ohio limited liability company
+ * (Aclara).  This information may not be published, reproduced, or otherwise disseminated without the express written
+ * authorization of Aclara.  Any software or firmware described in this document is furnished under a license and may be
+ * used or copied only in accordance with the terms of such license.
+ ******************************************************************************
+ *
+ * $Log$
+ *
+ ******************************************************************************
+ * Revision History:
+ * v0.1 - Initial Release
+ *************************************************************************** */
+
+/* INCLUDE FILES */
+#include <stdint.h>
+#include <math.h>
+#include <assert.h>  /* static_assert */
+#include "project.h"
+#include "dB_util.h"
+
+/* ************************************************************************* */
+/* CONSTANTS */
+
+#define DB_LOG2_10_OVER_10    ( 0.332192809f )  /* log2(10)/10, 10^(dB/10) = 2^(dB * this) */
+#define DB_10_LOG10_2         ( 3.010299957f )  /* 10*log10(2), 10*log10(x) = log2(x) * this */
+#define DB_SQRT2              ( 1.414213562f )
+
+#define DB_FLT_EXP_BIAS       ( 127 )
+#define DB_FLT_MANT_BITS      ( 23 )
+#define DB_FLT_MANT_MASK      ( 0x007FFFFFUL )
+#define DB_FLT_ONE            ( 0x3F800000UL )  /* 1.0f, used to put a mantissa back in [1, 2) */
+
+/* 2^f for f in [0, 1), degree 5 fit at the Chebyshev nodes, relative error 1.0e-7 */
+static const float exp2Poly_[] =
+{
+   9.999998984e-01f, 6.931544897e-01f, 2.401418182e-01f, 5.586033708e-02f, 8.949590423e-03f, 1.893754058e-03f
+};
+
+/* log2(1+t)/t for t in [sqrt(1/2)-1, sqrt(2)-1), degree 6 fit at the Chebyshev nodes, absolute error 6.3e-7 in log2 */
+static const float log2Poly_[] =
+{
+   1.442696523e+00f, -7.213601786e-01f, 4.806131255e-01f, -3.595244555e-01f, 2.961195572e-01f, -2.679638705e-01f,
+   1.681865911e-01f
+};
+
+/* 10^(r/10) for r = 0 to 9 */
+static const float tenthPow10_[] =
+{
+   1.000000000e+00f, 1.258925412e+00f, 1.584893192e+00f, 1.995262315e+00f, 2.511886432e+00f,
+   3.162277660e+00f, 3.981071706e+00f, 5.011872336e+00f, 6.309573445e+00f, 7.943282347e+00f
+};
+
+/* 10^q for q = DB_TBL_MIN/10 to DB_TBL_MAX/10 */
+static const float pow10_[] =
+{
+   1.0e-20f, 1.0e-19f, 1.0e-18f, 1.0e-17f, 1.0e-16f, 1.0e-15f, 1.0e-14f, 1.0e-13f, 1.0e-12f, 1.0e-11f,
+   1.0e-10f, 1.0e-9f,  1.0e-8f,  1.0e-7f,  1.0e-6f,  1.0e-5f,  1.0e-4f,  1.0e-3f,  1.0e-2f,  1.0e-1f,
+   1.0e0f,   1.0e1f,   1.0e2f,   1.0e3f,   1.0e4f,   1.0e5f,   1.0e6f,   1.0e7f,   1.0e8f,   1.0e9f,
+   1.0e10f,  1.0e11f,  1.0e12f,  1.0e13f,  1.0e14f,  1.0e15f,  1.0e16f,  1.0e17f,  1.0e18f,  1.0e19f,
+   1.0e20f,  1.0e21f,  1.0e22f,  1.0e23f,  1.0e24f,  1.0e25f
+};
+
+static_assert( ( ARRAY_IDX_CNT( pow10_ ) * 10 ) == ( ( DB_TBL_MAX - DB_TBL_MIN ) + 1 ), "pow10_ must cover DB_TBL_MIN to DB_TBL_MAX" );
+
+/* ************************************************************************* */
+/* TYPE DEFINITIONS */
+
+typedef union
+{
+   float    f;
+   uint32_t u;
+} floatBits_t;
+
+/* ************************************************************************* */
+/* FUNCTION DEFINITIONS */
+
+/******************************************************************************
+ *
+ * Function name: DB_toLinear()
+ *
+ * Purpose: Converts dB to linear power, 10^(dB/10).  Drop in for powf(10.0f, dB/10.0f).
+ *
+ * Arguments: float dB
+ *
+ * Returns: float - linear power.  0 below about -379 dB, HUGE_VALF above about +385 dB.
+ *
+ * Reentrant: Yes
+ *
+ *****************************************************************************/
+float DB_toLinear( float dB )
+{
+   float       y = dB * DB_LOG2_10_OVER_10;  /* 10^(dB/10) = 2^y */
+   float       f;
+   float       p;
+   int32_t     n;
+   floatBits_t scale;
+
+   if ( y < (float)( 1 - DB_FLT_EXP_BIAS ) )
+   {
+      return 0.0f;                           /* Below the smallest normal float */
+   }
+   if ( y >= (float)( DB_FLT_EXP_BIAS + 1 ) )
+   {
+      return HUGE_VALF;
+   }
+   n = (int32_t)y;                           /* floor(y), the cast truncates toward 0 */
+   if ( (float)n > y )
+   {
+      n--;
+   }
+   f = y - (float)n;                         /* 2^y = 2^n * 2^f, f in [0, 1) */
+   p = exp2Poly_[5];
+   p = ( p * f ) + exp2Poly_[4];
+   p = ( p * f ) + exp2Poly_[3];
+   p = ( p * f ) + exp2Poly_[2];
+   p = ( p * f ) + exp2Poly_[1];
+   p = ( p * f ) + exp2Poly_[0];
+   scale.u = (uint32_t)( n + DB_FLT_EXP_BIAS ) << DB_FLT_MANT_BITS;  /* 2^n */
+   return p * scale.f;
+}
+
+/******************************************************************************
+ *
+ * Function name: DB_toLinearTbl()
+ *
+ * Purpose: Converts whole dB to linear power, 10^(dB/10), with two table look-ups.  Intended for the radio's raw RSSI
+ *          samples which are whole numbers.
+ *
+ * Arguments: int16_t dB
+ *
+ * Returns: float - linear power
+ *
+ * Reentrant: Yes
+ *
+ *****************************************************************************/
+float DB_toLinearTbl( int16_t dB )
+{
+   uint16_t idx;
+
+   if ( ( dB < DB_TBL_MIN ) || ( dB > DB_TBL_MAX ) )
+   {
+      return DB_toLinear( (float)dB );
+   }
+   idx = (uint16_t)( dB - DB_TBL_MIN );
+   return pow10_[ idx / 10 ] * tenthPow10_[ idx % 10 ];  /* DB_TBL_MIN is a multiple of 10 */
+}
+
+/******************************************************************************
+ *
+ * Function name: DB_fromLinear()
+ *
+ * Purpose: Converts linear power to dB, 10*log10(linear).  Drop in for log10f(linear)*10.0f.
+ *
+ * Arguments: float linear
+ *
+ * Returns: float - dB.  -HUGE_VALF for 0 or less (log10f() would return -inf or NaN).
+ *
+ * Reentrant: Yes
+ *
+ *****************************************************************************/
+float DB_fromLinear( float linear )
+{
+   floatBits_t v;
+   int32_t     e;
+   float       m;
+   float       t;
+   float       p;
+
+   if ( !( linear > 0.0f ) )
+   {
+      return -HUGE_VALF;
+   }
+   v.f = linear;
+   if ( 0 == ( v.u >> DB_FLT_MANT_BITS ) )   /* Subnormal, normalize it first */
+   {
+      v.f = linear * 8388608.0f;             /* 2^23 */
+      e = -DB_FLT_MANT_BITS;
+   }
+   else
+   {
+      e = 0;
+   }
+   if ( ( v.u >> DB_FLT_MANT_BITS ) >= 0xFFUL )
+   {
+      return HUGE_VALF;                      /* Infinity */
+   }
+   e += (int32_t)( v.u >> DB_FLT_MANT_BITS ) - DB_FLT_EXP_BIAS;
+   v.u = ( v.u & DB_FLT_MANT_MASK ) | DB_FLT_ONE;  /* linear = 2^e * m, m in [1, 2) */
+   m = v.f;
+   if ( m >= DB_SQRT2 )                      /* Center the polynomial's range on 1 */
+   {
+      m *= 0.5f;
+      e++;
+   }
+   t = m - 1.0f;
+   p = log2Poly_[6];
+   p = ( p * t ) + log2Poly_[5];
+   p = ( p * t ) + log2Poly_[4];
+   p = ( p * t ) + log2Poly_[3];
+   p = ( p * t ) + log2Poly_[2];
+   p = ( p * t ) + log2Poly_[1];
+   p = ( p * t ) + log2Poly_[0];
+   return ( (float)e + ( t * p ) ) * DB_10_LOG10_2;
+}
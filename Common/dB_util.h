@@ -0,0 +1,49 @@
+/******************************************************************************
+ *
+ * Filename: dB_util.h
+ *
+ * Contents: Decibel <-> linear power conversion prototypes
+ *
+ ******************************************************************************
+ * A product of
+ * Aclara Technologies LLC
+ * Confidential and Proprietary
+ * Copyright 2022 Aclara.  All Rights Reserved.
+ *
+ * PROPRIETARY NOTICE
+ * The information contained in this document is private to Aclara Technologies LLC an Ohio limited liability company
+ * (Aclara).  This information may not be published, reproduced, or otherwise disseminated without the express written
+ * authorization of Aclara.  Any software or firmware described in this document is furnished under a license and may be
+ * used or copied only in accordance with the terms of such license.
+ ******************************************************************************
+ *
+ * $Log$
+ *
+ *****************************************************************************/
+
+#ifndef DB_UTIL_H
+#define DB_UTIL_H
+
+/* INCLUDE FILES */
+
+#include "project.h"
+
+/* CONSTANT DEFINITIONS */
+
+/* Range of whole dB values DB_toLinearTbl() looks up, anything outside falls back to DB_toLinear() */
+#define DB_TBL_MIN   ((int16_t)-200)
+#define DB_TBL_MAX   ((int16_t)259)
+
+/* MACRO DEFINITIONS */
+
+/* TYPE DEFINITIONS */
+
+/* GLOBAL VARIABLES */
+
+/* FUNCTION PROTOTYPES */
+
+float DB_toLinear( float dB );         /* 10^(dB/10), relative error < 3.0e-6 */
+float DB_toLinearTbl( int16_t dB );    /* 10^(dB/10) for whole dB, relative error < 1.2e-7 */
+float DB_fromLinear( float linear );   /* 10*log10(linear), absolute error < 3.5e-5 dB */
+
+#endif
@@ -51,6 +51,11 @@
 #define CACHE_NOT_RESTORED      false
 #define CACHE_RESTORED          true
 
+/* Changes to the RAM cache are tracked in chunks of this many bytes so a flush only writes the chunks that changed.
+   A cached partition may have at most 32 chunks (one bit each in cacheDirty). */
+#define CACHE_DIRTY_CHUNK_SIZE  ((lCnt)256)
+#define CACHE_MAX_CHUNKS        ((uint8_t)32)
+
 /* ****************************************************************************************************************** */
 /* TYPE DEFINITIONS */
 
@@ -59,6 +64,7 @@
 
 #if RTOS
 static OS_MUTEX_Obj cacheMutex_; /* Serialize access to the cache driver */
+static OS_MUTEX_Obj cacheFlushMutex_; /* Held while the cache is written to NV, keeps writers out of the cache */
 static bool cacheMutexCreated_ = false;
 #endif
 
@@ -85,6 +91,7 @@ static returnStatus_t ioctl( const void *pCmd, void *pData, PartitionData_t cons
 static returnStatus_t restore( lAddr lDest, lCnt cnt, PartitionData_t const *pParData,
                                DeviceDriverMem_t const * const * pNxtDvr );
 static bool        timeSlice(PartitionData_t const *pParData, DeviceDriverMem_t const * const * pNextDriver);
+static uint32_t    dirtyMask( dSize offset, lCnt cnt );
 
 /* ****************************************************************************************************************** */
 /* CONSTANTS */
@@ -138,7 +145,7 @@ static returnStatus_t init( PartitionData_t const *pParData, DeviceDriverMem_t c
    if ( cacheMutexCreated_ == false ) /* If the mutex has not been created, create it. */
    {
       /* Create mutex to protect the cache driver modules critical section */
-      if ( true == OS_MUTEX_Create(&cacheMutex_) )
+      if ( ( true == OS_MUTEX_Create(&cacheMutex_) ) && ( true == OS_MUTEX_Create(&cacheFlushMutex_) ) )
       {
          cacheMutexCreated_ = true;
       } /* end if() */
@@ -172,6 +179,9 @@ static returnStatus_t open( PartitionData_t const *pParData, DeviceDriverMem_t c
    ASSERT(NULL != pNxtDvr); /* The next driver must be defined, this can be caught in testing. */
    /*lint -efunc( 613, open ) : pNxtDvr can never be NULL in production code.  The ASSERT catches this. */
 
+   /* The dirty chunks must fit in cacheDirty */
+   ASSERT( ( pParData->lDataSize + sizeof(cacheMetaData_t) ) <= ( CACHE_MAX_CHUNKS * CACHE_DIRTY_CHUNK_SIZE ) );
+
    pParData->sAttributes.pMetaData->cacheRestored = CACHE_NOT_RESTORED;
    eRetVal = (*pNxtDvr)->devOpen(pParData, pNxtDvr + 1); /* Open the driver */
    if ( eSUCCESS == eRetVal ) /* If the driver opened properly, restore the cache. */
@@ -185,6 +195,10 @@ static returnStatus_t open( PartitionData_t const *pParData, DeviceDriverMem_t c
       {  /* restore cache */
          eRetVal = restore((lAddr)0, (lCnt)0, pParData, pNxtDvr); /* 1st two parameters are ignored by the restore function */
       }
+      else
+      {  /* The RAM kept through the reset may have changes that were not flushed */
+         pParData->sAttributes.pMetaData->cacheDirty = dirtyMask((dSize)0, pParData->lDataSize + sizeof(cacheMetaData_t));
+      }
       pParData->sAttributes.pMetaData->cacheRestored = CACHE_RESTORED;
    }
 
@@ -265,7 +279,7 @@ static returnStatus_t read( uint8_t *pDest, const dSize srcOffset, const lCnt cn
 
    Returns: As defined by error_codes.h
 
-   Side Effects: None
+   Side Effects: Waits for a flush in progress to finish
 
    Reentrant Code: Yes
 
@@ -273,18 +287,20 @@ static returnStatus_t read( uint8_t *pDest, const dSize srcOffset, const lCnt cn
 static returnStatus_t write( const dSize DestOffset, uint8_t const *pSrc, const lCnt cnt, PartitionData_t const *pParData,
                              DeviceDriverMem_t const * const * pNxtDvr )
 {
-   cacheMetaData_t sCache;    /* Cache meta data */
    /*lint -efunc( 715, write ) : pNxtDvr is not used here, but must be in the parameter list for the common API. */
    /*lint -efunc( 818, write ) : pNxtDvr is not used here, but must be in the parameter list for the common API. */
 
    ASSERT(cnt <= pParData->lSize); /* Count must be <= the sector size. */
 
+   /* The flush writes to NV straight from the cache, so the cache must not change while a flush is in progress */
+   OS_MUTEX_Lock(&cacheFlushMutex_);
    OS_MUTEX_Lock(&cacheMutex_);
    (void)memcpy(pParData->sAttributes.pCachedData + DestOffset, pSrc, cnt); /* Write the data to the RAM */
-   /* Compute CRC on the whole cache area */
-   //sCache.crc16 = CRC_16_Calculate(pParData->sAttributes.pCachedData, pParData->lDataSize);
-   (void)memcpy(pParData->sAttributes.pCachedData + pParData->lDataSize, ( uint8_t *)&sCache, sizeof(sCache));
+   /* The cache CRC is not kept up to date here (it would cost a CRC of the whole cache per write), so the meta data is
+      left alone and open() restores the cache from NV after a reset */
+   pParData->sAttributes.pMetaData->cacheDirty |= dirtyMask(DestOffset, cnt);
    OS_MUTEX_Unlock(&cacheMutex_);
+   OS_MUTEX_Unlock(&cacheFlushMutex_);
 
    return (eSUCCESS);
 }
@@ -292,7 +308,13 @@ static returnStatus_t write( const dSize DestOffset, uint8_t const *pSrc, const
 
    Function Name: flush
 
-   Purpose: Writes the cached memory to next layer.
+   Purpose: Writes the chunks of the cached memory that changed since the last flush to the next layer.  A banked
+            layer copies the whole bank on every write, so for a banked partition the changed chunks are written with a
+            single write from the first to the last; otherwise each run of changed chunks is written.
+
+            cacheFlushMutex_ is held while the data is written, which keeps write() and erase() out so the NV copy is
+            never torn by a memcpy into the chunk being written.  cacheMutex_ is not held, so the cache can still be
+            read.
 
    Arguments:
       PartitionData_t const *pParData Points to a partition table entry.  This contains all information to access the
@@ -317,13 +339,61 @@ static returnStatus_t flush( PartitionData_t const *pParData, DeviceDriverMem_t
    {
       /* DevNote 07/05/18 SMG: Could add RAM cache CRC check to ensure RAM is not corrupted before saving.
                               Need to evalute the execution time hit at power down. */
+      lCnt     cacheSize = pParData->lDataSize + sizeof(cacheMetaData_t);   /* Bytes in the RAM cache */
+      uint32_t dirty;                                                      /* Chunks left to write */
+
+      /* A second caller (and any writer) waits here until the first flush is in NV, not just started. */
+      OS_MUTEX_Lock(&cacheFlushMutex_);
       OS_MUTEX_Lock(&cacheMutex_);
-      eRetVal = (*pNxtDvr)->devWrite((dSize)0,                                   /* Start at the begining of the memory. */
-                                  pParData->sAttributes.pCachedData,             /* Points to the cache ram buffer. */
-                                  pParData->lDataSize + sizeof(cacheMetaData_t), /* write all data to NV */
-                                  pParData,                                      /* Partition information. */
-                                  pNxtDvr + 1);                                  /* Next driver to go to. */
+      dirty = pParData->sAttributes.pMetaData->cacheDirty;
+      pParData->sAttributes.pMetaData->cacheDirty = 0;
       OS_MUTEX_Unlock(&cacheMutex_);
+
+      while ( ( 0 != dirty ) && ( eSUCCESS == eRetVal ) )
+      {
+         uint8_t  first;   /* First chunk to write */
+         uint8_t  last;    /* Last chunk to write */
+         uint32_t runMask; /* Chunks written */
+         dSize    start;   /* Offset of the first byte written */
+         lCnt     end;     /* Offset after the last byte written */
+
+         for ( first = 0; 0 == ( dirty & ( (uint32_t)1 << first ) ); first++ )
+         {
+         }
+         if ( pParData->PartitionType.banked )
+         {
+            for ( last = CACHE_MAX_CHUNKS - 1; 0 == ( dirty & ( (uint32_t)1 << last ) ); last-- )
+            {
+            }
+         }
+         else
+         {
+            for ( last = first; ( last < ( CACHE_MAX_CHUNKS - 1 ) ) && ( 0 != ( dirty & ( (uint32_t)1 << ( last + 1 ) ) ) );
+                  last++ )
+            {
+            }
+         }
+         runMask = dirtyMask( (dSize)first * CACHE_DIRTY_CHUNK_SIZE,
+                              ( (lCnt)( last - first ) + 1 ) * CACHE_DIRTY_CHUNK_SIZE );
+         start = (dSize)first * CACHE_DIRTY_CHUNK_SIZE;
+         end = MINIMUM( ( (lCnt)last + 1 ) * CACHE_DIRTY_CHUNK_SIZE, cacheSize );
+         eRetVal = (*pNxtDvr)->devWrite(start,                                     /* First changed chunk. */
+                                        pParData->sAttributes.pCachedData + start, /* Points to the cache ram buffer. */
+                                        end - start,                               /* Through the last changed chunk. */
+                                        pParData,                                  /* Partition information. */
+                                        pNxtDvr + 1);                              /* Next driver to go to. */
+         if ( eSUCCESS == eRetVal )
+         {
+            dirty &= ~runMask;
+         }
+      }
+      if ( 0 != dirty )    /* Not written, try again at the next flush */
+      {
+         OS_MUTEX_Lock(&cacheMutex_);
+         pParData->sAttributes.pMetaData->cacheDirty |= dirty;
+         OS_MUTEX_Unlock(&cacheMutex_);
+      }
+      OS_MUTEX_Unlock(&cacheFlushMutex_);
    }
    return (eRetVal);
 }
@@ -354,14 +424,13 @@ static returnStatus_t erase( dSize destOffset, lCnt cnt, PartitionData_t const *
    ASSERT(NULL != pNxtDvr); /* The next driver must be defined, this can be caught in testing. */
    /*lint -efunc( 613, erase ) : pNxtDvr can never be NULL in production code.  The ASSERT catches this. */
 
+   OS_MUTEX_Lock(&cacheFlushMutex_);
    OS_MUTEX_Lock(&cacheMutex_);
    (void)memset(pParData->sAttributes.pCachedData + destOffset, 0, cnt);
-   eRetVal = (*pNxtDvr)->devWrite((dSize)0,                          /* Start at the begining of the memory. */
-                               pParData->sAttributes.pCachedData,    /* Points to the cache ram buffer. */
-                               pParData->lDataSize + sizeof(cacheMetaData_t),  /* write all data to NV */
-                               pParData,                             /* Partition information. */
-                               pNxtDvr + 1);                         /* Next driver to go to. */
+   pParData->sAttributes.pMetaData->cacheDirty |= dirtyMask(destOffset, cnt);
    OS_MUTEX_Unlock(&cacheMutex_);
+   OS_MUTEX_Unlock(&cacheFlushMutex_);
+   eRetVal = flush(pParData, pNxtDvr);
    return(eRetVal);
 }
 
@@ -472,8 +541,15 @@ static returnStatus_t restore(lAddr lDest, lCnt cnt, PartitionData_t const *pPar
    /*lint -efunc( 613, restore ) : pNxtDvr can never be NULL in production code.  The ASSERT catches this. */
    /*lint -efunc( 715, restore ) : DeviceDriverMem_t is not used.  Is is needed for a common API. */
 
-   return ((*pNxtDvr)->devRead(pParData->sAttributes.pCachedData, (dSize)0, pParData->lDataSize + sizeof(cacheMetaData_t),
-                            pParData, pNxtDvr + 1));
+   returnStatus_t eRetVal;
+
+   eRetVal = (*pNxtDvr)->devRead(pParData->sAttributes.pCachedData, (dSize)0, pParData->lDataSize + sizeof(cacheMetaData_t),
+                                 pParData, pNxtDvr + 1);
+   if ( eSUCCESS == eRetVal )
+   {
+      pParData->sAttributes.pMetaData->cacheDirty = 0;   /* The cache matches NV */
+   }
+   return (eRetVal);
 }
 /***********************************************************************************************************************
 
@@ -495,6 +571,36 @@ static bool timeSlice(PartitionData_t const *pParData, DeviceDriverMem_t const *
 {
    return ((*pNextDriver)->devTimeSlice(pParData, pNextDriver + 1));
 }
+/***********************************************************************************************************************
+
+   Function Name: dirtyMask
+
+   Purpose: Returns the cacheDirty bits of the chunks a range of the cache touches.
+
+   Arguments:
+      dSize offset - Offset of the range in the cache
+      lCnt cnt - Number of bytes in the range
+
+   Returns: uint32_t - bit n set for chunk n
+
+   Side Effects: None
+
+   Reentrant Code: Yes
+
+ **********************************************************************************************************************/
+static uint32_t dirtyMask( dSize offset, lCnt cnt )
+{
+   uint32_t mask = 0;
+
+   if ( 0 != cnt )
+   {
+      uint32_t first = offset / CACHE_DIRTY_CHUNK_SIZE;
+      uint32_t last = ( ( offset + cnt ) - 1 ) / CACHE_DIRTY_CHUNK_SIZE;
+
+      mask = ( ( ( (uint32_t)2 << last ) - 1 ) & ~( ( (uint32_t)1 << first ) - 1 ) );
+   }
+   return (mask);
+}
 /* ****************************************************************************************************************** */
 /* Unit Test */
 
@@ -0,0 +1,1600 @@
+/***********************************************************************************************************************
+
+   Filename:   dvr_logStore.c
+
+   Global Designator: DVR_LOGSTORE_
+
+   Contents:   Log structured record store memory driver.  An alternative to the banked driver for small partitions that
+               are updated often (time sync state, counters, registration status, etc...).
+
+               The partition's data is divided into records of LOG_STORE_RECORD_SIZE bytes.  A write appends a new
+               entry (header + record) for each record that changed to the end of the log, instead of copying the whole
+               bank.  A RAM index holds the offset of the latest entry of every record so reads go straight to NV.
+
+               The log is a ring of LOG_STORE_NUM_SECTORS erase sectors.  The first entry of each sector holds the
+               sector's sequence number.  The sector after the one being written to is always kept erased.  When the
+               log moves into it, the sector after that (the oldest) is garbage collected: the entries that are still
+               the latest for their record are copied to the new sector and the old sector is erased.
+
+               Power loss: An entry is only used if its header and check value are correct, so a partly written entry
+               is skipped.  A garbage collection that was interrupted is completed at the next power up.  Copies made
+               before the power loss are in a newer sector and so are the ones used.
+
+   NOTES:
+      1. Records that were never written read as 0, the same as the erased external flash.
+      2. EraseBlockSize must be a multiple of LOG_STORE_ENTRY_SIZE and the partition must start on a sector boundary.
+      3. The partition may hold at most (LOG_STORE_NUM_SECTORS - 2) sectors of records, so garbage collection always
+         frees at least one entry.
+      4. Select the driver for a partition with a driver table of { &sDeviceDriver_eLogStore, &sDeviceDriver_eFlash }.
+         Partition table entries use lSize = lDataSize and are not banked or cached.
+
+ ***********************************************************************************************************************
+   A product of
+   Aclara Technologies LLC
+   Confidential and Proprietary
+   Copyright 2022 Aclara.  All Rights Reserved.
+
+   PROPRIETARY NOTICE
+   The information contained in this document is private to Aclara Technologies LLC an Ohio limited liability company
+   (Aclara).  This information may not be published, reproduced, or otherwise disseminated without the express written
+   authorization of Aclara.  Any software or firmware described in this document is furnished under a license and may be
+   used or copied only in accordance with the terms of such license.
+ ***********************************************************************************************************************
+   Revision History:
+   v0.1 - Initial Release
+ **********************************************************************************************************************/
+/* ****************************************************************************************************************** */
+/* INCLUDE FILES */
+
+#include "project.h"
+#include <string.h>
+#if ( RTOS_SELECTION == MQX_RTOS )
+#include <mqx.h>
+#endif
+
+#define dvr_logStore_GLOBAL
+#include "dvr_logStore.h"
+#undef  dvr_logStore_GLOBAL
+#ifdef TM_LOGSTORE_UNIT_TEST
+#include "DBG_SerialDebug.h"
+#endif
+
+/* ****************************************************************************************************************** */
+/* MACRO DEFINITIONS */
+
+#define LOG_STORE_SECTOR_KEY     ((uint16_t)0xFFFE)  /* Key of the sector header entry */
+#define LOG_NOT_WRITTEN          ((uint16_t)0xFFFF)  /* Index value of a record that has never been written */
+#define SECTOR_ERASED            ((uint32_t)0)       /* Sequence number of an erased sector */
+
+#ifdef TM_LOGSTORE_UNIT_TEST
+#define LGS_TST_SECTOR_SIZE      ((lCnt)256)         /* Erase size of the RAM flash, 7 entries and the sector header */
+#define LGS_TST_NUM_RECORDS      ((uint16_t)4)       /* Records in the test partition */
+#define LGS_TST_DATA_SIZE        ((lCnt)LGS_TST_NUM_RECORDS * LOG_STORE_RECORD_SIZE)
+#define LGS_TST_NUM_WRITES       ((uint16_t)60)      /* Writes in each pass, the log goes around the ring a few times */
+#endif
+
+/* ****************************************************************************************************************** */
+/* TYPE DEFINITIONS */
+
+typedef struct
+{
+   logEntryHdr_t  hdr;
+   uint8_t        record[LOG_STORE_RECORD_SIZE];
+}logEntry_t;   /* One entry in the log */
+
+typedef struct
+{
+   PartitionData_t const *pParData;                      /* Partition using this entry, NULL if not used */
+   uint32_t             sectorSeq[LOG_STORE_NUM_SECTORS]; /* Sequence number of each sector, SECTOR_ERASED if erased */
+   uint32_t             nextSeq;                         /* Sequence number for the next sector started */
+   uint16_t             index[LOG_STORE_MAX_RECORDS];    /* Offset of the latest entry of each record */
+   uint16_t             numRecords;                      /* Number of records in the partition */
+   uint16_t             slotsPerSector;                  /* Number of entries in a sector, including the header */
+   uint16_t             headSlot;                        /* Next free entry in the head sector */
+   uint8_t              head;                            /* Sector being written to */
+}logStore_t;   /* RAM state of a partition */
+
+/* ****************************************************************************************************************** */
+/* FILE VARIABLE DEFINITIONS */
+
+static logStore_t logStore_[LOG_STORE_MAX_PARTITIONS];
+static logEntry_t entryBuf_;                             /* Entry being read or written */
+static uint8_t    recordBuf_[LOG_STORE_RECORD_SIZE];     /* Record being updated */
+
+#if RTOS
+static OS_MUTEX_Obj logStoreMutex_; /* Serialize access to the log store driver */
+static bool logStoreMutexCreated_ = false;
+#endif
+
+#ifdef TM_LOGSTORE_UNIT_TEST
+static uint8_t    lgsTstNv_[LOG_STORE_NUM_SECTORS * LGS_TST_SECTOR_SIZE];  /* RAM flash the test partition is on */
+static uint16_t   lgsTstOpsLeft_;                                         /* Power is lost during this write/erase */
+static bool       lgsTstPowerOff_;                                        /* true after the power is lost */
+#endif
+
+/* ****************************************************************************************************************** */
+/* FUNCTION PROTOTYPES */
+
+static returnStatus_t lgs_init( PartitionData_t const *pParData, DeviceDriverMem_t const * const *pNextDriver );
+static returnStatus_t lgs_open( PartitionData_t const *pParData, DeviceDriverMem_t const * const *pNextDriver );
+static returnStatus_t lgs_close( PartitionData_t const *pParData, DeviceDriverMem_t const * const *pNextDriver );
+static returnStatus_t lgs_read( uint8_t *pDest, const dSize srcOffset, const lCnt cnt, PartitionData_t const *pParData,
+                                DeviceDriverMem_t const * const *pNextDriver );
+static returnStatus_t lgs_write( dSize destOffset, uint8_t const *pSrc, lCnt cnt, PartitionData_t const *pParData,
+                                 DeviceDriverMem_t const * const *pNextDriver );
+static returnStatus_t lgs_flush( PartitionData_t const *pParData, DeviceDriverMem_t const * const *pNextDriver );
+static returnStatus_t lgs_erase( dSize destOffset, lCnt cnt, PartitionData_t const *pParData,
+                                 DeviceDriverMem_t const * const *pNextDriver );
+#if ( MCU_SELECTED == RA6E1 )
+static returnStatus_t lgs_blankCheck( dSize destOffset, lCnt cnt, PartitionData_t const *pParData,
+                                      DeviceDriverMem_t const * const *pNextDriver );
+#endif
+static returnStatus_t lgs_setPowerMode( const ePowerMode, PartitionData_t const *pParData, DeviceDriverMem_t const
+                                        * const *pNextDriver );
+static returnStatus_t lgs_ioctl( const void *pCmd, void *pData, PartitionData_t const *pParData,
+                                 DeviceDriverMem_t const * const *pNextDriver );
+static returnStatus_t lgs_restore( lAddr lDest, lCnt cnt, PartitionData_t const *pParData, DeviceDriverMem_t const
+                                   * const *pNextDriver );
+static bool           lgs_timeSlice( PartitionData_t const *pParData, DeviceDriverMem_t const * const *pNextDriver );
+
+static logStore_t    *findStore( PartitionData_t const *pParData );
+static uint16_t       entryCheck( logEntry_t const *pEntry );
+static bool           entryValid( logEntry_t const *pEntry );
+static bool           entryBlank( logEntry_t const *pEntry );
+static returnStatus_t loadIndex( logStore_t *pStore, PartitionData_t const *pParData,
+                                 DeviceDriverMem_t const * const *pNextDriver );
+static returnStatus_t startSector( logStore_t *pStore, uint8_t sector, PartitionData_t const *pParData,
+                                   DeviceDriverMem_t const * const *pNextDriver );
+static returnStatus_t writeEntry( logStore_t *pStore, uint16_t key, uint8_t const *pRecord,
+                                  PartitionData_t const *pParData, DeviceDriverMem_t const * const *pNextDriver );
+static returnStatus_t collectSector( logStore_t *pStore, uint8_t sector, PartitionData_t const *pParData,
+                                     DeviceDriverMem_t const * const *pNextDriver );
+static returnStatus_t appendEntry( logStore_t *pStore, uint16_t key, uint8_t const *pRecord,
+                                   PartitionData_t const *pParData, DeviceDriverMem_t const * const *pNextDriver );
+static returnStatus_t updateRecords( logStore_t *pStore, dSize destOffset, uint8_t const *pSrc, lCnt cnt,
+                                     PartitionData_t const *pParData, DeviceDriverMem_t const * const *pNextDriver );
+
+#ifdef TM_LOGSTORE_UNIT_TEST
+static returnStatus_t lgsTst_nop( PartitionData_t const *pParData, DeviceDriverMem_t const * const *pNextDriver );
+static returnStatus_t lgsTst_setPowerMode( const ePowerMode ePwrMode, PartitionData_t const *pParData,
+                                           DeviceDriverMem_t const * const *pNextDriver );
+static returnStatus_t lgsTst_read( uint8_t *pDest, const dSize srcOffset, const lCnt cnt,
+                                   PartitionData_t const *pParData, DeviceDriverMem_t const * const *pNextDriver );
+static returnStatus_t lgsTst_write( dSize destOffset, uint8_t const *pSrc, lCnt cnt, PartitionData_t const *pParData,
+                                    DeviceDriverMem_t const * const *pNextDriver );
+static returnStatus_t lgsTst_erase( dSize destOffset, lCnt cnt, PartitionData_t const *pParData,
+                                    DeviceDriverMem_t const * const *pNextDriver );
+#if ( MCU_SELECTED == RA6E1 )
+static returnStatus_t lgsTst_blankCheck( dSize destOffset, lCnt cnt, PartitionData_t const *pParData,
+                                         DeviceDriverMem_t const * const *pNextDriver );
+#endif
+static returnStatus_t lgsTst_ioctl( const void *pCmd, void *pData, PartitionData_t const *pParData,
+                                    DeviceDriverMem_t const * const *pNextDriver );
+static returnStatus_t lgsTst_restore( lAddr lDest, lCnt cnt, PartitionData_t const *pParData,
+                                      DeviceDriverMem_t const * const *pNextDriver );
+static bool           lgsTst_timeSlice( PartitionData_t const *pParData, DeviceDriverMem_t const * const *pNextDriver );
+static bool           lgsTstPowerCut( void );
+static returnStatus_t lgsTstPowerUp( void );
+static uint16_t       lgsTstCheck( uint8_t expected[][LOG_STORE_RECORD_SIZE], uint16_t cutAt );
+#endif
+
+/* ****************************************************************************************************************** */
+/* CONSTANTS */
+
+/* The driver table must be defined after the function definitions. The list below are the supported commands for this
+ * driver. */
+const DeviceDriverMem_t sDeviceDriver_eLogStore ={
+   lgs_init,          // Init function - Creates mutex & calls lower drivers
+   lgs_open,          // Open Command - Builds the RAM index from the log and calls lower drivers.
+   lgs_close,         // Close Command - For this implementation it only calls the lower level drivers.
+   lgs_setPowerMode,  // Sets the power mode of the lower drivers (the app may set to low power mode when power is lost */
+   lgs_read,          // Read Command
+   lgs_write,         // Write Command - Appends the records that changed to the log
+   lgs_erase,         // Erases all of the log or clears the records in a range.
+#if ( MCU_SELECTED == RA6E1 )
+   lgs_blankCheck,    // Blank check a memory in the partition
+#endif
+   lgs_flush,         // Not used, calls the next driver.
+   lgs_ioctl,         // ioctl function - Does Nothing for this implementation
+   lgs_restore,       // Restore function not used for this module, but calls the next layer of code.
+   lgs_timeSlice      // Not used, calls the next driver.
+};
+
+#ifdef TM_LOGSTORE_UNIT_TEST
+/* RAM flash the unit test puts under the log store driver.  It can lose power part way through a write or an erase. */
+static const DeviceDriverMem_t lgsTstFlashDriver_ ={
+   lgsTst_nop,          // Init
+   lgsTst_nop,          // Open
+   lgsTst_nop,          // Close
+   lgsTst_setPowerMode, // Power mode
+   lgsTst_read,         // Read
+   lgsTst_write,        // Write - Only clears bits, the same as the external flash
+   lgsTst_erase,        // Erase
+#if ( MCU_SELECTED == RA6E1 )
+   lgsTst_blankCheck,   // Blank check
+#endif
+   lgsTst_nop,          // Flush
+   lgsTst_ioctl,        // ioctl
+   lgsTst_restore,      // Restore
+   lgsTst_timeSlice     // Time slice
+};
+
+static const DeviceDriverMem_t *lgsTstDriver_[] =
+{
+   &sDeviceDriver_eLogStore,
+   &lgsTstFlashDriver_,
+   (DeviceDriverMem_t *) NULL
+};
+
+/* Test partition, 4 records on 4 sectors of the RAM flash.  Not in the partition table. */
+static const PartitionData_t lgsTstPartition_ =
+{
+   ePART_NV_TEST,                            /* Partition Name */
+   0,                                        /* Start Offset */
+   LGS_TST_DATA_SIZE,                        /* Size of partition */
+   LGS_TST_DATA_SIZE,                        /* Size of partition */
+   lgsTstDriver_,                            /* Driver access table */
+   (void *) NULL,                            /* Driver Config (Port, Address, etc...) */
+   {                                         /* Partition Description */
+      (uint8_t const *)"RAM",                /* Describes the Bus being used */
+      (uint8_t const *)"RAM Flash",          /* Describes the chip being accessed */
+      (uint8_t const *)"Log Store Test",     /* Describes the partition */
+      false,                                 /* Banked? */
+      false,                                 /* Cached? */
+      false,                                 /* Automatically erase the 'old' bank of memory? */
+      false,                                 /* Updateable during DFW? */
+      false                                  /* partition uses the file system */
+   },
+   {  /* Attributes: */
+      (PartitionMetaData_t *)NULL,           /* Location to store meta data */
+      LGS_TST_SECTOR_SIZE,                   /* Erase block size */
+      (uint8_t *)NULL,                       /* Location of the cached area */
+      0,                                     /* Maximum write frequency to any one cell */
+      0                                      /* Number of banks */
+   }
+};
+#endif
+
+/* ****************************************************************************************************************** */
+/* FUNCTION DEFINITIONS */
+
+/***********************************************************************************************************************
+
+   Function Name: lgs_init
+
+   Purpose: Initializes the log store driver.  The initialize function should only be called once at power up.
+
+   Arguments:
+      PartitionData_t const *pParData Points to a partition table entry.  This contains all information to access the
+                                  partition to initialize.
+      DeviceDriverMem_t const * const *pNextDriver Points to the next driver's table.
+
+   Returns: returnStatus_t  As defined by error_codes.h
+
+   Side Effects: N/A
+
+   Reentrant Code: No (this should only be called at power up before the scheduler is running)
+
+ **********************************************************************************************************************/
+static returnStatus_t lgs_init( PartitionData_t const *pParData, DeviceDriverMem_t const * const *pNextDriver )
+{
+#if RTOS
+   if ( logStoreMutexCreated_ == false ) /* If the mutex has not been created, create it. */
+   {
+      /* Create mutex to protect the log store driver modules critical section */
+      if ( true == OS_MUTEX_Create(&logStoreMutex_) )
+      {
+         logStoreMutexCreated_ = true;
+      } /* end if() */
+   }
+#endif
+
+   ASSERT(NULL != pNextDriver); /* The next driver must be defined, this can be caught in testing. */
+   /*lint -efunc( 613, lgs_init ) : pNextDriver can never be NULL in production code.  The ASSERT catches this. */
+
+   return ((*pNextDriver)->devInit(pParData, pNextDriver + 1));
+}
+/***********************************************************************************************************************
+
+   Function Name: lgs_open
+
+   Purpose: Opens the next layer and builds the RAM index of the partition from the log.
+
+   Arguments:
+      PartitionData_t const *pParData Points to a partition table entry.  This contains all information to access the
+                               partition to initialize.
+      DeviceDriverMem_t const * const *pNextDriver Points to the next driver's table.
+
+   Returns: returnStatus_t  As defined by error_codes.h
+
+   Side Effects: An interrupted garbage collection is completed, sectors left partly erased are erased.
+
+   Reentrant Code:  No
+
+   Note: This should only be called at power up before the scheduler is running
+
+ **********************************************************************************************************************/
+static returnStatus_t lgs_open( PartitionData_t const *pParData, DeviceDriverMem_t const * const *pNextDriver )
+{
+   returnStatus_t eRetVal;
+   logStore_t     *pStore;
+
+   ASSERT(NULL != pNextDriver); /* The next driver must be defined, this can be caught in testing. */
+   /*lint -efunc( 613, lgs_open ) : pNextDriver can never be NULL in production code.  The ASSERT catches this. */
+
+   /* Check the partition fits the log: Whole entries in a sector, starting on a sector boundary, the index can hold
+      every record, GC frees at least one entry and the offsets fit the index. */
+   ASSERT( 0 == (pParData->sAttributes.EraseBlockSize % LOG_STORE_ENTRY_SIZE) );
+   ASSERT( 0 == (pParData->PhyStartingAddress % pParData->sAttributes.EraseBlockSize) );
+   ASSERT( pParData->lDataSize <= ((lCnt)LOG_STORE_MAX_RECORDS * LOG_STORE_RECORD_SIZE) );
+   ASSERT( pParData->lDataSize <= ( (lCnt)(LOG_STORE_NUM_SECTORS - 2) *
+                                    ((pParData->sAttributes.EraseBlockSize / LOG_STORE_ENTRY_SIZE) - 1) *
+                                    LOG_STORE_RECORD_SIZE ) );
+   ASSERT( ((lCnt)LOG_STORE_NUM_SECTORS * pParData->sAttributes.EraseBlockSize) < LOG_NOT_WRITTEN );
+
+   /* Open the driver */
+   eRetVal = (*pNextDriver)->devOpen(pParData, pNextDriver + 1);
+   if ( eSUCCESS == eRetVal )
+   {
+      pStore = findStore(pParData);
+      if ( NULL == pStore )
+      {
+         eRetVal = eFAILURE;  /* LOG_STORE_MAX_PARTITIONS is too small */
+      }
+      else
+      {
+#if RTOS
+         OS_MUTEX_Lock(&logStoreMutex_); // Function will not return if it fails
+#endif
+         eRetVal = loadIndex(pStore, pParData, pNextDriver);
+#if RTOS
+         OS_MUTEX_Unlock(&logStoreMutex_); // Function will not return if it fails
+#endif
+      }
+   }
+   return (eRetVal);
+}
+/***********************************************************************************************************************
+
+   Function Name: lgs_close
+
+   Purpose: The log store driver doesn't have anything to close; the information is passed to the next driver.
+
+   Arguments:
+      PartitionData_t const *pParData Points to a partition table entry.  This contains all information to access the
+                               partition to initialize.
+      DeviceDriverMem_t const * const *pNextDriver Points to the next driver's table.
+
+   Returns: As defined by error_codes.h
+
+   Side Effects: None
+
+   Reentrant Code: Yes
+
+ **********************************************************************************************************************/
+static returnStatus_t lgs_close( PartitionData_t const *pParData, DeviceDriverMem_t const * const *pNextDriver )
+{
+   ASSERT(NULL != pNextDriver); /* The next driver must be defined, this can be caught in testing. */
+   /*lint -efunc( 613, lgs_close ) : pNextDriver can never be NULL in production code.  The ASSERT catches this. */
+
+   return ((*pNextDriver)->devClose(pParData, pNextDriver + 1));
+}
+/***********************************************************************************************************************
+
+   Function Name: lgs_read
+
+   Purpose: Reads data from the latest entry of each record in the range.
+
+   Arguments:
+      uint8_t *pDest:  Location to write data
+      dSize srcOffset:  Location of the source data in the partition
+      lCnt Cnt:  Number of bytes to Read from the NV Memory.
+      PartitionData_t const *pParData Points to a partition table entry.  This contains all information to access the
+                               partition to read.
+      DeviceDriverMem_t const * const *pNextDriver Points to the next driver's table.
+
+   Returns: As defined by error_codes.h
+
+   Side Effects: None
+
+   Reentrant Code: Yes
+
+ **********************************************************************************************************************/
+static returnStatus_t lgs_read( uint8_t *pDest, const dSize srcOffset, const lCnt cnt, PartitionData_t const *pParData,
+                                DeviceDriverMem_t const * const *pNextDriver )
+{
+   returnStatus_t eRetVal = eFAILURE;
+   logStore_t     *pStore;
+
+   ASSERT(NULL != pNextDriver); /* The next driver must be defined, this can be caught in testing. */
+   /*lint -efunc( 613, lgs_read ) : pNextDriver can never be NULL in production code.  The ASSERT catches this. */
+
+#if RTOS
+   OS_MUTEX_Lock(&logStoreMutex_); // Function will not return if it fails
+#endif
+   pStore = findStore(pParData);
+   if ( (NULL != pStore) && ((srcOffset + cnt) <= ((lCnt)pStore->numRecords * LOG_STORE_RECORD_SIZE)) )
+   {
+      dSize offset = srcOffset;
+      lCnt  bytesLeft = cnt;
+
+      eRetVal = eSUCCESS;
+      while ( (0 != bytesLeft) && (eSUCCESS == eRetVal) )
+      {
+         uint16_t key = (uint16_t)(offset / LOG_STORE_RECORD_SIZE);
+         lCnt     pos = offset % LOG_STORE_RECORD_SIZE;
+         lCnt     numBytes = MINIMUM(bytesLeft, LOG_STORE_RECORD_SIZE - pos);
+
+         if ( LOG_NOT_WRITTEN == pStore->index[key] )
+         {
+            (void)memset(pDest, 0, numBytes);
+         }
+         else
+         {
+            eRetVal = (*pNextDriver)->devRead(pDest, pStore->index[key] + sizeof(logEntryHdr_t) + pos, numBytes,
+                                              pParData, pNextDriver + 1);
+         }
+         pDest += numBytes;
+         offset += numBytes;
+         bytesLeft -= numBytes;
+      }
+   }
+#if RTOS
+   OS_MUTEX_Unlock(&logStoreMutex_); // Function will not return if it fails
+#endif
+   return (eRetVal);
+}
+/***********************************************************************************************************************
+
+   Function Name: lgs_write
+
+   Purpose: Writes data by appending an entry to the log for every record in the range that changes.  Records that are
+            not changed by the write are not written.
+
+   Arguments:
+      dSize destOffset:  Location of the data to write in the partition
+      uint8_t *pSrc:  Location of the source data to write to Flash
+      lCnt Cnt:  Number of bytes to write to the NV Memory.
+      PartitionData_t const *pParData Points to a partition table entry.  This contains all information to access the
+                               partition to initialize.
+      DeviceDriverMem_t const * const *pNextDriver Points to the next driver's table.
+
+   Returns: As defined by error_codes.h
+
+   Side Effects: May garbage collect the oldest sector of the log.
+
+   Reentrant Code: Yes
+
+ **********************************************************************************************************************/
+static returnStatus_t lgs_write( dSize destOffset, uint8_t const *pSrc, lCnt cnt, PartitionData_t const *pParData,
+                                 DeviceDriverMem_t const * const *pNextDriver )
+{
+   returnStatus_t eRetVal = eFAILURE;
+   logStore_t     *pStore;
+
+   ASSERT(NULL != pNextDriver); /* The next driver must be defined, this can be caught in testing. */
+   /*lint -efunc( 613, lgs_write ) : pNextDriver can never be NULL in production code.  The ASSERT catches this. */
+
+#if RTOS
+   OS_MUTEX_Lock(&logStoreMutex_); // Function will not return if it fails
+#endif
+   pStore = findStore(pParData);
+   if ( NULL != pStore )
+   {
+      eRetVal = updateRecords(pStore, destOffset, pSrc, cnt, pParData, pNextDriver);
+   }
+#if RTOS
+   OS_MUTEX_Unlock(&logStoreMutex_); // Function will not return if it fails
+#endif
+   return (eRetVal);
+}
+/***********************************************************************************************************************
+
+   Function Name: lgs_flush
+
+   Purpose: The log store driver doesn't have anything to flush; the information is passed to the next driver.
+
+   Arguments:
+      PartitionData_t const *pParData Points to a partition table entry.  This contains all information to access the
+                               partition to initialize.
+      DeviceDriverMem_t const * const *pNextDriver Points to the next driver's table.
+
+   Returns: As defined by error_codes.h
+
+   Side Effects: None
+
+   Reentrant Code: Yes
+
+ **********************************************************************************************************************/
+static returnStatus_t lgs_flush( PartitionData_t const *pParData, DeviceDriverMem_t const * const *pNextDriver )
+{
+   ASSERT(NULL != pNextDriver); /* The next driver must be defined, this can be caught in testing. */
+   /*lint -efunc( 613, lgs_flush ) : pNextDriver can never be NULL in production code.  The ASSERT catches this. */
+   return ((*pNextDriver)->devFlush(pParData, pNextDriver + 1));
+}
+/***********************************************************************************************************************
+
+   Function Name: lgs_erase
+
+   Purpose: Erasing the whole partition erases every sector of the log.  Erasing part of the partition sets the records
+            in the range to 0 (the value read back from erased external flash).
+
+   Arguments:
+      dSize destOffset - Offset into the partition to erase
+      lCnt cnt - number of bytes to erase
+      PartitionData_t const *pParData Points to a partition table entry.  This contains all information to access the
+                               partition to initialize.
+      DeviceDriverMem_t const * const *pNextDriver Points to the next driver's table.
+
+   Returns: As defined by error_codes.h
+
+   Side Effects: None
+
+   Reentrant Code: Yes
+
+ **********************************************************************************************************************/
+static returnStatus_t lgs_erase( dSize destOffset, lCnt cnt, PartitionData_t const *pParData,
+                                 DeviceDriverMem_t const * const *pNextDriver )
+{
+   returnStatus_t eRetVal = eFAILURE;
+   logStore_t     *pStore;
+
+   ASSERT(NULL != pNextDriver); /* The next driver must be defined, this can be caught in testing. */
+   /*lint -e{613} : pNextDriver can never be NULL in production code.  The ASSERT catches this. */
+
+#if RTOS
+   OS_MUTEX_Lock(&logStoreMutex_); // Function will not return if it fails
+#endif
+   pStore = findStore(pParData);
+   if ( (NULL != pStore) && (0 != cnt) )
+   {
+      if ( (0 == destOffset) && (cnt >= pParData->lDataSize) )   /* Erasing the whole partition?  */
+      {
+         eRetVal = (*pNextDriver)->devErase(0, (lCnt)LOG_STORE_NUM_SECTORS * pParData->sAttributes.EraseBlockSize,
+                                            pParData, pNextDriver + 1);
+         if ( eSUCCESS == eRetVal )
+         {
+            eRetVal = loadIndex(pStore, pParData, pNextDriver);
+         }
+      }
+      else
+      {
+         eRetVal = updateRecords(pStore, destOffset, NULL, cnt, pParData, pNextDriver);
+      }
+      if ( eSUCCESS == eRetVal )
+      {
+         eRetVal = lgs_flush(pParData, pNextDriver); /* The next driver could be a device that needs to be flushed. */
+      }
+   }
+#if RTOS
+   OS_MUTEX_Unlock(&logStoreMutex_); // Function will not return if it fails
+#endif
+   return (eRetVal);
+}
+
+#if ( MCU_SELECTED == RA6E1 )
+/***********************************************************************************************************************
+
+   Function Name: lgs_blankCheck
+
+   Purpose: Blank check a portion of the current partition of memory.
+
+   Arguments:
+      dSize destOffset - Offset into the partition to blank check
+      lCnt cnt - number of bytes to blank check
+      PartitionData_t const *pParData Points to a partition table entry.  This contains all information to access the
+                               partition to initialize.
+      DeviceDriverMem_t const * const *pNextDriver Points to the next driver's table.
+
+   Returns: As defined by error_codes.h
+
+   Side Effects: None
+
+   Reentrant Code: Yes
+
+ **********************************************************************************************************************/
+static returnStatus_t lgs_blankCheck( dSize destOffset, lCnt cnt, PartitionData_t const *pParData,
+                                      DeviceDriverMem_t const * const *pNextDriver )
+{
+   return ( (*pNextDriver)->devBlankCheck(destOffset, cnt, pParData, pNextDriver + 1) );
+}
+#endif
+
+/***********************************************************************************************************************
+
+   Function Name: lgs_setPowerMode
+
+   Purpose: The log store driver doesn't have a power mode; the information is passed to the next driver.
+
+   Arguments:
+      enum ePwrMode  uses ePowerMode enumeration
+      PartitionData_t const *pParData Points to a partition table entry.  This contains all information to access the
+                               partition to initialize.
+      DeviceDriverMem_t const * const *pNextDriver Points to the next driver's table.
+
+   Returns: As defined by error_codes.h
+
+   Side Effects: None
+
+   Reentrant Code: Yes
+
+ **********************************************************************************************************************/
+static returnStatus_t lgs_setPowerMode( const ePowerMode ePwrMode, PartitionData_t const *pParData,
+                                        DeviceDriverMem_t const * const *pNextDriver )
+{
+   ASSERT(NULL != pNextDriver); /* The next driver must be defined, this can be caught in testing. */
+   /*lint -efunc( 613, lgs_setPowerMode ) : pNextDriver can never be NULL in production code.  The ASSERT catches this. */
+   return ((*pNextDriver)->devSetPwrMode(ePwrMode, pParData, pNextDriver + 1));
+}
+/***********************************************************************************************************************
+
+   Function Name: lgs_ioctl
+
+   Purpose: The log store driver doesn't support ioctl commands
+
+   Arguments:
+      void *pCmd  Command to execute:
+      void *pData  Data to device.
+      PartitionData_t const *pParData Points to a partition table entry.  This contains all information to access the
+                               partition to initialize.
+      DeviceDriverMem_t const * const *pNextDriver Points to the next driver's table.
+
+   Returns: As defined by error_codes.h
+
+   Side Effects: None
+
+   Reentrant Code: Yes
+
+ **********************************************************************************************************************/
+static returnStatus_t lgs_ioctl( const void *pCmd, void *pData, PartitionData_t const *pParData,
+                                 DeviceDriverMem_t const * const *pNextDriver )
+{
+   ASSERT(NULL != pNextDriver); /* The next driver must be defined, this can be caught in testing. */
+   /*lint -efunc( 613, lgs_ioctl ) : pNxtDvr can never be NULL in production code.  The ASSERT catches this. */
+
+   return ((*pNextDriver)->devIoctl(pCmd, pData, pParData, pNextDriver + 1));
+}
+/***********************************************************************************************************************
+
+   Function Name: lgs_restore
+
+   Purpose: The log store driver doesn't support the restore command
+
+   Arguments:
+      PartitionData_t const *pParData Points to a partition table entry.  This contains all information to access the
+                               partition to initialize.
+      DeviceDriverMem_t const * const *pNextDriver Points to the next driver's table.
+
+   Returns: As defined by error_codes.h
+
+   Side Effects: None
+
+   Reentrant Code: Yes
+
+ **********************************************************************************************************************/
+static returnStatus_t lgs_restore( lAddr lDest, lCnt cnt, PartitionData_t const *pParData,
+                                   DeviceDriverMem_t const * const *pNextDriver )
+{
+   ASSERT(NULL != pNextDriver); /* The next driver must be defined, this can be caught in testing. */
+   /*lint -efunc( 613, lgs_restore ) : pNxtDvr can never be NULL in production code.  The ASSERT catches this. */
+
+   return ((*pNextDriver)->devRestore(lDest, cnt, pParData, pNextDriver + 1));
+}
+/***********************************************************************************************************************
+
+   Function Name: lgs_timeSlice
+
+   Purpose: Common API function, allows for the driver to perform any housekeeping that may be required.  For this
+            module, nothing is to be completed.
+
+   Arguments: PartitionData_t const *pParData, DeviceDriverMem_t const * const *pNextDriver
+
+   Returns: bool - Result of the next driver
+
+   Side Effects: None
+
+   Reentrant Code: Yes
+
+ **********************************************************************************************************************/
+static bool lgs_timeSlice( PartitionData_t const *pParData, DeviceDriverMem_t const * const *pNextDriver )
+{
+   return ((*pNextDriver)->devTimeSlice(pParData, pNextDriver + 1));
+}
+/***********************************************************************************************************************
+
+   Function Name: findStore
+
+   Purpose: Finds the RAM state of a partition, assigning a free one the first time the partition is seen.
+
+   Arguments: PartitionData_t const *pParData - Partition table entry
+
+   Returns: logStore_t * - NULL if all of the entries are used by other partitions
+
+   Side Effects: None
+
+   Reentrant Code: No - Caller must hold logStoreMutex_ (except at power up)
+
+ **********************************************************************************************************************/
+static logStore_t *findStore( PartitionData_t const *pParData )
+{
+   logStore_t *pStore = NULL;
+   uint8_t    i;
+
+   for ( i = 0; (i < ARRAY_IDX_CNT(logStore_)) && (NULL == pStore); i++ )
+   {
+      if ( pParData == logStore_[i].pParData )
+      {
+         pStore = &logStore_[i];
+      }
+   }
+   for ( i = 0; (i < ARRAY_IDX_CNT(logStore_)) && (NULL == pStore); i++ )
+   {
+      if ( NULL == logStore_[i].pParData )
+      {
+         pStore = &logStore_[i];
+         pStore->pParData = pParData;
+      }
+   }
+   return (pStore);
+}
+/***********************************************************************************************************************
+
+   Function Name: entryCheck
+
+   Purpose: Computes the Fletcher-16 check value of an entry's key and record.
+
+   Arguments: logEntry_t const *pEntry
+
+   Returns: uint16_t - check value
+
+   Side Effects: None
+
+   Reentrant Code: Yes
+
+ **********************************************************************************************************************/
+static uint16_t entryCheck( logEntry_t const *pEntry )
+{
+   uint16_t sum1 = (uint16_t)(pEntry->hdr.key & 0xFF);
+   uint16_t sum2 = sum1;
+   uint8_t  i;
+
+   sum1 = (sum1 + (pEntry->hdr.key >> 8)) % 255;
+   sum2 = (sum2 + sum1) % 255;
+   for ( i = 0; i < LOG_STORE_RECORD_SIZE; i++ )
+   {
+      sum1 = (sum1 + pEntry->record[i]) % 255;
+      sum2 = (sum2 + sum1) % 255;
+   }
+   return ((uint16_t)((sum2 << 8) | sum1));
+}
+/***********************************************************************************************************************
+
+   Function Name: entryValid
+
+   Purpose: Checks whether an entry read from the log was completely written.
+
+   Arguments: logEntry_t const *pEntry
+
+   Returns: bool - true if the entry can be used
+
+   Side Effects: None
+
+   Reentrant Code: Yes
+
+ **********************************************************************************************************************/
+static bool entryValid( logEntry_t const *pEntry )
+{
+   return ( ((uint16_t)(~pEntry->hdr.key) == pEntry->hdr.keyInv) && (entryCheck(pEntry) == pEntry->hdr.check) );
+}
+/***********************************************************************************************************************
+
+   Function Name: entryBlank
+
+   Purpose: Checks whether an entry read from the log is erased (all 0x00 or all 0xFF, depending on the device).
+
+   Arguments: logEntry_t const *pEntry
+
+   Returns: bool - true if nothing has been written to the entry
+
+   Side Effects: None
+
+   Reentrant Code: Yes
+
+ **********************************************************************************************************************/
+static bool entryBlank( logEntry_t const *pEntry )
+{
+   uint8_t const *pByte = (uint8_t const *)pEntry;
+   uint8_t       i;
+
+   for ( i = 1; (i < sizeof(logEntry_t)) && (pByte[i] == pByte[0]); i++ )
+   {
+   }
+   return ( (i == sizeof(logEntry_t)) && ((0 == pByte[0]) || (0xFF == pByte[0])) );
+}
+/***********************************************************************************************************************
+
+   Function Name: loadIndex
+
+   Purpose: Builds the RAM state of a partition from the log.  Each sector's header is read to find the newest sector
+            (the head), then the sectors are read from the oldest to the newest so the index ends up with the latest
+            entry of each record.
+
+   Arguments:
+      logStore_t *pStore - RAM state to build
+      PartitionData_t const *pParData Points to a partition table entry.
+      DeviceDriverMem_t const * const *pNextDriver Points to the next driver's table.
+
+   Returns: As defined by error_codes.h
+
+   Side Effects: Erases sectors that are not part of the log but are not erased.  Completes an interrupted garbage
+                 collection.  Starts the log in an erased partition.
+
+   Reentrant Code: No - Caller must hold logStoreMutex_ (except at power up)
+
+ **********************************************************************************************************************/
+static returnStatus_t loadIndex( logStore_t *pStore, PartitionData_t const *pParData,
+                                 DeviceDriverMem_t const * const *pNextDriver )
+{
+   returnStatus_t eRetVal = eSUCCESS;
+   lCnt           sectorSize = pParData->sAttributes.EraseBlockSize;
+   uint32_t       seq;
+   uint16_t       slot;
+   uint8_t        sector;
+   uint8_t        i;
+   bool           bFound = false;
+
+   pStore->numRecords = (uint16_t)((pParData->lDataSize + (LOG_STORE_RECORD_SIZE - 1)) / LOG_STORE_RECORD_SIZE);
+   pStore->slotsPerSector = (uint16_t)(sectorSize / LOG_STORE_ENTRY_SIZE);
+   pStore->nextSeq = SECTOR_ERASED + 1;
+   pStore->head = 0;
+   (void)memset(pStore->index, 0xFF, sizeof(pStore->index)); /* LOG_NOT_WRITTEN */
+
+   /* Read each sector's header and find the newest sector */
+   for ( sector = 0; (sector < LOG_STORE_NUM_SECTORS) && (eSUCCESS == eRetVal); sector++ )
+   {
+      pStore->sectorSeq[sector] = SECTOR_ERASED;
+      eRetVal = (*pNextDriver)->devRead((uint8_t *)&entryBuf_, sector * sectorSize, sizeof(entryBuf_), pParData,
+                                        pNextDriver + 1);
+      if ( eSUCCESS == eRetVal )
+      {
+         if ( entryValid(&entryBuf_) && (LOG_STORE_SECTOR_KEY == entryBuf_.hdr.key) )
+         {
+            (void)memcpy(&seq, entryBuf_.record, sizeof(seq));
+            pStore->sectorSeq[sector] = seq;
+            if ( !bFound || (seq >= pStore->nextSeq) )
+            {
+               pStore->head = sector;
+               pStore->nextSeq = seq + 1;
+               bFound = true;
+            }
+         }
+         else
+         {
+            /* Not part of the log.  Make sure it is erased (an erase may have been interrupted). */
+            bool bBlank = true;
+
+            for ( slot = 0; (slot < pStore->slotsPerSector) && bBlank && (eSUCCESS == eRetVal); slot++ )
+            {
+               eRetVal = (*pNextDriver)->devRead((uint8_t *)&entryBuf_,
+                                                 (sector * sectorSize) + (slot * LOG_STORE_ENTRY_SIZE),
+                                                 sizeof(entryBuf_), pParData, pNextDriver + 1);
+               bBlank = entryBlank(&entryBuf_);
+            }
+            if ( (eSUCCESS == eRetVal) && !bBlank )
+            {
+               eRetVal = (*pNextDriver)->devErase(sector * sectorSize, sectorSize, pParData, pNextDriver + 1);
+            }
+         }
+      }
+   }
+
+   if ( eSUCCESS == eRetVal )
+   {
+      if ( !bFound )
+      {
+         eRetVal = startSector(pStore, 0, pParData, pNextDriver);   /* Erased partition, start the log */
+      }
+      else
+      {
+         /* Read the entries from the oldest sector to the newest */
+         for ( i = 1; (i <= LOG_STORE_NUM_SECTORS) && (eSUCCESS == eRetVal); i++ )
+         {
+            sector = (pStore->head + i) % LOG_STORE_NUM_SECTORS;
+            if ( SECTOR_ERASED == pStore->sectorSeq[sector] )
+            {
+               continue;
+            }
+            pStore->headSlot = pStore->slotsPerSector;
+            for ( slot = 1; (slot < pStore->slotsPerSector) && (eSUCCESS == eRetVal); slot++ )
+            {
+               dSize offset = (sector * sectorSize) + (slot * LOG_STORE_ENTRY_SIZE);
+
+               eRetVal = (*pNextDriver)->devRead((uint8_t *)&entryBuf_, offset, sizeof(entryBuf_), pParData,
+                                                 pNextDriver + 1);
+               if ( eSUCCESS == eRetVal )
+               {
+                  if ( entryValid(&entryBuf_) )
+                  {
+                     if ( entryBuf_.hdr.key < pStore->numRecords )
+                     {
+                        pStore->index[entryBuf_.hdr.key] = (uint16_t)offset;
+                     }
+                  }
+                  else if ( entryBlank(&entryBuf_) )
+                  {
+                     pStore->headSlot = slot;   /* End of this sector's entries */
+                     break;
+                  }
+                  /* else a partly written entry, skip it */
+               }
+            }
+         }
+         /* The sector after the head must be erased.  If not, garbage collection was interrupted, finish it. */
+         sector = (pStore->head + 1) % LOG_STORE_NUM_SECTORS;
+         if ( (eSUCCESS == eRetVal) && (SECTOR_ERASED != pStore->sectorSeq[sector]) )
+         {
+            eRetVal = collectSector(pStore, sector, pParData, pNextDriver);
+         }
+      }
+   }
+   return (eRetVal);
+}
+/***********************************************************************************************************************
+
+   Function Name: startSector
+
+   Purpose: Makes an erased sector the head of the log by writing its header.
+
+   Arguments:
+      logStore_t *pStore - RAM state of the partition
+      uint8_t sector - Sector to start
+      PartitionData_t const *pParData Points to a partition table entry.
+      DeviceDriverMem_t const * const *pNextDriver Points to the next driver's table.
+
+   Returns: As defined by error_codes.h
+
+   Side Effects: None
+
+   Reentrant Code: No - Caller must hold logStoreMutex_ (except at power up)
+
+ **********************************************************************************************************************/
+static returnStatus_t startSector( logStore_t *pStore, uint8_t sector, PartitionData_t const *pParData,
+                                   DeviceDriverMem_t const * const *pNextDriver )
+{
+   returnStatus_t eRetVal;
+   uint32_t       seq = pStore->nextSeq;
+
+   (void)memset(&entryBuf_, 0, sizeof(entryBuf_));
+   entryBuf_.hdr.key = LOG_STORE_SECTOR_KEY;
+   entryBuf_.hdr.keyInv = (uint16_t)~LOG_STORE_SECTOR_KEY;
+   (void)memcpy(entryBuf_.record, &seq, sizeof(seq));
+   entryBuf_.hdr.check = entryCheck(&entryBuf_);
+
+   eRetVal = (*pNextDriver)->devWrite(sector * pParData->sAttributes.EraseBlockSize, (uint8_t *)&entryBuf_,
+                                      sizeof(entryBuf_), pParData, pNextDriver + 1);
+   if ( eSUCCESS == eRetVal )
+   {
+      pStore->sectorSeq[sector] = seq;
+      pStore->nextSeq = seq + 1;
+      pStore->head = sector;
+      pStore->headSlot = 1;
+   }
+   return (eRetVal);
+}
+/***********************************************************************************************************************
+
+   Function Name: writeEntry
+
+   Purpose: Writes a record to the next free entry of the head sector and points the index at it.  The caller makes
+            sure the head sector has room.
+
+   Arguments:
+      logStore_t *pStore - RAM state of the partition
+      uint16_t key - Record number
+      uint8_t const *pRecord - LOG_STORE_RECORD_SIZE bytes to write
+      PartitionData_t const *pParData Points to a partition table entry.
+      DeviceDriverMem_t const * const *pNextDriver Points to the next driver's table.
+
+   Returns: As defined by error_codes.h
+
+   Side Effects: None
+
+   Reentrant Code: No - Caller must hold logStoreMutex_ (except at power up)
+
+ **********************************************************************************************************************/
+static returnStatus_t writeEntry( logStore_t *pStore, uint16_t key, uint8_t const *pRecord,
+                                  PartitionData_t const *pParData, DeviceDriverMem_t const * const *pNextDriver )
+{
+   returnStatus_t eRetVal;
+   dSize          offset = (pStore->head * pParData->sAttributes.EraseBlockSize) +
+                           (pStore->headSlot * LOG_STORE_ENTRY_SIZE);
+
+   if ( pRecord != entryBuf_.record )
+   {
+      (void)memcpy(entryBuf_.record, pRecord, sizeof(entryBuf_.record));
+   }
+   entryBuf_.hdr.key = key;
+   entryBuf_.hdr.keyInv = (uint16_t)~key;
+   entryBuf_.hdr.rsvd = 0;
+   entryBuf_.hdr.check = entryCheck(&entryBuf_);
+
+   /* The slot is used even if the write fails, it may be partly written. */
+   pStore->headSlot++;
+   eRetVal = (*pNextDriver)->devWrite(offset, (uint8_t *)&entryBuf_, sizeof(entryBuf_), pParData, pNextDriver + 1);
+   if ( eSUCCESS == eRetVal )
+   {
+      pStore->index[key] = (uint16_t)offset;
+   }
+   return (eRetVal);
+}
+/***********************************************************************************************************************
+
+   Function Name: collectSector
+
+   Purpose: Garbage collects a sector.  The entries in the sector that are still the latest for their record are copied
+            to the head sector and then the sector is erased.
+
+   Arguments:
+      logStore_t *pStore - RAM state of the partition
+      uint8_t sector - Sector to collect, the oldest sector of the log
+      PartitionData_t const *pParData Points to a partition table entry.
+      DeviceDriverMem_t const * const *pNextDriver Points to the next driver's table.
+
+   Returns: As defined by error_codes.h
+
+   Side Effects: None
+
+   Reentrant Code: No - Caller must hold logStoreMutex_ (except at power up)
+
+ **********************************************************************************************************************/
+static returnStatus_t collectSector( logStore_t *pStore, uint8_t sector, PartitionData_t const *pParData,
+                                     DeviceDriverMem_t const * const *pNextDriver )
+{
+   returnStatus_t eRetVal = eSUCCESS;
+   lCnt           sectorSize = pParData->sAttributes.EraseBlockSize;
+   dSize          start = sector * sectorSize;
+   uint16_t       key;
+
+   for ( key = 0; (key < pStore->numRecords) && (eSUCCESS == eRetVal); key++ )
+   {
+      if ( (LOG_NOT_WRITTEN != pStore->index[key]) &&
+           (pStore->index[key] >= start) && (pStore->index[key] < (start + sectorSize)) )
+      {
+         if ( pStore->headSlot >= pStore->slotsPerSector )
+         {
+            eRetVal = eFAILURE;  /* No room, the partition is larger than NOTE 3 allows */
+         }
+         else
+         {
+            eRetVal = (*pNextDriver)->devRead((uint8_t *)&entryBuf_, pStore->index[key], sizeof(entryBuf_), pParData,
+                                              pNextDriver + 1);
+            if ( eSUCCESS == eRetVal )
+            {
+               eRetVal = writeEntry(pStore, key, entryBuf_.record, pParData, pNextDriver);
+            }
+         }
+      }
+   }
+   if ( eSUCCESS == eRetVal )
+   {
+      eRetVal = (*pNextDriver)->devErase(start, sectorSize, pParData, pNextDriver + 1);
+      if ( eSUCCESS == eRetVal )
+      {
+         pStore->sectorSeq[sector] = SECTOR_ERASED;
+      }
+   }
+   return (eRetVal);
+}
+/***********************************************************************************************************************
+
+   Function Name: appendEntry
+
+   Purpose: Appends a record to the log.  When the head sector is full the log moves to the next sector (which is
+            erased) and the oldest sector is garbage collected so the sector after the head is erased again.
+
+   Arguments:
+      logStore_t *pStore - RAM state of the partition
+      uint16_t key - Record number
+      uint8_t const *pRecord - LOG_STORE_RECORD_SIZE bytes to write
+      PartitionData_t const *pParData Points to a partition table entry.
+      DeviceDriverMem_t const * const *pNextDriver Points to the next driver's table.
+
+   Returns: As defined by error_codes.h
+
+   Side Effects: None
+
+   Reentrant Code: No - Caller must hold logStoreMutex_
+
+ **********************************************************************************************************************/
+static returnStatus_t appendEntry( logStore_t *pStore, uint16_t key, uint8_t const *pRecord,
+                                   PartitionData_t const *pParData, DeviceDriverMem_t const * const *pNextDriver )
+{
+   returnStatus_t eRetVal = eSUCCESS;
+   uint8_t        tries;
+
+   /* Each pass frees the entries of one sector that are no longer used.  NOTE 3 makes sure one of the sectors has some,
+      so at most every sector is collected once. */
+   for ( tries = 0; (pStore->headSlot >= pStore->slotsPerSector) && (eSUCCESS == eRetVal); tries++ )
+   {
+      if ( tries >= LOG_STORE_NUM_SECTORS )
+      {
+         eRetVal = eFAILURE;
+      }
+      else
+      {
+         eRetVal = startSector(pStore, (pStore->head + 1) % LOG_STORE_NUM_SECTORS, pParData, pNextDriver);
+         if ( eSUCCESS == eRetVal )
+         {
+            uint8_t oldest = (pStore->head + 1) % LOG_STORE_NUM_SECTORS;
+
+            if ( SECTOR_ERASED != pStore->sectorSeq[oldest] )
+            {
+               eRetVal = collectSector(pStore, oldest, pParData, pNextDriver);
+            }
+         }
+      }
+   }
+   if ( eSUCCESS == eRetVal )
+   {
+      eRetVal = writeEntry(pStore, key, pRecord, pParData, pNextDriver);
+   }
+   return (eRetVal);
+}
+/***********************************************************************************************************************
+
+   Function Name: updateRecords
+
+   Purpose: Updates the bytes of the records in a range, appending an entry for each record that changes.
+
+   Arguments:
+      logStore_t *pStore - RAM state of the partition
+      dSize destOffset - Offset into the partition
+      uint8_t const *pSrc - Data to write, NULL to write 0's
+      lCnt cnt - Number of bytes
+      PartitionData_t const *pParData Points to a partition table entry.
+      DeviceDriverMem_t const * const *pNextDriver Points to the next driver's table.
+
+   Returns: As defined by error_codes.h
+
+   Side Effects: None
+
+   Reentrant Code: No - Caller must hold logStoreMutex_
+
+ **********************************************************************************************************************/
+static returnStatus_t updateRecords( logStore_t *pStore, dSize destOffset, uint8_t const *pSrc, lCnt cnt,
+                                     PartitionData_t const *pParData, DeviceDriverMem_t const * const *pNextDriver )
+{
+   returnStatus_t eRetVal = eFAILURE;
+
+   if ( (destOffset + cnt) <= ((lCnt)pStore->numRecords * LOG_STORE_RECORD_SIZE) )
+   {
+      eRetVal = eSUCCESS;
+      while ( (0 != cnt) && (eSUCCESS == eRetVal) )
+      {
+         uint16_t key = (uint16_t)(destOffset / LOG_STORE_RECORD_SIZE);
+         lCnt     pos = destOffset % LOG_STORE_RECORD_SIZE;
+         lCnt     numBytes = MINIMUM(cnt, LOG_STORE_RECORD_SIZE - pos);
+         bool     bChanged;
+
+         /* Get the current record */
+         if ( LOG_NOT_WRITTEN == pStore->index[key] )
+         {
+            (void)memset(recordBuf_, 0, sizeof(recordBuf_));
+         }
+         else
+         {
+            eRetVal = (*pNextDriver)->devRead(recordBuf_, pStore->index[key] + sizeof(logEntryHdr_t),
+                                              sizeof(recordBuf_), pParData, pNextDriver + 1);
+         }
+         if ( eSUCCESS == eRetVal )
+         {
+            /* Modify it and append it to the log if it changed */
+            if ( NULL == pSrc )
+            {
+               uint8_t orBytes = 0;
+               lCnt    i;
+
+               for ( i = 0; i < numBytes; i++ )
+               {
+                  orBytes |= recordBuf_[pos + i];
+               }
+               bChanged = ( 0 != orBytes );
+               (void)memset(&recordBuf_[pos], 0, numBytes);
+            }
+            else
+            {
+               bChanged = ( 0 != memcmp(&recordBuf_[pos], pSrc, numBytes) );
+               (void)memcpy(&recordBuf_[pos], pSrc, numBytes);
+               pSrc += numBytes;
+            }
+            if ( bChanged )
+            {
+               eRetVal = appendEntry(pStore, key, recordBuf_, pParData, pNextDriver);
+            }
+         }
+         destOffset += numBytes;
+         cnt -= numBytes;
+      }
+   }
+   return (eRetVal);
+}
+/* ****************************************************************************************************************** */
+/* Unit Test */
+
+#ifdef TM_LOGSTORE_UNIT_TEST
+/***********************************************************************************************************************
+
+   Function Name: lgsTst_nop, lgsTst_setPowerMode, lgsTst_blankCheck, lgsTst_ioctl, lgsTst_restore, lgsTst_timeSlice
+
+   Purpose: Functions of the RAM flash that have nothing to do.
+
+   Arguments: See the DeviceDriverMem_t function typedefs
+
+   Returns: eSUCCESS (lgsTst_timeSlice returns false, nothing left to do)
+
+   Side Effects: None
+
+   Reentrant Code: Yes
+
+ **********************************************************************************************************************/
+static returnStatus_t lgsTst_nop( PartitionData_t const *pParData, DeviceDriverMem_t const * const *pNextDriver )
+{
+   return (eSUCCESS);
+}
+static returnStatus_t lgsTst_setPowerMode( const ePowerMode ePwrMode, PartitionData_t const *pParData,
+                                           DeviceDriverMem_t const * const *pNextDriver )
+{
+   return (eSUCCESS);
+}
+#if ( MCU_SELECTED == RA6E1 )
+static returnStatus_t lgsTst_blankCheck( dSize destOffset, lCnt cnt, PartitionData_t const *pParData,
+                                         DeviceDriverMem_t const * const *pNextDriver )
+{
+   return (eSUCCESS);
+}
+#endif
+static returnStatus_t lgsTst_ioctl( const void *pCmd, void *pData, PartitionData_t const *pParData,
+                                    DeviceDriverMem_t const * const *pNextDriver )
+{
+   return (eSUCCESS);
+}
+static returnStatus_t lgsTst_restore( lAddr lDest, lCnt cnt, PartitionData_t const *pParData,
+                                      DeviceDriverMem_t const * const *pNextDriver )
+{
+   return (eSUCCESS);
+}
+static bool lgsTst_timeSlice( PartitionData_t const *pParData, DeviceDriverMem_t const * const *pNextDriver )
+{
+   return (false);
+}
+/***********************************************************************************************************************
+
+   Function Name: lgsTstPowerCut
+
+   Purpose: Counts a write or erase of the RAM flash and loses the power when the count set by the test runs out.
+
+   Arguments: none
+
+   Returns: bool - true if the power is lost part way through this write or erase
+
+   Side Effects: Sets lgsTstPowerOff_, every access fails until the test powers up again.
+
+   Reentrant Code: No
+
+ **********************************************************************************************************************/
+static bool lgsTstPowerCut( void )
+{
+   bool bCut = false;
+
+   if ( 0 != lgsTstOpsLeft_ )
+   {
+      lgsTstOpsLeft_--;
+      bCut = ( 0 == lgsTstOpsLeft_ );
+      lgsTstPowerOff_ = bCut;
+   }
+   return (bCut);
+}
+/***********************************************************************************************************************
+
+   Function Name: lgsTst_read
+
+   Purpose: Reads the RAM flash.
+
+   Arguments: See dev_read_fptr
+
+   Returns: As defined by error_codes.h - eFAILURE while the power is off
+
+   Side Effects: None
+
+   Reentrant Code: No
+
+ **********************************************************************************************************************/
+static returnStatus_t lgsTst_read( uint8_t *pDest, const dSize srcOffset, const lCnt cnt,
+                                   PartitionData_t const *pParData, DeviceDriverMem_t const * const *pNextDriver )
+{
+   returnStatus_t eRetVal = eFAILURE;
+
+   if ( !lgsTstPowerOff_ && ((srcOffset + cnt) <= sizeof(lgsTstNv_)) )
+   {
+      (void)memcpy(pDest, &lgsTstNv_[srcOffset], cnt);
+      eRetVal = eSUCCESS;
+   }
+   return (eRetVal);
+}
+/***********************************************************************************************************************
+
+   Function Name: lgsTst_write
+
+   Purpose: Programs the RAM flash.  Like the external flash, programming only clears bits.  When the power is lost
+            during the write only the first half of the bytes are programmed.
+
+   Arguments: See dev_write_fptr
+
+   Returns: As defined by error_codes.h - eFAILURE if the power is lost
+
+   Side Effects: None
+
+   Reentrant Code: No
+
+ **********************************************************************************************************************/
+static returnStatus_t lgsTst_write( dSize destOffset, uint8_t const *pSrc, lCnt cnt, PartitionData_t const *pParData,
+                                    DeviceDriverMem_t const * const *pNextDriver )
+{
+   returnStatus_t eRetVal = eFAILURE;
+   lCnt           numBytes = cnt;
+   lCnt           i;
+
+   if ( !lgsTstPowerOff_ && ((destOffset + cnt) <= sizeof(lgsTstNv_)) )
+   {
+      if ( lgsTstPowerCut() )
+      {
+         numBytes = cnt / 2;
+      }
+      else
+      {
+         eRetVal = eSUCCESS;
+      }
+      for ( i = 0; i < numBytes; i++ )
+      {
+         lgsTstNv_[destOffset + i] &= pSrc[i];
+      }
+   }
+   return (eRetVal);
+}
+/***********************************************************************************************************************
+
+   Function Name: lgsTst_erase
+
+   Purpose: Erases the RAM flash.  When the power is lost during the erase only the first half of the range is erased,
+            so the sector header is gone but the entries after it are not.
+
+   Arguments: See dev_erase_fptr
+
+   Returns: As defined by error_codes.h - eFAILURE if the power is lost
+
+   Side Effects: None
+
+   Reentrant Code: No
+
+ **********************************************************************************************************************/
+static returnStatus_t lgsTst_erase( dSize destOffset, lCnt cnt, PartitionData_t const *pParData,
+                                    DeviceDriverMem_t const * const *pNextDriver )
+{
+   returnStatus_t eRetVal = eFAILURE;
+   lCnt           numBytes = cnt;
+
+   if ( !lgsTstPowerOff_ && ((destOffset + cnt) <= sizeof(lgsTstNv_)) )
+   {
+      if ( lgsTstPowerCut() )
+      {
+         numBytes = cnt / 2;
+      }
+      else
+      {
+         eRetVal = eSUCCESS;
+      }
+      (void)memset(&lgsTstNv_[destOffset], 0xFF, numBytes);
+   }
+   return (eRetVal);
+}
+/***********************************************************************************************************************
+
+   Function Name: lgsTstPowerUp
+
+   Purpose: Powers the test partition up again: the RAM state of the driver is lost and the partition is opened, which
+            rebuilds the index from the RAM flash.
+
+   Arguments: none
+
+   Returns: As defined by error_codes.h - Result of opening the partition
+
+   Side Effects: The power loss of the RAM flash is disarmed.
+
+   Reentrant Code: No
+
+ **********************************************************************************************************************/
+static returnStatus_t lgsTstPowerUp( void )
+{
+   lgsTstPowerOff_ = false;
+   lgsTstOpsLeft_ = 0;
+   (void)memset(findStore(&lgsTstPartition_), 0, sizeof(logStore_t));
+   return (sDeviceDriver_eLogStore.devOpen(&lgsTstPartition_, &lgsTstDriver_[1]));
+}
+/***********************************************************************************************************************
+
+   Function Name: lgsTstCheck
+
+   Purpose: Checks the state of the test partition after a power up.  Every record must read back as expected and the
+            sector after the head must be erased.
+
+   Arguments:
+      uint8_t expected[][LOG_STORE_RECORD_SIZE] - Value of each record
+      uint16_t cutAt - Write/erase the power was lost at, for the log
+
+   Returns: uint16_t - Number of failures
+
+   Side Effects: None
+
+   Reentrant Code: No
+
+ **********************************************************************************************************************/
+static uint16_t lgsTstCheck( uint8_t expected[][LOG_STORE_RECORD_SIZE], uint16_t cutAt )
+{
+   uint8_t        rdData[LOG_STORE_RECORD_SIZE];
+   logStore_t     *pStore = findStore(&lgsTstPartition_);
+   dSize          offset;
+   dSize          end;
+   uint16_t       failures = 0;
+   uint16_t       key;
+
+   for ( key = 0; key < LGS_TST_NUM_RECORDS; key++ )
+   {
+      if ( ( eSUCCESS != sDeviceDriver_eLogStore.devRead(rdData, key * LOG_STORE_RECORD_SIZE, sizeof(rdData),
+                                                         &lgsTstPartition_, &lgsTstDriver_[1]) ) ||
+           ( 0 != memcmp(rdData, expected[key], sizeof(rdData)) ) )
+      {
+         DBG_logPrintf('U', "    Cut at %u: Record %u Read Verify Failed!", cutAt, key);
+         failures++;
+      }
+   }
+   offset = ((pStore->head + 1) % LOG_STORE_NUM_SECTORS) * LGS_TST_SECTOR_SIZE;
+   for ( end = offset + LGS_TST_SECTOR_SIZE; (offset < end) && (0xFF == lgsTstNv_[offset]); offset++ )
+   {
+   }
+   if ( offset < end )
+   {
+      DBG_logPrintf('U', "    Cut at %u: The sector after the head is not erased!", cutAt);
+      failures++;
+   }
+   return (failures);
+}
+#endif
+
+/***********************************************************************************************************************
+
+   Function Name: DVR_LOGSTORE_unitTest
+
+   Purpose: Power loss test of the log store driver.  A test partition on a RAM flash is written until the power is lost
+            part way through a write or an erase of the flash, then powered up again and checked.  The power is lost at
+            every write and erase of the pass in turn, so it is lost while appending entries, while starting a sector
+            and while copying and erasing the sector being garbage collected.  After each power up every record must
+            hold its last written value (the record being written when the power was lost may hold its old or its new
+            value), the sector after the head must be erased and the driver must still write.
+
+   Arguments: none
+
+   Returns: none
+
+   Side Effects: None, the partitions in the partition table are not used.
+
+   Reentrant Code: No
+
+ **********************************************************************************************************************/
+void DVR_LOGSTORE_unitTest(void)
+{
+#ifdef TM_LOGSTORE_UNIT_TEST
+   uint8_t        expected[LGS_TST_NUM_RECORDS][LOG_STORE_RECORD_SIZE];
+   uint8_t        wrData[LOG_STORE_RECORD_SIZE];
+   uint8_t        rdData[LOG_STORE_RECORD_SIZE];
+   logStore_t     *pStore;
+   uint16_t       cutAt;
+   uint16_t       i;
+   uint16_t       key = 0;
+   uint16_t       appendCuts = 0;
+   uint16_t       gcCuts = 0;
+   uint16_t       failures = 0;
+   bool           bGc = false;
+   bool           bCut = true;
+
+   DBG_logPrintf('U', "  Unit Testing the Log Store Driver: Power loss mid append and mid garbage collection");
+   (void)sDeviceDriver_eLogStore.devInit(&lgsTstPartition_, &lgsTstDriver_[1]);
+
+   for ( cutAt = 1; bCut; cutAt++ )
+   {
+      /* Start with an erased partition */
+      (void)memset(lgsTstNv_, 0xFF, sizeof(lgsTstNv_));
+      (void)memset(expected, 0, sizeof(expected));
+      (void)lgsTstPowerUp();
+
+      /* Write until the power is lost.  Record 3 is only written once, so it is copied every time its sector is
+         garbage collected.  Every write changes the record. */
+      lgsTstOpsLeft_ = cutAt;
+      bCut = false;
+      for ( i = 0; (i < LGS_TST_NUM_WRITES) && !bCut; i++ )
+      {
+         if ( 0 == i )
+         {
+            key = 3;
+         }
+         else if ( 0 == (i % 4) )
+         {
+            key = (uint16_t)(((i / 4) % 2) + 1);
+         }
+         else
+         {
+            key = 0;
+         }
+         (void)memset(wrData, (int)(i + 1), sizeof(wrData));
+         pStore = findStore(&lgsTstPartition_);
+         bGc = ( pStore->headSlot >= pStore->slotsPerSector ); /* This write moves to the next sector and collects */
+         if ( eSUCCESS == sDeviceDriver_eLogStore.devWrite(key * LOG_STORE_RECORD_SIZE, wrData, sizeof(wrData),
+                                                           &lgsTstPartition_, &lgsTstDriver_[1]) )
+         {
+            (void)memcpy(expected[key], wrData, sizeof(wrData));
+         }
+         else
+         {
+            bCut = true;
+         }
+      }
+
+      /* Power up, the record being written may hold either value */
+      if ( eSUCCESS != lgsTstPowerUp() )
+      {
+         DBG_logPrintf('U', "    Cut at %u: Open Failed!", cutAt);
+         failures++;
+      }
+      else
+      {
+         if ( bCut )
+         {
+            if ( bGc )
+            {
+               gcCuts++;
+            }
+            else
+            {
+               appendCuts++;
+            }
+            if ( ( eSUCCESS == sDeviceDriver_eLogStore.devRead(rdData, key * LOG_STORE_RECORD_SIZE, sizeof(rdData),
+                                                               &lgsTstPartition_, &lgsTstDriver_[1]) ) &&
+                 ( 0 == memcmp(rdData, wrData, sizeof(rdData)) ) )
+            {
+               (void)memcpy(expected[key], wrData, sizeof(wrData));
+            }
+         }
+         failures += lgsTstCheck(expected, cutAt);
+
+         /* The log must still work: change every record, power up and check again */
+         for ( key = 0; key < LGS_TST_NUM_RECORDS; key++ )
+         {
+            (void)memset(expected[key], (int)(0xA0 + key), sizeof(expected[key]));
+            if ( eSUCCESS != sDeviceDriver_eLogStore.devWrite(key * LOG_STORE_RECORD_SIZE, expected[key],
+                                                              sizeof(expected[key]), &lgsTstPartition_,
+                                                              &lgsTstDriver_[1]) )
+            {
+               DBG_logPrintf('U', "    Cut at %u: Write after power up Failed!", cutAt);
+               failures++;
+            }
+         }
+         (void)lgsTstPowerUp();
+         failures += lgsTstCheck(expected, cutAt);
+      }
+      OS_TASK_Sleep ( 10 );
+   }
+   (void)memset(findStore(&lgsTstPartition_), 0, sizeof(logStore_t)); /* Free the partition's RAM state */
+
+   DBG_logPrintf('U', "  %u power losses: %u appending, %u garbage collecting.  %u failures.",
+                 appendCuts + gcCuts, appendCuts, gcCuts, failures);
+#endif
+}
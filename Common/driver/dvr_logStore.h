@@ -0,0 +1,89 @@
+/* ****************************************************************************************************************** */
+/***********************************************************************************************************************
+ *
+ * Filename: dvr_logStore.h
+ *
+ * Contents: Log structured record store memory driver
+ *
+ ***********************************************************************************************************************
+ * A product of
+ * Aclara Technologies LLC
+ * Confidential and Proprietary
+ * Copyright 2022 Aclara.  All Rights Reserved.
+ *
+ * PROPRIETARY NOTICE
+ * The information contained in this document is private to Aclara Technologies LLC an Ohio limited liability company
+ * (Aclara).  This information may not be published, reproduced, or otherwise disseminated without the express written
+ * authorization of Aclara.  Any software or firmware described in this document is furnished under a license and may be
+ * used or copied only in accordance with the terms of such license.
+ ***********************************************************************************************************************
+ *
+ * $Log$
+ *
+ **********************************************************************************************************************/
+#ifndef DVR_LOGSTORE_H_
+#define DVR_LOGSTORE_H_
+
+/* ****************************************************************************************************************** */
+/* INCLUDE FILES */
+
+#include "partitions.h"
+
+/* ****************************************************************************************************************** */
+/* GLOBAL DEFINTION */
+
+#ifdef dvr_logStore_GLOBAL
+   #define dvr_logStore_EXTERN
+#else
+   #define dvr_logStore_EXTERN extern
+#endif
+
+/* ****************************************************************************************************************** */
+/* MACRO DEFINITIONS */
+
+/* The partition's data is kept as records of this many bytes.  Each update of a record appends an entry of
+   LOG_STORE_ENTRY_SIZE bytes to the log. */
+#define LOG_STORE_RECORD_SIZE       ((lCnt)24)
+#define LOG_STORE_ENTRY_SIZE        ((lCnt)32)
+
+/* Number of erase sectors (EraseBlockSize) the log of one partition uses.  The partition's lSize is the data size; the
+   log occupies LOG_STORE_NUM_SECTORS * EraseBlockSize bytes of NV starting at PhyStartingAddress.  At least 3. */
+#ifndef LOG_STORE_NUM_SECTORS
+#define LOG_STORE_NUM_SECTORS       ((uint8_t)4)
+#endif
+
+/* Size of the RAM index.  A partition may hold at most LOG_STORE_MAX_RECORDS * LOG_STORE_RECORD_SIZE bytes. */
+#ifndef LOG_STORE_MAX_PARTITIONS
+#define LOG_STORE_MAX_PARTITIONS    ((uint8_t)2)
+#endif
+#ifndef LOG_STORE_MAX_RECORDS
+#define LOG_STORE_MAX_RECORDS       ((uint16_t)128)
+#endif
+
+/* ****************************************************************************************************************** */
+/* TYPE DEFINITIONS */
+
+typedef struct
+{
+   uint16_t key;        /* Record number, or LOG_STORE_SECTOR_KEY for the sector header */
+   uint16_t keyInv;     /* ~key, an erased or partially written entry will not match */
+   uint16_t check;      /* Fletcher-16 of the key and the record */
+   uint16_t rsvd;       /* Written as 0 */
+}logEntryHdr_t;         /* Header of every entry in the log */
+
+/* ****************************************************************************************************************** */
+/* CONSTANTS */
+
+/* ****************************************************************************************************************** */
+/* GLOBAL VARIABLES */
+
+extern const DeviceDriverMem_t sDeviceDriver_eLogStore;
+
+/* ****************************************************************************************************************** */
+/* FUNCTION PROTOTYPES */
+
+void DVR_LOGSTORE_unitTest(void);
+
+#undef dvr_logStore_EXTERN
+
+#endif
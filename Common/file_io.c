@@ -74,6 +74,12 @@ typedef struct
    uint8_t       u8Data[FIO_MAX_FILE_SIZE_WITH_CHECKSUM];  /* Used to hold the data */
 } tCsFile;   /* Used to perform read-modify-write operations for files with a checksum attribute. */
 
+typedef struct
+{
+   PartitionData_t const *pPartition;  /* Partition holding the file, NULL if the file has not been seen */
+   dSize                 FileOffset;   /* Offset of the file's header in the partition */
+} tFioDirEntry;   /* Where a file was last found, so FIO_fopen does not have to walk the partition's files */
+
 /* ****************************************************************************************************************** */
 /* CONSTANTS */
 
@@ -85,6 +91,7 @@ static OS_MUTEX_Obj  fioMutex_;  /* Serialize access to the file i/o driver for
 #endif
 STATIC tCsFile       _sFile;     /* Buffer to store file contents for read-modify-write ops on checksumed files */
 STATIC bool          runNVTest_; /* Flag to indicate, if time to run NV test */
+STATIC tFioDirEntry  fioDir_[eFN_LASTFILE]; /* File directory, indexed by file id */
 
 /* Create macro to make a list of filenames whose names are exactly their respective enums.
    example: FILENAME( eFN_DST ) expands to [ eFN_DST ] = "eFN_DST"   */
@@ -246,6 +253,9 @@ static returnStatus_t   verifyFixFileChecksum(  tFileHeader const *pHeader, Part
                                                 dSize FileOffset );
 static uint32_t         calcFileCrc(            tFileHeader     const *pHeader,   PartitionData_t const *pPartitionData,
                                                 dSize FileOffset );
+static void             fioDirBuild( void );
+static void             fioDirAdd( PartitionData_t const *pPartitionData, uint16_t fId, dSize FileOffset );
+static bool             fioDirLookup( PartitionData_t const *pPartitionData, uint16_t fId, dSize *pFileOffset );
 
 /* ****************************************************************************************************************** */
 /* FUNCTION DEFINITIONS */
@@ -254,7 +264,7 @@ static uint32_t         calcFileCrc(            tFileHeader     const *pHeader,
 
    Function Name: FIO_finit
 
-   Purpose: Creates the mutex for the file i/o module and initializes the partition manager.
+   Purpose: Creates the mutex for the file i/o module, initializes the partition manager and builds the file directory.
 
    Arguments: None
 
@@ -274,6 +284,10 @@ returnStatus_t FIO_finit( void )
       //Mutex create succeeded
       runNVTest_ = false;
       retVal = PAR_partitionFptr.parInit();
+      if ( eSUCCESS == retVal )
+      {
+         fioDirBuild();
+      }
 #if ( RTOS_SELECTION == FREE_RTOS )
       if ( eSUCCESS != retVal )
       {
@@ -334,13 +348,23 @@ returnStatus_t FIO_fopen( FileHandle_t *pFileHandle, ePartitionName ePartition,
          tFileHeader sHeader;          /* Contains the current file's header just read from memory */
          bool  bFileFound = false;     /* Set true if the file is found. */
          dSize FileOffset = 0;         /* Offset to the file in the partition.  Used to search the partition. */
+         bool  bFromDir;               /* Set true while FileOffset comes from the file directory */
 
+         /* Start at the file itself when the directory knows where it is */
+         bFromDir = fioDirLookup( pFileHandle->pTblInfo, fId, &FileOffset );
          do
          {
             /* Read the file's header */
             eRetVal = PAR_partitionFptr.parRead( ( uint8_t * ) & sHeader, FileOffset, sizeof( sHeader ), pFileHandle->pTblInfo );
 
-            if ( eSUCCESS == eRetVal )   /* Was the header read properly? */
+            if ( bFromDir && ( ( eSUCCESS != eRetVal ) || ( sHeader.Id != fId ) ) )
+            {
+               /* The directory is out of date (partition erased?), search the partition from the start */
+               bFromDir = false;
+               FileOffset = 0;
+               eRetVal = eSUCCESS;
+            }
+            else if ( eSUCCESS == eRetVal )   /* Was the header read properly? */
             {
                if ( sHeader.Id == fId ) /* Was the file passed in found? */
                {
@@ -356,6 +380,7 @@ returnStatus_t FIO_fopen( FileHandle_t *pFileHandle, ePartitionName ePartition,
                   pFileHandle->FileOffset = FileOffset;
                   pFileHandle->Attr = fAttr;
                   pFileHandle->dataSize = ( FileDataSize_t )sHeader.dataSize; //return the size of file in NV, if the file size mismatch
+                  fioDirAdd( pFileHandle->pTblInfo, fId, FileOffset );
                   if ( sHeader.dataSize != cnt )   /* Make sure the file size matches */
                   {
                      eRetVal = eFILEIO_FILE_SIZE_MISMATCH;
@@ -406,6 +431,10 @@ returnStatus_t FIO_fopen( FileHandle_t *pFileHandle, ePartitionName ePartition,
                      }
                      bFileFound = true;  /* It has just been created and so it is found. */
                      pStatus->bFileCreated = true;
+                     if ( eSUCCESS == eRetVal )
+                     {
+                        fioDirAdd( pFileHandle->pTblInfo, fId, FileOffset );
+                     }
                   }
                   else
                   {
@@ -455,6 +484,117 @@ returnStatus_t FIO_fopen( FileHandle_t *pFileHandle, ePartitionName ePartition,
    OS_MUTEX_Unlock( &fioMutex_ );
    return( eRetVal );
 }
+/***********************************************************************************************************************
+
+   Function Name: fioDirBuild
+
+   Purpose: Builds the file directory by walking the files of every file system partition once.
+
+   Arguments: None
+
+   Returns: None
+
+   Side Effects: None
+
+   Reentrant Code: No - Called from FIO_finit only
+
+ **********************************************************************************************************************/
+static void fioDirBuild( void )
+{
+   PartitionData_t      *pPartitionData;     // open partition
+   PAR_getNextMember_t  sMember;             // data structure needed to get all partitions
+   returnStatus_t       eRetVal;             // Return value, used throughout the function to test for errors
+
+   ( void )memset( fioDir_, 0, sizeof( fioDir_ ) );
+
+   /* Initialize and get the first partition */
+   pPartitionData = PAR_GetFirstPartition( &sMember );
+
+   while ( ( NULL != pPartitionData ) && ( pPartitionData->ePartition < ePART_START_NAMED_PARTITIONS ) )
+   {
+      tFileHeader sHeader;          /* Contains the current file's header just read from memory */
+      dSize    FileOffset = 0;      /* Offset to the file in the partition.  Used to search the partition. */
+
+      // we only want to process partitions that contain a file system
+      if( pPartitionData->PartitionType.fileSys )
+      {
+         do
+         {
+            /* Read the file's header */
+            eRetVal = PAR_partitionFptr.parRead( ( uint8_t * ) & sHeader, FileOffset, sizeof( sHeader ), pPartitionData );
+            if ( ( eSUCCESS == eRetVal ) && ( INVALID_FILE_ID != sHeader.Id ) )
+            {
+               fioDirAdd( pPartitionData, sHeader.Id, FileOffset );
+               /* Set offset to next file.  The read above will fail if the partition boundary is exceeded. */
+               FileOffset += sHeader.dataSize + sizeof( sHeader );
+            }
+            else
+            {
+               /* Past the last file, go to next partition */
+               break;
+            }
+         }
+         while ( FileOffset < pPartitionData->lDataSize );
+      }
+      /* Get next partition */
+      pPartitionData = PAR_GetNextPartition( &sMember );
+   }
+}
+/***********************************************************************************************************************
+
+   Function Name: fioDirAdd
+
+   Purpose: Records where a file is in the file directory.
+
+   Arguments:
+      pPartitionData:  Partition holding the file
+      fId:  ID of the file (filename)
+      FileOffset:  Offset of the file's header in the partition
+
+   Returns: None
+
+   Side Effects: None
+
+   Reentrant Code: No - Caller must hold fioMutex_ (except during FIO_finit)
+
+ **********************************************************************************************************************/
+static void fioDirAdd( PartitionData_t const *pPartitionData, uint16_t fId, dSize FileOffset )
+{
+   if ( fId < ( uint16_t )eFN_LASTFILE )  /* Ids the directory has no room for are found by searching */
+   {
+      fioDir_[fId].pPartition = pPartitionData;
+      fioDir_[fId].FileOffset = FileOffset;
+   }
+}
+/***********************************************************************************************************************
+
+   Function Name: fioDirLookup
+
+   Purpose: Looks up where a file is in the file directory.
+
+   Arguments:
+      pPartitionData:  Partition the file is expected in
+      fId:  ID of the file (filename)
+      *pFileOffset:  Set to the offset of the file's header in the partition, if found
+
+   Returns: bool - true if the directory has the file in this partition. The caller checks the header at the offset.
+
+   Side Effects: None
+
+   Reentrant Code: No - Caller must hold fioMutex_
+
+ **********************************************************************************************************************/
+static bool fioDirLookup( PartitionData_t const *pPartitionData, uint16_t fId, dSize *pFileOffset )
+{
+   bool bFound = false;
+
+   if ( ( fId < ( uint16_t )eFN_LASTFILE ) && ( NULL != pPartitionData ) && ( fioDir_[fId].pPartition == pPartitionData ) )
+   {
+      *pFileOffset = fioDir_[fId].FileOffset;
+      bFound = true;
+   }
+   return bFound;
+}
 /***********************************************************************************************************************
 
    Function Name: FIO_fclose
@@ -552,17 +692,29 @@ returnStatus_t FIO_fwrite( const FileHandle_t *pFileHandle, const fileOffset fOf
    {
       if ( pFileHandle->Attr & FILE_IS_CHECKSUMED )
       {
-         /* For a checksumed file, read the data to a local buffer. Compute new checksum as
+         /* For a checksumed file, only the header and the bytes up to the last one overwritten are read.
+            Compute new checksum as
             New checksum = old checksum + checksum of new bytes to write - checksum of the byte overwritten
-            The over-write local buffer with pSrc and then write the entire file to the device.
+            Then write the header through the last byte changed with a single write, so the data and the checksum are
+            never out of step: a banked partition copies the whole bank on every write (the bank switch is what makes
+            the update atomic), a raw partition may erase and rewrite the sector on every write and a cached partition
+            may be flushed between two writes.
             If file get corrupted, this method will not mask it. The NV error check will catch the NV error */
          OS_MUTEX_Lock( &fioMutex_ );
 
-         /* Read the file into the local buffer including the header. */
-         eRetVal = PAR_partitionFptr.parRead( ( uint8_t * ) & _sFile, pFileHandle->FileOffset,
-                                              ( lCnt )sizeof( _sFile.sHeader ) + pFileHandle->dataSize,
+         /* Read the header into the local buffer */
+         eRetVal = PAR_partitionFptr.parRead( ( uint8_t * ) & _sFile.sHeader, pFileHandle->FileOffset,
+                                              ( lCnt )sizeof( _sFile.sHeader ),
                                               pFileHandle->pTblInfo );
          if ( eSUCCESS == eRetVal )   /* Was the file header successfully read? */
+         {
+            /* Read the data through the last byte to be overwritten */
+            eRetVal = PAR_partitionFptr.parRead( &_sFile.u8Data[0],
+                                                 pFileHandle->FileOffset + sizeof( tFileHeader ),
+                                                 ( lCnt )( fOffset + Cnt ),
+                                                 pFileHandle->pTblInfo );
+         }
+         if ( eSUCCESS == eRetVal )   /* Was the file successfully read? */
          {
             //Compute the checksum
             _sFile.sHeader.Cs += FileChecksum( ( uint8_t * )pSrc, ( uint16_t )Cnt ); //Add the checksum of the bytes to write
@@ -572,10 +724,10 @@ returnStatus_t FIO_fwrite( const FileHandle_t *pFileHandle, const fileOffset fOf
             /* Modify the local buffer with the data to be written in pSrc */
             ( void )memcpy( &_sFile.u8Data[fOffset], pSrc, Cnt ); //lint !e419 !e669   Data size is checked by FILE_IS_CHECKSUMED
 
-            /* Write the entire file content to memory */
+            /* Write the header through the last byte changed */
             eRetVal = PAR_partitionFptr.parWrite( pFileHandle->FileOffset,
                                                   ( uint8_t * ) & _sFile,
-                                                  ( lCnt )_sFile.sHeader.dataSize + sizeof( tFileHeader ),
+                                                  ( lCnt )( fOffset + Cnt ) + sizeof( tFileHeader ),
                                                   pFileHandle->pTblInfo );
          }
          OS_MUTEX_Unlock( &fioMutex_ );
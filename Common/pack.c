@@ -42,6 +42,8 @@
  * v0.12 - Optimized all MOD operations by replacing them with "& MOD8"
  *          Added 3 new #defines to get rid of magic numbers.
  *          Added braces where needed.
+ * v0.13 - Added byte/word at a time versions of the pack/unpack routines.  The original bit at a time routines are
+ *         kept for the legacy corner cases and as the reference for PACK_unitTest().
  ******************************************************************************************************************** */
 // </editor-fold>
 // <editor-fold defaultstate="collapsed" desc="Psect Definitions">
@@ -63,11 +65,15 @@
 #include <stdbool.h>
 #include <limits.h> /* only for CHAR_BIT */
 #include <string.h>
+#include "project.h"
 #include "error_codes.h"
 #include "portable_freescale.h" /* only for PROCESSOR_LITTLE_ENDIAN */
 #include "pack.h"
 #include "byteswap.h"
 #include "portable_aclara.h"
+#ifdef TM_PACK_UNIT_TEST
+#include "DBG_SerialDebug.h"
+#endif
 // </editor-fold>
 // <editor-fold defaultstate="collapsed" desc="Constant Definitions">
 /* ****************************************************************************************************************** */
@@ -94,6 +100,14 @@
 static uint8_t pack_bits  ( const uint8_t *pSrc, uint8_t srcSize,   uint8_t *pDst, uint16_t dstOffset, uint8_t numBits );
 static uint8_t unpack_bits( const uint8_t *pSrc, uint16_t srcOffset, uint8_t *pDst, uint8_t dstSize,   uint8_t numBits );
 static uint8_t copy_bits  ( const uint8_t *pSrc, uint16_t srcOffset, uint8_t *pDst, uint8_t dstOffset, uint16_t numBits );
+static uint8_t pack_bits_bitwise  ( const uint8_t *pSrc, uint8_t srcSize,   uint8_t *pDst, uint16_t dstOffset, uint8_t numBits );
+static uint8_t unpack_bits_bitwise( const uint8_t *pSrc, uint16_t srcOffset, uint8_t *pDst, uint8_t dstSize,   uint8_t numBits );
+static uint8_t copy_bits_bitwise  ( const uint8_t *pSrc, uint16_t srcOffset, uint8_t *pDst, uint8_t dstOffset, uint16_t numBits );
+static void    pack_buffer_bitwise  ( int16_t numBits,  uint8_t *pSrc,    pack_t *pack );
+static void    unpack_buffer_bitwise( int8_t  bitCount, uint8_t *pResult, pack_t *pack );
+static uint32_t get_bits ( const uint8_t *pSrc, uint16_t srcOffset, uint8_t numBits );
+static void     put_bits ( uint8_t *pDst, uint16_t dstOffset, uint32_t value, uint8_t numBits );
+static void     move_bits( const uint8_t *pSrc, uint16_t srcOffset, uint8_t *pDst, uint16_t dstOffset, uint16_t numBits );
 // </editor-fold>
 
 /* ********************************************************************************************************************/
@@ -389,7 +403,7 @@ uint64_t UNPACK_bits2_uint64 ( const uint8_t *pSrc, uint16_t *pSrcOffset, uint8_
 
    \retval    cnt    The number of bits moved.
 */
-static uint8_t copy_bits(
+static uint8_t copy_bits_bitwise(
    const uint8_t *pSrc,          /* [in] Pointer to source         */
    uint16_t       srcOffset,     /* [in] Number  of bits to offset */
    uint8_t       *pDst,          /* [in] Pointer to destination    */
@@ -457,7 +471,7 @@ static uint8_t copy_bits(
 
    \retval    cnt    The number of bits moved.
 */
-static uint8_t pack_bits(
+static uint8_t pack_bits_bitwise(
    const uint8_t *pSrc,    /* [in] Pointer to source */
    uint8_t srcSize,        /* [in] Size of source in bytes (1, 2, 4, 8) */
    uint8_t *pDst,          /* [in] Pointer to destination */
@@ -539,7 +553,7 @@ static uint8_t pack_bits(
           a uint16_t, and only 12 bits are requested, the returned value will be 0x0123.
    \retval    cnt    The number of bits moved.
 */
-static uint8_t unpack_bits(
+static uint8_t unpack_bits_bitwise(
    const  uint8_t *pSrc,   /*  Pointer to source */
    uint16_t srcOffset,     /*  Offset  in bits   */
    uint8_t *pDst,          /*  Pointer to destination */
@@ -606,6 +620,264 @@ static uint8_t unpack_bits(
    return ( bitCnt );
 }
 
+/*!
+   \brief Reads up to 24 bits from a big endian bit array, a byte at a time.
+
+   \param[in] pSrc       Pointer to the source.
+   \param[in] srcOffset  Offset into the source in bits.
+   \param[in] numBits    The number of bits to read (1-24).
+
+   \retval    value      The bits, right justified.
+*/
+static uint32_t get_bits( const uint8_t *pSrc, uint16_t srcOffset, uint8_t numBits )
+{
+   uint32_t acc = 0;
+   uint8_t  total;
+   uint8_t  numBytes;
+   uint8_t  i;
+
+   pSrc    += DIV_8( srcOffset );
+   total    = ( uint8_t )( MOD_8( srcOffset ) + numBits );
+   numBytes = ( uint8_t )DIV_8( total + MOD8 );
+   for ( i = 0; i < numBytes; i++ )
+   {
+      acc = ( acc << 8 ) | pSrc[i];
+   }
+   acc >>= ( ( numBytes * CHAR_BIT ) - total );
+   return ( acc & ( ( 1UL << numBits ) - 1UL ) );
+}
+
+/*!
+   \brief Writes up to 24 bits to a big endian bit array, a byte at a time.  Only the bits in the range are modified.
+
+   \param[in] pDst       Pointer to the destination.
+   \param[in] dstOffset  Offset into the destination in bits.
+   \param[in] value      The bits to write, right justified.
+   \param[in] numBits    The number of bits to write (1-24).
+*/
+static void put_bits( uint8_t *pDst, uint16_t dstOffset, uint32_t value, uint8_t numBits )
+{
+   uint32_t acc = 0;
+   uint32_t mask;
+   uint8_t  total;
+   uint8_t  numBytes;
+   uint8_t  shift;
+   uint8_t  i;
+
+   pDst    += DIV_8( dstOffset );
+   total    = ( uint8_t )( MOD_8( dstOffset ) + numBits );
+   numBytes = ( uint8_t )DIV_8( total + MOD8 );
+   shift    = ( uint8_t )( ( numBytes * CHAR_BIT ) - total );
+   mask     = ( ( 1UL << numBits ) - 1UL ) << shift;
+   for ( i = 0; i < numBytes; i++ )
+   {
+      acc = ( acc << 8 ) | pDst[i];
+   }
+   acc = ( acc & ~mask ) | ( ( value << shift ) & mask );
+   for ( i = numBytes; i != 0; i-- )
+   {
+      pDst[i - 1] = ( uint8_t )acc;
+      acc >>= 8;
+   }
+}
+
+/*!
+   \brief Copies bits between two big endian bit arrays.  Uses memcpy when both offsets are on a byte boundary,
+          otherwise moves 24 bits per step.  Only the bits in the destination range are modified.
+
+   \param[in] pSrc       Pointer to the source.
+   \param[in] srcOffset  Offset into the source in bits.
+   \param[in] pDst       Pointer to the destination.
+   \param[in] dstOffset  Offset into the destination in bits.
+   \param[in] numBits    The number of bits to move.
+*/
+static void move_bits( const uint8_t *pSrc, uint16_t srcOffset, uint8_t *pDst, uint16_t dstOffset, uint16_t numBits )
+{
+   uint8_t n;
+
+   if ( ( 0 == MOD_8( srcOffset ) ) && ( 0 == MOD_8( dstOffset ) ) )
+   {
+      (void)memcpy( pDst + DIV_8( dstOffset ), pSrc + DIV_8( srcOffset ), DIV_8( numBits ) );
+      srcOffset += numBits & ~( uint16_t )MOD8;
+      dstOffset += numBits & ~( uint16_t )MOD8;
+      numBits   &= MOD8;
+   }
+   while ( numBits != 0 )
+   {
+      n = ( numBits > 24 ) ? 24 : ( uint8_t )numBits;
+      put_bits( pDst, dstOffset, get_bits( pSrc, srcOffset, n ), n );
+      srcOffset += n;
+      dstOffset += n;
+      numBits   -= n;
+   }
+}
+
+/*!
+   \brief Reads a local machine format value (uint8_t, uint16_t, uint32_t, uint64_t).  The source need not be aligned.
+
+   \retval    value  The value read.
+*/
+static uint64_t load_value( const uint8_t *pSrc, uint8_t srcSize )
+{
+   uint64_t value;
+
+   switch ( srcSize )
+   {
+      case sizeof( uint8_t ):
+      {
+         value = *pSrc;
+         break;
+      }
+      case sizeof( uint16_t ):
+      {
+         uint16_t temp;
+         (void)memcpy( &temp, pSrc, sizeof( temp ) );
+         value = temp;
+         break;
+      }
+      case sizeof( uint32_t ):
+      {
+         uint32_t temp;
+         (void)memcpy( &temp, pSrc, sizeof( temp ) );
+         value = temp;
+         break;
+      }
+      default:
+      {
+         (void)memcpy( &value, pSrc, sizeof( value ) );
+         break;
+      }
+   }
+   return ( value );
+}
+
+/*!
+   \brief ORs a value into a local machine format destination (uint8_t, uint16_t, uint32_t, uint64_t).  The destination
+          need not be aligned.
+*/
+static void or_value( uint8_t *pDst, uint8_t dstSize, uint64_t value )
+{
+   value |= load_value( pDst, dstSize );
+   switch ( dstSize )
+   {
+      case sizeof( uint8_t ):
+      {
+         *pDst = ( uint8_t )value;
+         break;
+      }
+      case sizeof( uint16_t ):
+      {
+         uint16_t temp = ( uint16_t )value;
+         (void)memcpy( pDst, &temp, sizeof( temp ) );
+         break;
+      }
+      case sizeof( uint32_t ):
+      {
+         uint32_t temp = ( uint32_t )value;
+         (void)memcpy( pDst, &temp, sizeof( temp ) );
+         break;
+      }
+      default:
+      {
+         (void)memcpy( pDst, &value, sizeof( value ) );
+         break;
+      }
+   }
+}
+
+/*!
+   \brief Fast version of pack_bits_bitwise.  Same arguments and results.  Falls back to the bit at a time version for
+          bit counts that are not valid for the source size.
+
+   \retval    cnt    The number of bits moved.
+*/
+static uint8_t pack_bits(
+   const uint8_t *pSrc,    /* [in] Pointer to source */
+   uint8_t srcSize,        /* [in] Size of source in bytes (1, 2, 4, 8) */
+   uint8_t *pDst,          /* [in] Pointer to destination */
+   uint16_t dstOffset,     /* [in] Number of  bits to offset */
+   uint8_t numBits)        /* [in] Number of bits to move */
+{
+   uint64_t value;
+   uint8_t  remaining;
+
+   // If destination pointer is NULL then all we are interested in is the size of the operation
+   if ( pDst == NULL ) {
+      return (numBits);
+   }
+   if ( ( 0 == numBits ) || ( numBits > ( srcSize * CHAR_BIT ) ) )
+   {
+      return ( pack_bits_bitwise( pSrc, srcSize, pDst, dstOffset, numBits ) );
+   }
+
+   value     = load_value( pSrc, srcSize );
+   remaining = numBits;
+   while ( remaining > 24 )                     /* Most significant bits first */
+   {
+      remaining -= 24;
+      put_bits( pDst, dstOffset, ( uint32_t )( value >> remaining ), 24 );
+      dstOffset += 24;
+   }
+   put_bits( pDst, dstOffset, ( uint32_t )value, remaining );
+   return ( numBits );
+}
+
+/*!
+   \brief Fast version of unpack_bits_bitwise.  Same arguments and results.  Falls back to the bit at a time version for
+          bit counts that are not valid for the destination size.
+
+   \retval    cnt    The number of bits moved.
+*/
+static uint8_t unpack_bits(
+   const  uint8_t *pSrc,   /*  Pointer to source */
+   uint16_t srcOffset,     /*  Offset  in bits   */
+   uint8_t *pDst,          /*  Pointer to destination */
+   uint8_t  dstSize,       /*  Size of the destination in bytes (1, 2, 4, 8)  */
+   uint8_t  numBits )      /*  Number of bits to move */
+{
+   uint64_t value = 0;
+   uint8_t  remaining;
+   uint8_t  n;
+
+   if ( pSrc == NULL )
+   {
+      return ( 0 );
+   }
+   if ( numBits > ( dstSize * CHAR_BIT ) )
+   {
+      return ( unpack_bits_bitwise( pSrc, srcOffset, pDst, dstSize, numBits ) );
+   }
+
+   for ( remaining = numBits; remaining != 0; remaining -= n )
+   {
+      n = ( remaining > 24 ) ? 24 : remaining;
+      value = ( value << n ) | get_bits( pSrc, srcOffset, n );
+      srcOffset += n;
+   }
+   or_value( pDst, dstSize, value );
+   return ( numBits );
+}
+
+/*!
+   \brief Fast version of copy_bits_bitwise.  Same arguments and results.
+
+   \retval    cnt    The number of bits moved.
+*/
+static uint8_t copy_bits(
+   const uint8_t *pSrc,          /* [in] Pointer to source         */
+   uint16_t       srcOffset,     /* [in] Number  of bits to offset */
+   uint8_t       *pDst,          /* [in] Pointer to destination    */
+   uint8_t        dstOffset,     /* [in] Number of bits to offset  */
+   uint16_t       numBits )      /* [in] Number of bits to move    */
+{
+   if ( 0 == numBits )
+   {  /* Preserve the legacy behavior for this case */
+      return ( copy_bits_bitwise( pSrc, srcOffset, pDst, dstOffset, numBits ) );
+   }
+   move_bits( pSrc, srcOffset, pDst, dstOffset, numBits );
+   return ( ( uint8_t )numBits );
+}
+
 // <editor-fold defaultstate="collapsed" desc="void UNPACK_init( uint8_t *pSrc, pack_t *pUnpackCfg )">
 /*******************************************************************************************************************
  *
@@ -668,7 +940,7 @@ void UNPACK_inc( uint16_t cnt, pack_t *pUnpackCfg )
  *
  The result is ALWAYS stored in little endian!  A neg count means that
  ******************************************************************************************************************/
-void UNPACK_Buffer( int8_t bitCount, uint8_t *pResult, pack_t *pack )
+static void unpack_buffer_bitwise( int8_t bitCount, uint8_t *pResult, pack_t *pack )
 {
    uint8_t shiftMask = INITIAL_MASK;
    uint8_t isByteSwap = 0;
@@ -769,6 +1041,71 @@ void UNPACK_Buffer( int8_t bitCount, uint8_t *pResult, pack_t *pack )
       /*   Byte swap the result                   */
    }
 }
+/*******************************************************************************************************************
+ *
+ * Function name: UNPACK_Buffer
+ *
+ * Purpose: Reads the bit array.  Same interface and results as the bit at a time version above, but moves whole bytes
+ *          (memcpy when the source is on a byte boundary).
+ *
+ * Arguments: int8_t   bitCount - Number Of Bits to unpack (if neg, call byte swap after reading)
+ *                        Valid Range: 1-127, -1--127. 0 is invalid.
+ *         uint8_t *pResult  - Pointer to store the results
+ *         pack_t  *pack     - Pointer to the control structure
+ *
+ * Returns: NONE
+ *
+ ******************************************************************************************************************/
+void UNPACK_Buffer( int8_t bitCount, uint8_t *pResult, pack_t *pack )
+{
+   uint16_t srcBit;
+   uint8_t  bitCnt;
+   uint8_t  byteCnt;
+   uint8_t  i = 0;
+
+   if ( ( 0 == bitCount ) || ( INT8_MIN == bitCount ) )
+   {  /* Nothing to do or an invalid count - let the bit at a time version handle it */
+      unpack_buffer_bitwise( bitCount, pResult, pack );
+      return;
+   }
+
+   bitCnt = ( uint8_t )( ( bitCount < 0 ) ? -bitCount : bitCount );
+   srcBit = pack->bitNo;
+   if ( bitCnt <= CHAR_BIT )
+   {
+      pResult[0] = ( uint8_t )get_bits( pack->pArray, srcBit, bitCnt );
+   }
+   else
+   {  /* The result is right justified and big endian; any partial byte goes in the first result byte */
+      byteCnt = ( uint8_t )( ( bitCnt + MOD8 ) / CHAR_BIT );
+      if ( bitCnt & MOD8 )
+      {
+         pResult[i++] = ( uint8_t )get_bits( pack->pArray, srcBit, bitCnt & MOD8 );
+         srcBit += bitCnt & MOD8;
+      }
+      if ( 0 == ( srcBit & MOD8 ) )
+      {
+         (void)memcpy( &pResult[i], &pack->pArray[srcBit / CHAR_BIT], byteCnt - i );
+      }
+      else
+      {
+         for ( ; i < byteCnt; i++ )
+         {
+            pResult[i] = ( uint8_t )get_bits( pack->pArray, srcBit, CHAR_BIT );
+            srcBit += CHAR_BIT;
+         }
+      }
+#if (  PROCESSOR_LITTLE_ENDIAN )
+      if ( bitCount < 0 )                             /* Source is big endian, result is little endian */
+#else
+      if ( bitCount > 0 )
+#endif
+      {
+         Byte_Swap( pResult, byteCnt );
+      }
+   }
+   pack->bitNo += bitCnt;
+}
 /* ****************************************************************************************************************** */
 // </editor-fold>
 // <editor-fold defaultstate="collapsed" desc="void UNPACK_BufferArray( uint8_t *pArray, int8_t *pBitCount, uint8_t *pResult )">
@@ -861,12 +1198,9 @@ return
 **********************************************************************************************************************/
 void UNPACK_addr( uint8_t const *pSrc, uint16_t *pSrcOffset, uint8_t numBytes, uint8_t *address)
 {
-   uint32_t i;
    // Decode the 40 or 128 bit address
-   for(i = 0; i < numBytes; i++)
-   {
-      address[i] = UNPACK_bits2_uint8(pSrc, pSrcOffset, 8);
-   }
+   move_bits( pSrc, *pSrcOffset, address, 0, ( uint16_t )numBytes * CHAR_BIT );
+   *pSrcOffset += ( uint16_t )numBytes * CHAR_BIT;
 }
 
 // <editor-fold defaultstate="collapsed" desc="void PACK_init( uint8_t *pSrc, pack_t *pPackCfg )">
@@ -951,10 +1285,10 @@ void PACK_Byte( uint8_t value, pack_t *pack )
  * Returns: None
  *
  ******************************************************************************************************************/
-void PACK_Buffer(
-                  int16_t  numBits,  /* Number of bits to pack            */
-                  uint8_t *pSrc,     /* Pointer to the data to be packed  */
-                  pack_t  *pack )    /* Pointer to the control  structure */
+static void pack_buffer_bitwise(
+                          int16_t  numBits,  /* Number of bits to pack            */
+                          uint8_t *pSrc,     /* Pointer to the data to be packed  */
+                          pack_t  *pack )    /* Pointer to the control  structure */
 {
 
    uint8_t srcMask;                 /* Initialize the bit mask               */
@@ -1065,6 +1399,91 @@ void PACK_Buffer(
       Byte_Swap( pSrc, ( uint8_t )byteCnt );
    }
 }
+/*******************************************************************************************************************
+ *
+ * Function name: PACK_Buffer
+ *
+ * Purpose: Copies bits from the source to destination array.  Same interface and results as the bit at a time version
+ *          above, but moves whole bytes (memcpy when the destination is on a byte boundary).  The legacy cases where
+ *          numbits > 8 and numBits%8 > 0 are passed to the bit at a time version unchanged.
+ *
+ * Arguments: int16_t  numBits - Number Of Bits to Pack (if neg, call byte swap first! )
+ *         uint8_t *pSrc    - Pointer to the source data.
+ *         pack_t  *pack    - Pointer to the control  structure.  Must be initialized before call.
+ *
+ * Returns: None
+ *
+ ******************************************************************************************************************/
+void PACK_Buffer(
+                  int16_t  numBits,  /* Number of bits to pack            */
+                  uint8_t *pSrc,     /* Pointer to the data to be packed  */
+                  pack_t  *pack )    /* Pointer to the control  structure */
+{
+   uint8_t *pDst;                   /* Current byte in the packed array      */
+   uint16_t byteCnt;                /* Number of bytes                       */
+   uint16_t bitCnt;                 /* Number of bits (always positive)      */
+   uint16_t i;
+   uint8_t  isByteSwap = 0;         /* Was the data swapped?                 */
+   uint8_t  dstBit;                 /* Bit offset in the current packed byte */
+   uint8_t  bits;
+
+   bitCnt = ( uint16_t )( ( numBits < 0 ) ? -numBits : numBits );
+   if ( ( 0 == numBits ) || ( ( bitCnt > CHAR_BIT ) && ( bitCnt & MOD8 ) ) )
+   {  /* Nothing to do or one of the legacy partial byte cases - let the bit at a time version handle it */
+      pack_buffer_bitwise( numBits, pSrc, pack );
+      return;
+   }
+
+   pDst   = pack->pArray;
+   dstBit = ( uint8_t )( pack->bitNo & MOD8 );
+   if ( 0 == dstBit )                                  /* Are we on a byte boundry at the packed array? */
+   {
+      *pDst = 0U;                                     /*   Set the new location to 0              */
+   }
+
+   if ( bitCnt <= CHAR_BIT )
+   {  /* The LSBs of a single byte */
+      bits = ( uint8_t )( *pSrc & ( 0xFFU >> ( CHAR_BIT - bitCnt ) ) );
+      if ( ( dstBit + bitCnt ) <= CHAR_BIT )
+      {
+         *pDst |= ( uint8_t )( bits << ( CHAR_BIT - ( dstBit + bitCnt ) ) );
+      }
+      else
+      {  /* Straddles two bytes of the packed array */
+         *pDst  |= ( uint8_t )( bits >> ( ( dstBit + bitCnt ) - CHAR_BIT ) );
+         pDst[1] = ( uint8_t )( bits << ( ( 2 * CHAR_BIT ) - ( dstBit + bitCnt ) ) );
+      }
+   }
+   else
+   {  /* Whole bytes */
+      byteCnt = ( uint16_t )( bitCnt / CHAR_BIT );
+      if ( numBits < 0 )
+      {
+         isByteSwap = 1U;
+         Byte_Swap( pSrc, ( uint8_t )byteCnt );        /*   Byte swap the source byte order        */
+      }
+      if ( 0 == dstBit )
+      {
+         (void)memcpy( pDst, pSrc, byteCnt );
+      }
+      else
+      {  /* Each packed byte takes the tail of one source byte and the head of the next */
+         *pDst |= ( uint8_t )( pSrc[0] >> dstBit );
+         for ( i = 1; i < byteCnt; i++ )
+         {
+            pDst[i] = ( uint8_t )( ( uint8_t )( pSrc[i - 1] << ( CHAR_BIT - dstBit ) ) | ( pSrc[i] >> dstBit ) );
+         }
+         pDst[byteCnt] = ( uint8_t )( pSrc[byteCnt - 1] << ( CHAR_BIT - dstBit ) );
+      }
+      if ( isByteSwap )
+      {
+         Byte_Swap( pSrc, ( uint8_t )byteCnt );        /*   Swap the source back                   */
+      }
+   }
+
+   pack->pArray += ( dstBit + bitCnt ) / CHAR_BIT;     /* Point to the byte holding the next bit      */
+   pack->bitNo  += bitCnt;
+}
 /* ****************************************************************************************************************** */
    // </editor-fold>
 // <editor-fold defaultstate="collapsed" desc="returnStatus_t PACK_hton(uint8_t *pSrc, int8_t *pDecoder, bool bChangeEndian)">
@@ -1172,12 +1591,132 @@ return: dstOffset  The new destination offset.
 **********************************************************************************************************************/
 uint16_t PACK_addr(uint8_t const *pSrc, uint8_t numBytes, uint8_t *pDst, uint16_t dstOffset)
 {
-   uint32_t i;
+   move_bits( pSrc, 0, pDst, dstOffset, ( uint16_t )numBytes * CHAR_BIT );
+   return ( dstOffset + ( ( uint16_t )numBytes * CHAR_BIT ) );
+}
+
+/* ****************************************************************************************************************** */
+/* Unit Test */
+
+/***********************************************************************************************************************
+
+   Function Name: PACK_unitTest
+
+   Purpose: Checks the byte/word at a time pack/unpack routines against the original bit at a time routines using random
+            values, offsets and bit counts, then times building a load profile sized payload both ways.
+
+   Arguments: none
+
+   Returns: none
+
+   Side Effects: N/A
+
+   Reentrant Code: No
+
+ **********************************************************************************************************************/
+void PACK_unitTest(void)
+{
+#ifdef TM_PACK_UNIT_TEST
+   static uint8_t    fastBuf[64];
+   static uint8_t    refBuf[sizeof(fastBuf)];
+   uint8_t           srcBuf[16];
+   uint8_t           fastRes[16];
+   uint8_t           refRes[16];
+   pack_t            fastCfg;
+   pack_t            refCfg;
+   uint32_t          seed = 0x13579BDFUL;
+   uint32_t          errors = 0;
+   uint32_t          startMs;
+   uint32_t          fastMs;
+   uint32_t          refMs;
+   uint16_t          offset;
+   uint16_t          pass;
+   uint16_t          i;
+   int16_t           bits;
+   uint8_t           size;
+
+#define PACK_UT_RAND() ( seed = ( seed * 1103515245UL ) + 12345UL, ( uint8_t )( seed >> 16 ) )
+
+   for ( pass = 0; pass < 2000; pass++ )
+   {
+      for ( i = 0; i < sizeof(fastBuf); i++ )
+      {
+         fastBuf[i] = refBuf[i] = PACK_UT_RAND();
+      }
+      for ( i = 0; i < sizeof(srcBuf); i++ )
+      {
+         srcBuf[i] = PACK_UT_RAND();
+         fastRes[i] = refRes[i] = PACK_UT_RAND();
+      }
+      offset = PACK_UT_RAND() % 200;
+      size   = ( uint8_t )( 1 << ( PACK_UT_RAND() % 4 ) );
+      bits   = ( int16_t )( ( PACK_UT_RAND() % ( size * CHAR_BIT ) ) + 1 );
+
+      /* pack_bits/unpack_bits (PACK_uintX_2bits/UNPACK_bits2_uintX) */
+      (void)pack_bits( srcBuf, size, fastBuf, offset, ( uint8_t )bits );
+      (void)pack_bits_bitwise( srcBuf, size, refBuf, offset, ( uint8_t )bits );
+      (void)unpack_bits( fastBuf, offset, fastRes, size, ( uint8_t )bits );
+      (void)unpack_bits_bitwise( refBuf, offset, refRes, size, ( uint8_t )bits );
+      errors += ( 0 != memcmp( fastBuf, refBuf, sizeof(fastBuf) ) ) || ( 0 != memcmp( fastRes, refRes, sizeof(fastRes) ) );
+
+      /* copy_bits (UNPACK_bits2_ucArray) */
+      bits = ( int16_t )( ( PACK_UT_RAND() % 120 ) + 1 );
+      (void)copy_bits( fastBuf, offset, fastRes, 0, ( uint16_t )bits );
+      (void)copy_bits_bitwise( refBuf, offset, refRes, 0, ( uint16_t )bits );
+      errors += ( 0 != memcmp( fastRes, refRes, sizeof(fastRes) ) );
+
+      /* PACK_Buffer/UNPACK_Buffer - byte counts, both signs */
+      bits = ( int16_t )( ( PACK_UT_RAND() % 2 ) ? ( ( PACK_UT_RAND() % CHAR_BIT ) + 1 ) : ( ( ( PACK_UT_RAND() % 15 ) + 1 ) * CHAR_BIT ) );
+      if ( PACK_UT_RAND() % 2 )
+      {
+         bits = -bits;
+      }
+      fastCfg.pArray = &fastBuf[DIV_8( offset )];
+      fastCfg.bitNo  = offset;
+      refCfg.pArray  = &refBuf[DIV_8( offset )];
+      refCfg.bitNo   = offset;
+      PACK_Buffer( bits, srcBuf, &fastCfg );
+      pack_buffer_bitwise( bits, srcBuf, &refCfg );
+      errors += ( 0 != memcmp( fastBuf, refBuf, sizeof(fastBuf) ) ) || ( fastCfg.bitNo != refCfg.bitNo ) ||
+                ( ( fastCfg.pArray - fastBuf ) != ( refCfg.pArray - refBuf ) );
+
+      fastCfg.pArray = fastBuf;
+      fastCfg.bitNo  = offset;
+      refCfg.pArray  = refBuf;
+      refCfg.bitNo   = offset;
+      UNPACK_Buffer( ( int8_t )bits, fastRes, &fastCfg );
+      unpack_buffer_bitwise( ( int8_t )bits, refRes, &refCfg );
+      errors += ( 0 != memcmp( fastRes, refRes, sizeof(fastRes) ) ) || ( fastCfg.bitNo != refCfg.bitNo );
+   }
+   DBG_logPrintf( 'U', "PACK equivalence: %u passes, %u errors", pass, errors );
 
-   for(i = 0; i < numBytes; i++)
+   /* Timing - 48 intervals of a 32 bit value and an 8 bit quality code at odd offsets, similar to an LP bubble-up */
+   startMs = OS_TICK_Get_ElapsedMilliseconds();
+   for ( pass = 0; pass < 500; pass++ )
    {
-      dstOffset = PACK_uint8_2bits(&pSrc[i], 8, pDst, dstOffset);
+      PACK_init( fastBuf, &fastCfg );
+      PACK_Buffer( 3, srcBuf, &fastCfg );
+      for ( i = 0; i < ( sizeof(fastBuf) - 1 ) / 5; i++ )
+      {
+         PACK_Buffer( -32, srcBuf, &fastCfg );
+         PACK_Buffer( 8, &srcBuf[4], &fastCfg );
+      }
    }
-   return ( dstOffset );
+   fastMs = OS_TICK_Get_ElapsedMilliseconds() - startMs;
+   startMs = OS_TICK_Get_ElapsedMilliseconds();
+   for ( pass = 0; pass < 500; pass++ )
+   {
+      PACK_init( refBuf, &refCfg );
+      pack_buffer_bitwise( 3, srcBuf, &refCfg );
+      for ( i = 0; i < ( sizeof(refBuf) - 1 ) / 5; i++ )
+      {
+         pack_buffer_bitwise( -32, srcBuf, &refCfg );
+         pack_buffer_bitwise( 8, &srcBuf[4], &refCfg );
+      }
+   }
+   refMs = OS_TICK_Get_ElapsedMilliseconds() - startMs;
+   DBG_logPrintf( 'U', "PACK_Buffer timing: fast %lums, bitwise %lums, %s", fastMs, refMs,
+                  ( 0 == memcmp( fastBuf, refBuf, sizeof(fastBuf) ) ) ? "match" : "MISMATCH" );
+#undef PACK_UT_RAND
+#endif
 }
-
@@ -88,6 +88,7 @@ void UNPACK_Buffer(int8_t bitCount,   uint8_t *pResult, pack_t *pPack);
 void UNPACK_BufferArray( uint8_t *pArray, int8_t const *pBitCount, uint8_t *pResult, pack_t *pUnpackCfg );
 void UNPACK_BufferArrayNoInit(int8_t const *,            uint8_t *,        pack_t *pPack);
 void UNPACK_addr(uint8_t const *pSrc, uint16_t *pSrcOffset, uint8_t numBytes, uint8_t *address);
+void PACK_unitTest(void);
 
 #ifdef ERROR_CODES_H_
 returnStatus_t PACK_hton(uint8_t *pSrc, int8_t const *pDecoder, bool bChangeEndian);
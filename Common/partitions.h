@@ -64,6 +64,7 @@ typedef struct
    uint8_t CurrentBankSequence;  /* Used as a counter that is placed in the meta data when writing to a new bank.
                                     Zero indicates an erased state. */
    bool  cacheRestored;          /* RAM cache restored/valid */
+   uint32_t cacheDirty;          /* RAM cache chunks changed since the last flush, see dvr_cache.c */
 }PartitionMetaData_t;
 
 typedef struct
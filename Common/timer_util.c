@@ -30,6 +30,17 @@
  * Note:  The following #defines needs to be defined in the configuration file (cfg_app.h)
  *        MAX_TIMERS //Maximum number of timers supported
  *
+ * Implementation:
+ *    Active timers are kept in a hierarchical timing wheel (TMR_WHEEL_LEVELS levels of TMR_WHEEL_SLOTS slots). A
+ *    timer is hashed on its absolute expiration tick into the lowest level that can hold it, and moved (cascaded) one
+ *    level down each time the level below wraps. Add/stop/reset are O(1) (doubly linked slot lists), and each tick
+ *    only touches one level-0 slot. A bit mask of non-empty slots per level lets the task skip empty stretches and
+ *    find the next expiration.
+ *
+ *    With TMR_SLEEP_UNTIL_EXPIRY set, the tick hook only counts ticks and signals the task when the next expiration
+ *    tick is reached, instead of waking the task on every tick. The task then catches the wheel and _TMR_Tick_Cntr up
+ *    to the tick count.
+ *
  ***********************************************************************************************************************
  * A product of
  * Aclara Technologies LLC
@@ -44,6 +55,7 @@
  ***********************************************************************************************************************
  * Revision History:
  * 100710  MS    - Initial Release
+ *         - Replaced the delta list with a hierarchical timing wheel, added the sleep until expiry mode
  *
  **********************************************************************************************************************/
 
@@ -52,6 +64,7 @@
 
 #include "project.h"
 #include <string.h>
+#include <assert.h>  /* static_assert */
 #if ( RTOS_SELECTION == MQX_RTOS )
 #include <mqx.h>
 #endif
@@ -66,6 +79,15 @@
 /* ****************************************************************************************************************** */
 /* MACRO DEFINITIONS */
 
+#define TMR_WHEEL_BITS        5                                      /* log2 of the number of slots per level */
+#define TMR_WHEEL_SLOTS       ( (uint32_t)1 << TMR_WHEEL_BITS )      /* One bit per slot in _TMR_wheelSlotMask */
+#define TMR_WHEEL_SLOT_MASK   ( TMR_WHEEL_SLOTS - 1 )
+#define TMR_WHEEL_LEVELS      6                                      /* 6 levels x 5 bits = 2^30 ticks */
+/* Slot of a tick count at a given level */
+#define TMR_WHEEL_INDEX( ticks, level )   ( ( (ticks) >> ( TMR_WHEEL_BITS * (level) ) ) & TMR_WHEEL_SLOT_MASK )
+/* Number of ticks covered by all levels below the given level */
+#define TMR_WHEEL_RANGE( level )          ( (uint32_t)1 << ( TMR_WHEEL_BITS * (level) ) )
+#define TMR_LOWEST_BIT( mask )            ( (uint32_t)__CLZ( __RBIT( mask ) ) )  /* Index of the lowest bit set */
 
 /* ****************************************************************************************************************** */
 /* TYPE DEFINITIONS */
@@ -76,20 +98,42 @@ typedef struct my_isr_struct
    void           (_CODE_PTR_ OLD_ISR)(void *);
 } MY_ISR_STRUCT, *MY_ISR_STRUCT_PTR;
 #endif
+#ifdef TM_TIMER_UNIT_TEST
+typedef struct
+{
+   uint16_t id;                     /* Timer under test */
+   uint16_t calls;                  /* Times the call back ran */
+} tmrSelfTest_t;                    /* Call back data of the timers that reset or stop themselves */
+#endif
 
 /* ****************************************************************************************************************** */
 /* FILE VARIABLE DEFINITIONS */
 
 STATIC uint64_t      _TMR_Tick_Cntr;               /* RTOS Tick counter */
 STATIC timer_t       _sTimer[MAX_TIMERS];          /* Manage timer requests */
-STATIC timer_t       *_TMR_headNode;               /* Link-list head */
+STATIC timer_t       *_TMR_wheel[TMR_WHEEL_LEVELS][TMR_WHEEL_SLOTS]; /* Active timers, by level and slot */
+STATIC uint32_t      _TMR_wheelSlotMask[TMR_WHEEL_LEVELS];         /* Bit n set when slot n of the level is not empty */
+STATIC uint32_t      _TMR_wheelTime;               /* Next tick to be processed by the wheel */
+STATIC timer_t       *_TMR_expiring;               /* Timers of the tick being processed, not yet handled */
+#if ( TMR_SLEEP_UNTIL_EXPIRY == 1 )
+STATIC volatile uint32_t _TMR_isrTicks;            /* Ticks counted by the tick hook */
+STATIC uint32_t      _TMR_lastTick;                /* Tick count when _TMR_Tick_Cntr was last brought up to date */
+STATIC volatile uint32_t _TMR_wakeTick;            /* Tick at which the tick hook signals the task */
+STATIC volatile bool _TMR_wakeArmed;               /* _TMR_wakeTick is valid */
+#endif
 static OS_MUTEX_Obj  _tmrUtilMutex;                /* Serialize access to timer data-structure */
+static bool          _TMR_inCallBack;              /* A timer call back is running, with _tmrUtilMutex held */
+static OS_TASK_id    _TMR_callBackTask;            /* Task running the call back (the timer task) */
 static OS_SEM_Obj    _tmrUtilSem;                  /* Semaphore used by timer module to count the number of ticks */
 static bool          _tmrUtilSemCreated = (bool)false;
 #if ( RTOS_SELECTION == FREE_RTOS )
 static bool          tmrTaskCreated_ = (bool)false;
 #endif
 
+#ifndef _lint
+static_assert( ( 0xFFFFFFFFUL / portTICK_RATE_MS ) < TMR_WHEEL_RANGE( TMR_WHEEL_LEVELS ), "Longest timer must fit in the wheel" );
+#endif
+
 #ifdef TM_TIMER_DEBUG
 nInt MaxTimersUsed = 0;
 nInt TimersUsed = 0;
@@ -108,6 +152,20 @@ STATIC          uint32_t TMR_maximumJumpsOfPostFailures[2][MAX_JUMPS_OF_POST_ERR
 STATIC void insertTimerNode( timer_t *pTimer );   /* Inserts the timer in the active list */
 STATIC returnStatus_t deleteTimerNode( uint16_t usiTimerId );  /* Deletes the timer from the active timer list */
 STATIC returnStatus_t isTimerActive( uint16_t usiTimerId );    /* Checks if the timer is active */
+static uint32_t currentTick( void );
+static void wheelLink( timer_t **ppHead, timer_t *pTimer );
+static void wheelUnlink( timer_t *pTimer );
+static void wheelAdd( timer_t *pTimer );
+static void wheelCascade( uint8_t level );
+static void wheelAdvance( uint32_t now );
+static void expireTimer( timer_t *pTimer );
+#ifdef TM_TIMER_UNIT_TEST
+static void tmrSelfTestCallBack( uint8_t ucCmd, void *pData );
+#endif
+#if ( TMR_SLEEP_UNTIL_EXPIRY == 1 )
+static bool wheelNextExpiry( uint32_t *pTick );
+static void armWakeTick( uint32_t tick );
+#endif
 #if ( RTOS_SELECTION == MQX_RTOS )
 STATIC void TMR_vApplicationTickHook( void *user_isr_ptr );
 #endif
@@ -118,63 +176,466 @@ STATIC void TMR_vApplicationTickHook( void *user_isr_ptr );
 
 /***********************************************************************************************************************
  *
- * Function name: insertTimerNode
+ * Function name: currentTick
  *
- * Purpose: This function insert timer node in the active list. The timer tick count (ulTimer_ticks) must be set
- *          before calling this function.
+ * Purpose: Return the tick count that timer durations are measured from.
  *
- * Arguments: timer_t *pData: Pointer to the Timer node
+ * Arguments: None
+ *
+ * Returns: uint32_t - The last tick processed by the wheel, or the tick hook count in sleep until expiry mode (the
+ *                     wheel may lag behind the hook count in that mode).
+ *
+ * Side effects: None
+ *
+ * Reentrant: NO. This function should be called after taking the _TMR_Mutex.
+ *
+ **********************************************************************************************************************/
+static uint32_t currentTick( void )
+{
+#if ( TMR_SLEEP_UNTIL_EXPIRY == 1 )
+   return _TMR_isrTicks;
+#else
+   return ( _TMR_wheelTime - 1 );
+#endif
+}
+
+/***********************************************************************************************************************
+ *
+ * Function name: tmrLock
+ *
+ * Purpose: Take the timer mutex, unless the caller is a timer call back, which already runs with it held.
+ *
+ * Arguments: None
+ *
+ * Returns: bool - true if the mutex was taken and must be given back with tmrUnlock
+ *
+ * Side effects: None
+ *
+ * Reentrant: Yes
+ *
+ * Notes: The mutex is not recursive. Only the task running the call back skips it, any other task waits as usual.
+ *
+ **********************************************************************************************************************/
+static bool tmrLock( void )
+{
+   if ( _TMR_inCallBack && ( _TMR_callBackTask == OS_TASK_GetId() ) )
+   {
+      return (bool)false;
+   }
+   OS_MUTEX_Lock(&_tmrUtilMutex); // Function will not return if it fails
+   return (bool)true;
+}
+
+/***********************************************************************************************************************
+ *
+ * Function name: tmrUnlock
+ *
+ * Purpose: Give back the timer mutex taken by tmrLock.
+ *
+ * Arguments: bool bLocked - Value returned by tmrLock
  *
  * Returns: None
  *
- * Side effects: Updates the active timer link list
+ * Side effects: None
+ *
+ * Reentrant: Yes
+ *
+ **********************************************************************************************************************/
+static void tmrUnlock( bool bLocked )
+{
+   if ( bLocked )
+   {
+      OS_MUTEX_Unlock(&_tmrUtilMutex); // Function will not return if it fails
+   }
+}
+
+/***********************************************************************************************************************
+ *
+ * Function name: wheelLink
+ *
+ * Purpose: Put a timer at the head of a wheel slot list
+ *
+ * Arguments: timer_t **ppHead: Slot list head
+ *            timer_t *pTimer: Timer to add
+ *
+ * Returns: None
+ *
+ * Side effects: None
  *
  * Reentrant: NO. This function should be called after taking the _TMR_Mutex.
  *
  **********************************************************************************************************************/
-STATIC void insertTimerNode( timer_t *pTimer )
+static void wheelLink( timer_t **ppHead, timer_t *pTimer )
+{
+   pTimer->next = *ppHead;
+   if ( NULL != pTimer->next )
+   {
+      pTimer->next->pprev = &pTimer->next;
+   }
+   pTimer->pprev = ppHead;
+   *ppHead = pTimer;
+}
+
+/***********************************************************************************************************************
+ *
+ * Function name: wheelUnlink
+ *
+ * Purpose: Remove a timer from the wheel slot list (or expiring list) it is on
+ *
+ * Arguments: timer_t *pTimer: Timer to remove. Must be active (pprev != NULL).
+ *
+ * Returns: None
+ *
+ * Side effects: Clears the slot bit when a wheel slot becomes empty
+ *
+ * Reentrant: NO. This function should be called after taking the _TMR_Mutex.
+ *
+ **********************************************************************************************************************/
+static void wheelUnlink( timer_t *pTimer )
 {
-   pTimer->next = NULL;  /* Initialize to null */
+   timer_t **ppHead = pTimer->pprev;
 
-   if ( NULL == _TMR_headNode )
-   {  /* List is empty, set as head node */
-      _TMR_headNode = pTimer;
+   *ppHead = pTimer->next;
+   if ( NULL != pTimer->next )
+   {
+      pTimer->next->pprev = ppHead;
    }
-   else
-   {  /* Insert the node, start at the head node */
-      timer_t *currentNode = _TMR_headNode; /* Points to the current node being processed in the active timer list */
-      timer_t *previousNode = NULL;         /* Points to the previous node processed in the active timer list */
+   pTimer->next  = NULL;
+   pTimer->pprev = NULL;
 
-      while ( currentNode != NULL )
+   if ( ( NULL == *ppHead ) && ( ppHead >= &_TMR_wheel[0][0] ) &&
+        ( ppHead < &_TMR_wheel[TMR_WHEEL_LEVELS - 1][TMR_WHEEL_SLOTS - 1] + 1 ) )
+   {  /* A wheel slot is empty now. Slots are contiguous so the head address gives level and slot. */
+      uint32_t index = (uint32_t)( ppHead - &_TMR_wheel[0][0] );
+      _TMR_wheelSlotMask[index / TMR_WHEEL_SLOTS] &= ~( (uint32_t)1 << ( index % TMR_WHEEL_SLOTS ) );
+   }
+}
+
+/***********************************************************************************************************************
+ *
+ * Function name: wheelAdd
+ *
+ * Purpose: Hash a timer into the wheel on its absolute expiration tick (ulTimer_ticks).
+ *
+ * Arguments: timer_t *pTimer: Pointer to the Timer node
+ *
+ * Returns: None
+ *
+ * Side effects: None
+ *
+ * Reentrant: NO. This function should be called after taking the _TMR_Mutex.
+ *
+ * Notes: A timer is placed in the lowest level whose range covers the time left, at the slot of its expiration tick.
+ *        A timer that is already due goes in the slot processed next.
+ *
+ **********************************************************************************************************************/
+static void wheelAdd( timer_t *pTimer )
+{
+   uint32_t expires = pTimer->ulTimer_ticks;
+   uint32_t delta   = expires - _TMR_wheelTime;
+   uint32_t slot;
+   uint8_t  level;
+
+   if ( (int32_t)delta < 0 )
+   {  /* Already due */
+      expires = _TMR_wheelTime;
+      pTimer->ulTimer_ticks = expires;
+      delta = 0;
+   }
+   for ( level = 0; ( level < ( TMR_WHEEL_LEVELS - 1 ) ) && ( delta >= TMR_WHEEL_RANGE( level + 1 ) ); level++ )
+   {
+   }
+   slot = TMR_WHEEL_INDEX( expires, level );
+   wheelLink( &_TMR_wheel[level][slot], pTimer );
+   _TMR_wheelSlotMask[level] |= ( (uint32_t)1 << slot );
+}
+
+/***********************************************************************************************************************
+ *
+ * Function name: wheelCascade
+ *
+ * Purpose: Move the timers of the current slot of a level down to the lower levels. When that slot is slot 0, the
+ *          next level up is cascaded as well.
+ *
+ * Arguments: uint8_t level: Level to cascade (1 and up)
+ *
+ * Returns: None
+ *
+ * Side effects: None
+ *
+ * Reentrant: NO. This function should be called after taking the _TMR_Mutex.
+ *
+ **********************************************************************************************************************/
+static void wheelCascade( uint8_t level )
+{
+   uint32_t slot;
+   timer_t  *pTimer;
+
+   for ( ; level < TMR_WHEEL_LEVELS; level++ )
+   {
+      slot   = TMR_WHEEL_INDEX( _TMR_wheelTime, level );
+      pTimer = _TMR_wheel[level][slot];
+      _TMR_wheel[level][slot] = NULL;
+      _TMR_wheelSlotMask[level] &= ~( (uint32_t)1 << slot );
+      while ( NULL != pTimer )
       {
-         if ( pTimer->ulTimer_ticks < currentNode->ulTimer_ticks )
-         {  /* Insert the node before the current node */
-            if ( NULL == previousNode )
-            {  /* New node will be the head node */
-               _TMR_headNode = pTimer;
-            }
-            else
-            {  /* Insert between the previous node and the current node */
-               previousNode->next = pTimer;
-            }
-            pTimer->next = currentNode;
-            /* adjust the timer value of the current node */
-            currentNode->ulTimer_ticks -= pTimer->ulTimer_ticks;
-            break;
+         timer_t *pNext = pTimer->next;
+         wheelAdd( pTimer );
+         pTimer = pNext;
+      }
+      if ( 0 != slot )
+      {
+         break;
+      }
+   }
+}
+
+/***********************************************************************************************************************
+ *
+ * Function name: expireTimer
+ *
+ * Purpose: Signal an expired timer and rearm it, if periodic.
+ *
+ * Arguments: timer_t *pTimer: Timer that expired (already removed from the wheel)
+ *
+ * Returns: None
+ *
+ * Side effects: None
+ *
+ * Reentrant: NO. This function should be called after taking the _TMR_Mutex.
+ *
+ * Notes: The call back runs with the mutex held. It may stop, reset or delete its own timer (see tmrLock); those
+ *        clear bExpiring, so the timer is then left the way the call back set it. The semaphore handle and the slot
+ *        generation are read before the call back, so a slot deleted and reused by the call back is not touched.
+ *
+ **********************************************************************************************************************/
+static void expireTimer( timer_t *pTimer )
+{
+   OS_SEM_Handle pSemHandle = pTimer->pSemHandle;            /* Semaphore of the timer that expired */
+   uint8_t       ucGeneration = (uint8_t)pTimer->ucGeneration;  /* Slot generation before the call back */
+
+   pTimer->bExpiring = true;
+   if ( pTimer->pFunctCallBack != NULL )   // Is this a call back?
+   {
+      _TMR_callBackTask = OS_TASK_GetId();
+      _TMR_inCallBack = (bool)true;
+      pTimer->pFunctCallBack((uint8_t)pTimer->ucCmd, pTimer->pData);
+      _TMR_inCallBack = (bool)false;
+   }
+   if ( pSemHandle != NULL )   // give semaphore, if not NULL
+   {
+      OS_SEM_Post(pSemHandle);
+   }
+   if ( pTimer->bExpiring && ( ucGeneration == (uint8_t)pTimer->ucGeneration ) )
+   {  /* The call back left the timer alone */
+      pTimer->bExpiring = false;
+
+      /* Set the timer countdown */
+      pTimer->ulTimer_ticks = pTimer->ulDuration_ticks;
+
+      /* insert the node back on the active list, if it not a one shot timer */
+      if ( pTimer->bOneShot )
+      {  /* One shot timer, stop the timer, set the expired flag */
+         pTimer->bStopped = true;
+         pTimer->bExpired = true;
+         if ( pTimer->bOneShotDelete )
+         {  /* Delete one shot timer */
+            /* Clearing ulDuration_mS indicates timer is free */
+            //DBG_logPrintf ('I', "Self Delete Timer ID=%u", pTimer->usiTimerId);
+            pTimer->ulDuration_mS = 0;
+#ifdef TM_TIMER_DEBUG
+            TimersUsed--;
+#endif
          }
-         else
-         {  /* Move to the next node */
-            pTimer->ulTimer_ticks -= currentNode->ulTimer_ticks; /* Reduce the new node's tick count */
-            previousNode = currentNode;
-            currentNode = currentNode->next;
-            if ( NULL == currentNode )
-            {  /* insert at the end of the link list */
-               previousNode->next = pTimer;
-               break;
-            }
+         // else, Do not delete this one-shot timer. This timer does not need to be rearmed
+      }
+      else
+      {
+         /* Rearm, Add the timer to the active list. The period runs from the tick that expired. */
+         pTimer->ulTimer_ticks += ( _TMR_wheelTime - 1 );
+         wheelAdd(pTimer);
+      }
+   }
+   // else, the call back stopped, reset or deleted this timer, it already has its new state
+}
+
+/***********************************************************************************************************************
+ *
+ * Function name: wheelAdvance
+ *
+ * Purpose: Process every tick up to and including the given tick, expiring the timers that are due.
+ *
+ * Arguments: uint32_t now: Last tick to process
+ *
+ * Returns: None
+ *
+ * Side effects: Calls back, posts semaphores of the expired timers
+ *
+ * Reentrant: NO. This function should be called after taking the _TMR_Mutex.
+ *
+ * Notes: Runs of empty level 0 slots are skipped up to the next cascade point, so catching up after a long sleep does
+ *        not cost one iteration per tick.
+ *
+ **********************************************************************************************************************/
+static void wheelAdvance( uint32_t now )
+{
+   uint32_t index;
+   uint32_t pending;
+   uint32_t step;
+   timer_t  *pTimer;
+
+   while ( (int32_t)( now - _TMR_wheelTime ) >= 0 )
+   {
+      index = _TMR_wheelTime & TMR_WHEEL_SLOT_MASK;
+      if ( 0 == index )
+      {  /* Level 0 wrapped, bring the next timers down */
+         wheelCascade( 1 );
+      }
+      pending = _TMR_wheelSlotMask[0] >> index;
+      step = ( 0 == pending ) ? ( TMR_WHEEL_SLOTS - index ) : TMR_LOWEST_BIT( pending );
+      if ( step != 0 )
+      {  /* Nothing due before the next non-empty slot or cascade point */
+         if ( step > ( ( now - _TMR_wheelTime ) + 1 ) )
+         {
+            step = ( now - _TMR_wheelTime ) + 1;
+         }
+         _TMR_wheelTime += step;
+         continue;
+      }
+
+      /* Move the slot to the expiring list, so timers stopped by a call back are unlinked properly */
+      _TMR_expiring = _TMR_wheel[0][index];
+      _TMR_wheel[0][index] = NULL;
+      _TMR_wheelSlotMask[0] &= ~( (uint32_t)1 << index );
+      _TMR_expiring->pprev = &_TMR_expiring;
+      _TMR_wheelTime++;
+
+      while ( NULL != _TMR_expiring )
+      {  /* Time has elapsed, execute the timers */
+         pTimer = _TMR_expiring;
+         wheelUnlink( pTimer );
+         expireTimer( pTimer );
+      }
+   }
+}
+
+#if ( TMR_SLEEP_UNTIL_EXPIRY == 1 )
+/***********************************************************************************************************************
+ *
+ * Function name: wheelNextExpiry
+ *
+ * Purpose: Find the tick at which the next active timer expires
+ *
+ * Arguments: uint32_t *pTick: Returns the expiration tick
+ *
+ * Returns: bool - false if no timer is active
+ *
+ * Side effects: None
+ *
+ * Reentrant: NO. This function should be called after taking the _TMR_Mutex.
+ *
+ * Notes: The first non-empty slot of each level (in the order the wheel will reach them) holds the earliest timers of
+ *        that level; only those slot lists are scanned.
+ *
+ **********************************************************************************************************************/
+static bool wheelNextExpiry( uint32_t *pTick )
+{
+   bool     found = (bool)false;
+   uint32_t best = 0;
+   uint32_t start;
+   uint32_t mask;
+   uint8_t  level;
+   timer_t  *pTimer;
+
+   for ( level = 0; level < TMR_WHEEL_LEVELS; level++ )
+   {
+      mask = _TMR_wheelSlotMask[level];
+      if ( 0 == mask )
+      {
+         continue;
+      }
+      /* Slots from the current one (or the one after it, if the current one was already cascaded) in wheel order */
+      start = TMR_WHEEL_INDEX( _TMR_wheelTime, level );
+      if ( ( 0 != level ) && ( 0 != ( _TMR_wheelTime & ( TMR_WHEEL_RANGE( level ) - 1 ) ) ) )
+      {
+         start = ( start + 1 ) & TMR_WHEEL_SLOT_MASK;
+      }
+      if ( 0 != start )
+      {
+         mask = ( mask >> start ) | ( mask << ( TMR_WHEEL_SLOTS - start ) );
+      }
+      for ( pTimer = _TMR_wheel[level][( start + TMR_LOWEST_BIT( mask ) ) & TMR_WHEEL_SLOT_MASK];
+            NULL != pTimer; pTimer = pTimer->next )
+      {
+         if ( !found || ( (int32_t)( pTimer->ulTimer_ticks - best ) < 0 ) )
+         {
+            best  = pTimer->ulTimer_ticks;
+            found = (bool)true;
          }
-      } /* end while */
-   } /* end else */
+      }
+   }
+   *pTick = best;
+   return found;
+}
+
+/***********************************************************************************************************************
+ *
+ * Function name: armWakeTick
+ *
+ * Purpose: Make the tick hook signal the task at the given tick, if that is earlier than the tick already armed.
+ *
+ * Arguments: uint32_t tick: Tick at which a timer expires
+ *
+ * Returns: None
+ *
+ * Side effects: Posts the task semaphore if the tick has already been reached
+ *
+ * Reentrant: NO. This function should be called after taking the _TMR_Mutex.
+ *
+ **********************************************************************************************************************/
+static void armWakeTick( uint32_t tick )
+{
+   if ( !_TMR_wakeArmed || ( (int32_t)( tick - _TMR_wakeTick ) < 0 ) )
+   {  /* The tick hook reads the pair, update it as a whole */
+      OS_INT_disable();
+      _TMR_wakeTick  = tick;
+      _TMR_wakeArmed = (bool)true;
+      OS_INT_enable();
+      if ( (int32_t)( _TMR_isrTicks - tick ) >= 0 )
+      {  /* The hook may have gone past the tick before it saw it */
+         OS_SEM_Post( &_tmrUtilSem );
+      }
+   }
+}
+#endif
+
+/***********************************************************************************************************************
+ *
+ * Function name: insertTimerNode
+ *
+ * Purpose: This function insert timer node in the active list. The timer tick count (ulTimer_ticks) must be set
+ *          before calling this function.
+ *
+ * Arguments: timer_t *pData: Pointer to the Timer node
+ *
+ * Returns: None
+ *
+ * Side effects: Updates the active timer wheel. ulTimer_ticks becomes the absolute expiration tick while active.
+ *
+ * Reentrant: NO. This function should be called after taking the _TMR_Mutex.
+ *
+ **********************************************************************************************************************/
+STATIC void insertTimerNode( timer_t *pTimer )
+{
+   if ( 0 == pTimer->ulTimer_ticks )
+   {  /* Stopped on the tick it was due, let it expire on the next one */
+      pTimer->ulTimer_ticks = 1;
+   }
+   pTimer->ulTimer_ticks += currentTick();
+   wheelAdd( pTimer );
+#if ( TMR_SLEEP_UNTIL_EXPIRY == 1 )
+   armWakeTick( pTimer->ulTimer_ticks );
+#endif
 }
 
 /***********************************************************************************************************************
@@ -188,52 +649,24 @@ STATIC void insertTimerNode( timer_t *pTimer )
  * Returns: returnStatus_t eRetVal - eSUCCESS - node deleted eSUCCESSfully
  *                                  eFAILURE - Node not found i.e. timer not valid or not active
  *
- * Side effects: Removes a timer node from the timer link list
+ * Side effects: Removes a timer node from the timer wheel. ulTimer_ticks is set to the number of ticks left.
  *
  * Reentrant: NO. This function should be called after taking the _TMR_Mutex.
  *
  **********************************************************************************************************************/
 STATIC returnStatus_t deleteTimerNode( uint16_t usiTimerId )
 {
-   uint32_t ulRemTickCnt = 0;             /* compute the remaining ticks to expiration */
-   timer_t *previousNode = NULL;          /* Points to the previous node processed in the active timer list */
-   timer_t *currentNode = _TMR_headNode;  /* Points to the current node being processed in the active timer list */
+   timer_t *pTimer = &_sTimer[usiTimerId - 1];
    returnStatus_t eRetVal = eFAILURE;     /* Return value, default timer not valid or not active */
+   uint32_t remaining;
 
-   /* Check the link list and remove the timer from the link list, if active */
-   while ( currentNode != NULL )
-   {
-      ulRemTickCnt += currentNode->ulTimer_ticks;
-
-      if ( currentNode->usiTimerId == usiTimerId )
-      {  /* Remove the timer from the active timers */
-         if ( NULL == previousNode )
-         {  /* Remove the head node */
-            _TMR_headNode = _TMR_headNode->next;
-            if ( _TMR_headNode != NULL )
-            {  /* more active timers, adjust the timer value of the next timer */
-               _TMR_headNode->ulTimer_ticks += currentNode->ulTimer_ticks;
-            }
-         }
-         else if ( NULL == currentNode->next )
-         {  /* Remove the tail node */
-            previousNode->next = NULL;
-         }
-         else
-         {
-            timer_t *nextNode = currentNode->next;  /* Remember the next node to the current node */
-            /* remove the node from the middle */
-            previousNode->next = nextNode;
-            /* update the timer value */
-            nextNode->ulTimer_ticks += currentNode->ulTimer_ticks;
-         }
-         /* Restore the number of ticks to expiration, used if this is called from stop timer function */
-         currentNode->ulTimer_ticks = ulRemTickCnt;
-         eRetVal = eSUCCESS;
-         break;
-      }
-      previousNode = currentNode;
-      currentNode = currentNode->next;
+   if ( NULL != pTimer->pprev )
+   {  /* Remove the timer from the active timers */
+      wheelUnlink( pTimer );
+      /* Restore the number of ticks to expiration, used if this is called from stop timer function */
+      remaining = pTimer->ulTimer_ticks - currentTick();
+      pTimer->ulTimer_ticks = ( (int32_t)remaining < 0 ) ? 0 : remaining;
+      eRetVal = eSUCCESS;
    }
    return (eRetVal);
 }
@@ -271,8 +704,19 @@ returnStatus_t TMR_HandlerInit( void )
       {
          _tmrUtilSemCreated = true;
          (void)memset(_sTimer, 0, sizeof(_sTimer)); //Initialize Timer data-structure
-         _TMR_headNode = NULL; //Set the head node of the active timer list to NULL
+         (void)memset(_TMR_wheel, 0, sizeof(_TMR_wheel)); //No active timers
+         (void)memset(_TMR_wheelSlotMask, 0, sizeof(_TMR_wheelSlotMask));
+         _TMR_expiring = NULL;
+         _TMR_wheelTime = 1;  //Tick 1 is the first one processed
          _TMR_Tick_Cntr = 0;
+#if ( TMR_SLEEP_UNTIL_EXPIRY == 1 )
+         _TMR_isrTicks = 0;
+         _TMR_lastTick = currentTick();
+         _TMR_wheelTime = _TMR_lastTick + 1;
+         OS_INT_disable();
+         _TMR_wakeArmed = (bool)false;
+         OS_INT_enable();
+#endif
          retVal = eSUCCESS;
       }
    }
@@ -285,6 +729,7 @@ returnStatus_t TMR_HandlerInit( void )
  *
  * Purpose: This function pends on _TMR_cntSem semaphore. Calls the callback function and/or
  *          gives the requested semaphore and/or sends queue message, when the requested timer has elapsed.
+ *          The semaphore is given on every tick, or only when a timer is due with TMR_SLEEP_UNTIL_EXPIRY.
  *
  * Arguments: uint32_t Arg0 - Value passed as part of task creation. Not used for this task.
  *
@@ -298,7 +743,6 @@ returnStatus_t TMR_HandlerInit( void )
  ******************************************************************************************************************/
 void TMR_HandlerTask( taskParameter )
 {
-   timer_t           *pTimer;          /* Pointer to timer data structure */
 #if ( RTOS_SELECTION == MQX_RTOS )
    MY_ISR_STRUCT_PTR isr_ptr;          /* */
 
@@ -316,7 +760,7 @@ void TMR_HandlerTask( taskParameter )
 
    for ( ; ; ) /* RTOS Task, keep running forever */
    {
-      /* Wait for the semaphore, at each tick, RTOS ISR will give a semaphore */
+      /* Wait for the semaphore, at each tick (or next expiration), RTOS ISR will give a semaphore */
       if ( true == OS_SEM_Pend(&_tmrUtilSem, OS_WAIT_FOREVER ) )
       {  /* RTOS Tick */
 #if ( TM_TICKHOOK_SEMAPHORE_POST_ERRORS )
@@ -350,54 +794,26 @@ void TMR_HandlerTask( taskParameter )
 #endif // ( TM_TICKHOOK_SEMAPHORE_POST_ERRORS )
          OS_MUTEX_Lock(&_tmrUtilMutex); // Function will not return if it fails
 
-         _TMR_Tick_Cntr++;  // Increment the global tick counter (ticks since powerup)
-
-         /* Check if the active list is empty */
-         if ( _TMR_headNode != NULL )
+#if ( TMR_SLEEP_UNTIL_EXPIRY == 1 )
          {
-            _TMR_headNode->ulTimer_ticks--;
-
-            /* Check if timer expired */
-            while ( (_TMR_headNode != NULL) && (0 == _TMR_headNode->ulTimer_ticks) )
-            {  /* Time has elapsed, execute the timers */
-               pTimer =  _TMR_headNode;  // remember the current timer node to be processed
-               /* Set head node to point to the next node in the list */
-               _TMR_headNode = _TMR_headNode->next;
+            uint32_t now = currentTick();    /* Ticks counted while the task was asleep */
+            uint32_t nextTick;               /* Next expiration */
 
-               if ( pTimer->pFunctCallBack != NULL )   // Is this a call back?
-               {
-                  pTimer->pFunctCallBack((uint8_t)pTimer->ucCmd, pTimer->pData);
-               }
-               if ( pTimer->pSemHandle != NULL )   // give semaphore, if not NULL
-               {
-                  OS_SEM_Post(pTimer->pSemHandle);
-               }
-               /* Set the timer countdown */
-               pTimer->ulTimer_ticks = pTimer->ulDuration_ticks;
-
-               /* insert the node back on the active list, if it not a one shot timer */
-               if ( pTimer->bOneShot )
-               {  /* One shot timer, stop the timer, set the expired flag */
-                  pTimer->bStopped = true;
-                  pTimer->bExpired = true;
-                  if ( pTimer->bOneShotDelete )
-                  {  /* Delete one shot timer */
-                     /* Clearing ulDuration_mS indicates timer is free */
-                     //DBG_logPrintf ('I', "Self Delete Timer ID=%u", pTimer->usiTimerId);
-                     pTimer->ulDuration_mS = 0;
-#ifdef TM_TIMER_DEBUG
-                     TimersUsed--;
-#endif
-                  }
-                  // else, Do not delete this one-shot timer. This timer does not need to be rearmed
-               }
-               else
-               {
-                  /* Rearm, Add the timer to the active list */
-                  insertTimerNode(pTimer);
-               }
-            } //while
+            _TMR_Tick_Cntr += (uint32_t)( now - _TMR_lastTick );  // Catch up the global tick counter
+            _TMR_lastTick = now;
+            OS_INT_disable();
+            _TMR_wakeArmed = (bool)false;
+            OS_INT_enable();
+            wheelAdvance( now );
+            if ( wheelNextExpiry( &nextTick ) )
+            {
+               armWakeTick( nextTick );
+            }
          }
+#else
+         _TMR_Tick_Cntr++;  // Increment the global tick counter (ticks since powerup)
+         wheelAdvance( _TMR_wheelTime );  // Process this tick
+#endif
          OS_MUTEX_Unlock(&_tmrUtilMutex);  /* End critical section */ // Function will not return if it fails
       }
    }
@@ -421,17 +837,12 @@ void TMR_HandlerTask( taskParameter )
  **********************************************************************************************************************/
 STATIC returnStatus_t isTimerActive( uint16_t usiTimerId )
 {
-   timer_t *currentNode;       /* Points to the current node being processed in the active timer list */
    returnStatus_t eRetVal = eFAILURE;   /* Return value, default timer not active */
 
-   /* Check the link list first and remove the timer from the link list, if active */
-   for ( currentNode = _TMR_headNode; currentNode != NULL; currentNode = currentNode->next )
-   {
-      if ( currentNode->usiTimerId == usiTimerId )
-      {  /* Timer in active timers list */
-         eRetVal = eSUCCESS;
-         break;
-      }
+   /* An active timer is linked in the wheel (or in the list of timers expiring now), or its call back is running */
+   if ( ( NULL != _sTimer[usiTimerId - 1].pprev ) || _sTimer[usiTimerId - 1].bExpiring )
+   {  /* Timer in active timers list */
+      eRetVal = eSUCCESS;
    }
    return(eRetVal);
 }
@@ -458,12 +869,13 @@ returnStatus_t TMR_AddTimer( timer_t *pData )
    static uint16_t lastAllocatedIndex_ = ARRAY_IDX_CNT(_sTimer) - 1; /* Index, start at last timer as last allocated */
    timer_t *pTimer;                          /* Pointer to timer data structure */
    returnStatus_t eRetVal = eFAILURE;        /* Return value, default timer not added (out of timers) */
+   bool bLocked;                             /* This call took the mutex */
 
    /* Validate the timer parameters */
    if ( 0 != pData->ulDuration_mS )
    {  /* Non zero timer duration, find empty slot and add timer */
 
-      OS_MUTEX_Lock(&_tmrUtilMutex); // Function will not return if it fails
+      bLocked = tmrLock(); // Function will not return if it fails
 
       for ( i = 1; i <= ARRAY_IDX_CNT(_sTimer); i++ )
       {  /* Find first empty slot */
@@ -473,10 +885,16 @@ returnStatus_t TMR_AddTimer( timer_t *pData )
          pTimer = &_sTimer[nextSlotId];
          if ( 0 == pTimer->ulDuration_mS ) /* If timer duration is 0, timer slot is available */
          {
+            uint8_t ucGeneration = (uint8_t)pTimer->ucGeneration; /* Generation of the slot, not of the caller */
+
             pData->usiTimerId = (nextSlotId + 1);    /* Use index + 1 as Timer ID, so skip using 0 as valid ID */
             //DBG_logPrintf ('I', "ADD Timer ID=%u", pData->usiTimerId);
             (void)memcpy(pTimer, pData, sizeof(timer_t)); /* Set the timer parameters */
+            pTimer->ucGeneration = (unsigned)ucGeneration + 1U;
+            pTimer->next  = NULL;     /* Not in the wheel yet */
+            pTimer->pprev = NULL;
             pTimer->bExpired = false; /* can not be expired, while adding the timer */
+            pTimer->bExpiring = false;
             /* Compute the number of ticks, round up to the next tick */
             pTimer->ulDuration_ticks = pTimer->ulDuration_mS / portTICK_RATE_MS;
             if ( (pTimer->ulDuration_mS % portTICK_RATE_MS) != 0 )
@@ -501,7 +919,7 @@ returnStatus_t TMR_AddTimer( timer_t *pData )
             break; /* Break the for loop */
          }
       }
-      OS_MUTEX_Unlock(&_tmrUtilMutex);  /* End critical section */ // Function will not return if it fails
+      tmrUnlock( bLocked );  /* End critical section */ // Function will not return if it fails
    }
    return(eRetVal);
 }
@@ -527,11 +945,12 @@ returnStatus_t TMR_DeleteTimer( uint16_t usiTimerId )
    returnStatus_t eRetVal = eFAILURE;   /* Return value, default timer not found */
    timer_t *pTimer;                     /* Pointer to timer data structure */
    uint16_t slotId = usiTimerId - 1;    /* Get the slot Id for this timer */
+   bool bLocked;                        /* This call took the mutex */
 
    if ( slotId < ARRAY_IDX_CNT(_sTimer) )
    { /* ID within range */
 
-      OS_MUTEX_Lock(&_tmrUtilMutex); // Function will not return if it fails
+      bLocked = tmrLock(); // Function will not return if it fails
 
       pTimer = &_sTimer[slotId];
       /* Check if the timer is valid */
@@ -540,6 +959,8 @@ returnStatus_t TMR_DeleteTimer( uint16_t usiTimerId )
          //DBG_logPrintf ('I', "Delete Timer ID=%u", usiTimerId);
          /* Delete the timer from the active list, if present */
          (void)deleteTimerNode(usiTimerId);
+         pTimer->bExpiring = false;
+         pTimer->ucGeneration++;
          /* Clearing ulDuration_mS indicates timer is free */
          pTimer->ulDuration_mS = 0;
          eRetVal = eSUCCESS;
@@ -547,7 +968,7 @@ returnStatus_t TMR_DeleteTimer( uint16_t usiTimerId )
          TimersUsed--;
 #endif
       }
-      OS_MUTEX_Unlock(&_tmrUtilMutex);  /* End critical section */ // Function will not return if it fails
+      tmrUnlock( bLocked );  /* End critical section */ // Function will not return if it fails
    }
    return(eRetVal);
 }
@@ -574,11 +995,12 @@ returnStatus_t TMR_StartTimer( uint16_t usiTimerId )
    returnStatus_t eRetVal = eFAILURE; /* Return value, default timer not found or was already running */
    timer_t *pTimer;                   /* Pointer to timer data structure */
    uint16_t slotId = usiTimerId - 1;  /* Get the slot Id for this timer */
+   bool bLocked;                      /* This call took the mutex */
 
    if ( slotId < ARRAY_IDX_CNT(_sTimer) )
    { /* ID within range */
 
-      OS_MUTEX_Lock(&_tmrUtilMutex); // Function will not return if it fails
+      bLocked = tmrLock(); // Function will not return if it fails
 
       pTimer = &_sTimer[slotId];
       /* Check if the timer is valid */
@@ -594,7 +1016,7 @@ returnStatus_t TMR_StartTimer( uint16_t usiTimerId )
             }
          }
       }
-      OS_MUTEX_Unlock( &_tmrUtilMutex );  /* End critical section */ // Function will not return if it fails
+      tmrUnlock( bLocked );  /* End critical section */ // Function will not return if it fails
    }
    return(eRetVal);
 }
@@ -620,11 +1042,12 @@ returnStatus_t TMR_StopTimer( uint16_t usiTimerId )
    returnStatus_t eRetVal = eFAILURE; /* Return value, default timer not found or was already stopped */
    timer_t *pTimer;                   /* Pointer to timer data structure */
    uint16_t slotId = usiTimerId - 1;  /* Get the slot Id for this timer */
+   bool bLocked;                      /* This call took the mutex */
 
    if ( slotId < ARRAY_IDX_CNT(_sTimer) )
    { /* ID within range */
 
-      OS_MUTEX_Lock(&_tmrUtilMutex); // Function will not return if it fails
+      bLocked = tmrLock(); // Function will not return if it fails
       pTimer = &_sTimer[slotId];
       /* Check if the timer is allocated */
       if ( pTimer->ulDuration_mS != 0 )
@@ -635,8 +1058,15 @@ returnStatus_t TMR_StopTimer( uint16_t usiTimerId )
             pTimer->bStopped = true;
             eRetVal = eSUCCESS;
          }
+         else if ( pTimer->bExpiring )
+         {  /* Stopped by its own call back, a start will run a full period */
+            pTimer->ulTimer_ticks = pTimer->ulDuration_ticks;
+            pTimer->bExpiring = false;
+            pTimer->bStopped = true;
+            eRetVal = eSUCCESS;
+         }
       }
-      OS_MUTEX_Unlock(&_tmrUtilMutex);  /* End critical section */ // Function will not return if it fails
+      tmrUnlock( bLocked );  /* End critical section */ // Function will not return if it fails
    }
    return(eRetVal);
 }
@@ -665,10 +1095,11 @@ returnStatus_t TMR_ResetTimer( uint16_t usiTimerId, uint32_t ulTimerValue )
    returnStatus_t eRetVal = eFAILURE; /* Return value */
    timer_t *pTimer;                   /* Pointer to timer data structure */
    uint16_t slotId = usiTimerId - 1;  /* Get the slot Id for this timer */
+   bool bLocked;                      /* This call took the mutex */
 
    if ( slotId < ARRAY_IDX_CNT(_sTimer) )
    {  /* ID within range */
-      OS_MUTEX_Lock(&_tmrUtilMutex); // Function will not return if it fails
+      bLocked = tmrLock(); // Function will not return if it fails
 
       pTimer = &_sTimer[slotId];  /* Point to correct timer */
       /* Check if the timer is allocated */
@@ -676,6 +1107,7 @@ returnStatus_t TMR_ResetTimer( uint16_t usiTimerId, uint32_t ulTimerValue )
       {
          /* Delete the timer from the active list, if present */
          (void)deleteTimerNode(usiTimerId);
+         pTimer->bExpiring = false;
 
          if ( ulTimerValue > 0 )
          { /* New initial value */
@@ -696,7 +1128,7 @@ returnStatus_t TMR_ResetTimer( uint16_t usiTimerId, uint32_t ulTimerValue )
 
          eRetVal = eSUCCESS;
       }
-      OS_MUTEX_Unlock(&_tmrUtilMutex);  /* End critical section */ // Function will not return if it fails
+      tmrUnlock( bLocked );  /* End critical section */ // Function will not return if it fails
    }
    return(eRetVal);
 }
@@ -720,13 +1152,22 @@ returnStatus_t TMR_ReadTimer( timer_t *pData )
 {
    returnStatus_t eRetVal = eFAILURE; /* Return value */
    uint16_t slotId;                   /* Get the slot Id for this timer */
+   bool bLocked;                      /* This call took the mutex */
 
    slotId = pData->usiTimerId - 1; /* Get the slot of this timer */
    if ( slotId < ARRAY_IDX_CNT(_sTimer) )
    { /* ID within range */
-      OS_MUTEX_Lock(&_tmrUtilMutex); // Function will not return if it fails
+      bLocked = tmrLock(); // Function will not return if it fails
       (void)memcpy(pData, &_sTimer[slotId], sizeof(timer_t));
-      OS_MUTEX_Unlock(&_tmrUtilMutex);  /* End critical section */ // Function will not return if it fails
+      if ( NULL != pData->pprev )
+      {  /* Active, report the ticks left rather than the expiration tick */
+         pData->ulTimer_ticks -= currentTick();
+         if ( (int32_t)pData->ulTimer_ticks < 0 )
+         {  /* Due, not processed yet */
+            pData->ulTimer_ticks = 0;
+         }
+      }
+      tmrUnlock( bLocked );  /* End critical section */ // Function will not return if it fails
 
       eRetVal = eSUCCESS;
    }
@@ -750,9 +1191,16 @@ returnStatus_t TMR_ReadTimer( timer_t *pData )
  **********************************************************************************************************************/
 void TMR_GetMillisecondCntr( uint64_t *ulMSCntr )
 {
-   OS_MUTEX_Lock(&_tmrUtilMutex); // Function will not return if it fails
+   bool bLocked;  /* This call took the mutex */
+
+   bLocked = tmrLock(); // Function will not return if it fails
+#if ( TMR_SLEEP_UNTIL_EXPIRY == 1 )
+   /* Include the ticks elapsed since the task last ran */
+   *ulMSCntr = ( ( _TMR_Tick_Cntr + (uint32_t)( currentTick() - _TMR_lastTick ) ) * portTICK_RATE_MS );
+#else
    *ulMSCntr = (_TMR_Tick_Cntr * portTICK_RATE_MS);
-   OS_MUTEX_Unlock(&_tmrUtilMutex);  /* End critical section */ // Function will not return if it fails
+#endif
+   tmrUnlock( bLocked );  /* End critical section */ // Function will not return if it fails
 }
 
 /*****************************************************************************************************************
@@ -760,7 +1208,8 @@ void TMR_GetMillisecondCntr( uint64_t *ulMSCntr )
  * Function name: TMR_vApplicationTickHook
  *
  * Purpose: This function extends RTOS tick ISR. This function runs at ISR level and should only use ISR safe
- *          RTOS API's. This function give semaphore to the timer task on each RTOS tick.
+ *          RTOS API's. This function give semaphore to the timer task on each RTOS tick (only on the tick the next
+ *          timer expires, with TMR_SLEEP_UNTIL_EXPIRY).
  *
  * Arguments: None
  *
@@ -781,7 +1230,13 @@ STATIC void TMR_vApplicationTickHook( void *user_isr_ptr )
    /* RTOS tick, signal the timer task */
    if ( _tmrUtilSemCreated == true )
    {
-      OS_SEM_Post(&_tmrUtilSem);
+#if ( TMR_SLEEP_UNTIL_EXPIRY == 1 )
+      _TMR_isrTicks++;
+      if ( _TMR_wakeArmed && ( _TMR_isrTicks == _TMR_wakeTick ) )
+#endif
+      {
+         OS_SEM_Post(&_tmrUtilSem);
+      }
    }
 
    (*isr_ptr->OLD_ISR)(isr_ptr->OLD_ISR_DATA);     /* Chain to the previous notifier - This will call the RTOS tick. */
@@ -792,6 +1247,13 @@ void TMR_vApplicationTickHook( void )
    /* RTOS tick, signal the timer task */
    if ( _tmrUtilSemCreated == true )
    {
+#if ( TMR_SLEEP_UNTIL_EXPIRY == 1 )
+      _TMR_isrTicks++;
+      if ( !_TMR_wakeArmed || ( _TMR_isrTicks != _TMR_wakeTick ) )
+      {  /* No timer due on this tick */
+         return;
+      }
+#endif
 #if ( TM_TICKHOOK_SEMAPHORE_POST_ERRORS == 1 )
       if ( eFAILURE == OS_SEM_Post_fromISR_retStatus( &_tmrUtilSem ) )
       {
@@ -808,4 +1270,160 @@ void TMR_vApplicationTickHook( void )
    }
 }
 #endif
+#ifdef TM_TIMER_UNIT_TEST
+/***********************************************************************************************************************
+ *
+ * Function name: tmrSelfTestCallBack
+ *
+ * Purpose: Call back of the TMR_unitTest periodic timers. Resets its own timer (ucCmd 0) or stops it on the third
+ *          call (ucCmd 1).
+ *
+ * Arguments: uint8_t ucCmd: What to do to the timer
+ *            void *pData: tmrSelfTest_t of the timer
+ *
+ * Returns: None
+ *
+ * Side effects: Counts the calls
+ *
+ * Reentrant: No
+ *
+ **********************************************************************************************************************/
+static void tmrSelfTestCallBack( uint8_t ucCmd, void *pData )
+{
+   tmrSelfTest_t *pTest = (tmrSelfTest_t *)pData;
+
+   pTest->calls++;
+   if ( 0 == ucCmd )
+   {
+      (void)TMR_ResetTimer( pTest->id, 0 );
+   }
+   else if ( pTest->calls >= 3 )
+   {
+      (void)TMR_StopTimer( pTest->id );
+   }
+}
+#endif
+
+/***********************************************************************************************************************
+ *
+ * Function name: TMR_unitTest
+ *
+ * Purpose: Fill the free timer slots with stopped timers of assorted durations, time TMR_ResetTimer/TMR_StopTimer on
+ *          all of them and check the ticks left reported by TMR_ReadTimer.
+ *          Then run two 50ms periodic timers, one resetting itself from its call back, one stopping itself on the third
+ *          call, and check they expire the expected number of times.
+ *
+ * Arguments: None
+ *
+ * Returns: None
+ *
+ * Side effects: Uses (then deletes) all the free timers for the duration of the test
+ *
+ * Reentrant: No
+ *
+ **********************************************************************************************************************/
+void TMR_unitTest( void )
+{
+#ifdef TM_TIMER_UNIT_TEST
+   timer_t  tmrCfg;                 /* Timer configuration */
+   uint16_t ids[MAX_TIMERS];        /* Timers added by the test */
+   uint16_t nTimers = 0;            /* Number of timers added */
+   uint32_t errors = 0;
+   uint32_t startMs;
+   uint32_t resetMs;
+   uint16_t pass;
+   uint16_t i;
+   tmrSelfTest_t selfTest[2];       /* Timer reset by its call back, timer stopped by its call back */
+
+   (void)memset( &tmrCfg, 0, sizeof( tmrCfg ) );
+   tmrCfg.bOneShot = true;
+   tmrCfg.bStopped = true;
+   for ( i = 0; i < MAX_TIMERS; i++ )
+   {  /* From a few seconds to about a day, so all the wheel levels are used */
+      tmrCfg.ulDuration_mS = 5000UL + ( ( (uint32_t)i * (uint32_t)i * 28657UL ) % 86400000UL );
+      if ( eSUCCESS != TMR_AddTimer( &tmrCfg ) )
+      {
+         break;
+      }
+      ids[nTimers++] = tmrCfg.usiTimerId;
+   }
+
+   startMs = OS_TICK_Get_ElapsedMilliseconds();
+   for ( pass = 0; pass < 100; pass++ )
+   {
+      for ( i = 0; i < nTimers; i++ )
+      {
+         (void)TMR_ResetTimer( ids[i], 0 );
+      }
+   }
+   resetMs = OS_TICK_Get_ElapsedMilliseconds() - startMs;
+
+   for ( i = 0; i < nTimers; i++ )
+   {
+      tmrCfg.usiTimerId = ids[i];
+      (void)TMR_ReadTimer( &tmrCfg );
+      /* The timers were reset at most resetMs ago */
+      if ( ( tmrCfg.ulTimer_ticks > tmrCfg.ulDuration_ticks ) ||
+           ( ( tmrCfg.ulTimer_ticks + ( resetMs / portTICK_RATE_MS ) + 2 ) < tmrCfg.ulDuration_ticks ) )
+      {
+         errors++;
+      }
+      if ( eSUCCESS != TMR_StopTimer( ids[i] ) )
+      {
+         errors++;
+      }
+      (void)TMR_DeleteTimer( ids[i] );
+   }
+   DBG_logPrintf( 'U', "TMR %u timers, %u resets in %lu ms, %lu errors", nTimers, nTimers * pass, resetMs, errors );
+
+   /* Timers changed by their own call back */
+   errors = 0;
+   (void)memset( selfTest, 0, sizeof( selfTest ) );
+   (void)memset( &tmrCfg, 0, sizeof( tmrCfg ) );
+   tmrCfg.ulDuration_mS = 50;
+   tmrCfg.pFunctCallBack = tmrSelfTestCallBack;
+   for ( i = 0; i < ARRAY_IDX_CNT( selfTest ); i++ )
+   {
+      tmrCfg.ucCmd = (uint8_t)i;
+      tmrCfg.pData = &selfTest[i];
+      tmrCfg.bStopped = true;       /* Started once the id is known to the call back */
+      if ( eSUCCESS != TMR_AddTimer( &tmrCfg ) )
+      {
+         errors++;
+      }
+      selfTest[i].id = tmrCfg.usiTimerId;
+      (void)TMR_StartTimer( selfTest[i].id );
+   }
+   OS_TASK_Sleep( 525 );
+   for ( i = 0; i < ARRAY_IDX_CNT( selfTest ); i++ )
+   {
+      tmrCfg.usiTimerId = selfTest[i].id;
+      (void)TMR_ReadTimer( &tmrCfg );
+      if ( 0 == i )
+      {  /* Reset by its call back: once per period, still running */
+         if ( ( selfTest[i].calls < 9 ) || ( selfTest[i].calls > 11 ) || tmrCfg.bStopped ||
+              ( NULL == tmrCfg.pprev ) || ( tmrCfg.ulTimer_ticks > tmrCfg.ulDuration_ticks ) )
+         {
+            errors++;
+         }
+      }
+      else
+      {  /* Stopped by its call back on the third call, can be started again */
+         if ( ( 3 != selfTest[i].calls ) || !tmrCfg.bStopped || ( NULL != tmrCfg.pprev ) ||
+              ( eSUCCESS != TMR_StartTimer( selfTest[i].id ) ) )
+         {
+            errors++;
+         }
+         OS_TASK_Sleep( 75 );
+         if ( 4 != selfTest[i].calls )
+         {
+            errors++;
+         }
+      }
+      DBG_logPrintf( 'U', "TMR self %s: %u calls", ( 0 == i ) ? "reset" : "stop", selfTest[i].calls );
+      (void)TMR_DeleteTimer( selfTest[i].id );
+   }
+   DBG_logPrintf( 'U', "TMR self reset/stop, %lu errors", errors );
+#endif
+}
 /*lint +e454 +e456 The mutex is handled properly. */
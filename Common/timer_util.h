@@ -32,6 +32,10 @@
 
 /* MACRO DEFINITIONS */
 
+#ifndef TMR_SLEEP_UNTIL_EXPIRY
+#define TMR_SLEEP_UNTIL_EXPIRY   0  /* 1 = Timer task only wakes up when a timer expires, not on every RTOS tick */
+#endif
+
 /* TYPE DEFINITIONS */
 
 typedef void  (*vFPtr_u8_pv)(uint8_t, void *);
@@ -42,9 +46,10 @@ struct sTimerList
    OS_SEM_Handle pSemHandle;          /* Semaphore handle, if not NULL, give semaphore */
    uint32_t ulDuration_mS;               /* Duration of timer in milli-seconds */
    uint32_t ulDuration_ticks;            /* Duration of timer in RTOS ticks */
-   uint32_t ulTimer_ticks;               /* Current timer value in ticks */
+   uint32_t ulTimer_ticks;               /* Ticks left (expiration tick while the timer is in the timer wheel) */
    void *pData;                        /* Pointer to Data to Pass */
-   struct sTimerList *next;            /* Points to the next member in the link list */
+   struct sTimerList *next;            /* Points to the next member in the timer wheel slot list */
+   struct sTimerList **pprev;          /* Points to the link to this member, NULL when not in the timer wheel */
    unsigned usiTimerId: 16;            /* Timer ID */
    unsigned ucCmd:      8;             /* Command Parameter to Send */
    unsigned bOneShot:   1;             /* true = Run timer once, false = Reload Timer */
@@ -53,7 +58,9 @@ struct sTimerList
    unsigned bExpired:   1;             /* true = timer expired, false otherwise. Meaningful for one shot timer */
    unsigned bOneShotDelete:   1;       /* Valid for one shot timers only. Ignored for periodic timers.
                                           true = Delete the timer after it fires. false = Do not delete the timer */
-   unsigned bRsvd:      4;             /* Reserved Field */
+   unsigned bExpiring:  1;             /* true while the timer's call back runs, cleared if the call back changes the
+                                          timer (stop, reset, delete) */
+   unsigned ucGeneration: 3;           /* Bumped each time the slot is added or deleted (wraps) */
 };
 
 typedef struct sTimerList timer_t;
@@ -71,6 +78,7 @@ returnStatus_t TMR_StopTimer(uint16_t usiTimerId);
 returnStatus_t TMR_ResetTimer( uint16_t usiTimerId, uint32_t ulTimerValue);
 returnStatus_t TMR_ReadTimer(timer_t *pData);
 void           TMR_GetMillisecondCntr(uint64_t *ulMSCntr);
+void           TMR_unitTest(void);
 #if ( RTOS_SELECTION == FREE_RTOS )
 void TMR_vApplicationTickHook( void );
 #endif
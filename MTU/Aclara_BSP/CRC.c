@@ -174,7 +174,7 @@ uint16_t CRC_16_PhyHeader ( uint8_t *Data, uint32_t Length )
    (void)CRC_Config( 0x000053EB, 0, 0, 0, 0 );
    CRC16_Result = (uint16_t)CRC_Cal_16 ( 0x000098FD, Data, Length );
 #elif ( MCU_SELECTED == RA6E1 )
-   CRC16_Result = CRC_CUSTOM_16cal( 0x53EB, 0x98FD, Data, Length);
+   CRC16_Result = CRC_CUSTOM_16cal( CRC_CUSTOM_PHY_HDR_POLY, 0x98FD, Data, Length);
 #endif
 
    OS_MUTEX_Unlock(&CRC_Mutex); // Function will not return if it fails
@@ -206,7 +206,7 @@ uint32_t CRC_32_Calculate ( uint8_t *Data, uint32_t Length )
    (void)CRC_Config( 0xF4ACFB13, 0, 0, 0, 1 );
    CRC32_Result = CRC_Cal_32 ( 0xFDBB3209, Data, Length );
 #elif ( MCU_SELECTED == RA6E1 )
-   CRC32_Result = CRC_CUSTOM_32cal( 0xF4ACFB13, 0xFDBB3209, Data, Length);
+   CRC32_Result = CRC_CUSTOM_32cal( CRC_CUSTOM_PHY_PAYLOAD_POLY, 0xFDBB3209, Data, Length);
 #endif
    OS_MUTEX_Unlock(&CRC_Mutex); // Function will not return if it fails
 
@@ -242,6 +242,7 @@
 #define DTLS_CHECK_UNENCRYPTED         (1)   /* Check for previous version major file not encrypted   */
 /* ------------------------------------------------------------------------------------------------------------------ */
 #define BM_DEBUG                       0     /* Buffer allocate/free debug printing */
+#define TMR_SLEEP_UNTIL_EXPIRY         0     /* 1 = Timer task only wakes up when a timer expires, not on every tick */
 #define ENABLE_B2B_COMM                0     /* DCU3 XCVR only */
 /* ------------------------------------------------------------------------------------------------------------------ */
 #define USE_MTLS                       1
@@ -333,6 +334,7 @@
 #endif
 #define TM_RANDOM_NUMBER_GEN              0 /* Enable commands to test aclara random number generator */
 #define TM_EXT_FLASH_BUSY_TIMING          0 /* Measure time for busyCheck in dvr_extflash to receive a complete interrupt */
+#define TM_SD_STAGE_TIMING                0 /* Time each soft demodulator stage with the CYCCNT, adds the sdstats debug command */
 #define TM_HARDFAULT                      1 /* Enable hardfault command for testing */
 #define TM_BL_TEST_COMMANDS               1 /* Enable the Bootloader Test Commands */
 #define TM_VERIFY_TICK_TIME               0 /* Enable delta time printout from loop in STRT_Startup.c every 10 seconds; 0 disables this test */
@@ -347,9 +349,16 @@
 //#define TM_SPI_DRIVER_UNIT_TEST   /* Enabled - compiles SPI driver unit test code - Needs print util. */
 //#define TM_BANKED_UNIT_TEST       /* Enable the Banked Driver Unit Test Code */
 //#define TM_CACHE_UNIT_TEST        /* Enable the Cached Driver Unit Test Code */
+//#define TM_LOGSTORE_UNIT_TEST     /* Enable the Log Store Driver power loss Unit Test Code */
 //#define TM_ENCRYPT_UNIT_TEST      /* Enable the Encryption Driver Unit Test Code */
 //#define TM_AES_UNIT_TEST          /* Enable the AES Unit Test Code */
 //#define TM_DTLS_UNIT_TEST         /* Enable the DTLS Unit Test Code */
+//#define TM_PACK_UNIT_TEST         /* Enable the Pack/Unpack Unit Test Code */
+//#define TM_BM_UNIT_TEST           /* Enable the Buffer Manager Unit Test Code */
+//#define TM_TIMER_UNIT_TEST        /* Enable the Timer Utility Unit Test Code */
+//#define TM_DFWP_UNIT_TEST         /* Enable the DFW Packet Bit Field Unit Test Code */
+//#define TM_SOFTDEMOD_UNIT_TEST    /* Enable the Soft Demodulator Replay Unit Test Code */
+//#define TM_RS_UNIT_TEST           /* Enable the Reed-Solomon Unit Test Code */
 #endif
 /* These are now part of normal build   */
 #ifndef __BOOTLOADER
@@ -38,6 +38,7 @@
 
 #include "dvr_extflash.h"
 #include "dvr_banked.h"
+#include "dvr_logStore.h"
 #include "dvr_cache.h"
 #include "dvr_encryption.h"
 #include "dvr_sectPreErase.h"
@@ -606,6 +607,19 @@ partitions_EXTERN const DeviceDriverMem_t *pBankedDriver[]
 #endif
 ; // </editor-fold>
 
+// <editor-fold defaultstate="collapsed" desc="const DeviceDriverMem_t *pLogStoreDriver[]">
+/* Contains the list of drivers for the log store driver.  For small, often updated partitions in place of pBankedDriver */
+partitions_EXTERN const DeviceDriverMem_t *pLogStoreDriver[]
+#ifdef partitions_GLOBAL
+=
+{
+   &sDeviceDriver_eLogStore,
+   &sDeviceDriver_eFlash,
+   (DeviceDriverMem_t *) NULL
+}
+#endif
+; // </editor-fold>
+
 // <editor-fold defaultstate="collapsed" desc="const DeviceDriverMem_t *pSpeDriver[]">
 /* Contains the list of drivers for the Sect Pre-Erase driver */
 partitions_EXTERN const DeviceDriverMem_t *pSpeDriver[]
@@ -61,6 +61,7 @@
 #include "hmc_msg.h"
 #include "timer_util.h"
 #include "sys_busy.h"
+#include "DBG_SerialDebug.h"
 #if ( ( END_DEVICE_PROGRAMMING_CONFIG == 1 ) || ( END_DEVICE_PROGRAMMING_FLASH >  ED_PROG_FLASH_NOT_SUPPORTED ) )
 #include "intf_cim_cmd.h"
 #endif
@@ -74,6 +75,7 @@
 #define APPLET_INDEX_LOGIN       ((uint8_t)1)
 #define APPLET_INDEX_AFTER_LOGIN ((uint8_t)2)
 #define APPLET_INDEX_LOGOFF      ((uint8_t)0)
+#define APPLET_STATS_MAX         ((uint8_t)16)   /* Applets tracked by the per-applet statistics */
 
 /* ****************************************************************************************************************** */
 /* MACRO DEFINITIONS */
@@ -91,6 +93,13 @@
 /* ****************************************************************************************************************** */
 /* TYPE DEFINITIONS */
 
+typedef struct
+{
+   uint32_t cmds;    /* Command tables the applet launched */
+   uint32_t txns;    /* PSEM requests those commands took */
+   uint32_t mS;      /* Time from launch until the response was handed back to the applet */
+} appletStats_t;
+
 /* ****************************************************************************************************************** */
 /* FILE VARIABLE DEFINITIONS */
 
@@ -106,6 +115,9 @@ uint8_t        allAppletsIdlePassCnt_ = APPLET_IDLE_COUNT;
 uint8_t        appletResponse_;              /* Applet response when called */
 #endif
 static uint16_t      hmcAppletTimerId_ = 0;/* Timer Id for applets */ // Timeout in 6 Minutes
+static appletStats_t appletStats_[APPLET_STATS_MAX];  /* Meter traffic per applet since power up */
+static uint32_t      cmdStartTxn_;        /* Transaction count when the command in flight was launched */
+static uint32_t      cmdStartMs_;         /* Time when the command in flight was launched */
 #if ( ( END_DEVICE_PROGRAMMING_CONFIG == 1 ) || ( END_DEVICE_PROGRAMMING_FLASH >  ED_PROG_FLASH_NOT_SUPPORTED ) )
 static bool SkipToLogoff = false;
 #endif
@@ -458,6 +470,12 @@ uint8_t HMC_APP_main( uint8_t ucCmd, void *pData )
                   if ( bSendComResponseToApplet_ )
                   {
                      bSendComResponseToApplet_ = false;
+                     if ( appletIndex_ < APPLET_STATS_MAX )
+                     {
+                        appletStats_[appletIndex_].cmds++;
+                        appletStats_[appletIndex_].txns += HMC_PROTO_TransactionCount() - cmdStartTxn_;
+                        appletStats_[appletIndex_].mS   += OS_TICK_Get_ElapsedMilliseconds() - cmdStartMs_;
+                     }
 
                      ucComResultToApplet = ( uint8_t )HMC_APP_API_CMD_MSG_COMPLETE; /* Init to Complete */
                      if ( sProtocolStatus.Bits.bRestart )
@@ -753,6 +771,8 @@ uint8_t HMC_APP_main( uint8_t ucCmd, void *pData )
                      /* previous response is ready, so Launch the new command */
                      appletResponse_ = ( uint8_t )HMC_APP_API_RPLY_IDLE;
                      bSendComResponseToApplet_ = true; /* Process the response after the protocol layer is complete */
+                     cmdStartTxn_ = HMC_PROTO_TransactionCount();
+                     cmdStartMs_  = OS_TICK_Get_ElapsedMilliseconds();
                      ( void )HMC_PROTO_Protocol( ( uint8_t )HMC_PROTO_CMD_NEW_CMD, &hmcRxTx_ );
                      allAppletsIdlePassCnt_ = APPLET_IDLE_COUNT;
                   }
@@ -842,6 +862,32 @@ uint8_t HMC_APP_main( uint8_t ucCmd, void *pData )
    return( ucRetVal );
 }
 
+/**********************************************************************************************************************
+
+   Function name: HMC_APP_PrintAppletStats()
+
+   Purpose: Prints the number of commands, PSEM transactions and the time spent on the meter link by each applet.
+
+   Arguments: None
+
+   Returns:    nothing
+
+ **********************************************************************************************************************/
+void HMC_APP_PrintAppletStats( void )
+{
+   uint8_t i;
+
+   DBG_logPrintf( 'R', "applet stats (total txns %lu)", HMC_PROTO_TransactionCount() );
+   for ( i = 0; ( i < HMC_APP_NumOfApplets ) && ( i < APPLET_STATS_MAX ); i++ )
+   {
+      if ( 0 != appletStats_[i].cmds )
+      {
+         DBG_logPrintf( 'R', "   applet %2u: cmds %lu, txns %lu, %lu mS", i, appletStats_[i].cmds, appletStats_[i].txns,
+                        appletStats_[i].mS );
+      }
+   }
+}
+
 #if ( TM_ENHANCE_NOISEBAND_FOR_RA6E1 == 1 )
 /**********************************************************************************************************************
 
@@ -54,6 +54,7 @@
 #include "time_sys.h"
 #include "DBG_SerialDebug.h"
 #include "APP_MSG_Handler.h"
+#include "intf_cim_cmd.h"
 
 // </editor-fold>
 // <editor-fold defaultstate="collapsed" desc="Macro Definitions">
@@ -248,6 +249,7 @@ uint8_t HMC_DMD_Reset( uint8_t ucCMD, void *pData )
          if ( procedureNumberAndId_.procId == pProcRes->seqNbr )
          {
             bDoMeterCom_ = false;
+            INTF_CIM_CMD_ansiCacheInvalidate( INTF_CIM_CACHE_ALL_TABLES ); /* Reset changed the demand registers */
             if ( dmdResetCallBack_ != NULL )
             {
                switch( pProcRes->resultCode )
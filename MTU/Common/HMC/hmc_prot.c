@@ -97,11 +97,17 @@ enum  HMC_PROTO_STATE
 /* ************************************************************************* */
 /* FILE VARIABLE DEFINITIONS */
 
+static uint32_t txnCount_;       /* Number of PSEM requests sent to the host meter */
+
 /* ************************************************************************* */
 /* FUNCTION PROTOTYPES */
 
 static uint8_t AssembleCommand(uint8_t *, HMC_PROTO_Table far const *);
-static uint16_t DecodeResponse(HMC_COM_INFO *, HMC_PROTO_Table far const *);
+static uint16_t DecodeResponse(HMC_COM_INFO *, HMC_PROTO_Table far const *, uint8_t);
+static uint16_t StoreResponse(uint8_t, const HMC_PROTO_TableCmd far *, uint8_t *, uint16_t);
+static tReadPartial const *PartialRead(HMC_PROTO_Table far const *);
+static uint16_t PartialReadCount(tReadPartial const *);
+static uint8_t CoalesceReads(tReadPartial *, HMC_PROTO_Table far const *, uint16_t *);
 
 /* ************************************************************************* */
 /* FUNCTION DEFINITIONS */
@@ -128,6 +134,9 @@ uint16_t HMC_PROTO_Protocol(uint8_t ucCmd, HMC_COM_INFO *pData)
    static bool                      bProcessData_; /* Process the response from the message layer data flag */
    static HMC_PROTO_STATUS          status_ = {0}; /* Status of the Protocol Function */ /*lint !e708 */
    static uint8_t                   psem_IdByte_;  /* Contains the PSEM ID byte */
+   static uint8_t                   mergedEntries_;/* Table entries covered by the request in flight */
+   static uint16_t                  mergedCount_;  /* Byte count requested by a merged partial read */
+   static bool                      bNoMerge_;     /* A merged read failed, send the rest of the command unmerged */
 
    HMC_MSG_STATUS                   sMMPStatus;    /* Result of the message processor */
    uint8_t                          ucNumOfBytes;  /* Number of bytes to send to the host meter */
@@ -150,6 +159,8 @@ uint16_t HMC_PROTO_Protocol(uint8_t ucCmd, HMC_COM_INFO *pData)
          pData->TxPacket.ucSequenceNum = 0;  /* Initialize the Sequence Number */
          (void)HMC_MSG_Processor((uint8_t)HMC_MSG_CMD_INIT, pData);  /* Initialize the Message Layer */
          psem_IdByte_ = PSEM_UNIVERSAL_ID;  /* Set to universal ID */
+         mergedEntries_ = 1;
+         bNoMerge_ = false;
          break;
       }
       case (uint8_t)HMC_PROTO_CMD_NEW_SESSION:
@@ -196,6 +207,8 @@ uint16_t HMC_PROTO_Protocol(uint8_t ucCmd, HMC_COM_INFO *pData)
          status_.Bits.bBusy = true; /* Remains set until the table is processed */
          bProcessData_ = false;   /* Will be set AFTER a packet is sent to the lower layer */
          pTableIndex_ = (HMC_PROTO_Table far *)(pData->pCommandTable);   /* Set table index pointer */
+         mergedEntries_ = 1;
+         bNoMerge_ = false;
          break;   /* Next time the protocol layer gets called, the data will be sent to the message layer */
       }
       case (uint8_t)HMC_PROTO_CMD_PROCESS:
@@ -226,29 +239,41 @@ uint16_t HMC_PROTO_Protocol(uint8_t ucCmd, HMC_COM_INFO *pData)
                HMC_ENG_Execute((uint8_t)HMC_ENG_PCKT_RESP, pData);
 
                status_.Bits.bCPUTime = true; /* Data is going to be processed, CPU time will be taken. */
-               status_.uiStatus |= DecodeResponse(pData, pTableIndex_); /* Save the data */
-               if (RESP_TYPE_TABLE_DATA == pData->RxPacket.ucRespType)
+               if ( (mergedEntries_ > 1) && status_.Bits.bBusy &&
+                    ( (RESP_OK != pData->RxPacket.ucResponseCode) ||
+                      (mergedCount_ != pData->RxPacket.uRxData.sTblData.uiCount) ) )
                {
-                  /* Was there a problem reading the table information? */
-                  if (RESP_OK != pData->RxPacket.ucResponseCode)
-                  {
-                     status_.Bits.bTblError = true;   /* Need to report an ERROR */
-                     status_.Bits.bBusy = false;
-                  }
+                  /* The meter refused or short read the merged request (e.g. it ran past the end of the table).  Send
+                     the entries one at a time so each one gets exactly the response it would have had on its own. */
+                  bNoMerge_ = true;
+                  bProcessData_ = false;
                }
-               if (sMMPStatus.Bits.bComplete)  /* bComplete means no packet errors. */
+               else
                {
-                  /* If the HMC_MSG process is done AND we are suppose to process data */
-                  bProcessData_ = false;
-                  status_.Bits.bMsgComplete = true;
-                  if (status_.Bits.bBusy) /* If the protocol layer has NOT aborted, then increment the Table Index */
+                  status_.uiStatus |= DecodeResponse(pData, pTableIndex_, mergedEntries_); /* Save the data */
+                  if (RESP_TYPE_TABLE_DATA == pData->RxPacket.ucRespType)
                   {
-                     pTableIndex_++;  /* Increment pointer to the next item to process */
+                     /* Was there a problem reading the table information? */
+                     if (RESP_OK != pData->RxPacket.ucResponseCode)
+                     {
+                        status_.Bits.bTblError = true;   /* Need to report an ERROR */
+                        status_.Bits.bBusy = false;
+                     }
+                  }
+                  if (sMMPStatus.Bits.bComplete)  /* bComplete means no packet errors. */
+                  {
+                     /* If the HMC_MSG process is done AND we are suppose to process data */
+                     bProcessData_ = false;
+                     status_.Bits.bMsgComplete = true;
+                     if (status_.Bits.bBusy) /* If the protocol layer has NOT aborted, then increment the Table Index */
+                     {
+                        pTableIndex_ += mergedEntries_;  /* Increment pointer to the next item to process */
+                     }
+                  }
+                  if (!status_.Bits.bBusy)
+                  {
+                     bProcessData_ = false;
                   }
-               }
-               if (!status_.Bits.bBusy)
-               {
-                  bProcessData_ = false;
                }
             }
 
@@ -275,6 +300,12 @@ uint16_t HMC_PROTO_Protocol(uint8_t ucCmd, HMC_COM_INFO *pData)
                status_.Bits.bCPUTime = true; /* Since we are accessing lower layer of code with a command, Set True */
                if (0 != ucNumOfBytes)  /* Anything to send? */
                {
+                  mergedEntries_ = 1;
+                  if (!bNoMerge_ && (CMD_TBL_RD_PARTIAL == pData->TxPacket.uTxData.sReadFull.ucServiceCode))
+                  {
+                     /* Fold the partial reads that follow into this request while they are contiguous */
+                     mergedEntries_ = CoalesceReads(&pData->TxPacket.uTxData.sReadPartial, pTableIndex_, &mergedCount_);
+                  }
                   ucResponseType = RESP_TYPE_NILL; /* Assume the NILL */
                   if (CMD_NEG_SERVICE_REQ == pData->TxPacket.uTxData.sReadFull.ucServiceCode)
                   {
@@ -343,6 +374,7 @@ uint16_t HMC_PROTO_Protocol(uint8_t ucCmd, HMC_COM_INFO *pData)
                   pData->TxPacket.ucControl &= PSEM_CTRL_MASK;    /* Ensure the control is correct */
                   pData->TxPacket.ucControl ^= PSEM_CTRL_TOGGLE;  /* Toggle the PSEM Control bit 5 */
                   pData->RxPacket.ucRespType = ucResponseType;
+                  txnCount_++;
                   (void)HMC_MSG_Processor((uint8_t)HMC_MSG_CMD_SEND_DATA, pData);  /* Send the data */
                }
                else
@@ -496,21 +528,23 @@ static uint8_t AssembleCommand(uint8_t *pBuffer, HMC_PROTO_Table far const *pStr
  * Function name: DecodeResponse()
  *
  * Purpose: Decodes and writes to memory.  Can decode many bytes into multiple
- *          registers or memory locations.
+ *          registers or memory locations.  When the request covered several
+ *          merged partial reads, the table data is split between the entries
+ *          in order, each getting the count it asked for.  A failed response
+ *          carries no table data to split, so it goes to the first entry as
+ *          it would have without merging.
  *
- * Arguments: HMC_COM_INFO *, HMC_PROTO_Table far *TableToReadFrom
+ * Arguments: HMC_COM_INFO *, HMC_PROTO_Table far *TableToReadFrom,
+ *            uint8_t ucEntries - Number of table entries the request covered
  *
  * Returns: uint16_t
  *
  *****************************************************************************/
-static uint16_t DecodeResponse(HMC_COM_INFO *ucCmd, HMC_PROTO_Table far const *pStructData)
+static uint16_t DecodeResponse(HMC_COM_INFO *ucCmd, HMC_PROTO_Table far const *pStructData, uint8_t ucEntries)
 {
    uint8_t                       *pBufferData;
-   const HMC_PROTO_TableCmd far  *pCmdPtr;
-   uint8_t far                   *pAdr;
    uint16_t                      size;
-   enum HMC_PROTO_MEM_TYPE       eType;
-   uint8_t                       ucMemType;
+   uint16_t                      partSize;
    HMC_PROTO_STATUS              sRetVal;
 
    sRetVal.uiStatus = 0;
@@ -529,7 +563,48 @@ static uint16_t DecodeResponse(HMC_COM_INFO *ucCmd, HMC_PROTO_Table far const *p
       HMC_PROT_PRNT_HEX_INFO( 'H', "Decode:          ", pBufferData, ucCmd->RxPacket.uiPacketLength.n16 );
    }
 
-   pCmdPtr = pStructData->pData;
+   if ( (RESP_OK != ucCmd->RxPacket.ucResponseCode) || (RESP_TYPE_TABLE_DATA != ucCmd->RxPacket.ucRespType) )
+   {
+      ucEntries = 1;
+   }
+   for ( ; 0 != ucEntries; ucEntries--, pStructData++ )
+   {
+      partSize = size;
+      if (ucEntries > 1)   /* Merged read, this entry only gets the bytes it asked for (never more than is left) */
+      {
+         partSize = min( PartialReadCount(PartialRead(pStructData)), size );
+      }
+      sRetVal.uiStatus |= StoreResponse(ucCmd->RxPacket.ucResponseCode, pStructData->pData, pBufferData, partSize);
+      pBufferData += partSize;
+      size -= partSize;
+   }
+   return(sRetVal.uiStatus);
+}
+/* ************************************************************************* */
+/******************************************************************************
+ *
+ * Function name: StoreResponse()
+ *
+ * Purpose: Writes response data to the destination of a table entry (the
+ *          first HMC_PROTO_MEM_WRITE entry in its command list).
+ *
+ * Arguments: uint8_t ucResponseCode - Response code from the host meter
+ *            HMC_PROTO_TableCmd far *pCmdPtr - Command list of the table entry
+ *            uint8_t *pBufferData - Data to write
+ *            uint16_t size - Number of bytes to write
+ *
+ * Returns: uint16_t - STATUS in 'HMC_PROTO_STATUS' structure format
+ *
+ *****************************************************************************/
+static uint16_t StoreResponse(uint8_t ucResponseCode, const HMC_PROTO_TableCmd far *pCmdPtr, uint8_t *pBufferData,
+                              uint16_t size)
+{
+   uint8_t far                   *pAdr;
+   enum HMC_PROTO_MEM_TYPE       eType;
+   uint8_t                       ucMemType;
+   HMC_PROTO_STATUS              sRetVal;
+
+   sRetVal.uiStatus = 0;
 
    if ((void *)NULL != pCmdPtr)
    {
@@ -543,14 +618,14 @@ static uint16_t DecodeResponse(HMC_COM_INFO *ucCmd, HMC_PROTO_Table far const *p
             if ((uint8_t)eType & HMC_PROTO_MEM_WRITE) /* Write Data? */
             {
                /* Com Error and Zero Fill data on Error? */
-               if ( (ucCmd->RxPacket.ucResponseCode != RESP_OK) && ((uint8_t)eType & HMC_PROTO_MEM_ZF) )
+               if ( (ucResponseCode != RESP_OK) && ((uint8_t)eType & HMC_PROTO_MEM_ZF) )
                {
                   // Set the "result" to all zeros, which will be written into the destination below.
                   (void)memset(pBufferData, 0, size);
                }
 
                /* Com ok OR bad and we want to write zeros? */
-               if(  (ucCmd->RxPacket.ucResponseCode == RESP_OK ) || ((uint8_t)eType & HMC_PROTO_MEM_ZF ) )
+               if(  (ucResponseCode == RESP_OK ) || ((uint8_t)eType & HMC_PROTO_MEM_ZF ) )
                {
                   // Either response was ok, OR it was an error response and we want to write zeros to the destination.
                   if ((uint8_t)eType & HMC_PROTO_MEM_ENDIAN)
@@ -613,3 +688,138 @@ static uint16_t DecodeResponse(HMC_COM_INFO *ucCmd, HMC_PROTO_Table far const *p
    return(sRetVal.uiStatus);
 }
 /* ************************************************************************* */
+/******************************************************************************
+ *
+ * Function name: PartialRead()
+ *
+ * Purpose: Checks whether a table entry is a plain partial table read, i.e. a
+ *          single tReadPartial request from RAM or program memory followed by
+ *          one destination.  Only such entries are merged with their
+ *          neighbours.
+ *
+ * Arguments: HMC_PROTO_Table far *pStructData - Table entry to check
+ *
+ * Returns: tReadPartial const * - The request, NULL if the entry can't be merged
+ *
+ *****************************************************************************/
+static tReadPartial const *PartialRead(HMC_PROTO_Table far const *pStructData)
+{
+   const HMC_PROTO_TableCmd far  *pCmdPtr = pStructData->pData;
+   tReadPartial const            *pRead = NULL;
+   uint8_t                       ucMemType;
+
+   if ((void *)NULL != pCmdPtr)
+   {
+      ucMemType = (uint8_t)pCmdPtr[0].eMemType;
+      if ( ( ((uint8_t)HMC_PROTO_MEM_PGM == ucMemType) || ((uint8_t)HMC_PROTO_MEM_RAM == ucMemType) ) &&
+           ( sizeof(tReadPartial) == pCmdPtr[0].ucLen ) &&
+           ( 0 != ((uint8_t)pCmdPtr[1].eMemType & HMC_PROTO_MEM_WRITE) ) &&
+           ( HMC_PROTO_MEM_NULL == pCmdPtr[2].eMemType ) &&
+           ( CMD_TBL_RD_PARTIAL == ((tReadPartial const *)(void const *)pCmdPtr[0].pPtr)->ucServiceCode ) )
+      {
+         pRead = (tReadPartial const *)(void const *)pCmdPtr[0].pPtr;
+      }
+   }
+   return(pRead);
+}
+/* ************************************************************************* */
+/******************************************************************************
+ *
+ * Function name: PartialReadCount()
+ *
+ * Purpose: Returns the count of a partial read request (sent big endian).
+ *
+ * Arguments: tReadPartial const *pRead - Request
+ *
+ * Returns: uint16_t - Number of bytes requested
+ *
+ *****************************************************************************/
+static uint16_t PartialReadCount(tReadPartial const *pRead)
+{
+   uint8_t const *pCnt = (uint8_t const *)&pRead->uiCount;
+
+   return( (uint16_t)(((uint16_t)pCnt[0] << 8) | pCnt[1]) );
+}
+/* ************************************************************************* */
+/******************************************************************************
+ *
+ * Function name: CoalesceReads()
+ *
+ * Purpose: PSEM only allows one request in flight, so the cost of a command
+ *          table is mostly the number of round trips.  Command tables often
+ *          read one table in consecutive pieces (e.g. ST14 in three parts), so
+ *          partial reads that follow the one just assembled are folded into it
+ *          while they read the same table, start where the previous one ended
+ *          and the total still fits in a packet (HMC_REQ_MAX_BYTES).  The count
+ *          in the assembled request is updated to cover all of them.
+ *          Only entries whose request is constant (HMC_PROTO_MEM_PGM) are
+ *          folded in: a request in RAM may be filled in from the response of
+ *          an earlier entry, so it must not be read before that response.
+ *
+ * Arguments: tReadPartial *pTx - Assembled request in the TX buffer
+ *            HMC_PROTO_Table far *pStructData - Table entry that was assembled
+ *            uint16_t *pCount - Returns the total count requested
+ *
+ * Returns: uint8_t - Number of table entries covered by the request (1 = not merged)
+ *
+ *****************************************************************************/
+static uint8_t CoalesceReads(tReadPartial *pTx, HMC_PROTO_Table far const *pStructData, uint16_t *pCount)
+{
+   tReadPartial const   *pFirst;
+   tReadPartial const   *pNext;
+   uint32_t             offset;
+   uint32_t             nextOffset;
+   uint16_t             count;
+   uint8_t              ucEntries = 1;
+   uint8_t              *pCnt;
+
+   pFirst = PartialRead(pStructData);
+   if (NULL != pFirst)
+   {
+      offset = ((uint32_t)pFirst->ucOffset[0] << 16) | ((uint32_t)pFirst->ucOffset[1] << 8) | pFirst->ucOffset[2];
+      count  = PartialReadCount(pFirst);
+      for ( pStructData++; ucEntries < UINT8_MAX; pStructData++ )
+      {
+         pNext = PartialRead(pStructData);
+         if ( (NULL == pNext) || ((uint8_t)HMC_PROTO_MEM_PGM != (uint8_t)pStructData->pData[0].eMemType) )
+         {
+            break;
+         }
+         nextOffset = ((uint32_t)pNext->ucOffset[0] << 16) | ((uint32_t)pNext->ucOffset[1] << 8) | pNext->ucOffset[2];
+         if ( (pNext->uiTbleID != pFirst->uiTbleID) || (nextOffset != (offset + count)) ||
+              (((uint32_t)count + PartialReadCount(pNext)) > HMC_REQ_MAX_BYTES) )
+         {
+            break;
+         }
+         count += PartialReadCount(pNext);
+         ucEntries++;
+      }
+      if (ucEntries > 1)
+      {
+         pCnt = (uint8_t *)&pTx->uiCount;
+         pCnt[0] = (uint8_t)(count >> 8);
+         pCnt[1] = (uint8_t)count;
+         HMC_PROT_PRNT_INFO( 'H', "Merged %hhu partial reads, count %hu", ucEntries, count );
+      }
+      *pCount = count;
+   }
+   return (ucEntries);
+}
+/* ************************************************************************* */
+/******************************************************************************
+ *
+ * Function name: HMC_PROTO_TransactionCount()
+ *
+ * Purpose: Returns the number of PSEM requests sent to the host meter.  Used
+ *          to attribute meter traffic to the applets.
+ *
+ * Arguments: None
+ *
+ * Returns: uint32_t - Requests sent since power up (wraps)
+ *
+ *****************************************************************************/
+uint32_t HMC_PROTO_TransactionCount(void)
+{
+   return (txnCount_);
+}
+/* ************************************************************************* */
@@ -127,6 +127,7 @@ PACK_END
 /* FUNCTION PROTOTYPES */
 
 GLOBAL uint16_t HMC_PROTO_Protocol( uint8_t, HMC_COM_INFO * );
+GLOBAL uint32_t HMC_PROTO_TransactionCount( void );
 
 #undef GLOBAL
 #endif
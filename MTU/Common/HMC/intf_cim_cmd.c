@@ -245,6 +245,45 @@ static const HMC_PROTO_Table tblGenericProcedureWrOnly_[] =
 #define CIM_INTF_PRNT_HEX_ERROR( a, fmt,... )
 #endif
 
+#if ( ENABLE_HMC_TASKS == 1 ) /* meter specific code */
+#define ANSI_CACHE_SEGMENTS      6                       /* Number of table segments kept by INTF_CIM_CMD_ansiRead */
+#define ANSI_CACHE_NO_LIMIT      ((uint32_t)0xFFFFFFFF)  /* End of table not learned yet */
+
+/* Table segment cache used by INTF_CIM_CMD_ansiRead. A full meter read asks for many small values from the same few
+   tables. A miss on a cached table reads up to HMC_REQ_MAX_BYTES from the requested offset, so the reads of the
+   neighbouring values are served without another meter transaction. Only the tables listed in ansiCacheTbl_ are
+   cached. Writes and procedures through this module invalidate the cache, and the TTL bounds how stale a value can be
+   after a change this module did not see. An invalidation bumps the table's generation, so a read that was already in
+   progress does not store what the meter returned before the change. */
+typedef struct
+{
+   uint16_t id;         /* Table ID */
+   uint16_t ttl_mS;     /* How long a segment of this table stays valid */
+   uint32_t limit;      /* Known end of table. A read-ahead past the end is rejected by the meter */
+   uint32_t gen;        /* Bumped by INTF_CIM_CMD_ansiCacheInvalidate, under ansiCacheMutex_ */
+} ansiCacheTbl_t;
+
+typedef struct
+{
+   uint32_t offset;                    /* Table offset of data[0] */
+   uint32_t stamp;                     /* OS_TICK_Get_ElapsedMilliseconds() when the segment was read */
+   uint16_t id;                        /* Table ID */
+   uint16_t len;                       /* Number of valid bytes in data, 0 = unused */
+   uint8_t  data[HMC_REQ_MAX_BYTES];
+} ansiCacheSeg_t;
+
+static ansiCacheTbl_t ansiCacheTbl_[] =
+{
+   { STD_TBL_ACTUAL_REGISTER,       60000, ANSI_CACHE_NO_LIMIT, 0 },  /* Changes only when the meter is programmed */
+   { STD_TBL_DATA_SELECTION,        60000, ANSI_CACHE_NO_LIMIT, 0 },  /* Changes only when the meter is programmed */
+   { STD_TBL_CURRENT_REGISTER_DATA,  2000, ANSI_CACHE_NO_LIMIT, 0 },  /* One full meter read, dropped at LP boundaries */
+   { STD_TBL_PRESENT_REGISTER_DATA,  2000, ANSI_CACHE_NO_LIMIT, 0 }
+};
+static ansiCacheSeg_t ansiCacheSeg_[ANSI_CACHE_SEGMENTS];
+static OS_MUTEX_Obj   ansiCacheMutex_;                  /* Held only while the cache is accessed, never across a read */
+static bool           ansiCacheMutexCreated_ = false;
+#endif   /* end of ENABLE_HMC_TASKS == 1  */
+
 /* ****************************************************************************************************************** */
 /* FUNCTION PROTOTYPES */
 #if ( ENABLE_HMC_TASKS == 1 ) /* meter specific code */
@@ -253,6 +292,15 @@ static enum_CIM_QualityCode searchHmcUom( meterReadingType RdgType, pValueInfo_t
 static enum_CIM_QualityCode searchOddballDirectRead( meterReadingType RdgType, pValueInfo_t reading );
 static enum_CIM_QualityCode getSummationReading( const quantDesc_t *qDesc, pValueInfo_t reading );
 static enum_CIM_QualityCode getDemandReading( quantDesc_t *qDesc, pValueInfo_t reading );
+static ansiCacheTbl_t *ansiCacheTbl( uint16_t id );
+static bool ansiCacheLookup( void *pDest, ansiCacheTbl_t const *pTbl, uint32_t offset, uint16_t cnt );
+static uint32_t ansiCacheGen( ansiCacheTbl_t const *pTbl );
+static void ansiCacheStore( ansiCacheTbl_t const *pTbl, uint32_t gen, uint32_t offset, uint16_t len,
+                            uint8_t const *pData );
+static bool ansiMeterRead( uint16_t id, uint32_t offset, uint16_t cnt );
+#if ( ( END_DEVICE_PROGRAMMING_CONFIG == 1 ) || ( END_DEVICE_PROGRAMMING_FLASH >  ED_PROG_FLASH_NOT_SUPPORTED ) )
+static void ansiCacheReset( void );
+#endif
 #endif   /* end of ENABLE_HMC_TASKS == 1  */
 
 /* ****************************************************************************************************************** */
@@ -863,6 +911,9 @@ INTF_CIM_CMD_ansiReadBitField( uint32_t *pDest, uint16_t id, uint32_t offset, ui
 
    Reentrant: No
 
+   Notes: Reads of the tables in ansiCacheTbl_ go through the table segment cache. A hit returns without waiting for
+          the meter, and a miss reads ahead so that neighbouring values come from the same meter transaction.
+
  **********************************************************************************************************************/
 enum_CIM_QualityCode INTF_CIM_CMD_ansiRead( void *pDest, uint16_t id, uint32_t offset, uint16_t cnt )
 {
@@ -890,41 +941,77 @@ enum_CIM_QualityCode INTF_CIM_CMD_ansiRead( void *pDest, uint16_t id, uint32_t o
       intfCimAnsiReadSemCreated_ = OS_SEM_Create( &intfCimAnsiReadSem_, 0 );
    }
 
+   if ( !ansiCacheMutexCreated_ )         /* If the mutex is invalid, create it */
+   {
+      ansiCacheMutexCreated_ = OS_MUTEX_Create( &ansiCacheMutex_ );
+   }
+
    if( cnt <= (uint16_t)HMC_REQ_MAX_BYTES ) /* are we trying to read more bytes than what is available in the static buffer */
    {
+      ansiCacheTbl_t *pTbl = ansiCacheTbl( id );   /* NULL if this table is not cached */
 
-      OS_MUTEX_Lock( &intfCimAnsiMutex_ ); // Function will not return if it fails
+      ( void )memset( pDest, 0, cnt );             /*lint !e669 !e419   size passed as parameter. */
 
-      if ( intfCimAnsiReadSemCreated_ ) /* If semHandle is valid, then try to get data from the host meter */
+      /* A hit does not wait for another task's meter transaction */
+      if ( ( NULL != pTbl ) && ansiCacheLookup( pDest, pTbl, offset, cnt ) )
       {
-         CIM_INTF_PRNT_INFO( 'I', "Tbl: %d, Offset: %d, len: %d", id, offset, cnt );
-         ansiReadRequest.bOperation = eHMC_READ;                      /* Read from the meter */
-         ansiReadRequest.tblInfo.id = id;                             /* Table ID */
-         ansiReadRequest.tblInfo.offset = offset;                     /* Offset into the table */
-         ansiReadRequest.tblInfo.cnt = cnt;                           /* Number of bytes to read */
-         ansiReadRequest.maxDataLen = ( uint8_t )cnt;                 /* limit the size to the maximum meter data type */
-         ansiReadRequest.pSem = &intfCimAnsiReadSem_;                 /* Semaphore handle */
-         ( void )memset( pDest, 0, cnt );                             /*lint !e669 !e419   size passed as parameter. */
-         ansiReadRequest.pData = ansiReadBuffer;                      /* Location to store requested data */
-         ( void )memset( ansiReadBuffer, 0, sizeof(ansiReadBuffer) ); /* initialize default buffer */
+         return CIM_QUALCODE_SUCCESS;
+      }
 
-         (void)OS_SEM_Pend( &intfCimAnsiReadSem_, 0 ); /* guard against HMC request posting sem after sem timeout */
-         OS_QUEUE_Enqueue( &HMC_REQ_queueHandle, &ansiReadRequest );   /* Start the transmission to the host meter */
+      OS_MUTEX_Lock( &intfCimAnsiMutex_ ); // Function will not return if it fails
 
-         /* Wait for HMC module to process. */
-         if ( OS_SEM_Pend( &intfCimAnsiReadSem_, INTF_CIM_TIME_OUT_mS ) )
+      /* Another task may have read the same segment while this one waited for the meter */
+      if ( ( NULL != pTbl ) && ansiCacheLookup( pDest, pTbl, offset, cnt ) )
+      {
+         retVal = CIM_QUALCODE_SUCCESS;
+      }
+      else if ( intfCimAnsiReadSemCreated_ ) /* If semHandle is valid, then try to get data from the host meter */
+      {
+         uint16_t readCnt = cnt;    /* Number of bytes requested from the meter */
+         uint32_t gen = 0;          /* Cache generation of the table when the read was issued */
+         bool     done;             /* HMC completed the request */
+
+         CIM_INTF_PRNT_INFO( 'I', "Tbl: %d, Offset: %d, len: %d", id, offset, cnt );
+         if ( NULL != pTbl )
+         {
+            gen = ansiCacheGen( pTbl );
+            if ( pTbl->limit > offset )
+            {  /* Read ahead to the end of the segment, but not past a known end of table */
+               readCnt = ( uint16_t )min( (uint32_t)HMC_REQ_MAX_BYTES, pTbl->limit - offset );
+               readCnt = max( readCnt, cnt );
+            }
+         }
+         done = ansiMeterRead( id, offset, readCnt );
+         if ( done && ( eHMC_SUCCESS != ansiReadRequest.hmcStatus ) && ( readCnt > cnt ) )
+         {  /* The read-ahead may have run past the end of the table, retry with only what was asked for */
+            bool pastEnd = (bool)( ( eHMC_TBL_ERROR == ansiReadRequest.hmcStatus ) &&
+                                   ( ( RESP_ONP == ansiReadRequest.tblResp ) ||
+                                     ( RESP_IAR == ansiReadRequest.tblResp ) ) );
+
+            readCnt = cnt;
+            done = ansiMeterRead( id, offset, cnt );
+            if ( pastEnd && done && ( eHMC_SUCCESS == ansiReadRequest.hmcStatus ) )
+            {  /* Only the meter rejecting the range says the table is shorter, a com error does not */
+               pTbl->limit = offset + cnt;   /*lint !e613 pTbl is not NULL when readCnt > cnt */
+            }
+         }
+         if ( done )
          {
             if ( eHMC_SUCCESS == ansiReadRequest.hmcStatus )          /* Was the data retrieved successfully? */
             {
                retVal = CIM_QUALCODE_SUCCESS;                     /* Meter was successfully read! */
+               if ( NULL != pTbl )
+               {
+                  if ( ( pTbl->limit != ANSI_CACHE_NO_LIMIT ) && ( ( offset + readCnt ) > pTbl->limit ) )
+                  {
+                     pTbl->limit = offset + readCnt;  /* Table is longer than we thought */
+                  }
+                  ansiCacheStore( pTbl, gen, offset, readCnt, ansiReadBuffer );
+               }
             }
 
             ( void )memcpy( pDest, ansiReadBuffer, cnt );      /*lint !e669 !e419   size passed as parameter. */
          }
-         else  /* Remove the request and return a "failed" read.  */
-         {
-            ( void ) OS_QUEUE_Dequeue ( &HMC_REQ_queueHandle ); // Failsafe - is dequeued in request applet
-         }
       }
 
       OS_MUTEX_Unlock( &intfCimAnsiMutex_ ); // Function will not return if it fails
@@ -938,6 +1025,274 @@ enum_CIM_QualityCode INTF_CIM_CMD_ansiRead( void *pDest, uint16_t id, uint32_t o
 }  /*lint !e454 !e456 Mutex unlocked, if locked successfully   */
 
 
+/***********************************************************************************************************************
+
+   Function name: ansiMeterRead
+
+   Purpose: Reads part of an ansi table from the meter into ansiReadBuffer
+
+   Arguments:  uint16_t id, uint32_t offset, uint16_t cnt - Table information
+
+   Returns: true if the HMC completed the request (ansiReadRequest.hmcStatus holds the result), false on time out
+
+   Side effects: N/A
+
+   Reentrant: No. Caller must hold intfCimAnsiMutex_
+
+ **********************************************************************************************************************/
+static bool ansiMeterRead( uint16_t id, uint32_t offset, uint16_t cnt )
+{
+   bool done = (bool)false;
+
+   ansiReadRequest.bOperation = eHMC_READ;                      /* Read from the meter */
+   ansiReadRequest.tblInfo.id = id;                             /* Table ID */
+   ansiReadRequest.tblInfo.offset = offset;                     /* Offset into the table */
+   ansiReadRequest.tblInfo.cnt = cnt;                           /* Number of bytes to read */
+   ansiReadRequest.maxDataLen = ( uint8_t )cnt;                 /* limit the size to the maximum meter data type */
+   ansiReadRequest.pSem = &intfCimAnsiReadSem_;                 /* Semaphore handle */
+   ansiReadRequest.pData = ansiReadBuffer;                      /* Location to store requested data */
+   ( void )memset( ansiReadBuffer, 0, sizeof(ansiReadBuffer) ); /* initialize default buffer */
+
+   (void)OS_SEM_Pend( &intfCimAnsiReadSem_, 0 ); /* guard against HMC request posting sem after sem timeout */
+   OS_QUEUE_Enqueue( &HMC_REQ_queueHandle, &ansiReadRequest );   /* Start the transmission to the host meter */
+
+   /* Wait for HMC module to process. */
+   if ( OS_SEM_Pend( &intfCimAnsiReadSem_, INTF_CIM_TIME_OUT_mS ) )
+   {
+      done = (bool)true;
+   }
+   else  /* Remove the request and return a "failed" read.  */
+   {
+      ( void ) OS_QUEUE_Dequeue ( &HMC_REQ_queueHandle ); // Failsafe - is dequeued in request applet
+   }
+   return done;
+}
+
+/***********************************************************************************************************************
+
+   Function name: ansiCacheTbl
+
+   Purpose: Finds the cache settings of a table
+
+   Arguments:  uint16_t id - Table ID
+
+   Returns: Pointer to the table's entry in ansiCacheTbl_, NULL if the table is not cached
+
+   Side effects: N/A
+
+   Reentrant: Yes
+
+ **********************************************************************************************************************/
+static ansiCacheTbl_t *ansiCacheTbl( uint16_t id )
+{
+   ansiCacheTbl_t *pTbl = NULL;
+
+   for ( uint8_t i = 0; i < ARRAY_IDX_CNT( ansiCacheTbl_ ); i++ )
+   {
+      if ( ansiCacheTbl_[i].id == id )
+      {
+         pTbl = &ansiCacheTbl_[i];
+         break;
+      }
+   }
+   return pTbl;
+}
+
+/***********************************************************************************************************************
+
+   Function name: ansiCacheLookup
+
+   Purpose: Copies a table segment from the cache if a segment that is still valid holds all of it
+
+   Arguments:  void *pDest - Location to store the result
+               ansiCacheTbl_t const *pTbl - Cache settings of the table
+               uint32_t offset, uint16_t cnt - Part of the table requested
+
+   Returns: true if the data was found
+
+   Side effects: Expired segments of the table are dropped
+
+   Reentrant: Yes
+
+ **********************************************************************************************************************/
+static bool ansiCacheLookup( void *pDest, ansiCacheTbl_t const *pTbl, uint32_t offset, uint16_t cnt )
+{
+   bool     found = (bool)false;
+   uint32_t now   = OS_TICK_Get_ElapsedMilliseconds();
+
+   OS_MUTEX_Lock( &ansiCacheMutex_ ); // Function will not return if it fails
+   for ( uint8_t i = 0; i < ANSI_CACHE_SEGMENTS; i++ )
+   {
+      ansiCacheSeg_t *pSeg = &ansiCacheSeg_[i];
+
+      if ( ( pSeg->len != 0 ) && ( pSeg->id == pTbl->id ) )
+      {
+         if ( ( now - pSeg->stamp ) >= pTbl->ttl_mS )
+         {
+            pSeg->len = 0;    /* Expired */
+         }
+         else if ( ( offset >= pSeg->offset ) && ( ( offset + cnt ) <= ( pSeg->offset + pSeg->len ) ) )
+         {
+            ( void )memcpy( pDest, &pSeg->data[ offset - pSeg->offset ], cnt );
+            found = (bool)true;
+            break;
+         }
+      }
+   }
+   OS_MUTEX_Unlock( &ansiCacheMutex_ ); // Function will not return if it fails
+
+   return found;
+}
+
+/***********************************************************************************************************************
+
+   Function name: ansiCacheGen
+
+   Purpose: Returns the cache generation of a table, to be passed to ansiCacheStore with the data read from the meter
+
+   Arguments:  ansiCacheTbl_t const *pTbl - Cache settings of the table
+
+   Returns: Generation of the table before the meter read is issued
+
+   Side effects: N/A
+
+   Reentrant: Yes
+
+ **********************************************************************************************************************/
+static uint32_t ansiCacheGen( ansiCacheTbl_t const *pTbl )
+{
+   uint32_t gen;
+
+   OS_MUTEX_Lock( &ansiCacheMutex_ ); // Function will not return if it fails
+   gen = pTbl->gen;
+   OS_MUTEX_Unlock( &ansiCacheMutex_ ); // Function will not return if it fails
+
+   return gen;
+}
+
+/***********************************************************************************************************************
+
+   Function name: ansiCacheStore
+
+   Purpose: Adds a table segment read from the meter to the cache
+
+   Arguments:  ansiCacheTbl_t const *pTbl - Cache settings of the table
+               uint32_t gen - Generation of the table returned by ansiCacheGen before the read was issued
+               uint32_t offset, uint16_t len - Part of the table read
+               uint8_t const *pData - Data read from the meter
+
+   Returns: None
+
+   Side effects: Older segments of the same table that overlap the new one are dropped. When the cache is full, the
+                 oldest segment is replaced. Nothing is stored if the table was invalidated since the read was issued.
+
+   Reentrant: Yes
+
+ **********************************************************************************************************************/
+static void ansiCacheStore( ansiCacheTbl_t const *pTbl, uint32_t gen, uint32_t offset, uint16_t len,
+                            uint8_t const *pData )
+{
+   uint16_t        id      = pTbl->id;
+   uint32_t        now     = OS_TICK_Get_ElapsedMilliseconds();
+   ansiCacheSeg_t *pVictim = &ansiCacheSeg_[0];
+
+   OS_MUTEX_Lock( &ansiCacheMutex_ ); // Function will not return if it fails
+   if ( gen != pTbl->gen )
+   {  /* Invalidated while the meter was read, the data may predate the change */
+      OS_MUTEX_Unlock( &ansiCacheMutex_ ); // Function will not return if it fails
+      return;
+   }
+   for ( uint8_t i = 0; i < ANSI_CACHE_SEGMENTS; i++ )
+   {
+      ansiCacheSeg_t *pSeg = &ansiCacheSeg_[i];
+
+      if ( ( pSeg->len != 0 ) && ( pSeg->id == id ) &&
+           ( offset < ( pSeg->offset + pSeg->len ) ) && ( pSeg->offset < ( offset + len ) ) )
+      {
+         pSeg->len = 0;    /* Overlaps the new segment and is older */
+      }
+      if ( pVictim->len != 0 )
+      {  /* Prefer an unused slot, then the oldest segment */
+         if ( ( pSeg->len == 0 ) || ( ( now - pSeg->stamp ) > ( now - pVictim->stamp ) ) )
+         {
+            pVictim = pSeg;
+         }
+      }
+   }
+   pVictim->id     = id;
+   pVictim->offset = offset;
+   pVictim->stamp  = now;
+   pVictim->len    = len;
+   ( void )memcpy( pVictim->data, pData, len );
+   OS_MUTEX_Unlock( &ansiCacheMutex_ ); // Function will not return if it fails
+}
+
+/***********************************************************************************************************************
+
+   Function name: INTF_CIM_CMD_ansiCacheInvalidate
+
+   Purpose: Drops the cached segments of a table. Call this when the table may have changed in the meter by a path that
+            does not go through this module.
+
+   Arguments:  uint16_t id - Table ID, or INTF_CIM_CACHE_ALL_TABLES
+
+   Returns: None
+
+   Side effects: N/A
+
+   Reentrant: Yes
+
+ **********************************************************************************************************************/
+void INTF_CIM_CMD_ansiCacheInvalidate( uint16_t id )
+{
+   if ( ansiCacheMutexCreated_ )    /* Nothing is cached before the first read */
+   {
+      OS_MUTEX_Lock( &ansiCacheMutex_ ); // Function will not return if it fails
+      for ( uint8_t i = 0; i < ARRAY_IDX_CNT( ansiCacheTbl_ ); i++ )
+      {
+         if ( ( INTF_CIM_CACHE_ALL_TABLES == id ) || ( ansiCacheTbl_[i].id == id ) )
+         {
+            ansiCacheTbl_[i].gen++;    /* Reads in progress must not store what they get */
+         }
+      }
+      for ( uint8_t i = 0; i < ANSI_CACHE_SEGMENTS; i++ )
+      {
+         if ( ( INTF_CIM_CACHE_ALL_TABLES == id ) || ( ansiCacheSeg_[i].id == id ) )
+         {
+            ansiCacheSeg_[i].len = 0;
+         }
+      }
+      OS_MUTEX_Unlock( &ansiCacheMutex_ ); // Function will not return if it fails
+   }
+}
+
+#if ( ( END_DEVICE_PROGRAMMING_CONFIG == 1 ) || ( END_DEVICE_PROGRAMMING_FLASH >  ED_PROG_FLASH_NOT_SUPPORTED ) )
+/***********************************************************************************************************************
+
+   Function name: ansiCacheReset
+
+   Purpose: Empties the cache and forgets the learned end of every table. Table sizes can change when the meter is
+            programmed.
+
+   Arguments:  None
+
+   Returns: None
+
+   Side effects: N/A
+
+   Reentrant: No. Caller must hold intfCimAnsiMutex_
+
+ **********************************************************************************************************************/
+static void ansiCacheReset( void )
+{
+   INTF_CIM_CMD_ansiCacheInvalidate( INTF_CIM_CACHE_ALL_TABLES );
+   for ( uint8_t i = 0; i < ARRAY_IDX_CNT( ansiCacheTbl_ ); i++ )
+   {
+      ansiCacheTbl_[i].limit = ANSI_CACHE_NO_LIMIT;
+   }
+}
+#endif
+
 /***********************************************************************************************************************
 
    Function name: INTF_CIM_CMD_ansiWrite
@@ -1018,6 +1373,7 @@ enum_CIM_QualityCode INTF_CIM_CMD_ansiWrite( void *pSrc, uint16_t id, uint32_t o
             ( void ) OS_QUEUE_Dequeue ( &HMC_REQ_queueHandle );
          }
       }
+    INTF_CIM_CMD_ansiCacheInvalidate( id );  /* Even a timed out write may have reached the meter */
 
     OS_MUTEX_Unlock( &intfCimAnsiMutex_ ); // Function will not return if it fails
 
@@ -1108,6 +1464,7 @@ enum_CIM_QualityCode INTF_CIM_CMD_ansiProcedure( void const *pSrc, uint16_t proc
          ( void ) OS_QUEUE_Dequeue ( &HMC_REQ_queueHandle );
       }
    }
+   INTF_CIM_CMD_ansiCacheInvalidate( INTF_CIM_CACHE_ALL_TABLES );  /* A procedure can change any table */
    OS_MUTEX_Unlock( &intfCimAnsiMutex_ ); // Function will not return if it fails
 
    return( retVal ); /*lint !e454 !e456 Mutex unlocked, if locked successfully   */
@@ -1337,6 +1694,7 @@ enum_CIM_QualityCode HMC_PRG_MTR_ansiWrite( void *pSrc, uint16_t id, uint32_t of
          }
       }
 
+    ansiCacheReset( );  /* Meter is being programmed */
     OS_MUTEX_Unlock( &intfCimAnsiMutex_ ); // Function will not return if it fails
 
 //   }/*lint !e454 !e456 Mutex unlocked, if locked successfully   */
@@ -1503,6 +1861,7 @@ enum_CIM_QualityCode HMC_PRG_MTR_ansiProcedure( void const *pSrc, uint16_t proc,
 #endif
       }
    }
+   ansiCacheReset( );  /* Meter is being programmed */
    OS_MUTEX_Unlock( &intfCimAnsiMutex_ ); // Function will not return if it fails
 
    return( retVal ); /*lint !e454 !e456 Mutex unlocked, if locked successfully   */
@@ -48,6 +48,7 @@
 /* CONSTANT DEFINITIONS */
 
 /* MACRO DEFINITIONS */
+#define INTF_CIM_CACHE_ALL_TABLES   ((uint16_t)0xFFFF)   /* INTF_CIM_CMD_ansiCacheInvalidate() - drop every table */
 
 /* TYPE DEFINITIONS */
 PACK_BEGIN
@@ -142,6 +143,7 @@ enum_CIM_QualityCode INTF_CIM_CMD_ansiReadBitField( uint32_t *pDest, uint16_t id
 enum_CIM_QualityCode INTF_CIM_CMD_ansiRead( void *pDest, uint16_t id, uint32_t offset, uint16_t cnt );
 enum_CIM_QualityCode INTF_CIM_CMD_ansiWrite( void *pSrc, uint16_t id, uint32_t offset, uint16_t cnt );
 enum_CIM_QualityCode INTF_CIM_CMD_ansiProcedure( void const *pSrc, uint16_t proc, uint8_t cnt );
+void                 INTF_CIM_CMD_ansiCacheInvalidate( uint16_t id );
 #if ( DEMAND_IN_METER == 1 )
 enum_CIM_QualityCode INTF_CIM_CMD_getDemandCfg( uint16_t *pDemandConfig);
 enum_CIM_QualityCode INTF_CIM_CMD_getDemandTypeUom( meterReadingType uom, currentRegTblType_t * type,
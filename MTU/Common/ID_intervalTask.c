@@ -100,6 +100,14 @@ typedef struct PACK_MID
    int64_t     sample;                    /* 64-bit sample */
 } idSampleData_t;                         /* Data formatted to be placed in the interval data array. */
 PACK_END
+
+/* Most recent samples of a channel, kept in RAM (see lpWindowSmpl_) so bubble-up does not read each one from NV */
+typedef struct
+{
+   uint32_t    newestIdx;                 /* metaData.smplIndex of the newest sample */
+   uint8_t     head;                      /* Slot holding the newest sample */
+   uint8_t     cnt;                       /* Number of samples held, 0 when the window has to be loaded from NV */
+} lpWindow_t;
 #endif
 
 /* Since all the individual members are atomic, no MUTEX lock required to read them. If member
@@ -167,6 +175,17 @@ typedef struct
 #endif
 
 #define LP_BU_MAX_TIME_DIVERSITY_MAX      ((uint8_t)60)
+
+#if ( LP_IN_METER == 0 )
+/* Samples per channel kept in RAM for bubble-up: three bubble-up periods of the longest schedule (60 minutes, current +
+   2 redundant) plus the longest time diversity delay, at the LP interval.
+   The window takes ID_MAX_CHANNELS * ID_LP_WINDOW_INTS * 9 bytes of static RAM: 16 samples (1152 bytes for 8 channels)
+   at 15 minutes, 48 samples (3456 bytes for 8 channels, 8640 bytes for 20) at 5 minutes. A build short of RAM may
+   define a smaller ID_LP_WINDOW_INTS (at least 1); bubble-up then reads the older samples from NV. */
+#ifndef ID_LP_WINDOW_INTS
+#define ID_LP_WINDOW_INTS                 ((uint8_t)( ( ( 3U * 60U ) + LP_BU_MAX_TIME_DIVERSITY_MAX ) / LP_INTERVAL_IN_MINUTES ))
+#endif
+#endif
 #define ID_MAX_BYTES_PER_ALL_CHANNELS     ((uint16_t)256)
 
 #if( RTOS_SELECTION == FREE_RTOS )
@@ -184,6 +203,8 @@ static chCfg_t                chCfg_[(uint8_t)ID_MAX_CHANNELS];            /* Co
 static bool                   bModuleBusy_ = (bool)false;                  /* Indicates module is busy or idle */
 static PartitionData_t  const *pIdPartitions_[(uint8_t)ID_MAX_CHANNELS];   /* Pointer to partition that contains data array. */
 static uint64_t               readingAtPwrUp_[(uint8_t)ID_MAX_CHANNELS];   /* Readings at power-up, if we boot-up with invalid time */
+static lpWindow_t             lpWindow_[(uint8_t)ID_MAX_CHANNELS];         /* Describes lpWindowSmpl_ for each channel */
+static idSampleData_t         lpWindowSmpl_[(uint8_t)ID_MAX_CHANNELS][ID_LP_WINDOW_INTS]; /* Most recent samples, ring buffer */
 #endif
 
 static FileHandle_t           fileHndlParam_;                              /* Contains the file handle information. */
@@ -227,6 +248,8 @@ static void StoreNextID_Data( uint8_t ch, chCfg_t *pChCfg, uint64_t valToBeStore
 static void resetChannel ( uint8_t ch, chCfg_t *pChCfg );
 static void cfgAllIntervalData( void );
 static int16_t addAllLoadProfileChannels( uint32_t closeTime, uint8_t *buf, uint16_t room );
+static void lpWindowLoad( uint8_t ch );
+static returnStatus_t readLpSample( uint8_t ch, uint32_t intervalToRead, idSampleData_t *pSmplData );
 static returnStatus_t lpBuAllChannelsHandler( uint8_t ch, enum_MessageMethod action, meterReadingType id, void *value, OR_PM_Attr_t *attr );
 static ID_QC_e getPriorityQC( ID_QC_e newQC, ID_QC_e oldQC );
 #if ( REMOTE_DISCONNECT == 1 )
@@ -401,10 +424,7 @@ static int16_t addAllLoadProfileChannels( uint32_t closeTime, uint8_t *buf, uint
    {
       /* Get the value of each channel at this time and pack them in one bit-structure */
       idSampleData_t smplData;   /* packed buffer with quality codes   */
-      uint32_t       totLen;
-      uint32_t       index;
       uint32_t       intervalToRead;
-      lAddr          offset;
       qualCodes_u    qualCodes;
 
       if (  ( 0 == chCfg_[ch].cfg.sampleRate_mS )                    ||    /* Channel disabled  */
@@ -418,24 +438,19 @@ static int16_t addAllLoadProfileChannels( uint32_t closeTime, uint8_t *buf, uint
       {
          continue;
       }
-      totLen = ( chCfg_[ch].cfg.storageLen + (uint32_t)sizeof( chCfg_[ch].metaData.qualCodes.byte ) );
-      index = ( ( (uint32_t)chCfg_[ch].metaData.smplIndex + chCfg_[ch].metaData.totNumInts ) - intervalToRead ) %
-                  ( lAddr )chCfg_[ch].metaData.totNumInts;
-      offset = index * totLen;
-
-      (void)memset( &smplData, 0, sizeof( smplData ) );
-      if ( eSUCCESS == PAR_partitionFptr.parRead( ( uint8_t * )&smplData, offset, totLen, pIdPartitions_[ch] ) )
+      if ( eSUCCESS == readLpSample( ch, intervalToRead, &smplData ) )
       {
          quantitySig_t        *pSig;
          uint64_t             sampleVal;
-         sysTime_dateFormat_t dTime;
-         sysTime_t            sTime;
 
          qualCodes.byte = smplData.qualCodes; /* Quality code for this interval  */
 
+#if LP_VERBOSE
+         sysTime_dateFormat_t dTime;
+         sysTime_t            sTime;
+
          TIME_UTIL_ConvertSecondsToSysFormat( closeTime, 0, &sTime );
          (void)TIME_UTIL_ConvertSysFormatToDateFormat( &sTime, &dTime );
-#if LP_VERBOSE
          INFO_printf(   "LP %02hhu/%02hhu/%04hu %02hhu:%02hhu:%02hhu Ch=%hhu QC=0x%X Val=%llu", dTime.month, dTime.day, dTime.year,
                         dTime.hour, dTime.min, dTime.sec, ch, smplData.qualCodes, smplData.sample ); /*lint !e123 */
 
@@ -447,6 +462,9 @@ static int16_t addAllLoadProfileChannels( uint32_t closeTime, uint8_t *buf, uint
             uint8_t  powerOf10 = 0;
             uint8_t  powerOf10Code;
             uint8_t  numberOfBytes;
+            uint16_t qcSize;        /* Bytes PackQC() adds for this reading */
+            uint32_t trim = 1;      /* 10^trimDigits */
+            uint8_t  digit;
 
             if ( eANSI_MTR_LOOKUP == pSig->eAccess )
             {
@@ -458,7 +476,11 @@ static int16_t addAllLoadProfileChannels( uint32_t closeTime, uint8_t *buf, uint
             }
 
             /* Convert to raw format   */
-            sampleVal = smplData.sample * (uint32_t)pow( 10.0, ( double )chCfg_[ch].cfg.trimDigits );
+            for ( digit = 0; digit < chCfg_[ch].cfg.trimDigits; digit++ )
+            {
+               trim *= 10U;
+            }
+            sampleVal = smplData.sample * trim;
             if ( (   (  vRMSA == ( meterReadingType )chCfg_[ch].cfg.rdgTypeID                            ||
                         vRMSB == ( meterReadingType )chCfg_[ch].cfg.rdgTypeID                            ||
                         vRMSC == ( meterReadingType )chCfg_[ch].cfg.rdgTypeID ) && 0x7FFF == sampleVal ) ||
@@ -471,11 +493,12 @@ static int16_t addAllLoadProfileChannels( uint32_t closeTime, uint8_t *buf, uint
             /* get the powerof10code and number of bytes */
             powerOf10Code = HEEP_getPowerOf10Code( powerOf10, (int64_t *)&sampleVal );
             numberOfBytes = HEEP_getMinByteNeeded( (int64_t)sampleVal, intValue, 0 );
+            qcSize = PackQC( qualCodes.byte, &packCfg, (bool)false );
 
             if ( !headerAdded )  /* Add the bit structure fields  */
             {
                if ( room >= ( VALUES_INTERVAL_END_SIZE + sizeof( rdgCount ) ) +  /* Room for header   */
-                  ( PackQC( qualCodes.byte, &packCfg, (bool)false ) + numberOfBytes + sizeof( RdgType ) + sizeof( RdgInfo ) ) ) /* Room for rdg */
+                  ( qcSize + numberOfBytes + sizeof( RdgType ) + sizeof( RdgInfo ) ) ) /* Room for rdg */
                {
                   uint32_t msgTime;
 
@@ -496,7 +519,7 @@ static int16_t addAllLoadProfileChannels( uint32_t closeTime, uint8_t *buf, uint
                   break;
                }
             }
-            rdgSize = PackQC( qualCodes.byte, &packCfg, (bool)false ) + numberOfBytes + sizeof( RdgType ) + sizeof( RdgInfo );
+            rdgSize = qcSize + numberOfBytes + sizeof( RdgType ) + sizeof( RdgInfo );
             if ( room >= rdgSize )
             {
                /* Pack rest of the data, including the quality code  */
@@ -541,6 +564,103 @@ static int16_t addAllLoadProfileChannels( uint32_t closeTime, uint8_t *buf, uint
 }
 #endif
 
+#if ( LP_IN_METER == 0 )
+/***********************************************************************************************************************
+
+   Function name: lpWindowLoad
+
+   Purpose: Loads the RAM window of a channel with its most recent samples, in at most two partition reads
+
+   Arguments:  uint8_t ch: ID channel
+
+   Returns: None. The window is left empty if the partition can not be read.
+
+   Notes: Caller must hold idMutex_
+
+ **********************************************************************************************************************/
+static void lpWindowLoad( uint8_t ch )
+{
+   chMetaData_t const   *pMeta = &chCfg_[ch].metaData;
+   idSampleData_t       *pSmpl = &lpWindowSmpl_[ch][0];
+   uint8_t              *pRaw  = ( uint8_t * )pSmpl;
+   uint32_t             totLen = ( chCfg_[ch].cfg.storageLen + (uint32_t)sizeof( pMeta->qualCodes.byte ) );
+   uint32_t             cnt;     /* Samples to load */
+   uint32_t             first;   /* Partition index of the oldest sample loaded */
+   uint32_t             part;    /* Samples before the partition wraps */
+   uint32_t             i;
+
+   lpWindow_[ch].cnt = 0;
+   cnt = min( min( pMeta->numValidInts, pMeta->totNumInts ), (uint32_t)ID_LP_WINDOW_INTS );
+   if ( ( 0 == cnt ) || ( totLen > sizeof( idSampleData_t ) ) )
+   {
+      return;
+   }
+   first = ( ( pMeta->smplIndex + pMeta->totNumInts ) - ( cnt - 1 ) ) % pMeta->totNumInts;
+   part  = min( cnt, pMeta->totNumInts - first );
+
+   /* Read the samples as stored (totLen bytes each) into the start of the window */
+   if ( eSUCCESS != PAR_partitionFptr.parRead( pRaw, ( lAddr )( first * totLen ), ( lCnt )( part * totLen ), pIdPartitions_[ch] ) )
+   {
+      return;
+   }
+   if (  ( part < cnt ) &&
+         ( eSUCCESS != PAR_partitionFptr.parRead( &pRaw[part * totLen], 0, ( lCnt )( ( cnt - part ) * totLen ), pIdPartitions_[ch] ) ) )
+   {
+      return;
+   }
+
+   /* Spread them out to one idSampleData_t each. Samples only move up, so start with the newest. */
+   for ( i = cnt; i-- > 0; )
+   {
+      idSampleData_t smplData;
+
+      (void)memset( &smplData, 0, sizeof( smplData ) );
+      (void)memcpy( &smplData, &pRaw[i * totLen], totLen );
+      pSmpl[i] = smplData;
+   }
+   lpWindow_[ch].head      = (uint8_t)( cnt - 1 );
+   lpWindow_[ch].newestIdx = pMeta->smplIndex;
+   lpWindow_[ch].cnt       = (uint8_t)cnt;
+}
+#endif
+#if ( LP_IN_METER == 0 )
+/***********************************************************************************************************************
+
+   Function name: readLpSample
+
+   Purpose: Reads a stored sample. Recent samples come from the channel's RAM window, older ones from the partition.
+
+   Arguments:  uint8_t ch:                 ID channel
+               uint32_t intervalToRead:    Number of intervals before the newest sample (0 = newest)
+               idSampleData_t *pSmplData:  Sample read
+
+   Returns: eSUCCESS or eFAILURE
+
+   Notes: Caller must hold idMutex_ and check intervalToRead against metaData.numValidInts
+
+ **********************************************************************************************************************/
+static returnStatus_t readLpSample( uint8_t ch, uint32_t intervalToRead, idSampleData_t *pSmplData )
+{
+   chMetaData_t const   *pMeta = &chCfg_[ch].metaData;
+   uint32_t             totLen;
+   uint32_t             index;
+
+   if ( ( 0 == lpWindow_[ch].cnt ) || ( lpWindow_[ch].newestIdx != pMeta->smplIndex ) )
+   {
+      lpWindowLoad( ch );
+   }
+   if ( intervalToRead < lpWindow_[ch].cnt )
+   {
+      *pSmplData = lpWindowSmpl_[ch][( ( lpWindow_[ch].head + ID_LP_WINDOW_INTS ) - intervalToRead ) % ID_LP_WINDOW_INTS];
+      return eSUCCESS;
+   }
+
+   totLen = ( chCfg_[ch].cfg.storageLen + (uint32_t)sizeof( pMeta->qualCodes.byte ) );
+   index  = ( ( pMeta->smplIndex + pMeta->totNumInts ) - intervalToRead ) % ( lAddr )pMeta->totNumInts;
+   (void)memset( pSmplData, 0, sizeof( *pSmplData ) );
+   return PAR_partitionFptr.parRead( ( uint8_t * )pSmplData, ( lAddr )( index * totLen ), ( lCnt )totLen, pIdPartitions_[ch] );
+}
+#endif
 /***********************************************************************************************************************
 
    Function Name: ID_MsgHandler
@@ -1593,6 +1713,10 @@ void ID_task( taskParameter )
          trafficClass = ID_getQos();
 
 #if ( LP_IN_METER == 0 )
+#if ( ENABLE_HMC_TASKS == 1 )
+         /* Drop the cached ST23, a reading cached just before the boundary must not be sampled as the boundary's */
+         INTF_CIM_CMD_ansiCacheInvalidate( STD_TBL_CURRENT_REGISTER_DATA );
+#endif
          SYSBUSY_setBusy();
          bModuleBusy_ = (bool)true;
          for ( ch = 0; ch < (uint8_t)ID_MAX_CHANNELS; ch++ )
@@ -2004,14 +2128,9 @@ returnStatus_t ID_rdIntervalData( uint8_t *pQual, double *pVal, uint8_t ch, sysT
             if ( index < chCfg_[ch].metaData.numValidInts )      /* Make sure we aren't too far into the past */
             {
                idSampleData_t smplData;                     /* packed buffer with quality codes */
-               uint32_t totLen = ( chCfg_[ch].cfg.storageLen + (uint32_t)sizeof( chCfg_[ch].metaData.qualCodes.byte ) );
-               index =  ( ( (uint32_t)chCfg_[ch].metaData.smplIndex + chCfg_[ch].metaData.totNumInts ) - index ) %
-                        ( lAddr )chCfg_[ch].metaData.totNumInts;
-               lAddr offset = index * totLen;
 
                retVal = eNV_EXTERNAL_NV_ERROR;
-               (void)memset( &smplData, 0, sizeof( smplData ) );
-               if ( eSUCCESS == PAR_partitionFptr.parRead( ( uint8_t * )&smplData, offset, totLen, pIdPartitions_[ch] ) )
+               if ( eSUCCESS == readLpSample( ch, index, &smplData ) )
                {
                   int64_t  sample = smplData.sample; /* get the sample data into a local buffer, byte aligned */
 
@@ -2181,6 +2300,7 @@ static void StoreNextID_Data( uint8_t ch, chCfg_t *pChCfg, uint64_t valToBeStore
             idSampleData_t sampleData;
             lAddr          offset;
             uint32_t       dataLen = pChCfg->cfg.storageLen + sizeof( sampleData.qualCodes );
+            returnStatus_t wrStatus;      /* Result of writing the sample */
 
    PWR_lockMutex( PWR_MUTEX_ONLY ); /* Lock the power down mutex, the following data HAS to be written together. */
 
@@ -2198,7 +2318,30 @@ static void StoreNextID_Data( uint8_t ch, chCfg_t *pChCfg, uint64_t valToBeStore
 
       /* Store load profile with meta-data   */
       pChCfg->metaData.qualCodes.byte = 0; /* clear the QC  */
-      (void)PAR_partitionFptr.parWrite( offset, ( uint8_t * )&sampleData, dataLen, pIdPartitions_[ch] );
+      wrStatus = PAR_partitionFptr.parWrite( offset, ( uint8_t * )&sampleData, dataLen, pIdPartitions_[ch] );
+
+      /* Add the sample to the RAM window if it was stored and follows the window's newest sample, otherwise reload the
+         window later */
+      if (  ( eSUCCESS == wrStatus ) &&
+            ( 0 != lpWindow_[ch].cnt ) &&
+            ( ( ( lpWindow_[ch].newestIdx + 1 ) % pChCfg->metaData.totNumInts ) == pChCfg->metaData.smplIndex ) )
+      {
+         idSampleData_t *pSlot;
+
+         lpWindow_[ch].head      = (uint8_t)( ( lpWindow_[ch].head + 1U ) % ID_LP_WINDOW_INTS );
+         lpWindow_[ch].newestIdx = pChCfg->metaData.smplIndex;
+         if ( lpWindow_[ch].cnt < ID_LP_WINDOW_INTS )
+         {
+            lpWindow_[ch].cnt++;
+         }
+         pSlot = &lpWindowSmpl_[ch][lpWindow_[ch].head];
+         (void)memset( pSlot, 0, sizeof( *pSlot ) );
+         (void)memcpy( pSlot, &sampleData, dataLen );   /* Same bytes a read of the partition returns */
+      }
+      else
+      {
+         lpWindow_[ch].cnt = 0;
+      }
       if ( lastCh != ch )
       {
          INFO_printf( "LP Ch=%hhu QC=0x%X Val=%llu Index=%lu", ch, sampleData.qualCodes, sampleData.sample, pChCfg->metaData.smplIndex );
@@ -2241,6 +2384,7 @@ static void resetChannel ( uint8_t ch, chCfg_t *pChCfg )
    pChCfg->metaData.smplDateTime = timeMsgComb - ( timeMsgComb % pChCfg->cfg.sampleRate_mS ); /* store the last boundary as previous  */
    pChCfg->metaData.numValidInts = 0;
    pChCfg->metaData.smplIndex = ch; /* So that all channels do not cross sector boundary in the same interval  */
+   lpWindow_[ch].cnt = 0;
 
    if ( ID_MODE_DELTA_e == pChCfg->cfg.mode )
    {
@@ -2717,6 +2861,7 @@ static void IntervalDataCh( uint8_t ch, tTimeSysMsg const *pTimeMsg )
                                                    chCfg_[ch].metaData.totNumInts;
                chCfg_[ch].metaData.smplDateTime -= (uint64_t)numIntervals * chCfg_[ch].cfg.sampleRate_mS;
                chCfg_[ch].metaData.numValidInts -= numIntervals;
+               lpWindow_[ch].cnt = 0;                    /* Samples will be overwritten, reload the window */
             }
             if ( 0 == timeMsgComb % chCfg_[ch].cfg.sampleRate_mS )
             {
@@ -2910,6 +3055,7 @@ static returnStatus_t readCfg( uint8_t ch, chCfg_t *pChCfg )
    returnStatus_t retVal;
    uint8_t        cntr;
 
+   lpWindow_[ch].cnt = 0;   /* Configuration may have changed, reload the window */
    /* try 5 times */
    for ( cntr = 0; cntr < 5; cntr++ )
    {
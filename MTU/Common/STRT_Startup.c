@@ -122,6 +122,7 @@
 #include "historyd.h"
 #include "OR_MR_Handler.h"
 #include "APP_MSG_Handler.h"
+#include "HEEP_util.h"
 #include "TUNNEL_MSG_Handler.h"
 #include "time_DST.h"
 #include "SELF_test.h"
@@ -268,6 +269,7 @@ const STRT_FunctionList_t startUpTbl[] =
    INIT( MTLS_init, (STRT_FLAG_LAST_GASP|STRT_FLAG_RFTEST) ),
 #endif
    INIT( APP_MSG_init, (STRT_FLAG_LAST_GASP|STRT_FLAG_QUIET|STRT_FLAG_RFTEST) ),
+   INIT( HEEP_util_init, (STRT_FLAG_LAST_GASP|STRT_FLAG_QUIET|STRT_FLAG_RFTEST) ),    // OR_PM handler index, before messages are handled
 #if (USE_IPTUNNEL == 1)
    INIT(TUNNEL_MSG_init, STRT_FLAG_NONE),
 #endif
@@ -813,6 +813,10 @@ void HD_DailyShiftTask ( taskParameter )
             OS_TASK_Sleep(50);
          }
          //Perform daily shift
+#if ( ENABLE_HMC_TASKS == 1 )
+         //Drop the cached ST23, a reading cached before the shift must not be sampled as the shift's
+         INTF_CIM_CMD_ansiCacheInvalidate( STD_TBL_CURRENT_REGISTER_DATA );
+#endif
          OS_MUTEX_Lock(&HD_Mutex_); // Function will not return if it fails
 
          //Clear the data structure